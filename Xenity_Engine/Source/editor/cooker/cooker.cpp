@@ -1,8 +1,11 @@
 #include "cooker.h"
 
 #include <string>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <algorithm>
 #include <stb_image.h>
 #include <stb_image_write.h>
 #include <stb_image_resize.h>
@@ -13,10 +16,16 @@
 #include <engine/unique_id/unique_id.h>
 #include <engine/file_system/file_system.h>
 #include <engine/file_system/file.h>
+#include <engine/file_system/mesh_loader/wavefront_loader.h>
 #include <engine/graphics/texture.h>
+#include <engine/graphics/2d_graphics/texture_atlas_packer.h>
+#include <engine/graphics/2d_graphics/texture_atlas_builder.h>
 #include <engine/graphics/shader.h>
 #include <engine/graphics/3d_graphics/mesh_data.h>
+#include <engine/scene_management/binary_scene.h>
 #include <engine/debug/debug.h>
+#include <engine/tools/benchmark.h>
+#include <engine/job_system/job_system.h>
 
 namespace fs = std::filesystem;
 
@@ -25,8 +34,14 @@ namespace fs = std::filesystem;
 FileDataBase Cooker::fileDataBase;
 using ordered_json = nlohmann::ordered_json;
 
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
 void Cooker::CookAssets(const CookSettings& settings)
 {
+	Benchmark totalBenchmark;
+	totalBenchmark.Start();
+
 	fileDataBase.Clear();
 	fileDataBase.GetBitFile().Create(settings.exportPath + "data.xenb");
 
@@ -34,258 +49,756 @@ void Cooker::CookAssets(const CookSettings& settings)
 	const size_t projectFolderPathLen = projectAssetFolder.size();
 	const std::set<uint64_t> ids = ProjectManager::GetAllUsedFileByTheGame();
 
-	// Find file from id and cook it
+	// One cache folder per platform, the cooked data depends on the platform settings
+	const std::string cookCacheFolder = projectAssetFolder + ".cook_cache/" + EnumHelper::EnumAsString(settings.platform) + "/";
+	if (settings.useCookCache)
+	{
+		fs::create_directories(cookCacheFolder);
+	}
+
+	// Prepare the tasks on the main thread (the ProjectManager and the file references are not thread safe)
+	std::vector<CookTask> tasks(ids.size());
+	size_t taskCount = 0;
 	for (uint64_t id : ids)
 	{
 		const FileInfo* fileInfo = ProjectManager::GetFileById(id);
-		if (fileInfo)
+		if (!fileInfo)
+			continue;
+
+		if (fileInfo->type != FileType::File_Shader && settings.exportShadersOnly)
+			continue;
+
+		std::string newPath;
+		if (fileInfo->file->GetPath()[0] == '.')
+		{
+			newPath = fileInfo->file->GetPath().substr(2);
+		}
+		else
+		{
+			newPath = fileInfo->file->GetPath().substr(projectFolderPathLen, fileInfo->file->GetPath().size() - projectFolderPathLen);
+		}
+
+		// Create the destination folder for the file
+		std::string folderToCreate = (settings.exportPath + newPath);
+		folderToCreate = folderToCreate.substr(0, folderToCreate.find_last_of('/'));
+		fs::create_directories(folderToCreate);
+
+		CookTask& task = tasks[taskCount];
+		task.fileInfo = fileInfo;
+		task.exportPath = folderToCreate + "/" + fileInfo->file->GetFileName() + fileInfo->file->GetFileExtension();
+		task.partialFilePath = newPath;
+		task.isInBinaryFile = fileInfo->type != FileType::File_Audio; // Do not include audio in the binary file
+
+		// Only the assets with an expensive cooking are cached, the other files are already stored as is
+		if (settings.useCookCache && (fileInfo->type == FileType::File_Texture || fileInfo->type == FileType::File_Mesh))
+		{
+			task.cookCachePath = cookCacheFolder + std::to_string(fileInfo->file->GetUniqueId()) + ".xcc";
+		}
+
+		if (fileInfo->type == FileType::File_Texture)
+		{
+			const std::shared_ptr<Texture> texture = std::dynamic_pointer_cast<Texture>(ProjectManager::GetFileReferenceByFile(*fileInfo->file));
+			task.textureResolution = static_cast<int>(texture->m_settings[settings.platform]->resolution);
+			task.packInAtlas = texture->m_settings[settings.platform]->packInAtlas;
+
+			// The textures of a page can't repeat, the neighbour textures would be sampled
+			if (task.packInAtlas && texture->m_settings[settings.platform]->wrapMode != WrapMode::ClampToEdge)
+			{
+				Debug::PrintWarning("[Cooker::CookAssets] " + fileInfo->file->GetPath() + " is not packed in an atlas page, only the textures with the ClampToEdge wrap mode can be packed");
+				task.packInAtlas = false;
+			}
+		}
+		else if (fileInfo->type == FileType::File_Mesh)
 		{
-			std::string newPath;
-			if (fileInfo->file->GetPath()[0] == '.')
+			task.meshData = std::dynamic_pointer_cast<MeshData>(ProjectManager::GetFileReferenceByFile(*fileInfo->file));
+			if (task.meshData->m_fileStatus == FileStatus::FileStatus_Not_Loaded)
 			{
-				newPath = fileInfo->file->GetPath().substr(2);
+				task.meshData->m_fileStatus = FileStatus::FileStatus_Loading;
+				task.meshData->m_isValid = false;
+				task.loadMesh = true;
+			}
+		}
+		else if (fileInfo->type == FileType::File_Shader && settings.platform == AssetPlatform::AP_PS3)
+		{
+			task.isCookedOnMainThread = true;
+		}
+		taskCount++;
+	}
+	tasks.resize(taskCount);
+
+	// Cook the assets on the worker threads of the job system
+	std::vector<JobHandle> taskHandles(taskCount);
+	for (size_t taskIndex = 0; taskIndex < taskCount; taskIndex++)
+	{
+		CookTask& task = tasks[taskIndex];
+		if (!task.isCookedOnMainThread)
+		{
+			taskHandles[taskIndex] = JobSystem::Schedule([&settings, &task]() { CookAsset(settings, task); });
+		}
+	}
+
+	// Write the cooked assets in the order of the ids, so the offsets in the binary file do not depend on the threads
+	std::map<FileType, size_t> fileCountPerType;
+	std::map<FileType, uint64_t> cookTimePerType;
+	std::map<FileType, uint64_t> writeTimePerType;
+	size_t cachedFileCount = 0;
+	std::vector<CookTask*> atlasTasks;
+	for (size_t taskIndex = 0; taskIndex < taskCount; taskIndex++)
+	{
+		JobSystem::Wait(taskHandles[taskIndex]);
+
+		CookTask& task = tasks[taskIndex];
+		if (task.isCookedOnMainThread)
+		{
+			CookAsset(settings, task);
+		}
+
+		// The GPU upload of the loaded meshes has to be done on the main thread
+		if (task.loadMesh)
+		{
+			if (task.isFromCookCache)
+			{
+				// The mesh has not been loaded
+				task.meshData->m_fileStatus = FileStatus::FileStatus_Not_Loaded;
 			}
 			else
 			{
-				newPath = fileInfo->file->GetPath().substr(projectFolderPathLen, fileInfo->file->GetPath().size() - projectFolderPathLen);
+				task.meshData->m_fileStatus = task.success ? FileStatus::FileStatus_Loaded : FileStatus::FileStatus_Failed;
+				task.meshData->OnLoadFileReferenceFinished();
 			}
+		}
 
-			// Create the destination folder for the file
-			std::string folderToCreate = (settings.exportPath + newPath);
-			folderToCreate = folderToCreate.substr(0, folderToCreate.find_last_of('/'));
-			fs::create_directories(folderToCreate);
+		// The textures packed in atlas pages are written once all pages are made
+		const bool isWaitingForAtlas = task.success && task.packInAtlas;
 
-			CookAsset(settings, *fileInfo, folderToCreate, newPath);
+		Benchmark writeBenchmark;
+		writeBenchmark.Start();
+		if (task.success && !isWaitingForAtlas)
+		{
+			WriteCookedAsset(task);
+		}
+		writeBenchmark.Stop();
+
+		const FileType fileType = task.fileInfo->type;
+		if (task.isFromCookCache)
+		{
+			cachedFileCount++;
+		}
+		fileCountPerType[fileType]++;
+		cookTimePerType[fileType] += task.cookTime;
+		writeTimePerType[fileType] += writeBenchmark.GetMicroSeconds();
+
+		// Free the memory as soon as possible
+		if (isWaitingForAtlas)
+		{
+			atlasTasks.push_back(&task);
+		}
+		else
+		{
+			task = CookTask();
+		}
+	}
+
+	if (!atlasTasks.empty())
+	{
+		CookTextureAtlases(settings, atlasTasks);
+		for (CookTask* atlasTask : atlasTasks)
+		{
+			*atlasTask = CookTask();
 		}
 	}
+
+	fileDataBase.GetBitFile().Finalize();
+
 	IntegrityState integrityState = fileDataBase.CheckIntegrity();
 	if (integrityState != IntegrityState::Integrity_Ok)
 	{
 		Debug::PrintError("[Cooker::CookAssets] Data base integrity check failed");
 	}
 	fileDataBase.SaveToFile(settings.exportPath + "db.xenb");
+
+	totalBenchmark.Stop();
+
+	// Cook time is the time spent by the worker threads, write time is the time spent on the main thread
+	Debug::Print("[Cooker::CookAssets] " + std::to_string(taskCount) + " files cooked in " + std::to_string(totalBenchmark.GetMilliseconds()) + "ms with " + std::to_string(JobSystem::GetWorkerCount()) + " worker threads (" + std::to_string(cachedFileCount) + " from the cook cache)", true);
+	for (const auto& fileCountKV : fileCountPerType)
+	{
+		const FileType fileType = fileCountKV.first;
+		Debug::Print("[Cooker::CookAssets] " + EnumHelper::EnumAsString(fileType) + ": " + std::to_string(fileCountKV.second) + " files, cook " +
+			std::to_string(cookTimePerType[fileType] / 1000) + "ms, write " + std::to_string(writeTimePerType[fileType] / 1000) + "ms", true);
+	}
 }
 
-void Cooker::CookAsset(const CookSettings& settings, const FileInfo& fileInfo, const std::string& exportFolderPath, const std::string& partialFilePath)
+void Cooker::CookAsset(const CookSettings& settings, CookTask& task)
 {
-	const std::string exportPath = exportFolderPath + "/" + fileInfo.file->GetFileName() + fileInfo.file->GetFileExtension();
+	Benchmark cookBenchmark;
+	cookBenchmark.Start();
 
-	if (fileInfo.type != FileType::File_Shader && settings.exportShadersOnly)
+	const FileInfo& fileInfo = *task.fileInfo;
+
+	// Add the raw meta file, maybe we should cook it too later
+	task.success = ReadFile(fileInfo.file->GetPath() + ".meta", task.metaData);
+	if (!task.success)
 	{
-		return;
+		Debug::PrintError("[Cooker::CookAsset] Failed to open meta file: " + fileInfo.file->GetPath() + ".meta");
 	}
-
-	// We copy the cooked file to the export folder, and then we add the copied file to the binary file
-	if (fileInfo.type == FileType::File_Texture) // Cook texture
+	else if (task.isCookedOnMainThread)
 	{
-		const std::string texturePath = fileInfo.file->GetPath();
-
-		int width, height, channels;
-		unsigned char* imageData = stbi_load(texturePath.c_str(), &width, &height, &channels, 4);
-		if (!imageData)
+		task.success = CookShaderPS3(settings, task);
+		if (task.success)
 		{
-			Debug::PrintError("[Cooker::CookAsset] Failed to load texture: " + texturePath);
-			return;
+			// The PS3 shader is written in the export folder first
+			task.success = ReadFile(task.exportPath, task.cookedData);
+			FileSystem::s_fileSystem->Delete(task.exportPath);
 		}
+	}
+	else
+	{
+		task.success = ReadFile(fileInfo.file->GetPath(), task.sourceData);
+		if (!task.success)
+		{
+			Debug::PrintError("[Cooker::CookAsset] Failed to read file: " + fileInfo.file->GetPath());
+		}
+	}
 
-		const std::shared_ptr<FileReference> fileRef = ProjectManager::GetFileReferenceByFile(*fileInfo.file);
-		const std::shared_ptr<Texture> texture = std::dynamic_pointer_cast<Texture>(fileRef);
-		TextureResolutions textureResolution = texture->m_settings[settings.platform]->resolution;
-
-		int newWidth = width;
-		int newHeight = height;
-		const int textureResolutionInt = static_cast<int>(textureResolution);
-		if ((newWidth > height) && newWidth > textureResolutionInt)
+	if (task.success && !task.isCookedOnMainThread)
+	{
+		// The meta file contains the import settings of each platform
+		const uint64_t cookerVersion = COOKER_VERSION;
+		task.cookHash = ComputeHash(&cookerVersion, sizeof(cookerVersion), FNV_OFFSET_BASIS);
+		task.cookHash = ComputeHash(&settings.platform, sizeof(settings.platform), task.cookHash);
+		task.cookHash = ComputeHash(task.metaData.data(), task.metaData.size(), task.cookHash);
+		task.cookHash = ComputeHash(task.sourceData.data(), task.sourceData.size(), task.cookHash);
+
+		if (!task.cookCachePath.empty() && ReadCookCache(task))
 		{
-			newWidth = textureResolutionInt;
-			newHeight = static_cast<int>(height * (static_cast<float>(textureResolution) / static_cast<float>(width)));
+			task.isFromCookCache = true;
 		}
-		else if ((newHeight > width) && newHeight > textureResolutionInt)
+		else if (fileInfo.type == FileType::File_Texture)
 		{
-			newWidth = static_cast<int>(width * (static_cast<float>(textureResolution) / static_cast<float>(height)));
-			newHeight = textureResolutionInt;
+			task.success = CookTexture(task);
 		}
-		else if ((newWidth == newHeight) && newWidth > textureResolutionInt)
+		else if (fileInfo.type == FileType::File_Mesh)
 		{
-			newWidth = textureResolutionInt;
-			newHeight = textureResolutionInt;
+			task.success = CookMesh(task);
+		}
+		else if (fileInfo.type == FileType::File_Scene)
+		{
+			task.success = CookScene(task);
+		}
+		else if (task.isInBinaryFile) // If file can't be cooked, just copy it
+		{
+			task.cookedData = std::move(task.sourceData);
+		}
+		else
+		{
+			task.success = WriteFile(task.exportPath, task.sourceData);
+			if (!task.success)
+			{
+				Debug::PrintError("[Cooker::CookAsset] Cannot copy " + fileInfo.file->GetPath() + " to " + task.exportPath);
+			}
 		}
 
-		//TODO do not resize if the texture is already at the correct size
-		unsigned char* resizedImageData = (unsigned char*)malloc(newWidth * newHeight * 4);
-		stbir_resize_uint8(imageData, width, height, 0, resizedImageData, newWidth, newHeight, 0, 4);
-		stbi_write_png(exportPath.c_str(), newWidth, newHeight, 4, resizedImageData, 0);
+		if (task.success && !task.isFromCookCache && !task.cookCachePath.empty())
+		{
+			WriteCookCache(task);
+		}
 
-		free(imageData);
-		free(resizedImageData);
+		// The atlas pages are made on the main thread once all textures are cooked
+		if (task.success && task.packInAtlas)
+		{
+			ReadAtlasPixels(settings, task);
+		}
 	}
-	else if (fileInfo.type == FileType::File_Mesh) // Cook mesh
+	else
 	{
-		const std::shared_ptr<FileReference> fileRef = ProjectManager::GetFileReferenceByFile(*fileInfo.file);
-		const std::shared_ptr<MeshData> meshData = std::dynamic_pointer_cast<MeshData>(fileRef);
-		meshData->LoadFileReference();
+		task.packInAtlas = false;
+	}
 
-		// REMINDER: NEVER WRITE A SIZE_T TO A FILE, ALWAYS CONVERT IT TO A FIXED SIZE TYPE
-		std::ofstream meshFile = std::ofstream(exportPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (task.success)
+	{
+		task.cookedFileSize = task.isInBinaryFile ? task.cookedData.size() : task.sourceData.size();
+	}
+	std::vector<uint8_t>().swap(task.sourceData);
+
+	cookBenchmark.Stop();
+	task.cookTime = cookBenchmark.GetMicroSeconds();
+}
+
+bool Cooker::CookTexture(CookTask& task)
+{
+	const std::string texturePath = task.fileInfo->file->GetPath();
+
+	int width, height, channels;
+	unsigned char* imageData = stbi_load_from_memory(task.sourceData.data(), static_cast<int>(task.sourceData.size()), &width, &height, &channels, 4);
+	if (!imageData)
+	{
+		Debug::PrintError("[Cooker::CookTexture] Failed to load texture: " + texturePath);
+		return false;
+	}
+
+	int newWidth = width;
+	int newHeight = height;
+	const int textureResolutionInt = task.textureResolution;
+	if ((newWidth > height) && newWidth > textureResolutionInt)
+	{
+		newWidth = textureResolutionInt;
+		newHeight = static_cast<int>(height * (static_cast<float>(textureResolutionInt) / static_cast<float>(width)));
+	}
+	else if ((newHeight > width) && newHeight > textureResolutionInt)
+	{
+		newWidth = static_cast<int>(width * (static_cast<float>(textureResolutionInt) / static_cast<float>(height)));
+		newHeight = textureResolutionInt;
+	}
+	else if ((newWidth == newHeight) && newWidth > textureResolutionInt)
+	{
+		newWidth = textureResolutionInt;
+		newHeight = textureResolutionInt;
+	}
+
+	//TODO do not resize if the texture is already at the correct size
+	unsigned char* resizedImageData = (unsigned char*)malloc(newWidth * newHeight * 4);
+	stbir_resize_uint8(imageData, width, height, 0, resizedImageData, newWidth, newHeight, 0, 4);
+
+	const bool writeResult = EncodePng(task.cookedData, newWidth, newHeight, resizedImageData);
+
+	free(imageData);
+	free(resizedImageData);
+
+	if (!writeResult)
+	{
+		Debug::PrintError("[Cooker::CookTexture] Failed to encode texture: " + texturePath);
+		return false;
+	}
+
+	return true;
+}
+
+void Cooker::ReadAtlasPixels(const CookSettings& settings, CookTask& task)
+{
+	int width, height, channels;
+	unsigned char* imageData = stbi_load_from_memory(task.cookedData.data(), static_cast<int>(task.cookedData.size()), &width, &height, &channels, 4);
+	if (!imageData || !TextureAtlasBuilder::CanBePacked(width, height, GetAtlasPageSize(settings.platform)))
+	{
+		// Written alone like the other textures
+		task.packInAtlas = false;
+	}
+	else
+	{
+		task.atlasPixels.assign(imageData, imageData + static_cast<size_t>(width) * height * 4);
+		task.textureWidth = width;
+		task.textureHeight = height;
+	}
+	stbi_image_free(imageData);
+}
 
-		// Write mesh data
-		meshFile.write((char*)&meshData->m_vertexDescriptor, sizeof(VertexElements));
-		meshFile.write((char*)&meshData->m_subMeshCount, sizeof(uint32_t));
+void Cooker::CookTextureAtlases(const CookSettings& settings, const std::vector<CookTask*>& atlasTasks)
+{
+	const int pageSize = GetAtlasPageSize(settings.platform);
+	const char* platformName = s_assetPlatformNames[static_cast<int>(settings.platform)];
+	const size_t atlasTaskCount = atlasTasks.size();
+
+	// Only the textures with the same import settings can share a page, the settings changed by the packing are ignored
+	static const char* packingVariableNames[] = { "resolution", "pixelPerUnit", "packInAtlas", "atlasPageId", "atlasUvX", "atlasUvY", "atlasUvWidth", "atlasUvHeight" };
+	std::vector<ordered_json> metaJsons(atlasTaskCount);
+	std::map<std::string, std::vector<size_t>> taskIndicesPerGroup;
+	for (size_t i = 0; i < atlasTaskCount; i++)
+	{
+		const CookTask& task = *atlasTasks[i];
+		try
+		{
+			metaJsons[i] = ordered_json::parse(task.metaData.begin(), task.metaData.end());
+		}
+		catch (const std::exception& e)
+		{
+			Debug::PrintError("[Cooker::CookTextureAtlases] Meta file error: " + task.fileInfo->file->GetPath() + " " + std::string(e.what()));
+			continue;
+		}
 
-		// Write submeshes data
-		for (std::unique_ptr<MeshData::SubMesh>& subMesh : meshData->m_subMeshes)
+		ordered_json groupSettings = metaJsons[i][platformName]["Values"];
+		for (const char* variableName : packingVariableNames)
 		{
-			meshFile.write((char*)&subMesh->vertice_count, sizeof(uint32_t));
-			meshFile.write((char*)&subMesh->index_count, sizeof(uint32_t));
-			meshFile.write((char*)&subMesh->vertexMemSize, sizeof(uint32_t));
-			meshFile.write((char*)&subMesh->indexMemSize, sizeof(uint32_t));
-			meshFile.write((char*)subMesh->data, subMesh->vertexMemSize);
-			meshFile.write((char*)subMesh->indices, subMesh->indexMemSize);
+			groupSettings.erase(variableName);
 		}
-		meshFile.close();
+		taskIndicesPerGroup[groupSettings.dump()].push_back(i);
 	}
-	else if (fileInfo.type == FileType::File_Shader) // Cook shader
+
+	struct AtlasPage
 	{
-		if (settings.platform == AssetPlatform::AP_PS3)
+		TextureAtlasPacker packer;
+		std::vector<uint8_t> pixels;
+		std::vector<size_t> taskIndices;
+	};
+
+	size_t pageCount = 0;
+	size_t packedTextureCount = 0;
+	for (auto& groupKV : taskIndicesPerGroup)
+	{
+		// The tallest textures first give a flatter skyline
+		std::vector<size_t>& taskIndices = groupKV.second;
+		std::stable_sort(taskIndices.begin(), taskIndices.end(), [&atlasTasks](size_t a, size_t b)
+			{
+				return atlasTasks[a]->textureHeight > atlasTasks[b]->textureHeight;
+			});
+
+		std::vector<AtlasPage> pages;
+		std::map<size_t, Vector4> uvRects;
+		for (const size_t taskIndex : taskIndices)
 		{
-			if (settings.exportShadersOnly)
+			CookTask& task = *atlasTasks[taskIndex];
+			const int packedWidth = task.textureWidth + TextureAtlasBuilder::BORDER_SIZE * 2;
+			const int packedHeight = task.textureHeight + TextureAtlasBuilder::BORDER_SIZE * 2;
+
+			AtlasPage* usedPage = nullptr;
+			int x = 0;
+			int y = 0;
+			for (AtlasPage& page : pages)
 			{
-				if (!std::filesystem::exists(settings.exportPath + "shaders_to_compile/"))
+				if (page.packer.Insert(packedWidth, packedHeight, x, y))
 				{
-					std::filesystem::create_directories(settings.exportPath + "shaders_to_compile/");
+					usedPage = &page;
+					break;
 				}
+			}
 
-				const std::shared_ptr<FileReference> fileRef = ProjectManager::GetFileReferenceByFile(*fileInfo.file);
-				const std::shared_ptr<Shader> shader = std::dynamic_pointer_cast<Shader>(fileRef);
+			if (!usedPage)
+			{
+				pages.push_back({ TextureAtlasPacker(pageSize, pageSize), std::vector<uint8_t>(static_cast<size_t>(pageSize) * pageSize * 4, 0), {} });
+				usedPage = &pages.back();
+				// Always fits in an empty page, the size has been checked by ReadAtlasPixels
+				usedPage->packer.Insert(packedWidth, packedHeight, x, y);
+			}
 
-				const std::string vertexShaderCode = shader->GetShaderCode(Shader::ShaderType::Vertex_Shader, Platform::P_PS3);
-				const std::string fragmentShaderCode = shader->GetShaderCode(Shader::ShaderType::Fragment_Shader, Platform::P_PS3);
+			TextureAtlasBuilder::CopyPixelsToPage(usedPage->pixels.data(), pageSize, task.atlasPixels.data(), task.textureWidth, task.textureHeight, x, y);
+			uvRects[taskIndex] = TextureAtlasBuilder::GetUvRect(pageSize, pageSize, x, y, task.textureWidth, task.textureHeight);
+			usedPage->taskIndices.push_back(taskIndex);
+			std::vector<uint8_t>().swap(task.atlasPixels);
+		}
 
-				if (vertexShaderCode.empty() || fragmentShaderCode.empty())
-				{
-					Debug::PrintError("[Cooker::CookAsset] Failed to get shader code for shader: " + partialFilePath);
-					return;
-				}
+		for (const AtlasPage& page : pages)
+		{
+			// A page with only one texture does not remove any texture change, the texture is kept alone
+			if (page.taskIndices.size() == 1)
+				continue;
 
-				const std::shared_ptr<File> vertexFile = FileSystem::MakeFile(settings.exportPath + "shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".vcg");
-				vertexFile->Open(FileMode::WriteCreateFile);
-				vertexFile->Write(vertexShaderCode);
-				vertexFile->Close();
+			std::vector<uint8_t> pageData;
+			if (!EncodePng(pageData, pageSize, pageSize, page.pixels.data()))
+			{
+				Debug::PrintError("[Cooker::CookTextureAtlases] Failed to encode atlas page");
+				continue;
+			}
 
-				const std::shared_ptr<File> fragmentFile = FileSystem::MakeFile(settings.exportPath + "shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".fcg");
-				fragmentFile->Open(FileMode::WriteCreateFile);
-				fragmentFile->Write(fragmentShaderCode);
-				fragmentFile->Close();
+			// The id only depends on the packed textures, cooking the same project again gives the same binary file
+			std::vector<uint64_t> textureIds;
+			for (const size_t taskIndex : page.taskIndices)
+			{
+				textureIds.push_back(atlasTasks[taskIndex]->fileInfo->file->GetUniqueId());
+			}
+			std::sort(textureIds.begin(), textureIds.end());
+			uint64_t pageId = ComputeHash(groupKV.first.data(), groupKV.first.size(), FNV_OFFSET_BASIS);
+			pageId = ComputeHash(textureIds.data(), textureIds.size() * sizeof(uint64_t), pageId);
+			while (pageId <= UniqueId::reservedFileId || ProjectManager::GetFileReferenceById(pageId))
+			{
+				pageId = ComputeHash(&pageId, sizeof(pageId), FNV_OFFSET_BASIS);
+			}
 
-				CopyUtils::AddCopyEntry(false, fileInfo.file->GetPath(), exportPath);
+			// The page uses the settings of its textures (ClampToEdge wrap mode), without mipmap to avoid the bleeding between the textures
+			ordered_json pageMeta = metaJsons[page.taskIndices[0]];
+			pageMeta["id"] = pageId;
+			ordered_json& pageValues = pageMeta[platformName]["Values"];
+			for (const char* variableName : packingVariableNames)
+			{
+				pageValues.erase(variableName);
 			}
-			else
+			pageValues["resolution"] = pageSize;
+			pageValues["useMipMap"] = false;
+			const std::string pageMetaString = pageMeta.dump(0);
+			const std::vector<uint8_t> pageMetaData(pageMetaString.begin(), pageMetaString.end());
+
+			FileDataBaseEntry* fileDataBaseEntry = new FileDataBaseEntry();
+			fileDataBaseEntry->p = "atlases/atlas_" + std::to_string(pageCount) + ".png";
+			fileDataBaseEntry->id = pageId;
+			fileDataBaseEntry->po = fileDataBase.GetBitFile().AddData(pageData);
+			fileDataBaseEntry->s = pageData.size();
+			fileDataBaseEntry->mpo = fileDataBase.GetBitFile().AddData(pageMetaData);
+			fileDataBaseEntry->ms = pageMetaData.size();
+			fileDataBaseEntry->t = FileType::File_Texture;
+			fileDataBaseEntry->h = ComputeHash(pageData.data(), pageData.size(), FNV_OFFSET_BASIS);
+			fileDataBase.AddFile(fileDataBaseEntry);
+			pageCount++;
+
+			// The textures load the page with the area written in their meta file
+			for (const size_t taskIndex : page.taskIndices)
 			{
-				const std::shared_ptr<FileReference> fileRef = ProjectManager::GetFileReferenceByFile(*fileInfo.file);
+				CookTask& task = *atlasTasks[taskIndex];
+				const Vector4& uvRect = uvRects[taskIndex];
+				ordered_json& values = metaJsons[taskIndex][platformName]["Values"];
+				values["atlasPageId"] = pageId;
+				values["atlasUvX"] = uvRect.x;
+				values["atlasUvY"] = uvRect.y;
+				values["atlasUvWidth"] = uvRect.z;
+				values["atlasUvHeight"] = uvRect.w;
+				const std::string metaString = metaJsons[taskIndex].dump(0);
+				task.metaData.assign(metaString.begin(), metaString.end());
+			}
+			packedTextureCount += page.taskIndices.size();
+		}
+	}
 
-				std::string projetPath = ProjectManager::GetProjectFolderPath();
-				std::string vertexShaderCodePath = projetPath + ".shaders_build/cooked_assets/shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".vco";
-				std::string fragmentShaderCodePath = projetPath + ".shaders_build/cooked_assets/shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".fco";
+	// Written in the order of the ids like the other assets
+	for (CookTask* task : atlasTasks)
+	{
+		WriteCookedAsset(*task);
+	}
 
-				const std::shared_ptr<File> vertexCodeFile = FileSystem::MakeFile(vertexShaderCodePath);
-				const std::shared_ptr<File> fragmentCodeFile = FileSystem::MakeFile(fragmentShaderCodePath);
+	Debug::Print("[Cooker::CookTextureAtlases] " + std::to_string(packedTextureCount) + " textures packed in " + std::to_string(pageCount) + " atlas pages of " + std::to_string(pageSize) + "x" + std::to_string(pageSize), true);
+}
 
-				const bool vOpenResult = vertexCodeFile->Open(FileMode::ReadOnly);
-				if (!vOpenResult) 
-				{
-					Debug::PrintError("[Cooker::CookAsset] Failed to load shader code: " + vertexShaderCodePath);
-					return;
-				}
-				const bool fOpenResult = fragmentCodeFile->Open(FileMode::ReadOnly);
-				if (!fOpenResult)
-				{
-					Debug::PrintError("[Cooker::CookAsset] Failed to load shader code: " + fragmentShaderCodePath);
-					vertexCodeFile->Close();
-					return;
-				}
+int Cooker::GetAtlasPageSize(AssetPlatform platform)
+{
+	// The PSP does not support textures bigger than 512x512
+	if (platform == AssetPlatform::AP_PSP)
+		return 512;
 
-				size_t vertexBinaryCodeSize = 0;
-				unsigned char* vertexCodeBinary = vertexCodeFile->ReadAllBinary(vertexBinaryCodeSize);
-				vertexCodeFile->Close();
+	return 2048;
+}
 
-				size_t fragmentBinaryCodeSize = 0;
-				unsigned char* fragmentCodeBinary = fragmentCodeFile->ReadAllBinary(fragmentBinaryCodeSize);
-				fragmentCodeFile->Close();
+bool Cooker::EncodePng(std::vector<uint8_t>& pngData, int width, int height, const unsigned char* pixels)
+{
+	// Encode the png in memory
+	auto writeFunction = [](void* context, void* data, int size)
+	{
+		std::vector<uint8_t>& cookedData = *static_cast<std::vector<uint8_t>*>(context);
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		cookedData.insert(cookedData.end(), bytes, bytes + size);
+	};
+	return stbi_write_png_to_func(writeFunction, &pngData, width, height, 4, pixels, 0) != 0;
+}
 
-				const uint32_t vertexBinaryCodeSizeFixed = static_cast<uint32_t>(vertexBinaryCodeSize);
-				const uint32_t fragmentBinaryCodeSizeFixed = static_cast<uint32_t>(fragmentBinaryCodeSize);
+bool Cooker::CookMesh(CookTask& task)
+{
+	MeshData& meshData = *task.meshData;
+	if (task.loadMesh)
+	{
+		// Only load the data, the GPU upload is done later on the main thread
+		if (!WavefrontLoader::LoadFromRawData(meshData))
+			return false;
+	}
+
+	// REMINDER: NEVER WRITE A SIZE_T TO A FILE, ALWAYS CONVERT IT TO A FIXED SIZE TYPE
+	std::vector<uint8_t>& meshFile = task.cookedData;
+	auto write = [&meshFile](const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		meshFile.insert(meshFile.end(), bytes, bytes + size);
+	};
 
-				// REMINDER: NEVER WRITE A SIZE_T TO A FILE, ALWAYS CONVERT IT TO A FIXED SIZE TYPE
-				std::ofstream shaderFile = std::ofstream(exportPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-				shaderFile.write((char*)&vertexBinaryCodeSizeFixed, sizeof(uint32_t));
-				shaderFile.write((char*)vertexCodeBinary, vertexBinaryCodeSizeFixed);
-				shaderFile.write((char*)&fragmentBinaryCodeSizeFixed, sizeof(uint32_t));
-				shaderFile.write((char*)fragmentCodeBinary, fragmentBinaryCodeSizeFixed);
-				shaderFile.close();
+	// Write mesh data
+	write(&meshData.m_vertexDescriptor, sizeof(VertexElements));
+	write(&meshData.m_subMeshCount, sizeof(uint32_t));
 
-				free(vertexCodeBinary);
-				free(fragmentCodeBinary);
-			}
+	// Write submeshes data
+	for (const std::unique_ptr<MeshData::SubMesh>& subMesh : meshData.m_subMeshes)
+	{
+		write(&subMesh->vertice_count, sizeof(uint32_t));
+		write(&subMesh->index_count, sizeof(uint32_t));
+		write(&subMesh->vertexMemSize, sizeof(uint32_t));
+		write(&subMesh->indexMemSize, sizeof(uint32_t));
+		write(subMesh->data, subMesh->vertexMemSize);
+		write(subMesh->indices, subMesh->indexMemSize);
+	}
+
+	return true;
+}
+
+bool Cooker::CookScene(CookTask& task)
+{
+	// The editor keeps the json format, the game loads the binary format
+	try
+	{
+		const ordered_json sceneJson = ordered_json::parse(task.sourceData.begin(), task.sourceData.end());
+		if (!BinaryScene::JsonToBinary(sceneJson, task.cookedData))
+			return false;
+	}
+	catch (const std::exception& e)
+	{
+		Debug::PrintError("[Cooker::CookScene] Scene file error: " + task.fileInfo->file->GetPath() + " " + std::string(e.what()));
+		return false;
+	}
+
+	return true;
+}
+
+bool Cooker::CookShaderPS3(const CookSettings& settings, CookTask& task)
+{
+	if (settings.exportShadersOnly)
+	{
+		if (!std::filesystem::exists(settings.exportPath + "shaders_to_compile/"))
+		{
+			std::filesystem::create_directories(settings.exportPath + "shaders_to_compile/");
 		}
-		else 
+
+		const std::shared_ptr<FileReference> fileRef = ProjectManager::GetFileReferenceByFile(*task.fileInfo->file);
+		const std::shared_ptr<Shader> shader = std::dynamic_pointer_cast<Shader>(fileRef);
+
+		const std::string vertexShaderCode = shader->GetShaderCode(Shader::ShaderType::Vertex_Shader, Platform::P_PS3);
+		const std::string fragmentShaderCode = shader->GetShaderCode(Shader::ShaderType::Fragment_Shader, Platform::P_PS3);
+
+		if (vertexShaderCode.empty() || fragmentShaderCode.empty())
 		{
-			CopyUtils::AddCopyEntry(false, fileInfo.file->GetPath(), exportPath);
+			Debug::PrintError("[Cooker::CookShaderPS3] Failed to get shader code for shader: " + task.partialFilePath);
+			return false;
 		}
+
+		const std::shared_ptr<File> vertexFile = FileSystem::MakeFile(settings.exportPath + "shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".vcg");
+		vertexFile->Open(FileMode::WriteCreateFile);
+		vertexFile->Write(vertexShaderCode);
+		vertexFile->Close();
+
+		const std::shared_ptr<File> fragmentFile = FileSystem::MakeFile(settings.exportPath + "shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".fcg");
+		fragmentFile->Open(FileMode::WriteCreateFile);
+		fragmentFile->Write(fragmentShaderCode);
+		fragmentFile->Close();
+
+		CopyUtils::AddCopyEntry(false, task.fileInfo->file->GetPath(), task.exportPath);
 	}
-	else // If file can't be cooked, just copy it
+	else
 	{
-		CopyUtils::AddCopyEntry(false, fileInfo.file->GetPath(), exportPath);
-	}
+		const std::shared_ptr<FileReference> fileRef = ProjectManager::GetFileReferenceByFile(*task.fileInfo->file);
 
-	// Copy the raw meta file, maybe we should cook it too later
-	CopyUtils::AddCopyEntry(false, fileInfo.file->GetPath() + ".meta", exportPath + ".meta");
-	const uint64_t metaSize = fs::file_size(fileInfo.file->GetPath() + ".meta");
+		std::string projetPath = ProjectManager::GetProjectFolderPath();
+		std::string vertexShaderCodePath = projetPath + ".shaders_build/cooked_assets/shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".vco";
+		std::string fragmentShaderCodePath = projetPath + ".shaders_build/cooked_assets/shaders_to_compile/" + std::to_string(fileRef->GetFileId()) + ".fco";
 
-	CopyUtils::ExecuteCopyEntries();
+		const std::shared_ptr<File> vertexCodeFile = FileSystem::MakeFile(vertexShaderCodePath);
+		const std::shared_ptr<File> fragmentCodeFile = FileSystem::MakeFile(fragmentShaderCodePath);
 
-	const uint64_t cookedFileSize = fs::file_size(exportPath.c_str());
+		const bool vOpenResult = vertexCodeFile->Open(FileMode::ReadOnly);
+		if (!vOpenResult) 
+		{
+			Debug::PrintError("[Cooker::CookShaderPS3] Failed to load shader code: " + vertexShaderCodePath);
+			return false;
+		}
+		const bool fOpenResult = fragmentCodeFile->Open(FileMode::ReadOnly);
+		if (!fOpenResult)
+		{
+			Debug::PrintError("[Cooker::CookShaderPS3] Failed to load shader code: " + fragmentShaderCodePath);
+			vertexCodeFile->Close();
+			return false;
+		}
+
+		size_t vertexBinaryCodeSize = 0;
+		unsigned char* vertexCodeBinary = vertexCodeFile->ReadAllBinary(vertexBinaryCodeSize);
+		vertexCodeFile->Close();
+
+		size_t fragmentBinaryCodeSize = 0;
+		unsigned char* fragmentCodeBinary = fragmentCodeFile->ReadAllBinary(fragmentBinaryCodeSize);
+		fragmentCodeFile->Close();
+
+		const uint32_t vertexBinaryCodeSizeFixed = static_cast<uint32_t>(vertexBinaryCodeSize);
+		const uint32_t fragmentBinaryCodeSizeFixed = static_cast<uint32_t>(fragmentBinaryCodeSize);
+
+		// REMINDER: NEVER WRITE A SIZE_T TO A FILE, ALWAYS CONVERT IT TO A FIXED SIZE TYPE
+		std::ofstream shaderFile = std::ofstream(task.exportPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		shaderFile.write((char*)&vertexBinaryCodeSizeFixed, sizeof(uint32_t));
+		shaderFile.write((char*)vertexCodeBinary, vertexBinaryCodeSizeFixed);
+		shaderFile.write((char*)&fragmentBinaryCodeSizeFixed, sizeof(uint32_t));
+		shaderFile.write((char*)fragmentCodeBinary, fragmentBinaryCodeSizeFixed);
+		shaderFile.close();
+
+		free(vertexCodeBinary);
+		free(fragmentCodeBinary);
+	}
+
+	return CopyUtils::ExecuteCopyEntries();
+}
 
-	// Do not include audio in the binary file
+void Cooker::WriteCookedAsset(CookTask& task)
+{
 	size_t dataOffset = 0;
-	if (fileInfo.type != FileType::File_Audio)
+	if (task.isInBinaryFile)
 	{
-		const std::shared_ptr<File> cookedFile = FileSystem::MakeFile(exportPath);
-		size_t cookedFileSizeOut;
-		cookedFile->Open(FileMode::ReadOnly);
-		unsigned char* fileData = cookedFile->ReadAllBinary(cookedFileSizeOut);
-		cookedFile->Close();
-		dataOffset = fileDataBase.GetBitFile().AddData(fileData, cookedFileSize);
-		delete[] fileData;
-		FileSystem::s_fileSystem->Delete(exportPath);
+		dataOffset = fileDataBase.GetBitFile().AddData(task.cookedData);
 	}
 
 	// Add the meta file to the binary file
-	size_t metaDataOffset = 0;
-	const std::shared_ptr<File> cookedMetaFile = FileSystem::MakeFile(exportPath + ".meta");
-	size_t cookedMetaFileSizeOut;
-	bool cookedMetaOpen = cookedMetaFile->Open(FileMode::ReadOnly);
-	if (cookedMetaOpen)
-	{
-		unsigned char* metaFileData = cookedMetaFile->ReadAllBinary(cookedMetaFileSizeOut);
-		cookedMetaFile->Close();
-		metaDataOffset = fileDataBase.GetBitFile().AddData(metaFileData, cookedMetaFileSizeOut);
-		delete[] metaFileData;
-	}
-	else
-	{
-		Debug::PrintError("[Cooker::CookAsset] Failed to open meta file: " + exportPath + ".meta");
-		return;
-	}
-	FileSystem::s_fileSystem->Delete(exportPath + ".meta");
+	const size_t metaDataOffset = fileDataBase.GetBitFile().AddData(task.metaData);
 
 	FileDataBaseEntry* fileDataBaseEntry = new FileDataBaseEntry();
-	fileDataBaseEntry->p = partialFilePath; // Path
-	fileDataBaseEntry->id = fileInfo.file->GetUniqueId(); // Unique id
+	fileDataBaseEntry->p = task.partialFilePath; // Path
+	fileDataBaseEntry->id = task.fileInfo->file->GetUniqueId(); // Unique id
 	fileDataBaseEntry->po = dataOffset; // Position in the binary file in byte
-	fileDataBaseEntry->s = cookedFileSize; // Size in byte
+	fileDataBaseEntry->s = task.cookedFileSize; // Size in byte
 	fileDataBaseEntry->mpo = metaDataOffset; // Meta position in the binary file in byte
-	fileDataBaseEntry->ms = metaSize; // Meta Size in byte
-	fileDataBaseEntry->t = fileInfo.type; // Type
+	fileDataBaseEntry->ms = task.metaData.size(); // Meta Size in byte
+	fileDataBaseEntry->t = task.fileInfo->type; // Type
+	fileDataBaseEntry->h = task.cookHash; // Hash of the cooking inputs
 
 	fileDataBase.AddFile(fileDataBaseEntry);
-}
\ No newline at end of file
+}
+
+bool Cooker::ReadFile(const std::string& path, std::vector<uint8_t>& data)
+{
+	std::ifstream file = std::ifstream(path, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+	if (!file.is_open())
+		return false;
+
+	const std::streamsize fileSize = file.tellg();
+	file.seekg(0, std::ios_base::beg);
+	data.resize(static_cast<size_t>(fileSize));
+	if (fileSize > 0 && !file.read(reinterpret_cast<char*>(data.data()), fileSize))
+		return false;
+
+	return true;
+}
+
+bool Cooker::WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+	std::ofstream file = std::ofstream(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!file.is_open())
+		return false;
+
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return file.good();
+}
+
+uint64_t Cooker::ComputeHash(const void* data, size_t size, uint64_t seed)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+bool Cooker::ReadCookCache(CookTask& task)
+{
+	std::vector<uint8_t> cacheData;
+	if (!ReadFile(task.cookCachePath, cacheData) || cacheData.size() < sizeof(uint64_t))
+		return false;
+
+	// The cache entry starts with the hash of the inputs used to cook it
+	uint64_t cachedHash = 0;
+	memcpy(&cachedHash, cacheData.data(), sizeof(uint64_t));
+	if (cachedHash != task.cookHash)
+		return false;
+
+	task.cookedData.assign(cacheData.begin() + sizeof(uint64_t), cacheData.end());
+	return true;
+}
+
+void Cooker::WriteCookCache(const CookTask& task)
+{
+	std::ofstream file = std::ofstream(task.cookCachePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!file.is_open())
+	{
+		Debug::PrintWarning("[Cooker::WriteCookCache] Failed to write cook cache: " + task.cookCachePath);
+		return;
+	}
+
+	file.write(reinterpret_cast<const char*>(&task.cookHash), sizeof(uint64_t));
+	file.write(reinterpret_cast<const char*>(task.cookedData.data()), task.cookedData.size());
+}
@@ -2,11 +2,14 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 #include <engine/platform.h>
 #include <engine/file_system/data_base/file_data_base.h>
 
 class FileReference;
+class MeshData;
 struct FileInfo;
 
 struct CookSettings 
@@ -14,6 +17,7 @@ struct CookSettings
 	AssetPlatform platform;
 	std::string exportPath;
 	bool exportShadersOnly = false;
+	bool useCookCache = true; // Reuse the cooked textures and meshes if their inputs did not change
 };
 
 class Cooker
@@ -21,7 +25,114 @@ class Cooker
 public:
 	static FileDataBase fileDataBase;
 
+	/**
+	* @brief Cook all assets used by the game on worker threads and write them in the same order in the binary file
+	*/
 	static void CookAssets(const CookSettings& settings);
-	static void CookAsset(const CookSettings& settings, const FileInfo& fileInfo, const std::string& exportFolderPath, const std::string& partialFilePath);
-};
 
+private:
+	/**
+	* @brief Increase this value when the cooked data format changes to invalidate the cook cache
+	*/
+	static constexpr uint64_t COOKER_VERSION = 1;
+
+	/**
+	* @brief Asset to cook, prepared on the main thread, cooked on a worker thread and written on the main thread
+	*/
+	struct CookTask
+	{
+		const FileInfo* fileInfo = nullptr;
+		std::string exportPath;
+		std::string partialFilePath;
+		int textureResolution = 0;
+		bool packInAtlas = false; // True if the texture is packed in an atlas page once all textures are cooked
+		std::vector<uint8_t> atlasPixels; // RGBA pixels of the cooked texture to copy in the atlas page
+		int textureWidth = 0;
+		int textureHeight = 0;
+		std::shared_ptr<MeshData> meshData;
+		bool loadMesh = false; // True if the mesh is loaded by the worker thread
+		bool isCookedOnMainThread = false; // Used for assets that can't be cooked in parallel (PS3 shaders)
+
+		std::vector<uint8_t> sourceData;
+		std::vector<uint8_t> cookedData; // Data to add in the binary file
+		std::vector<uint8_t> metaData;
+		uint64_t cookedFileSize = 0;
+		uint64_t cookHash = 0; // Hash of the source data, the meta data, the platform and the cooker version
+		std::string cookCachePath; // Empty if the asset is not cached
+		bool isInBinaryFile = true;
+		bool isFromCookCache = false;
+		bool success = false;
+		uint64_t cookTime = 0; // In microseconds
+	};
+
+	/**
+	* @brief Cook an asset, can be called from a worker thread
+	*/
+	static void CookAsset(const CookSettings& settings, CookTask& task);
+
+	static bool CookTexture(CookTask& task);
+
+	/**
+	* @brief Decode the cooked texture for the atlas packing, the texture is not packed if it is too big
+	*/
+	static void ReadAtlasPixels(const CookSettings& settings, CookTask& task);
+
+	/**
+	* @brief Pack the cooked textures in atlas pages, add the pages to the binary file and write the textures with their atlas area
+	* The textures stay in the binary file to be usable by the meshes and the UI
+	*/
+	static void CookTextureAtlases(const CookSettings& settings, const std::vector<CookTask*>& atlasTasks);
+
+	/**
+	* @brief Get the width and height of the atlas pages of a platform
+	*/
+	static int GetAtlasPageSize(AssetPlatform platform);
+
+	/**
+	* @brief Encode RGBA pixels in a png file in memory
+	*/
+	static bool EncodePng(std::vector<uint8_t>& pngData, int width, int height, const unsigned char* pixels);
+	static bool CookMesh(CookTask& task);
+
+	/**
+	* @brief Convert a json scene to the binary scene format
+	*/
+	static bool CookScene(CookTask& task);
+
+	/**
+	* @brief Cook a PS3 shader, has to be called from the main thread
+	*/
+	static bool CookShaderPS3(const CookSettings& settings, CookTask& task);
+
+	/**
+	* @brief Add the cooked asset in the binary file and in the file data base
+	*/
+	static void WriteCookedAsset(CookTask& task);
+
+	/**
+	* @brief Read a whole file in a buffer
+	*/
+	static bool ReadFile(const std::string& path, std::vector<uint8_t>& data);
+
+	/**
+	* @brief Write a buffer in a file, replace the file if it exists
+	*/
+	static bool WriteFile(const std::string& path, const std::vector<uint8_t>& data);
+
+	/**
+	* @brief Compute a 64 bits FNV-1a hash
+	* @param seed Hash of the previous data to combine several buffers
+	*/
+	static uint64_t ComputeHash(const void* data, size_t size, uint64_t seed);
+
+	/**
+	* @brief Fill the cooked data from the cook cache if the cache entry has the same hash
+	* @return True if the cached data has been used
+	*/
+	static bool ReadCookCache(CookTask& task);
+
+	/**
+	* @brief Save the cooked data in the cook cache with the hash of the inputs
+	*/
+	static void WriteCookCache(const CookTask& task);
+};
@@ -40,8 +40,13 @@ void ProfilerMenu::Draw()
 		ImGui::Text("FPS average: %0.2f, average frame time %0.2fms", fpsAVG, (1 / fpsAVG) * 1000);
 
 		ImGui::Text("DrawCalls Count: %d", Performance::GetDrawCallCount());
+		ImGui::Text("State changes Count: %d", Performance::GetStateChangeCount());
 		ImGui::Text("Triangles Count: %d", Performance::GetDrawTrianglesCount());
 		ImGui::Text("Materials update count: %d", Performance::GetUpdatedMaterialCount());
+		ImGui::Text("Render batch updated drawables: %d", Performance::GetRenderBatchUpdateCount());
+		ImGui::Text("Culled chunks: %d", Performance::GetCulledChunkCount());
+		ImGui::Text("Frustum tested meshes: %d, culled: %d", Performance::GetFrustumVisitedMeshCount(), Performance::GetFrustumCulledMeshCount());
+		ImGui::Text("Sprite batches: %d, sprites: %d", Performance::GetSpriteBatchCount(), Performance::GetBatchedSpriteCount());
 
 		DrawMemoryStats();
 
@@ -124,23 +129,23 @@ void ProfilerMenu::DrawMemoryStats()
 		const MemoryTracker* goMem = Performance::s_gameObjectMemoryTracker;
 
 		ImGui::Text("%s:", goMem->m_name.c_str());
-		ImGui::Text("Current allocation: %zu Bytes, Total: %zu Bytes", goMem->m_allocatedMemory - goMem->m_deallocatedMemory, goMem->m_allocatedMemory);
+		ImGui::Text("Current allocation: %zu Bytes, Total: %zu Bytes", goMem->m_allocatedMemory - goMem->m_deallocatedMemory, goMem->m_allocatedMemory.load());
 		ImGui::Text("Current allocation: %f MegaBytes, Total: %f MegaBytes,", (goMem->m_allocatedMemory - goMem->m_deallocatedMemory) / 1000000.0f, goMem->m_allocatedMemory / 1000000.0f);
-		ImGui::Text("Alloc count: %zu, Delete count: %zu", goMem->m_allocCount, goMem->m_deallocCount);
+		ImGui::Text("Alloc count: %zu, Delete count: %zu", goMem->m_allocCount.load(), goMem->m_deallocCount.load());
 
 		const MemoryTracker* meshDataMem = Performance::s_meshDataMemoryTracker;
 		ImGui::Separator();
 		ImGui::Text("%s:", meshDataMem->m_name.c_str());
-		ImGui::Text("Current allocation: %zu Bytes, Total: %zu Bytes", meshDataMem->m_allocatedMemory - meshDataMem->m_deallocatedMemory, meshDataMem->m_allocatedMemory);
+		ImGui::Text("Current allocation: %zu Bytes, Total: %zu Bytes", meshDataMem->m_allocatedMemory - meshDataMem->m_deallocatedMemory, meshDataMem->m_allocatedMemory.load());
 		ImGui::Text("Current allocation: %f MegaBytes, Total: %f MegaBytes,", (meshDataMem->m_allocatedMemory - meshDataMem->m_deallocatedMemory) / 1000000.0f, meshDataMem->m_allocatedMemory / 1000000.0f);
-		ImGui::Text("Alloc count: %zu, Delete count: %zu", meshDataMem->m_allocCount, meshDataMem->m_deallocCount);
+		ImGui::Text("Alloc count: %zu, Delete count: %zu", meshDataMem->m_allocCount.load(), meshDataMem->m_deallocCount.load());
 
 		const MemoryTracker* textureMem = Performance::s_textureMemoryTracker;
 		ImGui::Separator();
 		ImGui::Text("%s:", textureMem->m_name.c_str());
-		ImGui::Text("Current allocation: %zu Bytes, Total: %zu Bytes", textureMem->m_allocatedMemory - textureMem->m_deallocatedMemory, textureMem->m_allocatedMemory);
+		ImGui::Text("Current allocation: %zu Bytes, Total: %zu Bytes", textureMem->m_allocatedMemory - textureMem->m_deallocatedMemory, textureMem->m_allocatedMemory.load());
 		ImGui::Text("Current allocation: %f MegaBytes, Total: %f MegaBytes,", (textureMem->m_allocatedMemory - textureMem->m_deallocatedMemory) / 1000000.0f, textureMem->m_allocatedMemory / 1000000.0f);
-		ImGui::Text("Alloc count: %zu, Delete count: %zu", textureMem->m_allocCount, textureMem->m_deallocCount);
+		ImGui::Text("Alloc count: %zu, Delete count: %zu", textureMem->m_allocCount.load(), textureMem->m_deallocCount.load());
 #endif
 	}
 }
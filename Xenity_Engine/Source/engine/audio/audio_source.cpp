@@ -6,7 +6,6 @@
 
 #include "audio_source.h"
 
-#include <thread>
 #if defined(__PSP__)
 #include <pspkernel.h>
 #endif
@@ -22,6 +21,7 @@
 #include <engine/graphics/color/color.h>
 #include <engine/audio/audio_clip.h>
 #include <engine/debug/debug.h>
+#include <engine/job_system/job_system.h>
 #include "audio_manager.h"
 
 
@@ -93,9 +93,8 @@ void AudioSource::Play()
 		m_isPlaying = true;
 		const std::shared_ptr<AudioSource> sharedThis = GetThisShared();
 #if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
-		std::thread t(&AudioManager::PlayAudioSource, sharedThis);
-		t.detach();
-		//AudioManager::PlayAudioSource(GetThisShared());
+		// Opening the stream reads the file, do not block the main thread
+		JobSystem::Schedule([sharedThis]() { AudioManager::PlayAudioSource(sharedThis); }, JobPriority::High);
 #elif defined(__PSP__) || defined(__vita__) || defined(__PS3__)
 		AudioManager::PlayAudioSource(sharedThis);
 #endif
@@ -48,6 +48,10 @@ std::vector<ClassRegistry::MenuClassInfo> ClassRegistry::s_menuClassInfos;
 #include <engine/game_elements/rect_transform.h>
 #include <engine/audio/audio_source.h>
 #include <engine/test_component.h>
+#include <engine/tools/instancing_benchmark.h>
+#include <engine/tools/world_partitionner_benchmark.h>
+#include <engine/tools/raycast_benchmark.h>
+#include <engine/tools/particle_benchmark.h>
 #include <engine/physics/rigidbody.h>
 #include <engine/physics/box_collider.h>
 #include <engine/physics/sphere_collider.h>
@@ -154,6 +158,10 @@ void ClassRegistry::RegisterEngineComponents()
 	REGISTER_COMPONENT(Lod);
 #if defined(DEBUG)
 	REGISTER_COMPONENT(TestComponent);
+	REGISTER_COMPONENT(InstancingBenchmark);
+	REGISTER_COMPONENT(WorldPartitionnerBenchmark);
+	REGISTER_COMPONENT(RaycastBenchmark);
+	REGISTER_COMPONENT(ParticleBenchmark);
 #endif
 	REGISTER_INVISIBLE_COMPONENT(MissingScript);
 }
@@ -28,14 +28,27 @@ Component::Component(bool canBeDisabled)
 
 Component::~Component()
 {
+	if (m_updateListIndex != INVALID_UPDATE_LIST_INDEX || m_isUpdatePending)
+	{
+		GameplayManager::RemoveComponent(*this);
+	}
+	GameplayManager::RemoveComponentFromIdIndex(*this);
 }
 
 #pragma endregion
 
 void Component::SetUpdatePriority(int priority)
 {
+	if (m_updatePriority == priority)
+		return;
+
 	m_updatePriority = priority;
-	GameplayManager::componentsListDirty = true;
+	GameplayManager::OnComponentUpdatePriorityChanged(*this);
+}
+
+void Component::OnUniqueIdChanged(uint64_t oldId)
+{
+	GameplayManager::OnComponentIdChanged(*this, oldId);
 }
 
 void Component::SetGameObject(const std::shared_ptr<GameObject>& newGameObject)
@@ -46,7 +59,6 @@ void Component::SetGameObject(const std::shared_ptr<GameObject>& newGameObject)
 	bool firstUse = false;
 	if (m_gameObject.expired())
 	{
-		GameplayManager::componentsListDirty = true;
 		firstUse = true;
 	}
 
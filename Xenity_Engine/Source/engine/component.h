@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
 #include <engine/api.h>
 #include <engine/reflection/reflection.h>
 #include <engine/reflection/enum_utils.h>
@@ -61,6 +64,16 @@ public:
 	*/
 	virtual void OnEnabled() {};
 
+	/**
+	* @brief Called when the GameObject is taken from a GameObjectPool, used to reset the component's state
+	*/
+	virtual void OnAcquire() {};
+
+	/**
+	* @brief Called when the GameObject is given back to a GameObjectPool
+	*/
+	virtual void OnRelease() {};
+
 	/**
 	* @brief Called each frame to draw gizmos
 	*/
@@ -159,6 +172,8 @@ private:
 	*/
 	void SetGameObject(const std::shared_ptr<GameObject>& gameObject);
 
+	void OnUniqueIdChanged(uint64_t oldId) override;
+
 protected:
 	/**
 	* @brief [Internal] Remove references of this component for some specific cases
@@ -186,9 +201,28 @@ protected:
 	int m_updatePriority = 5000; //Lower is more priority
 
 private:
+	static constexpr size_t INVALID_UPDATE_LIST_INDEX = SIZE_MAX;
+
+	// Position of the component in the GameplayManager's update list
+	size_t m_updateListIndex = INVALID_UPDATE_LIST_INDEX;
+	int m_updateListPriority = 0; // Priority of the bucket containing the component (can differ from m_updatePriority until the list is updated)
+
 	bool m_initiated = false;
 	bool m_isAwakeCalled = false;
 	bool m_waitingForDestroy = false;
 	bool m_isEnabled = true;
 	bool m_canBeDisabled = true;
-};
\ No newline at end of file
+	bool m_hasUpdateFunction = true; // False if the class does not override Update(), set by GameObject::AddComponent
+	bool m_isUpdatePending = false; // True if the component has been added to the update list during the update loop
+};
+
+/**
+* @brief Check if a component class overrides Component::Update()
+* If the function is not accessible (declared as protected or private), the class is considered as overriding it
+*/
+template<typename T, typename = void>
+struct OverridesComponentUpdate : std::true_type {};
+
+template<typename T>
+struct OverridesComponentUpdate<T, std::void_t<decltype(&T::Update)>>
+	: std::bool_constant<!std::is_same<decltype(&T::Update), void (Component::*)()>::value> {};
\ No newline at end of file
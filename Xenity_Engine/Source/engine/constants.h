@@ -4,8 +4,9 @@
 // -------------------------------------------------- Features
 //
 //#define ENABLE_EXPERIMENTAL_FEATURES // Enable features that are not fully tested or implemented
-//#define ENABLE_OVERDRAW_OPTIMIZATION // Enable overdraw optimization (currently not great)
+//#define ENABLE_OVERDRAW_OPTIMIZATION // Sort opaque meshes by distance before sorting them by render state (less overdraw but more state changes)
 //#define ENABLE_SHADER_VARIANT_OPTIMIZATION // Enable shader variant optimization (currently effective only on PS3, WIP)
+//#define ENABLE_BENCHMARK_TESTS // Run the benchmark unit tests on start (slow, they print their timings in the console)
 
 #if defined(__PS3__)
 //#define ENABLE_OVERDRAW_OPTIMIZATION
@@ -65,6 +66,8 @@
 // -------------------------------------------------- Physics
 //
 #define DEFAULT_GRAVITY_Y -20
+#define DEFAULT_PHYSICS_FIXED_TIME_STEP (1 / 60.0f)
+#define DEFAULT_PHYSICS_MAX_SUB_STEPS 4
 
 //
 // -------------------------------------------------- Graphics
@@ -75,12 +78,24 @@
 #define MAX_LIGHT_COUNT 4
 #endif
 
+// Maximum number of sprites drawn by one draw call, a bigger batch is split
+#if defined(__vita__) || defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+#define SPRITE_BATCH_MAX_SPRITE_COUNT 2048
+#else
+#define SPRITE_BATCH_MAX_SPRITE_COUNT 256
+#endif
+
 //
 // -------------------------------------------------- World partitionner
 //
 #define WORLD_CHUNK_SIZE 10
 #define WORLD_CHUNK_HALF_SIZE (WORLD_CHUNK_SIZE / 2.0f)
 
+//
+// -------------------------------------------------- Asset streaming
+//
+#define ASYNC_FILE_LOADING_TIME_BUDGET 4000 // Microseconds spent per frame to finish the loaded files (GPU upload...)
+
 //
 // -------------------------------------------------- Profiling
 //
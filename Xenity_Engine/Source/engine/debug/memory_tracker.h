@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <atomic>
 
 class MemoryTracker
 {
@@ -12,9 +13,10 @@ public:
 
 	std::string m_name;
 
-	size_t m_allocatedMemory = 0;
-	size_t m_deallocatedMemory = 0;
-	size_t m_allocCount = 0;
-	size_t m_deallocCount = 0;
+	// Atomic, the assets are allocated by the job system workers
+	std::atomic<size_t> m_allocatedMemory = 0;
+	std::atomic<size_t> m_deallocatedMemory = 0;
+	std::atomic<size_t> m_allocCount = 0;
+	std::atomic<size_t> m_deallocCount = 0;
 };
 
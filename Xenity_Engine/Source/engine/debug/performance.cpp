@@ -20,6 +20,18 @@
 int Performance::s_drawCallCount = 0;
 int Performance::s_drawTriangleCount = 0;
 int Performance::s_updatedMaterialCount = 0;
+int Performance::s_renderBatchUpdateCount = 0;
+int Performance::s_lastRenderBatchUpdateCount = 0;
+int Performance::s_culledChunkCount = 0;
+int Performance::s_lastCulledChunkCount = 0;
+int Performance::s_frustumVisitedMeshCount = 0;
+int Performance::s_lastFrustumVisitedMeshCount = 0;
+int Performance::s_frustumCulledMeshCount = 0;
+int Performance::s_lastFrustumCulledMeshCount = 0;
+int Performance::s_spriteBatchCount = 0;
+int Performance::s_lastSpriteBatchCount = 0;
+int Performance::s_batchedSpriteCount = 0;
+int Performance::s_lastBatchedSpriteCount = 0;
 uint32_t Performance::s_currentProfilerFrame = 0;
 uint32_t Performance::s_currentFrame = 0;
 bool Performance::s_isPaused = false;
@@ -31,6 +43,8 @@ int Performance::s_tickCount = 0;
 float Performance::s_averageCoolDown = 0;
 int Performance::s_lastDrawCallCount = 0;
 int Performance::s_lastDrawTriangleCount = 0;
+int Performance::s_stateChangeCount = 0;
+int Performance::s_lastStateChangeCount = 0;
 
 MemoryTracker* Performance::s_gameObjectMemoryTracker = nullptr;
 MemoryTracker* Performance::s_meshDataMemoryTracker = nullptr;
@@ -58,6 +72,20 @@ void Performance::ResetCounters()
 	s_drawCallCount = 0;
 	s_lastDrawTriangleCount = s_drawTriangleCount;
 	s_drawTriangleCount = 0;
+	s_lastStateChangeCount = s_stateChangeCount;
+	s_stateChangeCount = 0;
+	s_lastRenderBatchUpdateCount = s_renderBatchUpdateCount;
+	s_renderBatchUpdateCount = 0;
+	s_lastCulledChunkCount = s_culledChunkCount;
+	s_culledChunkCount = 0;
+	s_lastFrustumVisitedMeshCount = s_frustumVisitedMeshCount;
+	s_frustumVisitedMeshCount = 0;
+	s_lastFrustumCulledMeshCount = s_frustumCulledMeshCount;
+	s_frustumCulledMeshCount = 0;
+	s_lastSpriteBatchCount = s_spriteBatchCount;
+	s_spriteBatchCount = 0;
+	s_lastBatchedSpriteCount = s_batchedSpriteCount;
+	s_batchedSpriteCount = 0;
 
 	s_updatedMaterialCount = 0;
 	ResetProfiler();
@@ -81,6 +109,33 @@ void Performance::AddMaterialUpdate()
 	s_updatedMaterialCount++;
 }
 
+void Performance::AddStateChange()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	s_stateChangeCount++;
+}
+
+void Performance::AddRenderBatchUpdates(int count)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	s_renderBatchUpdateCount += count;
+}
+
+void Performance::AddFrustumCullingResults(int culledChunkCount, int visitedMeshCount, int culledMeshCount)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	s_culledChunkCount += culledChunkCount;
+	s_frustumVisitedMeshCount += visitedMeshCount;
+	s_frustumCulledMeshCount += culledMeshCount;
+}
+
+void Performance::AddSpriteBatch(int spriteCount)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	s_spriteBatchCount++;
+	s_batchedSpriteCount += spriteCount;
+}
+
 #pragma endregion
 
 #pragma region Getters
@@ -91,12 +146,54 @@ int Performance::GetDrawCallCount()
 	return s_lastDrawCallCount;
 }
 
+int Performance::GetStateChangeCount()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	return s_lastStateChangeCount;
+}
+
 int Performance::GetDrawTrianglesCount()
 {
 	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
 	return s_lastDrawTriangleCount;
 }
 
+int Performance::GetRenderBatchUpdateCount()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	return s_lastRenderBatchUpdateCount;
+}
+
+int Performance::GetCulledChunkCount()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	return s_lastCulledChunkCount;
+}
+
+int Performance::GetFrustumVisitedMeshCount()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	return s_lastFrustumVisitedMeshCount;
+}
+
+int Performance::GetFrustumCulledMeshCount()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	return s_lastFrustumCulledMeshCount;
+}
+
+int Performance::GetSpriteBatchCount()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	return s_lastSpriteBatchCount;
+}
+
+int Performance::GetBatchedSpriteCount()
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+	return s_lastBatchedSpriteCount;
+}
+
 int Performance::GetUpdatedMaterialCount()
 {
 	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
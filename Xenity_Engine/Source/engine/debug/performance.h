@@ -123,16 +123,76 @@ public:
 	*/
 	static void AddMaterialUpdate();
 
+	/**
+	* @brief Add one to the render state change counter (shader program, material uniforms or texture change)
+	*/
+	static void AddStateChange();
+
+	/**
+	* @brief Add a number of drawables whose render commands have been (re)created
+	* @param count Number of drawables
+	*/
+	static void AddRenderBatchUpdates(int count);
+
+	/**
+	* @brief Add the results of a frustum culling pass
+	* @param culledChunkCount Number of world chunks outside of the frustum
+	* @param visitedMeshCount Number of meshes tested in the visible chunks
+	* @param culledMeshCount Number of tested meshes outside of the frustum
+	*/
+	static void AddFrustumCullingResults(int culledChunkCount, int visitedMeshCount, int culledMeshCount);
+
+	/**
+	* @brief Add a sprite batch (one draw call for several sprites)
+	* @param spriteCount Number of sprites in the batch
+	*/
+	static void AddSpriteBatch(int spriteCount);
+
 	/**
 	* @brief Get draw call count
 	*/
 	static int GetDrawCallCount();
 
+	/**
+	* @brief Get render state change count
+	*/
+	static int GetStateChangeCount();
+
 	/**
 	* @brief Get draw triangle count
 	*/
 	static int GetDrawTrianglesCount();
 
+	/**
+	* @brief Get the number of drawables whose render commands have been (re)created during the last frame
+	*/
+	static int GetRenderBatchUpdateCount();
+
+	/**
+	* @brief Get the number of world chunks outside of the frustum during the last frame
+	*/
+	static int GetCulledChunkCount();
+
+	/**
+	* @brief Get the number of meshes tested against the frustum during the last frame
+	*/
+	static int GetFrustumVisitedMeshCount();
+
+	/**
+	* @brief Get the number of tested meshes outside of the frustum during the last frame
+	*/
+	static int GetFrustumCulledMeshCount();
+
+	/**
+	* @brief Get the number of sprite batches drawn during the last frame
+	*/
+	static int GetSpriteBatchCount();
+
+	/**
+	* @brief Get the number of sprites drawn in batches during the last frame
+	*/
+	static int GetBatchedSpriteCount();
+
 	/**
 	* @brief Get updated material count
 	*/
@@ -174,7 +234,21 @@ private:
 	static int s_drawTriangleCount;
 	static int s_lastDrawCallCount;
 	static int s_lastDrawTriangleCount;
+	static int s_stateChangeCount;
+	static int s_lastStateChangeCount;
 	static int s_updatedMaterialCount;
+	static int s_renderBatchUpdateCount;
+	static int s_lastRenderBatchUpdateCount;
+	static int s_culledChunkCount;
+	static int s_lastCulledChunkCount;
+	static int s_frustumVisitedMeshCount;
+	static int s_lastFrustumVisitedMeshCount;
+	static int s_frustumCulledMeshCount;
+	static int s_lastFrustumCulledMeshCount;
+	static int s_spriteBatchCount;
+	static int s_lastSpriteBatchCount;
+	static int s_batchedSpriteCount;
+	static int s_lastBatchedSpriteCount;
 
 	static int s_tickCount;
 	static float s_averageCoolDown;
@@ -53,6 +53,7 @@
 
 // Gameplay
 #include <engine/game_elements/gameplay_manager.h>
+#include <engine/game_elements/transform.h>
 
 // Game core
 #include "game_interface.h"
@@ -85,7 +86,9 @@
 
 // Physics
 #include <engine/physics/physics_manager.h>
+#include <engine/particle_system/particle_manager.h>
 
+#include <engine/job_system/job_system.h>
 #include <engine/file_system/async_file_loading.h>
 #include <engine/debug/crash_handler.h>
 #include <engine/tools/scope_benchmark.h>
@@ -146,6 +149,7 @@ int Engine::Init()
 
 	MemoryInfo::Init();
 	CrashHandler::Init();
+	JobSystem::Init();
 
 #if defined(DEBUG)
 #if defined(EDITOR)
@@ -347,9 +351,11 @@ void Engine::Loop()
 #endif
 
 			s_canUpdateAudio = false;
-#if defined(EDITOR)
-			AsyncFileLoading::FinishThreadedFileLoading();
+			// Finish the async loadings (GPU upload...)
+			JobSystem::ExecuteMainThreadContinuations();
+			AsyncFileLoading::Update();
 
+#if defined(EDITOR)
 			Editor::Update();
 
 			// Block game input if no game menu is focused
@@ -396,10 +402,19 @@ void Engine::Loop()
 				GameplayManager::UpdateComponents();
 #endif
 
+				// Simulate the particles after the components, a component can play or stop a particle system
+				if (GameplayManager::GetGameState() == GameState::Playing)
+				{
+					ParticleManager::Update();
+				}
+
 				// Remove all destroyed gameobjects and components
 				GameplayManager::RemoveDestroyedGameObjects();
 				GameplayManager::RemoveDestroyedComponents();
 
+				// Compute the world values of the transforms moved during the frame
+				Transform::UpdateDirtyTransforms();
+
 				s_canUpdateAudio = true;
 
 				// Draw
@@ -447,6 +462,9 @@ void Engine::Stop()
 
 	s_isInitialized = false;
 
+	// Finish the jobs before unloading the files used by them
+	JobSystem::Stop();
+
 	SceneManager::ClearScene();
 	AssetManager::RemoveUnusedFiles();
 	s_game.reset();
@@ -8,42 +8,109 @@
 
 #include <engine/file_system/file_reference.h>
 #include <engine/graphics/graphics.h>
+#include <engine/tools/benchmark.h>
+#include <engine/constants.h>
 #include <engine/assertions/assertions.h>
+#include <engine/debug/stack_debug_object.h>
 
-std::vector<std::shared_ptr<FileReference>> AsyncFileLoading::s_threadLoadedFiles;
-#if !defined(__PS3__)
-std::mutex AsyncFileLoading::s_threadLoadingMutex;
-#endif
-void AsyncFileLoading::FinishThreadedFileLoading()
+std::unordered_map<const FileReference*, AsyncFileLoading::LoadingFile> AsyncFileLoading::s_loadingFiles;
+std::deque<std::pair<const FileReference*, uint64_t>> AsyncFileLoading::s_decodedFiles;
+uint64_t AsyncFileLoading::s_nextLoadId = 0;
+size_t AsyncFileLoading::s_startedFileCount = 0;
+size_t AsyncFileLoading::s_finishedFileCount = 0;
+
+void AsyncFileLoading::LoadFile(const std::shared_ptr<FileReference>& file, std::function<void()> loadFunction)
 {
-#if !defined(__PS3__)
-	s_threadLoadingMutex.lock();
-#endif
-	size_t threadFileCount = s_threadLoadedFiles.size();
-	for (size_t i = 0; i < threadFileCount; i++)
-	{
-		if (s_threadLoadedFiles[i]->GetFileStatus() != FileStatus::FileStatus_Loading)
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	XASSERT(file != nullptr, "[AsyncFileLoading::LoadFile] file is nullptr");
+	XASSERT(loadFunction != nullptr, "[AsyncFileLoading::LoadFile] loadFunction is nullptr");
+	XASSERT(s_loadingFiles.find(file.get()) == s_loadingFiles.end(), "[AsyncFileLoading::LoadFile] The file is already loading");
+
+	const FileReference* fileKey = file.get();
+	const uint64_t loadId = s_nextLoadId++;
+
+	LoadingFile& loadingFile = s_loadingFiles[fileKey];
+	loadingFile.file = file;
+	loadingFile.loadId = loadId;
+	s_startedFileCount++;
+
+	// The GPU upload is not done in the continuation to spread it over several frames
+	loadingFile.jobHandle = JobSystem::Schedule(std::move(loadFunction), [fileKey, loadId]()
 		{
-			s_threadLoadedFiles[i]->OnLoadFileReferenceFinished();
-			s_threadLoadedFiles.erase(s_threadLoadedFiles.begin() + i);
-			Graphics::s_isRenderingBatchDirty = true; // Move this in a better location ???
-			threadFileCount--;
-			i--;
-		}
+			s_decodedFiles.emplace_back(fileKey, loadId);
+		}, JobPriority::Low);
+}
+
+void AsyncFileLoading::WaitForFile(const FileReference& file)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	auto it = s_loadingFiles.find(&file);
+	if (it == s_loadingFiles.end())
+		return;
+
+	JobSystem::Wait(it->second.jobHandle);
+
+	// The entry in s_decodedFiles will be ignored
+	const std::shared_ptr<FileReference> fileShared = std::move(it->second.file);
+	s_loadingFiles.erase(it);
+	FinishFileLoading(fileShared);
+}
+
+void AsyncFileLoading::Update()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (s_decodedFiles.empty())
+		return;
+
+	// At least one file is finished per frame, even if it takes longer than the budget
+	Benchmark uploadBenchmark;
+	uploadBenchmark.Start();
+	while (!s_decodedFiles.empty())
+	{
+		const std::pair<const FileReference*, uint64_t> decodedFile = s_decodedFiles.front();
+		s_decodedFiles.pop_front();
+
+		auto it = s_loadingFiles.find(decodedFile.first);
+		if (it == s_loadingFiles.end() || it->second.loadId != decodedFile.second)
+			continue;
+
+		const std::shared_ptr<FileReference> fileShared = std::move(it->second.file);
+		s_loadingFiles.erase(it);
+		FinishFileLoading(fileShared);
+
+		uploadBenchmark.Stop();
+		if (uploadBenchmark.GetMicroSeconds() >= ASYNC_FILE_LOADING_TIME_BUDGET)
+			break;
 	}
-#if !defined(__PS3__)
-	s_threadLoadingMutex.unlock();
-#endif
 }
 
-void AsyncFileLoading::AddFile(const std::shared_ptr<FileReference>& file)
+void AsyncFileLoading::ResetProgress()
+{
+	s_startedFileCount = s_loadingFiles.size();
+	s_finishedFileCount = 0;
+}
+
+float AsyncFileLoading::GetProgress()
 {
-	XASSERT(file != nullptr, "[AsyncFileLoading::AddFile] file is nullptr");
-#if !defined(__PS3__)
-	s_threadLoadingMutex.lock();
-#endif
-	s_threadLoadedFiles.push_back(file);
-#if !defined(__PS3__)
-	s_threadLoadingMutex.unlock();
-#endif
+	if (s_startedFileCount == 0)
+		return 1;
+
+	return static_cast<float>(s_finishedFileCount) / static_cast<float>(s_startedFileCount);
+}
+
+void AsyncFileLoading::FinishFileLoading(const std::shared_ptr<FileReference>& file)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	s_finishedFileCount++;
+	file->OnLoadFileReferenceFinished();
+	// The mesh renderers using a loaded mesh set themselves as dirty (OnMeshDataLoaded)
+	// The rendering mode of a material can change the render queue of all the drawables using it
+	if (file->GetFileType() == FileType::File_Material)
+	{
+		Graphics::s_isRenderingBatchDirty = true;
+	}
 }
@@ -10,34 +10,76 @@
  * [Internal]
  */
 
-#include <mutex>
 #include <memory>
-#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <deque>
+#include <cstdint>
+
+#include <engine/job_system/job_system.h>
 
 class FileReference;
 
 /**
 * @brief Class used to manage async file loading
+* The files are decoded by the job system workers, then finished on the main thread (GPU upload...) with a time budget per frame
 */
 class AsyncFileLoading
 {
 public:
+	/**
+	* @brief Load a file with a job, OnLoadFileReferenceFinished() is called later on the main thread
+	* @param file File to load
+	* @param loadFunction Function loading the file data, called from a worker thread
+	*/
+	static void LoadFile(const std::shared_ptr<FileReference>& file, std::function<void()> loadFunction);
 
 	/**
-	* @brief Finish file loading when files are loaded with a thread
+	* @brief Wait for the loading of a file and finish it now, does nothing if the file is not loading
+	* Used when the file data is needed immediately
 	*/
-	static void FinishThreadedFileLoading();
+	static void WaitForFile(const FileReference& file);
 
 	/**
-	* @brief Add a file loading with a thread
-	* @param file File to load
+	* @brief Finish the decoded files until the time budget of the frame is spent, called once per frame by the engine
 	*/
-	static void AddFile(const std::shared_ptr<FileReference>& file);
+	static void Update();
+
+	/**
+	* @brief Restart the progress count, the files still loading are kept in the count
+	*/
+	static void ResetProgress();
+
+	/**
+	* @brief Get the progress of the loadings started since the last ResetProgress call, between 0 and 1
+	*/
+	static float GetProgress();
+
+	/**
+	* @brief Get if files are still loading
+	*/
+	static inline bool IsLoading()
+	{
+		return !s_loadingFiles.empty();
+	}
 
 private:
-	static std::vector<std::shared_ptr<FileReference>> s_threadLoadedFiles;
-#if !defined(__PS3__)
-	static std::mutex s_threadLoadingMutex;
-#endif
-};
+	struct LoadingFile
+	{
+		std::shared_ptr<FileReference> file;
+		JobHandle jobHandle;
+		uint64_t loadId = 0; // Used to ignore the continuation of a load finished by WaitForFile
+	};
 
+	/**
+	* @brief Finish the loading of a file on the main thread (GPU upload...)
+	*/
+	static void FinishFileLoading(const std::shared_ptr<FileReference>& file);
+
+	// All accessed from the main thread only
+	static std::unordered_map<const FileReference*, LoadingFile> s_loadingFiles;
+	static std::deque<std::pair<const FileReference*, uint64_t>> s_decodedFiles;
+	static uint64_t s_nextLoadId;
+	static size_t s_startedFileCount;
+	static size_t s_finishedFileCount;
+};
@@ -5,27 +5,75 @@
 #include <engine/assertions/assertions.h>
 #include <engine/debug/stack_debug_object.h>
 
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#elif defined(__LINUX__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+BitFile::~BitFile()
+{
+	UnmapFile();
+}
+
 void BitFile::Create(const std::string& path)
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
+	if (m_isWriting)
+	{
+		Finalize();
+	}
+
+	UnmapFile();
 	FileSystem::s_fileSystem->Delete(path);
 	m_file = FileSystem::MakeFile(path);
 	const bool openResult = m_file->Open(FileMode::WriteCreateFile);
 	XASSERT(openResult, "[BitFile::Create] Failed to create bit file" + path);
 
-	if (openResult) 
-	{
-		m_file->Close();
-	}
-
+	// The file stays open, the data is written by big blocks
+	m_isWriting = openResult;
+	m_writeBuffer.clear();
+	m_writeBuffer.reserve(WRITE_BUFFER_SIZE);
 	m_fileSize = 0;
 }
 
+void BitFile::Finalize()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (!m_isWriting)
+		return;
+
+	FlushWriteBuffer();
+	m_file->Close();
+	m_isWriting = false;
+
+	// Release the buffer memory
+	std::vector<uint8_t>().swap(m_writeBuffer);
+
+	SyncFileToDisk(m_file->GetPath());
+}
+
 void BitFile::Open(const std::string& path)
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
+	UnmapFile();
+
+	// The mapped file is read without the File class
+	if (m_isMemoryMappingEnabled && MapFile(path))
+	{
+		m_file.reset();
+		return;
+	}
+
 	m_file = FileSystem::MakeFile(path);
 	const bool openResult = m_file->Open(FileMode::ReadOnly);
 	XASSERT(openResult, "[BitFile::Open] Failed to open bit file" + path);
@@ -33,28 +81,29 @@ void BitFile::Open(const std::string& path)
 
 size_t BitFile::AddData(const std::vector<uint8_t>& data)
 {
-	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
-
-	const size_t dataSize = data.size();
-	const bool openResult = m_file->Open(FileMode::WriteOnly);
-	XASSERT(openResult, "[BitFile::AddData] Failed to open bit file");
-	m_file->Write(reinterpret_cast<const unsigned char*>(data.data()), dataSize);
-	m_file->Close();
-
-	const size_t dataOffset = m_fileSize;
-	m_fileSize += dataSize;
-
-	return dataOffset;
+	return AddData(data.data(), data.size());
 }
 
 size_t BitFile::AddData(const unsigned char* data, size_t size)
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
-	const bool openResult = m_file->Open(FileMode::WriteOnly);
-	XASSERT(openResult, "[BitFile::AddData] Failed to open bit file");
-	m_file->Write(data, size);
-	m_file->Close();
+	XASSERT(m_isWriting, "[BitFile::AddData] The bit file is not open for writing");
+
+	if (m_writeBuffer.size() + size > WRITE_BUFFER_SIZE)
+	{
+		FlushWriteBuffer();
+	}
+
+	// Too big for the buffer, write it directly
+	if (size > WRITE_BUFFER_SIZE)
+	{
+		m_file->Write(data, size);
+	}
+	else
+	{
+		m_writeBuffer.insert(m_writeBuffer.end(), data, data + size);
+	}
 
 	const size_t dataOffset = m_fileSize;
 	m_fileSize += size;
@@ -62,10 +111,149 @@ size_t BitFile::AddData(const unsigned char* data, size_t size)
 	return dataOffset;
 }
 
+void BitFile::FlushWriteBuffer()
+{
+	if (m_writeBuffer.empty())
+		return;
+
+	m_file->Write(m_writeBuffer.data(), m_writeBuffer.size());
+	m_writeBuffer.clear();
+}
+
+void BitFile::SyncFileToDisk(const std::string& path)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		FlushFileBuffers(fileHandle);
+		CloseHandle(fileHandle);
+	}
+#elif defined(__LINUX__)
+	const int fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor >= 0)
+	{
+		fsync(fileDescriptor);
+		close(fileDescriptor);
+	}
+#else
+	(void)path;
+#endif
+}
+
 unsigned char* BitFile::ReadBinary(size_t offset, size_t size)
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
+	if (m_mappedData)
+	{
+		XASSERT(offset + size <= m_mappedSize, "[BitFile::ReadBinary] Out of bounds read");
+
+		unsigned char* data = static_cast<unsigned char*>(malloc(size));
+		if (data)
+		{
+			memcpy(data, m_mappedData + offset, size);
+		}
+		return data;
+	}
+
+#if defined(BIT_FILE_USE_MEMORY_MAPPING)
+	std::lock_guard<std::mutex> lock(m_readMutex);
+#endif
 	unsigned char* data = m_file->ReadBinary(offset, size);
 	return data;
 }
+
+const unsigned char* BitFile::GetReadOnlyView(size_t offset, size_t size) const
+{
+	if (!m_mappedData)
+		return nullptr;
+
+	XASSERT(offset + size <= m_mappedSize, "[BitFile::GetReadOnlyView] Out of bounds view");
+	if (offset + size > m_mappedSize)
+		return nullptr;
+
+	return m_mappedData + offset;
+}
+
+bool BitFile::MapFile(const std::string& path)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	const void* mappedData = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (!mappedData)
+	{
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	m_mappedData = static_cast<const unsigned char*>(mappedData);
+	m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+#elif defined(__LINUX__)
+	const int fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	void* mappedData = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	// The mapping stays valid after closing the file descriptor
+	close(fileDescriptor);
+	if (mappedData == MAP_FAILED)
+		return false;
+
+	m_mappedData = static_cast<const unsigned char*>(mappedData);
+	m_mappedSize = static_cast<size_t>(fileStat.st_size);
+	return true;
+#else
+	(void)path;
+	return false;
+#endif
+}
+
+void BitFile::UnmapFile()
+{
+	if (!m_mappedData)
+		return;
+
+#if defined(_WIN32) || defined(_WIN64)
+	UnmapViewOfFile(m_mappedData);
+	CloseHandle(m_mappingHandle);
+	CloseHandle(m_fileHandle);
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+#elif defined(__LINUX__)
+	munmap(const_cast<unsigned char*>(m_mappedData), m_mappedSize);
+#endif
+
+	m_mappedData = nullptr;
+	m_mappedSize = 0;
+}
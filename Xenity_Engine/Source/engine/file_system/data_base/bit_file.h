@@ -7,6 +7,11 @@
 
 class File;
 
+#if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+#define BIT_FILE_USE_MEMORY_MAPPING
+#include <mutex>
+#endif
+
 // Class that hold game's binary data
 class BitFile
 {
@@ -14,34 +19,104 @@ public:
 	BitFile() = default;
 	BitFile(const BitFile& other) = delete;
 	BitFile& operator=(const BitFile&) = delete;
+	~BitFile();
 
 	/**
-	* Create the file at the given path
+	* Create the file at the given path and keep it open for writing until Finalize is called
 	*/
 	void Create(const std::string& path);
 
 	/**
-	* Open the file at the given path
+	* Write the buffered data, close the file and flush it to the disk
+	*/
+	void Finalize();
+
+	/**
+	* Open the file at the given path, the file is memory mapped if the memory mapping is enabled and supported
 	*/
 	void Open(const std::string& path);
 
 	/**
-	* Add binary data at the end of the file
+	* Enable or disable the memory mapping for the next Open call (enabled by default on desktop)
+	*/
+	void SetMemoryMappingEnabled(bool enabled)
+	{
+		m_isMemoryMappingEnabled = enabled;
+	}
+
+	/**
+	* Get if the file is currently memory mapped
+	*/
+	bool IsMemoryMapped() const
+	{
+		return m_mappedData != nullptr;
+	}
+
+	/**
+	* Add binary data at the end of the file (buffered, written on Finalize or when the buffer is full)
+	* @return Offset of the data in the file
 	*/
 	size_t AddData(const std::vector<uint8_t>& data);
 
 	/**
-	* Add binary data at the end of the file
+	* Add binary data at the end of the file (buffered, written on Finalize or when the buffer is full)
+	* @return Offset of the data in the file
 	*/
 	size_t AddData(const unsigned char* data, size_t size);
 
 	/**
-	* Read binary data
+	* Read binary data, the returned buffer has to be freed by the caller
+	* Thread safe, assets are read by the job system workers
 	*/
 	unsigned char* ReadBinary(size_t offset, size_t size);
 
+	/**
+	* Get a read-only view of binary data without copy, valid until the file is closed
+	* @return nullptr if the file is not memory mapped
+	*/
+	const unsigned char* GetReadOnlyView(size_t offset, size_t size) const;
+
 private:
+	/**
+	* Map the whole file in memory
+	* @return True if the file is mapped
+	*/
+	bool MapFile(const std::string& path);
+
+	/**
+	* Unmap the file if it is mapped
+	*/
+	void UnmapFile();
+
+	/**
+	* Write the content of the write buffer in the file
+	*/
+	void FlushWriteBuffer();
+
+	/**
+	* Ask the OS to write the file to the disk
+	*/
+	static void SyncFileToDisk(const std::string& path);
+
+	static constexpr size_t WRITE_BUFFER_SIZE = 8 * 1024 * 1024;
+
 	std::shared_ptr<File> m_file;
 	size_t m_fileSize = 0;
+
+	std::vector<uint8_t> m_writeBuffer;
+	bool m_isWriting = false;
+
+	const unsigned char* m_mappedData = nullptr;
+	size_t m_mappedSize = 0;
+#if defined(_WIN32) || defined(_WIN64)
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+#endif
+#if defined(BIT_FILE_USE_MEMORY_MAPPING)
+	std::mutex m_readMutex; // The seek and the read of a not mapped file have to be done together
+	bool m_isMemoryMappingEnabled = true;
+#else
+	bool m_isMemoryMappingEnabled = false;
+#endif
 };
 
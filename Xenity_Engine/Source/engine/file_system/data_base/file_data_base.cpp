@@ -17,6 +17,7 @@ ReflectiveData FileDataBaseEntry::GetReflectiveData()
 	Reflective::AddVariable(reflectedVariables, mpo, "mpo", true);
 	Reflective::AddVariable(reflectedVariables, ms, "ms", true);
 	Reflective::AddVariable(reflectedVariables, t, "t", true);
+	Reflective::AddVariable(reflectedVariables, h, "h", true);
 	return reflectedVariables;
 }
 
@@ -21,6 +21,7 @@ public:
 	uint64_t mpo = 0; // Meta position in the binary file in byte
 	uint64_t ms = 0; // Meta Size in byte
 	FileType t = FileType::File_Other; // Type
+	uint64_t h = 0; // Hash of the cooking inputs (source content, meta settings, platform, cooker version)
 
 private:
 	ReflectiveData GetReflectiveData() override;
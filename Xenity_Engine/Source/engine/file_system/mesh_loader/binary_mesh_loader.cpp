@@ -32,6 +32,17 @@ bool BinaryMeshLoader::LoadMesh(MeshData& mesh)
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
+	// Not profiled, called by the job system workers and the profiler is not thread safe
+
+#if !defined(__PS3__) && !defined(__PSP__)
+	// If the bit file is memory mapped, the sub meshes use the mapped data directly (no read, no copy)
+	const unsigned char* mappedData = ProjectManager::fileDataBase.GetBitFile().GetReadOnlyView(mesh.m_filePosition, mesh.m_fileSize);
+	if (mappedData)
+	{
+		return LoadMeshFromView(mesh, mappedData);
+	}
+#endif
+
 	unsigned char* fileData = ProjectManager::fileDataBase.GetBitFile().ReadBinary(mesh.m_filePosition, mesh.m_fileSize);
 	unsigned char* fileDataOriginalPtr = fileData;
 
@@ -170,7 +181,50 @@ bool BinaryMeshLoader::LoadMesh(MeshData& mesh)
 	sceKernelDcacheWritebackInvalidateAll(); // Very important
 #endif // defined(__PSP__)
 
-	delete[] fileDataOriginalPtr;
+	free(fileDataOriginalPtr);
+
+	return true;
+}
+
+bool BinaryMeshLoader::LoadMeshFromView(MeshData& mesh, const unsigned char* fileData)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	VertexElements vertexDescriptor;
+	uint32_t subMeshCount = 0;
+	memcpy(&vertexDescriptor, fileData, sizeof(VertexElements));
+	fileData += sizeof(VertexElements);
+	memcpy(&subMeshCount, fileData, sizeof(uint32_t));
+	fileData += sizeof(uint32_t);
+
+	mesh.m_hasIndices = true;
+	mesh.m_hasColor = false;
+
+	mesh.SetVertexDescriptor(vertexDescriptor);
+
+	for (uint32_t i = 0; i < subMeshCount; i++)
+	{
+		uint32_t vertice_count = 0;
+		uint32_t index_count = 0;
+		uint32_t vertexMemSize = 0;
+		uint32_t indexMemSize = 0;
+
+		memcpy(&vertice_count, fileData, sizeof(uint32_t));
+		fileData += sizeof(uint32_t);
+		memcpy(&index_count, fileData, sizeof(uint32_t));
+		fileData += sizeof(uint32_t);
+		memcpy(&vertexMemSize, fileData, sizeof(uint32_t));
+		fileData += sizeof(uint32_t);
+		memcpy(&indexMemSize, fileData, sizeof(uint32_t));
+		fileData += sizeof(uint32_t);
+
+		const unsigned char* vertexData = fileData;
+		fileData += vertexMemSize;
+		const unsigned char* indexData = fileData;
+		fileData += indexMemSize;
+
+		mesh.AddExternalSubMesh(vertice_count, index_count, vertexData, vertexMemSize, indexData, indexMemSize);
+	}
 
 	return true;
 }
@@ -12,5 +12,11 @@ public:
 	* Load mesh data
 	*/
 	static bool LoadMesh(MeshData& mesh);
+
+private:
+	/**
+	* Create the sub meshes from a read-only view of the mesh file, the view has to stay valid while the mesh is loaded
+	*/
+	static bool LoadMeshFromView(MeshData& mesh, const unsigned char* fileData);
 };
 
@@ -50,23 +50,7 @@ std::shared_ptr<GameObject> CreateGameObjectEditor(const std::string& name)
 
 std::shared_ptr<Component> FindComponentById(const uint64_t id)
 {
-	for (int i = 0; i < GameplayManager::gameObjectCount; i++)
-	{
-		const std::shared_ptr<GameObject> gameobject = GameplayManager::gameObjects[i];
-
-		GameObjectAccessor gameobjectAcc = GameObjectAccessor(gameobject);
-		const std::vector<std::shared_ptr<Component>>& gameobjectComponents = gameobjectAcc.GetComponents();
-
-		const int componentCount = gameobject->GetComponentCount();
-		for (int compI = 0; compI < componentCount; compI++)
-		{
-			if (gameobjectComponents[compI]->GetUniqueId() == id)
-			{
-				return gameobjectComponents[compI];
-			}
-		}
-	}
-	return std::shared_ptr<Component>();
+	return GameplayManager::FindComponentById(id);
 }
 
 GameObject::GameObject() : m_name(DEFAULT_GAMEOBJECT_NAME)
@@ -99,10 +83,16 @@ ReflectiveData GameObject::GetReflectiveData()
 
 GameObject::~GameObject()
 {
+	GameplayManager::RemoveGameObjectFromIdIndex(*this);
+
 	for (int i = 0; i < m_componentCount; i++)
 	{
 		if (m_components[i])
+		{
+			GameplayManager::RemoveComponent(*m_components[i]);
+			GameplayManager::RemoveComponentFromIdIndex(*m_components[i]);
 			m_components[i]->RemoveReferences();
+		}
 	}
 	m_components.clear();
 
@@ -111,6 +101,11 @@ GameObject::~GameObject()
 #endif
 }
 
+void GameObject::OnUniqueIdChanged(uint64_t oldId)
+{
+	GameplayManager::OnGameObjectIdChanged(*this, oldId);
+}
+
 void GameObject::Setup()
 {
 	// Create the transform after the constructor because we can't use shared_from_this() in the constructor
@@ -134,6 +129,7 @@ void GameObject::RemoveComponent(const std::shared_ptr<Component>& component)
 		{
 			if (m_components[componentIndex] == component)
 			{
+				GameplayManager::RemoveComponentFromIdIndex(*component);
 				m_components.erase(m_components.begin() + componentIndex);
 				m_componentCount--;
 				break;
@@ -153,6 +149,10 @@ void GameObject::AddChild(const std::shared_ptr<GameObject>& newChild)
 			return;
 		}
 
+		// The world values have to be computed with the old parent before changing it
+		if (newChild->m_transform->m_isWorldDirty)
+			newChild->m_transform->ResolveWorldValues();
+
 		// Remove the new child from his old parent's children list
 		if (newChild->m_parent.lock())
 		{
@@ -202,6 +202,9 @@ void GameObject::SetParent(const std::shared_ptr<GameObject>& gameObject)
 		// If the new parent is the root
 		if (auto lockParent = m_parent.lock())
 		{
+			if (m_transform->m_isWorldDirty)
+				m_transform->ResolveWorldValues();
+
 			const int parentChildCount = lockParent->m_childCount;
 			for (int i = 0; i < parentChildCount; i++)
 			{
@@ -230,6 +233,10 @@ void GameObject::AddExistingComponent(const std::shared_ptr<Component>& componen
 	m_components.push_back(componentToAdd);
 	componentToAdd->SetGameObject(shared_from_this());
 	m_componentCount++;
+	if (!m_isEditorGameObject)
+	{
+		GameplayManager::AddComponent(componentToAdd);
+	}
 	if ((GameplayManager::GetGameState() == GameState::Playing || GameplayManager::GetGameState() == GameState::Paused) && IsLocalActive() && componentToAdd->IsEnabled())
 	{
 		componentToAdd->Awake();
@@ -279,16 +286,7 @@ std::shared_ptr<GameObject> FindGameObjectByName(const std::string& name)
 
 std::shared_ptr<GameObject> FindGameObjectById(const uint64_t id)
 {
-	const std::vector<std::shared_ptr<GameObject>>& gameObjects = GameplayManager::GetGameObjects();
-
-	const size_t gameObjectCount = gameObjects.size();
-
-	for (size_t i = 0; i < gameObjectCount; i++)
-	{
-		if (gameObjects[i]->GetUniqueId() == id)
-			return gameObjects[i];
-	}
-	return std::shared_ptr<GameObject>();
+	return GameplayManager::FindGameObjectById(id);
 }
 
 #pragma endregion
@@ -109,6 +109,8 @@ public:
 	AddComponent()
 	{
 		std::shared_ptr<Component> newC = std::make_shared<T>();
+		// Components without Update() function are not added to the update list
+		newC->m_hasUpdateFunction = OverridesComponentUpdate<T>::value;
 		AddExistingComponent(newC);
 		return std::shared_ptr<T>(std::dynamic_pointer_cast<T>(newC));
 	}
@@ -215,6 +217,8 @@ private:
 	friend class GameObjectAccessor;
 	friend class GameplayManager;
 	friend class SceneManager;
+	friend class BinaryScene;
+	friend class GameObjectPool;
 	friend class EditorUI;
 	friend class InspectorMenu;
 	friend class InspectorDeleteGameObjectCommand;
@@ -234,6 +238,7 @@ private:
 
 	ReflectiveData GetReflectiveData() override;
 	void OnReflectionUpdated() override;
+	void OnUniqueIdChanged(uint64_t oldId) override;
 
 	std::vector<std::shared_ptr<Component>> m_components;
 	std::vector<std::weak_ptr<GameObject>> m_children;
@@ -285,6 +290,8 @@ private:
 	bool m_isSelected = false;
 #endif
 	bool m_waitingForDestroy = false;
+	bool m_isEditorGameObject = false; // Editor GameObjects components are not updated by the GameplayManager
+	bool m_isInPool = false; // Released in a GameObjectPool, the components are not in the update list
 
 	bool m_active = true;
 	bool m_localActive = true;
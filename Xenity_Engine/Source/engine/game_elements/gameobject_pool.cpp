@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "gameobject_pool.h"
+
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/gameplay_manager.h>
+#include <engine/tools/gameplay_utility.h>
+#include <engine/component.h>
+#include <engine/debug/stack_debug_object.h>
+
+GameObjectPool::GameObjectPool(const std::shared_ptr<GameObject>& prefab, size_t prewarmCount) : m_prefab(prefab)
+{
+	XASSERT(prefab != nullptr, "[GameObjectPool::GameObjectPool] prefab is nullptr");
+
+	Prewarm(prewarmCount);
+}
+
+GameObjectPool::~GameObjectPool()
+{
+	Clear();
+}
+
+void GameObjectPool::Prewarm(size_t count)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	m_availableInstances.reserve(count);
+	while (m_availableInstances.size() < count)
+	{
+		if (!CreateInstance())
+			break;
+	}
+}
+
+std::shared_ptr<GameObject> GameObjectPool::Acquire()
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	while (!m_availableInstances.empty())
+	{
+		std::shared_ptr<GameObject> instance = std::move(m_availableInstances.back());
+		m_availableInstances.pop_back();
+		instance->m_isInPool = false;
+
+		// The instance may have been removed from the scene since its release
+		if (!IsInstanceInScene(*instance))
+			continue;
+
+		SetHierarchyUpdated(*instance, true);
+		instance->SetActive(true);
+		CallPoolEvent(*instance, true);
+		return instance;
+	}
+
+	// The pool is empty, create a new instance
+	const std::shared_ptr<GameObject> prefab = m_prefab.lock();
+	if (!prefab)
+		return nullptr;
+
+	std::shared_ptr<GameObject> instance = Instantiate(prefab);
+	instance->SetActive(true);
+	CallPoolEvent(*instance, true);
+	return instance;
+}
+
+void GameObjectPool::Release(const std::shared_ptr<GameObject>& gameObject)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	XASSERT(gameObject != nullptr, "[GameObjectPool::Release] gameObject is nullptr");
+	if (!gameObject)
+		return;
+
+	XASSERT(!gameObject->m_isInPool, "[GameObjectPool::Release] The GameObject is already released");
+	if (gameObject->m_isInPool || !IsInstanceInScene(*gameObject))
+		return;
+
+	CallPoolEvent(*gameObject, false);
+	gameObject->SetParent(nullptr);
+	gameObject->SetActive(false);
+	SetHierarchyUpdated(*gameObject, false);
+
+	gameObject->m_isInPool = true;
+	m_availableInstances.push_back(gameObject);
+}
+
+void GameObjectPool::Clear()
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	for (const std::shared_ptr<GameObject>& instance : m_availableInstances)
+	{
+		instance->m_isInPool = false;
+		if (IsInstanceInScene(*instance))
+			Destroy(instance);
+	}
+	m_availableInstances.clear();
+}
+
+bool GameObjectPool::CreateInstance()
+{
+	const std::shared_ptr<GameObject> prefab = m_prefab.lock();
+	if (!prefab)
+		return false;
+
+	const std::shared_ptr<GameObject> instance = Instantiate(prefab);
+	instance->SetActive(false);
+	SetHierarchyUpdated(*instance, false);
+	instance->m_isInPool = true;
+	m_availableInstances.push_back(instance);
+	return true;
+}
+
+bool GameObjectPool::IsInstanceInScene(const GameObject& gameObject)
+{
+	return !gameObject.m_waitingForDestroy && GameplayManager::FindGameObjectById(gameObject.GetUniqueId()).get() == &gameObject;
+}
+
+void GameObjectPool::SetHierarchyUpdated(GameObject& gameObject, bool updated)
+{
+	for (const std::shared_ptr<Component>& component : gameObject.m_components)
+	{
+		if (updated)
+			GameplayManager::AddComponentToUpdateList(*component);
+		else
+			GameplayManager::RemoveComponent(*component);
+	}
+
+	for (const std::weak_ptr<GameObject>& child : gameObject.m_children)
+	{
+		if (const std::shared_ptr<GameObject> lockChild = child.lock())
+			SetHierarchyUpdated(*lockChild, updated);
+	}
+}
+
+void GameObjectPool::CallPoolEvent(GameObject& gameObject, bool acquired)
+{
+	for (const std::shared_ptr<Component>& component : gameObject.m_components)
+	{
+		if (acquired)
+			component->OnAcquire();
+		else
+			component->OnRelease();
+	}
+
+	for (const std::weak_ptr<GameObject>& child : gameObject.m_children)
+	{
+		if (const std::shared_ptr<GameObject> lockChild = child.lock())
+			CallPoolEvent(*lockChild, acquired);
+	}
+}
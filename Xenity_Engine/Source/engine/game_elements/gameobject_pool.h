@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <engine/api.h>
+
+class GameObject;
+
+/**
+* @brief Pool of instances of a GameObject, used to avoid creating and destroying objects that are often spawned (projectiles, enemies...)
+* Released instances are deactivated and their components are removed from the update list instead of being destroyed
+*/
+class API GameObjectPool
+{
+public:
+	/**
+	* @brief Create a pool
+	* @param prefab GameObject to duplicate when the pool is empty
+	* @param prewarmCount Number of instances to create now
+	*/
+	GameObjectPool(const std::shared_ptr<GameObject>& prefab, size_t prewarmCount = 0);
+	GameObjectPool(const GameObjectPool& other) = delete;
+	GameObjectPool& operator=(const GameObjectPool&) = delete;
+
+	/**
+	* @brief Destroy the released instances, the acquired instances are kept
+	*/
+	~GameObjectPool();
+
+	/**
+	* @brief Create instances until the pool has at least count released instances
+	* @param count Number of released instances wanted
+	*/
+	void Prewarm(size_t count);
+
+	/**
+	* @brief Get an instance from the pool (a new instance is created if the pool is empty)
+	* The instance is activated and OnAcquire() is called on all of its components
+	* @return The instance (nullptr if the pool is empty and the prefab has been destroyed)
+	*/
+	std::shared_ptr<GameObject> Acquire();
+
+	/**
+	* @brief Give back an instance to the pool
+	* OnRelease() is called on all of its components, then the instance is deactivated
+	* @param gameObject Instance to release
+	*/
+	void Release(const std::shared_ptr<GameObject>& gameObject);
+
+	/**
+	* @brief Get the number of released instances ready to be acquired
+	*/
+	inline size_t GetAvailableCount() const
+	{
+		return m_availableInstances.size();
+	}
+
+	/**
+	* @brief Destroy all released instances
+	*/
+	void Clear();
+
+private:
+	/**
+	* @brief Duplicate the prefab and release the new instance
+	* @return False if the prefab has been destroyed
+	*/
+	bool CreateInstance();
+
+	/**
+	* @brief Check if an instance has not been destroyed or removed from the scene (scene change)
+	*/
+	static bool IsInstanceInScene(const GameObject& gameObject);
+
+	/**
+	* @brief Remove the components of a GameObject and its children from the update list, or add them back
+	*/
+	static void SetHierarchyUpdated(GameObject& gameObject, bool updated);
+
+	/**
+	* @brief Call OnAcquire() or OnRelease() on the components of a GameObject and its children
+	*/
+	static void CallPoolEvent(GameObject& gameObject, bool acquired);
+
+	std::weak_ptr<GameObject> m_prefab;
+	std::vector<std::shared_ptr<GameObject>> m_availableInstances;
+};
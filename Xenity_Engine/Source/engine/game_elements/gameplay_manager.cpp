@@ -20,11 +20,23 @@
 #include <engine/debug/stack_debug_object.h>
 #include <engine/time/time.h>
 
+#include <algorithm>
+
+// Defined before the GameObjects lists to be destroyed after them (the components remove themselves from the update list)
+std::vector<GameplayManager::UpdateBucket> GameplayManager::s_updateBuckets;
+std::vector<GameplayManager::UpdateTombstone> GameplayManager::s_updateTombstones;
+std::vector<Component*> GameplayManager::s_pendingUpdateComponents;
+std::vector<std::weak_ptr<Component>> GameplayManager::s_componentsToInitialise;
+size_t GameplayManager::s_updatedComponentCount = 0;
+bool GameplayManager::s_isUpdatingComponents = false;
+bool GameplayManager::s_isUpdateListCleared = false;
+Component* GameplayManager::s_currentUpdatedComponent = nullptr;
+std::shared_ptr<Component> GameplayManager::s_currentUpdatedComponentKeepAlive;
+std::unordered_map<uint64_t, GameObject*> GameplayManager::s_gameObjectsById;
+std::unordered_map<uint64_t, Component*> GameplayManager::s_componentsById;
+
 int GameplayManager::gameObjectCount = 0;
-bool GameplayManager::componentsListDirty = true;
 bool GameplayManager::componentsInitListDirty = true;
-std::vector<std::weak_ptr<Component>> GameplayManager::orderedComponents;
-int GameplayManager::componentsCount = 0;
 std::vector<std::shared_ptr<GameObject>> GameplayManager::gameObjects;
 #if defined(EDITOR)
 int GameplayManager::gameObjectEditorCount = 0;
@@ -43,6 +55,7 @@ void GameplayManager::AddGameObject(const std::shared_ptr<GameObject>& gameObjec
 
 	gameObjects.push_back(gameObject);
 	gameObjectCount++;
+	s_gameObjectsById[gameObject->GetUniqueId()] = gameObject.get();
 }
 
 #if defined(EDITOR)
@@ -50,6 +63,7 @@ void GameplayManager::AddGameObjectEditor(const std::shared_ptr<GameObject>& gam
 {
 	XASSERT(gameObject != nullptr, "[GameplayManager::AddGameObjectEditor] gameObject is nullptr");
 
+	gameObject->m_isEditorGameObject = true;
 	gameObjectsEditor.push_back(gameObject);
 	gameObjectEditorCount++;
 }
@@ -104,115 +118,365 @@ void GameplayManager::SetGameState(GameState newGameState, bool restoreScene)
 #endif
 }
 
-void GameplayManager::UpdateComponents()
+void GameplayManager::AddComponent(const std::shared_ptr<Component>& component)
 {
-	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+	XASSERT(component != nullptr, "[GameplayManager::AddComponent] component is nullptr");
 
-	SCOPED_PROFILER("GameplayManager::UpdateComponents", scopeBenchmark);
-	// Order components and initialise new components
-	if (componentsListDirty)
+	s_componentsById[component->GetUniqueId()] = component.get();
+
+	s_componentsToInitialise.push_back(component);
+	componentsInitListDirty = true;
+
+	AddComponentToUpdateList(*component);
+}
+
+void GameplayManager::AddComponentToUpdateList(Component& component)
+{
+	if (!component.m_hasUpdateFunction)
+		return;
+
+	if (component.m_updateListIndex != Component::INVALID_UPDATE_LIST_INDEX || component.m_isUpdatePending)
+		return;
+
+	// Do not modify the buckets while iterating them, the component will be updated from the next frame
+	if (s_isUpdatingComponents)
+	{
+		component.m_isUpdatePending = true;
+		s_pendingUpdateComponents.push_back(&component);
+	}
+	else
 	{
-		componentsListDirty = false;
-		orderedComponents.clear();
+		AddComponentToUpdateBucket(component);
+	}
+}
 
-		componentsCount = 0;
-		OrderComponents();
-		componentsInitListDirty = true;
+void GameplayManager::RemoveComponent(Component& component)
+{
+	if (component.m_isUpdatePending)
+	{
+		component.m_isUpdatePending = false;
+		const size_t pendingCount = s_pendingUpdateComponents.size();
+		for (size_t i = 0; i < pendingCount; i++)
+		{
+			if (s_pendingUpdateComponents[i] == &component)
+			{
+				s_pendingUpdateComponents[i] = s_pendingUpdateComponents.back();
+				s_pendingUpdateComponents.pop_back();
+				break;
+			}
+		}
+		return;
 	}
 
-	if (componentsInitListDirty) 
+	if (component.m_updateListIndex == Component::INVALID_UPDATE_LIST_INDEX)
+		return;
+
+	UpdateBucket* bucket = FindUpdateBucket(component.m_updateListPriority);
+	XASSERT(bucket != nullptr, "[GameplayManager::RemoveComponent] The bucket of the component does not exist");
+	XASSERT(bucket->components[component.m_updateListIndex] == &component, "[GameplayManager::RemoveComponent] Wrong update list index");
+
+	if (s_isUpdatingComponents)
 	{
-		if (GetGameState() == GameState::Playing) 
+		bucket->components[component.m_updateListIndex] = nullptr;
+		s_updateTombstones.push_back({ component.m_updateListPriority, component.m_updateListIndex });
+	}
+	else
+	{
+		SwapRemoveFromUpdateBucket(*bucket, component.m_updateListIndex);
+	}
+	component.m_updateListIndex = Component::INVALID_UPDATE_LIST_INDEX;
+	s_updatedComponentCount--;
+}
+
+std::shared_ptr<GameObject> GameplayManager::FindGameObjectById(uint64_t id)
+{
+	const auto it = s_gameObjectsById.find(id);
+	if (it == s_gameObjectsById.end())
+		return nullptr;
+
+	return it->second->weak_from_this().lock(); // nullptr if the object is being destroyed
+}
+
+std::shared_ptr<Component> GameplayManager::FindComponentById(uint64_t id)
+{
+	const auto it = s_componentsById.find(id);
+	if (it == s_componentsById.end())
+		return nullptr;
+
+	return it->second->weak_from_this().lock(); // nullptr if the object is being destroyed
+}
+
+template<typename T>
+void GameplayManager::EraseFromIdIndex(std::unordered_map<uint64_t, T*>& index, uint64_t id, const T* object)
+{
+	const auto it = index.find(id);
+	if (it != index.end() && it->second == object)
+		index.erase(it);
+}
+
+void GameplayManager::RemoveGameObjectFromIdIndex(const GameObject& gameObject)
+{
+	EraseFromIdIndex(s_gameObjectsById, gameObject.GetUniqueId(), &gameObject);
+}
+
+void GameplayManager::RemoveComponentFromIdIndex(const Component& component)
+{
+	EraseFromIdIndex(s_componentsById, component.GetUniqueId(), &component);
+}
+
+void GameplayManager::OnGameObjectIdChanged(GameObject& gameObject, uint64_t oldId)
+{
+	const auto it = s_gameObjectsById.find(oldId);
+	if (it == s_gameObjectsById.end() || it->second != &gameObject)
+		return; // Not in the scene
+
+	s_gameObjectsById.erase(it);
+	s_gameObjectsById[gameObject.GetUniqueId()] = &gameObject;
+}
+
+void GameplayManager::OnComponentIdChanged(Component& component, uint64_t oldId)
+{
+	const auto it = s_componentsById.find(oldId);
+	if (it == s_componentsById.end() || it->second != &component)
+		return; // Not in the scene
+
+	s_componentsById.erase(it);
+	s_componentsById[component.GetUniqueId()] = &component;
+}
+
+void GameplayManager::ClearGameObjects()
+{
+	// Objects still referenced somewhere else are not part of the scene anymore
+	s_gameObjectsById.clear();
+	s_componentsById.clear();
+
+	gameObjects.clear();
+	gameObjectCount = 0;
+
+	// Cleared after the GameObjects because a destroyed component can destroy other objects
+	gameObjectsToDestroy.clear();
+	componentsToDestroy.clear();
+}
+
+void GameplayManager::OnComponentUpdatePriorityChanged(Component& component)
+{
+	if (component.m_isUpdatePending)
+		return; // The bucket will be chosen with the new priority when the pending components are added
+
+	if (component.m_updateListIndex == Component::INVALID_UPDATE_LIST_INDEX)
+		return;
+
+	RemoveComponent(component);
+	if (s_isUpdatingComponents)
+	{
+		component.m_isUpdatePending = true;
+		s_pendingUpdateComponents.push_back(&component);
+	}
+	else
+	{
+		AddComponentToUpdateBucket(component);
+	}
+}
+
+void GameplayManager::ClearComponents()
+{
+	for (UpdateBucket& bucket : s_updateBuckets)
+	{
+		for (Component* component : bucket.components)
 		{
-			componentsInitListDirty = false;
-			InitialiseComponents();
+			if (component)
+				component->m_updateListIndex = Component::INVALID_UPDATE_LIST_INDEX;
 		}
 	}
+	for (Component* component : s_pendingUpdateComponents)
+	{
+		component->m_isUpdatePending = false;
+	}
 
-	if (GetGameState() == GameState::Playing)
+	if (s_isUpdatingComponents)
 	{
-		// Update components
-		for (int i = 0; i < componentsCount; i++)
+		s_isUpdateListCleared = true;
+		if (s_currentUpdatedComponent)
 		{
-			if (const std::shared_ptr<Component> component = orderedComponents[i].lock())
-			{
-				if (component->GetGameObjectRaw()->IsLocalActive() && component->IsEnabled())
-				{
-#if defined(_WIN32) || defined(_WIN64)
-					s_lastUpdatedComponent = component;
-#endif
-					component->Update();
-				}
-			}
-			else
-			{
-				orderedComponents.erase(orderedComponents.begin() + i);
-				i--;
-				componentsCount--;
-			}
+			s_currentUpdatedComponentKeepAlive = s_currentUpdatedComponent->shared_from_this();
 		}
 	}
-	s_lastUpdatedComponent.reset();
+
+	s_updateBuckets.clear();
+	s_updateTombstones.clear();
+	s_pendingUpdateComponents.clear();
+	s_componentsToInitialise.clear();
+	s_updatedComponentCount = 0;
+}
+
+size_t GameplayManager::GetUpdatedComponentCount()
+{
+	return s_updatedComponentCount;
+}
+
+GameplayManager::UpdateBucket& GameplayManager::GetOrCreateUpdateBucket(int priority)
+{
+	const auto it = std::lower_bound(s_updateBuckets.begin(), s_updateBuckets.end(), priority,
+		[](const UpdateBucket& bucket, int value) { return bucket.priority < value; });
+
+	if (it != s_updateBuckets.end() && it->priority == priority)
+		return *it;
+
+	// There are only a few different priorities, the insertion is cheap
+	UpdateBucket newBucket;
+	newBucket.priority = priority;
+	return *s_updateBuckets.insert(it, std::move(newBucket));
+}
+
+GameplayManager::UpdateBucket* GameplayManager::FindUpdateBucket(int priority)
+{
+	const auto it = std::lower_bound(s_updateBuckets.begin(), s_updateBuckets.end(), priority,
+		[](const UpdateBucket& bucket, int value) { return bucket.priority < value; });
+
+	if (it != s_updateBuckets.end() && it->priority == priority)
+		return &(*it);
+
+	return nullptr;
+}
+
+void GameplayManager::AddComponentToUpdateBucket(Component& component)
+{
+	UpdateBucket& bucket = GetOrCreateUpdateBucket(component.m_updatePriority);
+	component.m_updateListPriority = component.m_updatePriority;
+	component.m_updateListIndex = bucket.components.size();
+	bucket.components.push_back(&component);
+	s_updatedComponentCount++;
+}
+
+void GameplayManager::SwapRemoveFromUpdateBucket(UpdateBucket& bucket, size_t index)
+{
+	Component* lastComponent = bucket.components.back();
+	bucket.components[index] = lastComponent;
+	if (lastComponent)
+		lastComponent->m_updateListIndex = index;
+	bucket.components.pop_back();
+}
+
+void GameplayManager::FlushUpdateListChanges()
+{
+	// Remove the tombstones, a moved component is never a tombstone because the trailing tombstones are removed first
+	for (const UpdateTombstone& tombstone : s_updateTombstones)
+	{
+		UpdateBucket* bucket = FindUpdateBucket(tombstone.priority);
+		if (!bucket)
+			continue;
+
+		std::vector<Component*>& components = bucket->components;
+		while (!components.empty() && components.back() == nullptr)
+		{
+			components.pop_back();
+		}
+
+		if (tombstone.index < components.size() && components[tombstone.index] == nullptr)
+		{
+			SwapRemoveFromUpdateBucket(*bucket, tombstone.index);
+		}
+	}
+	s_updateTombstones.clear();
+
+	// Remove empty buckets
+	s_updateBuckets.erase(std::remove_if(s_updateBuckets.begin(), s_updateBuckets.end(),
+		[](const UpdateBucket& bucket) { return bucket.components.empty(); }), s_updateBuckets.end());
+
+	for (Component* component : s_pendingUpdateComponents)
+	{
+		component->m_isUpdatePending = false;
+		AddComponentToUpdateBucket(*component);
+	}
+	s_pendingUpdateComponents.clear();
 }
 
-void GameplayManager::OrderComponents()
+void GameplayManager::UpdateComponents()
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
-	for(const std::shared_ptr<GameObject>& gameObjectToCheck : gameObjects)
+	SCOPED_PROFILER("GameplayManager::UpdateComponents", scopeBenchmark);
+
+	if (componentsInitListDirty) 
+	{
+		if (GetGameState() == GameState::Playing) 
+		{
+			componentsInitListDirty = false;
+			InitialiseComponents();
+		}
+	}
+
+	if (GetGameState() == GameState::Playing)
 	{
-		if (gameObjectToCheck)
+		s_isUpdatingComponents = true;
+		s_isUpdateListCleared = false;
+
+		// Update components, the buckets are not resized during the loop (additions are deferred, removals leave tombstones)
+		const size_t bucketCount = s_updateBuckets.size();
+		for (size_t bucketIndex = 0; bucketIndex < bucketCount && !s_isUpdateListCleared; bucketIndex++)
 		{
-			const int goComponentCount = gameObjectToCheck->GetComponentCount();
-			bool placeFound = false;
-			for (int cIndex = 0; cIndex < goComponentCount; cIndex++)
+			const std::vector<Component*>& components = s_updateBuckets[bucketIndex].components;
+			const size_t componentCount = components.size();
+			for (size_t i = 0; i < componentCount; i++)
 			{
-				const std::shared_ptr<Component>& componentToCheck = gameObjectToCheck->m_components[cIndex];
-				if (componentToCheck)
+				Component* component = components[i];
+				if (component && component->GetGameObjectRaw()->IsLocalActive() && component->IsEnabled())
 				{
-					for (int i = 0; i < componentsCount; i++)
-					{
-						// Check if the checked has a higher priority (lower value) than the component in the list
-						if (componentToCheck->m_updatePriority <= orderedComponents[i].lock()->m_updatePriority)
-						{
-							orderedComponents.insert(orderedComponents.begin() + i, componentToCheck);
-							placeFound = true;
-							break;
-						}
-					}
-					// if the priority is lower than all components's priorities in the list, add it the end of the list
-					if (!placeFound)
-					{
-						orderedComponents.push_back(componentToCheck);
-					}
-					componentsCount++;
+#if defined(_WIN32) || defined(_WIN64)
+					s_lastUpdatedComponent = component->weak_from_this();
+#endif
+					s_currentUpdatedComponent = component;
+					component->Update();
+
+					// The scene has been cleared by the component, the buckets do not exist anymore
+					if (s_isUpdateListCleared)
+						break;
 				}
 			}
 		}
+
+		s_currentUpdatedComponent = nullptr;
+		s_isUpdatingComponents = false;
+		s_currentUpdatedComponentKeepAlive.reset();
 	}
+
+	FlushUpdateListChanges();
+	s_lastUpdatedComponent.reset();
 }
 
 void GameplayManager::InitialiseComponents()
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
-	int componentsToInitCount = 0;
 	std::vector<std::shared_ptr<Component>> orderedComponentsToInit;
-	// Find uninitiated components and order them
-	for (int i = 0; i < componentsCount; i++)
+
+	// Find the components ready to be initiated, the others stay in the list until they are enabled
+	size_t keptCount = 0;
+	const size_t componentsToCheckCount = s_componentsToInitialise.size();
+	for (size_t i = 0; i < componentsToCheckCount; i++)
 	{
-		if (auto componentToCheck = orderedComponents[i].lock())
+		std::shared_ptr<Component> componentToCheck = s_componentsToInitialise[i].lock();
+		if (!componentToCheck || componentToCheck->m_initiated || componentToCheck->m_waitingForDestroy)
+			continue;
+
+		if (componentToCheck->IsEnabled() && componentToCheck->GetGameObjectRaw()->IsLocalActive())
 		{
-			if (!componentToCheck->m_initiated && componentToCheck->IsEnabled() && componentToCheck->GetGameObject()->IsLocalActive())
-			{
-				orderedComponentsToInit.push_back(componentToCheck);
-				componentsToInitCount++;
-			}
+			orderedComponentsToInit.push_back(std::move(componentToCheck));
+		}
+		else
+		{
+			s_componentsToInitialise[keptCount] = s_componentsToInitialise[i];
+			keptCount++;
 		}
 	}
+	s_componentsToInitialise.resize(keptCount);
+
+	std::stable_sort(orderedComponentsToInit.begin(), orderedComponentsToInit.end(),
+		[](const std::shared_ptr<Component>& a, const std::shared_ptr<Component>& b) { return a->m_updatePriority < b->m_updatePriority; });
 
 	// Init components
-	for (int i = 0; i < componentsToInitCount; i++)
+	const size_t componentsToInitCount = orderedComponentsToInit.size();
+	for (size_t i = 0; i < componentsToInitCount; i++)
 	{
 		s_lastUpdatedComponent = orderedComponentsToInit[i];
 		orderedComponentsToInit[i]->Start();
@@ -233,6 +497,16 @@ void GameplayManager::RemoveDestroyedGameObjects()
 			const std::shared_ptr<GameObject>& gameObjectToCheck = gameObjects[gIndex];
 			if (gameObjectToCheck == gameObjectsToDestroy[i].lock())
 			{
+				// The components may outlive the GameObject if they are referenced somewhere else
+				for (const std::shared_ptr<Component>& component : gameObjectToCheck->m_components)
+				{
+					if (component)
+					{
+						RemoveComponent(*component);
+						RemoveComponentFromIdIndex(*component);
+					}
+				}
+				RemoveGameObjectFromIdIndex(*gameObjectToCheck);
 				gameObjects.erase(gameObjects.begin() + gIndex);
 				break;
 			}
@@ -252,6 +526,8 @@ void GameplayManager::RemoveDestroyedComponents()
 		const std::shared_ptr<Component>& component = componentsToDestroy[i];
 		if (component)
 		{
+			RemoveComponent(*component);
+			RemoveComponentFromIdIndex(*component);
 			component->RemoveReferences();
 		}
 	}
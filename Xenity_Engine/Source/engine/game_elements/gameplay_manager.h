@@ -12,6 +12,8 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <cstdint>
 #include <engine/event_system/event_system.h>
 
 class GameObject;
@@ -47,10 +49,79 @@ public:
 	*/
 	static const std::vector<std::shared_ptr<GameObject>>& GetGameObjects();
 
-	static bool componentsListDirty;
+	/**
+	* @brief [Internal] Add a component to the update list and to the list of components to initialise
+	* @param component Component to add
+	*/
+	static void AddComponent(const std::shared_ptr<Component>& component);
+
+	/**
+	* @brief [Internal] Add a component to the update list only (the component is not initialised again)
+	* @param component Component to add
+	*/
+	static void AddComponentToUpdateList(Component& component);
+
+	/**
+	* @brief [Internal] Remove a component from the update list in O(1)
+	* During the update loop, the slot is replaced by a tombstone removed at the end of the loop
+	* @param component Component to remove
+	*/
+	static void RemoveComponent(Component& component);
+
+	/**
+	* @brief [Internal] Move a component to the bucket of its new update priority
+	* @param component Component with the new priority
+	*/
+	static void OnComponentUpdatePriorityChanged(Component& component);
+
+	/**
+	* @brief [Internal] Remove all components from the update and initialisation lists
+	*/
+	static void ClearComponents();
+
+	/**
+	* @brief Get the number of components in the update list (components without Update() function are not counted)
+	*/
+	static size_t GetUpdatedComponentCount();
+
+	/**
+	* @brief [Internal] Find a GameObject of the scene with its id in O(1)
+	* @return nullptr if not found
+	*/
+	static std::shared_ptr<GameObject> FindGameObjectById(uint64_t id);
+
+	/**
+	* @brief [Internal] Find a component of the scene with its id in O(1)
+	* @return nullptr if not found
+	*/
+	static std::shared_ptr<Component> FindComponentById(uint64_t id);
+
+	/**
+	* @brief [Internal] Remove a GameObject from the id index (the GameObject is not findable anymore)
+	*/
+	static void RemoveGameObjectFromIdIndex(const GameObject& gameObject);
+
+	/**
+	* @brief [Internal] Remove a component from the id index (the component is not findable anymore)
+	*/
+	static void RemoveComponentFromIdIndex(const Component& component);
+
+	/**
+	* @brief [Internal] Move an indexed GameObject to its new id
+	*/
+	static void OnGameObjectIdChanged(GameObject& gameObject, uint64_t oldId);
+
+	/**
+	* @brief [Internal] Move an indexed component to its new id
+	*/
+	static void OnComponentIdChanged(Component& component, uint64_t oldId);
+
+	/**
+	* @brief [Internal] Remove all GameObjects of the scene and clear the id indices
+	*/
+	static void ClearGameObjects();
+
 	static bool componentsInitListDirty;
-	static std::vector<std::weak_ptr<Component>> orderedComponents;
-	static int componentsCount;
 	static int gameObjectCount;
 	static std::vector<std::shared_ptr<GameObject>> gameObjects;
 #if defined(EDITOR)
@@ -65,11 +136,6 @@ public:
 	*/
 	static void UpdateComponents();
 
-	/**
-	* @brief Order components by their update order
-	*/
-	static void OrderComponents();
-
 	/**
 	* @brief Initialise all components
 	*/
@@ -117,6 +183,70 @@ public:
 	}
 
 private:
+	/**
+	* @brief Components with the same update priority, in no particular order
+	*/
+	struct UpdateBucket
+	{
+		int priority = 0;
+		std::vector<Component*> components; // nullptr for tombstones
+	};
+
+	/**
+	* @brief Slot to remove from a bucket after the update loop
+	*/
+	struct UpdateTombstone
+	{
+		int priority = 0;
+		size_t index = 0;
+	};
+
+	/**
+	* @brief Get the bucket of a priority with a binary search, create the bucket if needed
+	*/
+	static UpdateBucket& GetOrCreateUpdateBucket(int priority);
+
+	/**
+	* @brief Get the bucket of a priority with a binary search
+	* @return nullptr if there is no bucket for this priority
+	*/
+	static UpdateBucket* FindUpdateBucket(int priority);
+
+	/**
+	* @brief Add a component at the end of the bucket of its priority
+	*/
+	static void AddComponentToUpdateBucket(Component& component);
+
+	/**
+	* @brief Replace a slot by the last component of the bucket
+	*/
+	static void SwapRemoveFromUpdateBucket(UpdateBucket& bucket, size_t index);
+
+	/**
+	* @brief Remove the tombstones and add the components added during the update loop
+	*/
+	static void FlushUpdateListChanges();
+
+	static std::vector<UpdateBucket> s_updateBuckets; // Sorted by priority (lower first)
+	static std::vector<UpdateTombstone> s_updateTombstones;
+	static std::vector<Component*> s_pendingUpdateComponents; // Components added during the update loop
+	static std::vector<std::weak_ptr<Component>> s_componentsToInitialise;
+	static size_t s_updatedComponentCount;
+	static bool s_isUpdatingComponents;
+	static bool s_isUpdateListCleared; // Set if the list is cleared during the update loop (scene loaded by a component)
+	static Component* s_currentUpdatedComponent;
+	static std::shared_ptr<Component> s_currentUpdatedComponentKeepAlive; // Keep the current component alive if the scene is cleared during its update
+
+	/**
+	* @brief Remove an entry of an id index only if it points to the object (another object can use the same id after an undo)
+	*/
+	template<typename T>
+	static void EraseFromIdIndex(std::unordered_map<uint64_t, T*>& index, uint64_t id, const T* object);
+
+	// Raw pointers, the objects remove themselves from the indices when they are destroyed
+	static std::unordered_map<uint64_t, GameObject*> s_gameObjectsById;
+	static std::unordered_map<uint64_t, Component*> s_componentsById;
+
 	static std::weak_ptr<Component> s_lastUpdatedComponent;
 
 	static Event<> s_OnPlayEvent;
@@ -13,8 +13,13 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include <engine/tools/math.h>
+#include <engine/debug/performance.h>
 #include "gameobject.h"
 
+bool Transform::s_isLazyUpdateEnabled = false;
+std::vector<std::weak_ptr<Transform>> Transform::s_dirtyRootTransforms;
+std::vector<Transform::FlattenedTransform> Transform::s_flattenedTransforms;
+
 #pragma region Constructors
 
 Transform::Transform(const std::shared_ptr<GameObject>& _gameObject) : m_gameObject(_gameObject)
@@ -43,6 +48,10 @@ void Transform::SetPosition(const Vector3& value)
 	if (value.HasInvalidValues())
 		return;
 
+	// The local values are computed from the parent's world values
+	if (m_isWorldDirty)
+		ResolveWorldValues();
+
 	if (value != m_position)
 	{
 		m_isTransformationMatrixDirty = true;
@@ -101,6 +110,10 @@ void Transform::SetRotation(const Vector3& value)
 	if (value.HasInvalidValues())
 		return;
 
+	// The local values are computed from the parent's world values
+	if (m_isWorldDirty)
+		ResolveWorldValues();
+
 	// Do not update the matrix if it's the same value
 	if (value != m_rotation)
 		m_isTransformationMatrixDirty = true;
@@ -154,6 +167,10 @@ void Transform::SetLocalRotation(const Vector3& value)
 
 void Transform::SetRotation(const Quaternion& value)
 {
+	// The local values are computed from the parent's world values
+	if (m_isWorldDirty)
+		ResolveWorldValues();
+
 	if (value != m_rotationQuaternion)
 		m_isTransformationMatrixDirty = true;
 	else
@@ -229,6 +246,9 @@ void Transform::OnParentChanged()
 	if (!gm->GetParent().expired())
 	{
 		const std::shared_ptr<Transform>& parentTransform = gm->GetParent().lock()->GetTransform();
+		if (parentTransform->m_isWorldDirty)
+			parentTransform->ResolveWorldValues();
+
 		//----- Set new local scale
 		m_localScale = m_scale / parentTransform->m_scale;
 
@@ -254,6 +274,14 @@ void Transform::SetChildrenWorldPositions()
 {
 	UpdateTransformationMatrix();
 
+	if (s_isLazyUpdateEnabled)
+	{
+		// This transform is up to date, it is only used as the starting point to compute its dirty children
+		if (SetChildrenWorldValuesDirty())
+			s_dirtyRootTransforms.push_back(weak_from_this());
+		return;
+	}
+
 	const std::shared_ptr<GameObject> gm = m_gameObject.lock();
 
 	const int childCount = gm->GetChildrenCount();
@@ -261,7 +289,11 @@ void Transform::SetChildrenWorldPositions()
 	//For each children
 	for (int i = 0; i < childCount; i++)
 	{
-		const std::shared_ptr<Transform>& transform = gm->GetChildren()[i].lock()->GetTransform();
+		const std::shared_ptr<GameObject> child = gm->GetChildren()[i].lock();
+		if (!child)
+			continue;
+
+		const std::shared_ptr<Transform>& transform = child->GetTransform();
 		transform->m_isTransformationMatrixDirty = true;
 		transform->UpdateWorldValues();
 	}
@@ -269,17 +301,33 @@ void Transform::SetChildrenWorldPositions()
 
 void Transform::UpdateWorldValues()
 {
-	UpdateWorldPosition();
-	UpdateWorldRotation();
+	if (s_isLazyUpdateEnabled)
+	{
+		SetWorldValuesDirty();
+		return;
+	}
+
+	const Transform* parentTransform = GetParentTransform();
+	UpdateWorldPosition(parentTransform);
+	UpdateWorldRotation(parentTransform);
 	UpdateWorldScale();
 
 	SetChildrenWorldPositions();
 }
 
-void Transform::UpdateWorldRotation()
+Transform* Transform::GetParentTransform() const
 {
 	const std::shared_ptr<GameObject> gm = m_gameObject.lock();
-	if (gm->GetParent().expired())
+	const std::shared_ptr<GameObject> parentGm = gm->GetParent().lock();
+	if (!parentGm)
+		return nullptr;
+
+	return parentGm->GetTransform().get();
+}
+
+void Transform::UpdateWorldRotation(const Transform* parentTransform)
+{
+	if (!parentTransform)
 	{
 		m_rotationQuaternion = m_localRotationQuaternion;
 		m_rotation = m_rotationQuaternion.ToEuler();
@@ -287,25 +335,22 @@ void Transform::UpdateWorldRotation()
 		return;
 	}
 
-	const std::shared_ptr<Transform>& parentTransform = gm->GetParent().lock()->GetTransform();
 	const Quaternion quatChildGlobal2 = parentTransform->m_rotationQuaternion * m_localRotationQuaternion;
 	const Vector3 eulerChildGlobal2 = quatChildGlobal2.ToEuler();
 	m_rotation = eulerChildGlobal2;
 	m_rotationQuaternion = quatChildGlobal2;
 }
 
-void Transform::UpdateWorldPosition()
+void Transform::UpdateWorldPosition(const Transform* parentTransform)
 {
-	const std::shared_ptr<GameObject> gm = m_gameObject.lock();
-	if (gm->GetParent().expired())
+	if (!parentTransform)
 	{
 		m_position = m_localPosition;
 		return;
 	}
 
-	const std::shared_ptr<Transform>& parentTransform = gm->GetParent().lock()->GetTransform();
-	const Vector3& parentPosition = parentTransform->GetPosition();
-	const Vector3& parentScale = parentTransform->GetScale();
+	const Vector3& parentPosition = parentTransform->m_position;
+	const Vector3& parentScale = parentTransform->m_scale;
 	const Vector3& thisLocalPosition = GetLocalPosition();
 	//Get child local position
 	const float scaledLocalPos[3] = { (thisLocalPosition.x * parentScale.x), -(thisLocalPosition.y * parentScale.y), -(thisLocalPosition.z * parentScale.z) };
@@ -373,6 +418,137 @@ void Transform::UpdateLocalRotation()
 	m_localRotation = m_localRotationQuaternion.ToEuler();
 }
 
+#pragma region Lazy update
+
+void Transform::SetLazyUpdateEnabled(bool enabled)
+{
+	if (s_isLazyUpdateEnabled == enabled)
+		return;
+
+	// Apply the pending changes before going back to the immediate update
+	if (!enabled)
+		UpdateDirtyTransforms();
+
+	s_isLazyUpdateEnabled = enabled;
+}
+
+void Transform::SetWorldValuesDirty()
+{
+	// The children of a dirty transform are already dirty
+	if (m_isWorldDirty)
+		return;
+
+	m_isWorldDirty = true;
+	s_dirtyRootTransforms.push_back(weak_from_this());
+	SetChildrenWorldValuesDirty();
+}
+
+bool Transform::SetChildrenWorldValuesDirty()
+{
+	bool hasMarkedChild = false;
+	const std::shared_ptr<GameObject> gm = m_gameObject.lock();
+	const int childCount = gm->GetChildrenCount();
+	for (int i = 0; i < childCount; i++)
+	{
+		const std::shared_ptr<GameObject> child = gm->GetChildren()[i].lock();
+		if (!child)
+			continue;
+
+		const std::shared_ptr<Transform>& transform = child->GetTransform();
+		if (transform->m_isWorldDirty)
+			continue;
+
+		transform->m_isWorldDirty = true;
+		transform->SetChildrenWorldValuesDirty();
+		hasMarkedChild = true;
+	}
+	return hasMarkedChild;
+}
+
+void Transform::ComputeWorldValues(const Transform* parentTransform)
+{
+	// Cleared before the update event to let the listeners read the new values
+	m_isWorldDirty = false;
+
+	UpdateWorldPosition(parentTransform);
+	UpdateWorldRotation(parentTransform);
+	if (parentTransform)
+		m_scale = m_localScale * parentTransform->m_scale;
+	else
+		m_scale = m_localScale;
+
+	m_isTransformationMatrixDirty = true;
+	UpdateTransformationMatrix();
+}
+
+void Transform::ResolveWorldValues() const
+{
+	// The world values are a cache, computing them does not change the transform from the user's point of view
+	Transform* transform = const_cast<Transform*>(this);
+
+	// Only the dirty parents are computed, the other children stay dirty until the end of the frame
+	const Transform* parentTransform = transform->GetParentTransform();
+	if (parentTransform && parentTransform->m_isWorldDirty)
+		parentTransform->ResolveWorldValues();
+
+	transform->ComputeWorldValues(parentTransform);
+}
+
+void Transform::UpdateDirtyTransforms()
+{
+	SCOPED_PROFILER("Transform::UpdateDirtyTransforms", scopeBenchmark);
+
+	// The list can grow if a listener of the update event moves a transform
+	for (size_t rootIndex = 0; rootIndex < s_dirtyRootTransforms.size(); rootIndex++)
+	{
+		const std::shared_ptr<Transform> rootTransform = s_dirtyRootTransforms[rootIndex].lock();
+		if (!rootTransform)
+			continue;
+
+		// A parent may have been marked as dirty after this transform, start from the top most dirty transform
+		Transform* topTransform = rootTransform.get();
+		Transform* parentTransform = topTransform->GetParentTransform();
+		while (parentTransform && parentTransform->m_isWorldDirty)
+		{
+			topTransform = parentTransform;
+			parentTransform = parentTransform->GetParentTransform();
+		}
+
+		// Flatten the branch, a transform is always added after its parent.
+		// Clean transforms are kept because they can have dirty children if they have been read since they were marked
+		s_flattenedTransforms.clear();
+		s_flattenedTransforms.push_back({ topTransform, parentTransform });
+		for (size_t i = 0; i < s_flattenedTransforms.size(); i++)
+		{
+			Transform* transform = s_flattenedTransforms[i].transform;
+			const std::shared_ptr<GameObject> gm = transform->m_gameObject.lock();
+			const int childCount = gm->GetChildrenCount();
+			for (int childIndex = 0; childIndex < childCount; childIndex++)
+			{
+				const std::shared_ptr<GameObject> child = gm->GetChildren()[childIndex].lock();
+				if (!child)
+					continue;
+
+				s_flattenedTransforms.push_back({ child->GetTransform().get(), transform });
+			}
+		}
+
+		// Compute the world values in a single pass
+		const size_t flattenedCount = s_flattenedTransforms.size();
+		for (size_t i = 0; i < flattenedCount; i++)
+		{
+			const FlattenedTransform& flattenedTransform = s_flattenedTransforms[i];
+			if (flattenedTransform.transform->m_isWorldDirty)
+			{
+				flattenedTransform.transform->ComputeWorldValues(flattenedTransform.parent);
+			}
+		}
+	}
+	s_dirtyRootTransforms.clear();
+}
+
+#pragma endregion
+
 Vector3 Transform::GetLocalPositionFromMatrices(const glm::mat4& childMatrix, const glm::mat4& parentMatrix) const
 {
 	const glm::mat4 parentGlobalTransformInverse = glm::inverse(parentMatrix);
@@ -7,6 +7,7 @@
 #pragma once
 #include <glm/mat4x4.hpp>
 #include <memory>
+#include <vector>
 
 #include <engine/api.h>
 #include <engine/event_system/event_system.h>
@@ -28,6 +29,8 @@ public:
 	*/
 	inline const Vector3& GetPosition() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		return m_position;
 	}
 
@@ -44,6 +47,8 @@ public:
 	*/
 	inline const Vector3& GetEulerAngles() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		return m_rotation;
 	}
 
@@ -60,6 +65,8 @@ public:
 	*/
 	inline const Quaternion& GetRotation() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		return m_rotationQuaternion;
 	}
 
@@ -76,6 +83,8 @@ public:
 	*/
 	inline const Vector3& GetScale() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		return m_scale;
 	}
 
@@ -92,6 +101,8 @@ public:
 	*/
 	inline Vector3 GetForward() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		const Vector3 direction = Vector3(-rotationMatrix[6], rotationMatrix[7], rotationMatrix[8]);
 		return direction;
 	}
@@ -117,6 +128,8 @@ public:
 	*/
 	inline Vector3 GetRight() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		const Vector3 direction = Vector3(rotationMatrix[0], -rotationMatrix[1], -rotationMatrix[2]);
 		return direction;
 	}
@@ -126,6 +139,8 @@ public:
 	*/
 	inline Vector3 GetUp() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		const Vector3 direction = Vector3(-rotationMatrix[3], rotationMatrix[4], rotationMatrix[5]);
 		return direction;
 	}
@@ -180,11 +195,36 @@ public:
 	*/
 	void SetLocalScale(const Vector3& value);
 
+	/**
+	* @brief Get the transformation matrix (world space)
+	*/
 	inline const glm::mat4& GetTransformationMatrix() const
 	{
+		if (m_isWorldDirty)
+			ResolveWorldValues();
 		return transformationMatrix;
 	}
 
+	/**
+	* @brief Enable or disable the lazy update of the world values.
+	* When enabled, the setters only mark the children as dirty and the world values are computed when they are read or at the end of the frame
+	* @param enabled True to enable the lazy update
+	*/
+	static void SetLazyUpdateEnabled(bool enabled);
+
+	/**
+	* @brief Get if the lazy update of the world values is enabled
+	*/
+	static bool IsLazyUpdateEnabled()
+	{
+		return s_isLazyUpdateEnabled;
+	}
+
+	/**
+	* @brief [Internal] Compute the world values of all dirty transforms (parents before children)
+	*/
+	static void UpdateDirtyTransforms();
+
 	/**
 	* @brief Get GameObject
 	*/
@@ -226,6 +266,7 @@ private:
 	friend class InspectorDeleteGameObjectCommand;
 	friend class GameObject;
 	friend class SceneManager;
+	friend class BinaryScene;
 	friend class InspectorMenu;
 
 	/**
@@ -251,12 +292,12 @@ private:
 	/**
 	* @brief Update world position
 	*/
-	void UpdateWorldPosition();
+	void UpdateWorldPosition(const Transform* parentTransform);
 
 	/**
 	* @brief Update world rotation
 	*/
-	void UpdateWorldRotation();
+	void UpdateWorldRotation(const Transform* parentTransform);
 
 	/**
 	* @brief Update world scale
@@ -265,6 +306,52 @@ private:
 
 	void UpdateLocalRotation();
 
+	/**
+	* @brief Compute the world values of this transform and of its dirty parents (lazy update only)
+	*/
+	void ResolveWorldValues() const;
+
+	/**
+	* @brief Mark this transform and all its children as dirty (lazy update only)
+	*/
+	void SetWorldValuesDirty();
+
+	/**
+	* @brief Mark all the children as dirty (lazy update only)
+	* The caller has to add a parent of the children to the dirty list
+	* @return True if at least one child has been marked
+	*/
+	bool SetChildrenWorldValuesDirty();
+
+	/**
+	* @brief Compute the world values from the parent's world values (lazy update only)
+	* @param parentTransform Parent transform (already up to date), nullptr if there is no parent
+	*/
+	void ComputeWorldValues(const Transform* parentTransform);
+
+	/**
+	* @brief Get the parent transform (nullptr if there is no parent)
+	*/
+	Transform* GetParentTransform() const;
+
+	/**
+	* @brief Transform to update in the flattened update list
+	*/
+	struct FlattenedTransform
+	{
+		Transform* transform = nullptr;
+		const Transform* parent = nullptr;
+	};
+
+	static bool s_isLazyUpdateEnabled;
+	// Transforms marked as dirty while their parent was not dirty
+	static std::vector<std::weak_ptr<Transform>> s_dirtyRootTransforms;
+	static std::vector<FlattenedTransform> s_flattenedTransforms;
+
+	// True if the world values have to be computed from the parent (lazy update only)
+	// If a transform is dirty, all its children are dirty too
+	bool m_isWorldDirty = false;
+
 	Vector3 m_position = Vector3(0);
 	Vector3 m_localPosition = Vector3(0);
 	Vector3 m_rotation = Vector3(0);//Euler angle
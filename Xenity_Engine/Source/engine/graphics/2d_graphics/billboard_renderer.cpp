@@ -37,7 +37,7 @@ void BillboardRenderer::OnReflectionUpdated()
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 BillboardRenderer::~BillboardRenderer()
@@ -64,30 +64,29 @@ void BillboardRenderer::CreateRenderCommands(RenderBatch& renderBatch)
 	command.transform = GetTransformRaw();
 	command.isEnabled = IsEnabled() && GetGameObjectRaw()->IsLocalActive();
 
-	renderBatch.spriteCommands.push_back(command);
-	renderBatch.spriteCommandIndex++;
+	renderBatch.AddCommand(command, RenderQueueType::Sprite);
 }
 
 void BillboardRenderer::SetMaterial(const std::shared_ptr<Material>& material)
 {
 	m_material = material;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 void BillboardRenderer::SetTexture(const std::shared_ptr<Texture>& texture)
 {
 	m_texture = texture;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 void BillboardRenderer::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void BillboardRenderer::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 /// <summary>
@@ -96,5 +95,5 @@ void BillboardRenderer::OnEnabled()
 void BillboardRenderer::DrawCommand([[maybe_unused]] const RenderCommand& renderCommand)
 {
 	const Transform* transform = GetTransformRaw();
-	SpriteManager::DrawSprite(transform->GetPosition(), Graphics::usedCamera->GetTransformRaw()->GetRotation() * transform->GetRotation(), transform->GetScale(), m_color, *m_material, m_texture.get());
+	SpriteManager::AddSpriteToBatch(transform->GetPosition(), Graphics::usedCamera->GetTransformRaw()->GetRotation() * transform->GetRotation(), transform->GetScale(), m_color, *m_material, *m_texture, m_orderInLayer);
 }
\ No newline at end of file
@@ -41,7 +41,7 @@ void LineRenderer::OnReflectionUpdated()
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 LineRenderer::~LineRenderer()
@@ -69,25 +69,22 @@ void LineRenderer::CreateRenderCommands(RenderBatch& renderBatch)
 
 	if (m_material->GetRenderingMode() == MaterialRenderingModes::Opaque || m_material->GetRenderingMode() == MaterialRenderingModes::Cutout)
 	{
-		RenderQueue& renderQueue = renderBatch.renderQueues[m_material->GetFileId()];
-		renderQueue.commands.push_back(command);
-		renderQueue.commandIndex++;
+		renderBatch.AddCommand(command, RenderQueueType::Opaque);
 	}
 	else
 	{
-		renderBatch.transparentMeshCommands.push_back(command);
-		renderBatch.transparentMeshCommandIndex++;
+		renderBatch.AddCommand(command, RenderQueueType::Transparent);
 	}
 }
 
 void LineRenderer::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void LineRenderer::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 /// <summary>
@@ -6,9 +6,11 @@
 
 #include "sprite_manager.h"
 
+#include <algorithm>
 #include <glm/ext/matrix_transform.hpp>
 #if defined(__PSP__)
 #include <pspkernel.h>
+#include <malloc.h>
 #endif
 
 #include <engine/graphics/graphics.h>
@@ -24,8 +26,26 @@
 #include <engine/tools/profiler_benchmark.h>
 #include <engine/vectors/quaternion.h>
 #include <engine/tools/math.h>
+#include <engine/debug/performance.h>
+#include <engine/assertions/assertions.h>
+#include <engine/constants.h>
+#include <engine/debug/stack_debug_object.h>
 
 std::shared_ptr <MeshData> SpriteManager::s_spriteMeshData = nullptr;
+std::vector<SpriteManager::BatchedSprite> SpriteManager::s_batchedSprites;
+std::vector<uint32_t> SpriteManager::s_sortedBatchedSpriteIndices;
+#if defined(__vita__) || defined(_WIN32) || defined(_WIN64) || defined(__LINUX__) || defined(__PSP__)
+std::shared_ptr<MeshData> SpriteManager::s_batchMesh = nullptr;
+#if defined(__PSP__)
+std::vector<void*> SpriteManager::s_batchVertexBlocks;
+size_t SpriteManager::s_batchVertexBlockIndex = 0;
+size_t SpriteManager::s_batchVertexBlockOffset = 0;
+size_t SpriteManager::s_batchVertexSize = 0;
+#endif
+#else
+std::vector<std::shared_ptr<MeshData>> SpriteManager::s_batchMeshes;
+size_t SpriteManager::s_usedBatchMeshCount = 0;
+#endif
 
 /**
  * @brief Init the Sprite Manager
@@ -117,6 +137,301 @@ void SpriteManager::DrawSprite(const Vector3& position, const Quaternion& rotati
 	Graphics::DrawSubMesh(*s_spriteMeshData->m_subMeshes[0], material, texture, renderSettings, matrix, false);
 }
 
+void SpriteManager::AddSpriteToBatch(const Transform& transform, const Color& color, Material& material, Texture& texture, int orderInLayer)
+{
+	const Vector3& scale = transform.GetScale();
+
+	const float scaleCoef = (1.0f / texture.GetPixelPerUnit());
+	const float w = texture.GetWidth() * scaleCoef;
+	const float h = texture.GetHeight() * scaleCoef;
+
+	const glm::mat4 matrix = glm::scale(transform.GetTransformationMatrix(), glm::vec3(w, h, 1));
+
+	AddSpriteToBatch(matrix, scale.x * scale.y < 0, color, material, texture, orderInLayer);
+}
+
+void SpriteManager::AddSpriteToBatch(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const Color& color, Material& material, Texture& texture, int orderInLayer)
+{
+	const float scaleCoef = (1.0f / texture.GetPixelPerUnit());
+	const float w = texture.GetWidth() * scaleCoef;
+	const float h = texture.GetHeight() * scaleCoef;
+
+	const glm::mat4 matrix = glm::scale(Math::CreateModelMatrix(position, rotation, scale), glm::vec3(w, h, 1));
+
+	AddSpriteToBatch(matrix, scale.x * scale.y < 0, color, material, texture, orderInLayer);
+}
+
+void SpriteManager::AddSpriteToBatch(const glm::mat4& matrix, bool isFlipped, const Color& color, Material& material, Texture& texture, int orderInLayer)
+{
+	BatchedSprite sprite;
+
+	// Same corners as the sprite mesh
+	const glm::vec3 center = glm::vec3(matrix[3]);
+	const glm::vec3 halfRight = glm::vec3(matrix[0]) * 0.5f;
+	const glm::vec3 halfUp = glm::vec3(matrix[1]) * 0.5f;
+	sprite.corners[0] = center - halfRight - halfUp;
+	sprite.corners[1] = center + halfRight - halfUp;
+	sprite.corners[2] = center + halfRight + halfUp;
+	sprite.corners[3] = center - halfRight + halfUp;
+
+	sprite.color = color;
+	sprite.material = &material;
+
+	// The sprites of the textures packed in the same atlas page are drawn in the same batch
+	Texture* atlasPage = texture.GetAtlasPage();
+	if (atlasPage)
+	{
+		const Vector4& uvRect = texture.GetAtlasUvRect();
+		sprite.texture = atlasPage;
+		sprite.uvRect = glm::vec4(uvRect.x, uvRect.y, uvRect.z, uvRect.w);
+	}
+	else
+	{
+		sprite.texture = &texture;
+		sprite.uvRect = glm::vec4(0, 0, 1, 1);
+	}
+	sprite.orderInLayer = orderInLayer;
+	sprite.order = static_cast<uint32_t>(s_batchedSprites.size());
+	sprite.isFlipped = isFlipped;
+	s_batchedSprites.push_back(sprite);
+}
+
+void SpriteManager::FlushSpriteBatch()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (s_batchedSprites.empty())
+		return;
+
+	SCOPED_PROFILER("SpriteManager::FlushSpriteBatch", scopeBenchmark);
+
+	// Sort indices instead of the sprites, a sprite is much bigger than an index
+	const size_t spriteCount = s_batchedSprites.size();
+	s_sortedBatchedSpriteIndices.resize(spriteCount);
+	for (size_t i = 0; i < spriteCount; i++)
+	{
+		s_sortedBatchedSpriteIndices[i] = static_cast<uint32_t>(i);
+	}
+
+	std::sort(s_sortedBatchedSpriteIndices.begin(), s_sortedBatchedSpriteIndices.end(), [](uint32_t a, uint32_t b)
+		{
+			const BatchedSprite& spriteA = s_batchedSprites[a];
+			const BatchedSprite& spriteB = s_batchedSprites[b];
+			// The sprites are transparent and drawn without depth, the addition order has to be kept in a layer
+			if (spriteA.orderInLayer != spriteB.orderInLayer)
+				return spriteA.orderInLayer < spriteB.orderInLayer;
+			return spriteA.order < spriteB.order;
+		});
+
+	// Split the sorted sprites in batches of consecutive sprites sharing the same material and texture
+	size_t batchStart = 0;
+	for (size_t i = 1; i <= spriteCount; i++)
+	{
+		bool isNewBatch = i == spriteCount || i - batchStart == SPRITE_BATCH_MAX_SPRITE_COUNT;
+		if (!isNewBatch)
+		{
+			const BatchedSprite& firstSprite = s_batchedSprites[s_sortedBatchedSpriteIndices[batchStart]];
+			const BatchedSprite& sprite = s_batchedSprites[s_sortedBatchedSpriteIndices[i]];
+			isNewBatch = sprite.material != firstSprite.material || sprite.texture != firstSprite.texture;
+#if !defined(SPRITE_MANAGER_USE_VERTEX_COLOR)
+			// The color is given to the whole mesh
+			isNewBatch = isNewBatch || sprite.color.GetUnsignedIntRGBA() != firstSprite.color.GetUnsignedIntRGBA();
+#endif
+		}
+
+		if (isNewBatch)
+		{
+			DrawBatch(batchStart, i - batchStart);
+			batchStart = i;
+		}
+	}
+
+	s_batchedSprites.clear();
+}
+
+void SpriteManager::NewFrame()
+{
+#if defined(__PSP__)
+	// The GPU has finished the previous frame, its vertex memory can be written again
+	s_batchVertexBlockIndex = 0;
+	s_batchVertexBlockOffset = 0;
+#elif !defined(__vita__) && !defined(_WIN32) && !defined(_WIN64) && !defined(__LINUX__)
+	s_usedBatchMeshCount = 0;
+#endif
+}
+
+MeshData& SpriteManager::GetBatchMesh(size_t count)
+{
+#if defined(__vita__) || defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	// The vertices are copied to the GPU when the batch is drawn, the same mesh is rewritten for each batch
+	if (!s_batchMesh)
+	{
+		const unsigned int vertexCount = SPRITE_BATCH_MAX_SPRITE_COUNT * 6;
+#if defined(SPRITE_MANAGER_USE_VERTEX_COLOR)
+		s_batchMesh = MeshData::MakeMeshData(vertexCount, vertexCount, true, false, true);
+#else
+		s_batchMesh = MeshData::MakeMeshData(vertexCount, vertexCount, false, false, true);
+#endif
+		s_batchMesh->m_hasIndices = true;
+
+		// The indices never change
+		MeshData::SubMesh& subMesh = *s_batchMesh->m_subMeshes[0];
+		for (unsigned int i = 0; i < vertexCount; i++)
+		{
+			if (subMesh.isShortIndices)
+				static_cast<unsigned short*>(subMesh.indices)[i] = static_cast<unsigned short>(i);
+			else
+				static_cast<unsigned int*>(subMesh.indices)[i] = i;
+		}
+		s_batchMesh->OnLoadFileReferenceFinished();
+	}
+	(void)count;
+	return *s_batchMesh;
+#elif defined(__PSP__)
+	// The GPU reads the vertices from the memory while drawing, each batch of the frame writes its vertices after the previous batch
+	if (!s_batchMesh)
+	{
+#if defined(SPRITE_MANAGER_USE_VERTEX_COLOR)
+		s_batchMesh = MeshData::MakeMeshData(6, 0, true, false, true);
+#else
+		s_batchMesh = MeshData::MakeMeshData(6, 0, false, false, true);
+#endif
+		// Drawn without indices, the vertices are already in order
+		s_batchMesh->m_hasIndices = false;
+		s_batchMesh->OnLoadFileReferenceFinished();
+
+		MeshData::SubMesh& subMesh = *s_batchMesh->m_subMeshes[0];
+		s_batchVertexSize = subMesh.vertexMemSize / 6;
+		subMesh.FreeData();
+		subMesh.isExternalData = true;
+	}
+
+	const size_t blockSize = SPRITE_BATCH_MAX_SPRITE_COUNT * 6 * s_batchVertexSize;
+	const size_t batchSize = count * 6 * s_batchVertexSize;
+	if (s_batchVertexBlockOffset + batchSize > blockSize)
+	{
+		s_batchVertexBlockIndex++;
+		s_batchVertexBlockOffset = 0;
+	}
+	// The blocks are kept for the next frames, only the peak vertex count of a frame is allocated
+	if (s_batchVertexBlockIndex == s_batchVertexBlocks.size())
+	{
+		s_batchVertexBlocks.push_back(memalign(16, blockSize));
+	}
+	s_batchMesh->m_subMeshes[0]->data = static_cast<uint8_t*>(s_batchVertexBlocks[s_batchVertexBlockIndex]) + s_batchVertexBlockOffset;
+	s_batchVertexBlockOffset += batchSize;
+	return *s_batchMesh;
+#else
+	// The GPU reads the vertices from the memory while drawing, one mesh per batch drawn during the frame
+	if (s_usedBatchMeshCount == s_batchMeshes.size())
+	{
+		const unsigned int vertexCount = SPRITE_BATCH_MAX_SPRITE_COUNT * 6;
+#if defined(SPRITE_MANAGER_USE_VERTEX_COLOR)
+		std::shared_ptr<MeshData> batchMesh = MeshData::MakeMeshData(vertexCount, vertexCount, true, false, true);
+#else
+		std::shared_ptr<MeshData> batchMesh = MeshData::MakeMeshData(vertexCount, vertexCount, false, false, true);
+#endif
+		batchMesh->m_hasIndices = true;
+
+		// The indices never change
+		MeshData::SubMesh& subMesh = *batchMesh->m_subMeshes[0];
+		for (unsigned int i = 0; i < vertexCount; i++)
+		{
+			if (subMesh.isShortIndices)
+				static_cast<unsigned short*>(subMesh.indices)[i] = static_cast<unsigned short>(i);
+			else
+				static_cast<unsigned int*>(subMesh.indices)[i] = i;
+		}
+		batchMesh->OnLoadFileReferenceFinished();
+		s_batchMeshes.push_back(std::move(batchMesh));
+	}
+	(void)count;
+	return *s_batchMeshes[s_usedBatchMeshCount++];
+#endif
+}
+
+void SpriteManager::DrawBatch(size_t firstIndex, size_t count)
+{
+	XASSERT(count != 0 && count <= SPRITE_BATCH_MAX_SPRITE_COUNT, "[SpriteManager::DrawBatch] Invalid sprite count");
+
+	// 6 vertices per sprite because the PS2 renderer does not support indices
+	MeshData& batchMesh = GetBatchMesh(count);
+
+	// Corners and uvs of the two triangles of the sprite mesh (indices 0 2 1, 2 0 3), reversed for the flipped sprites
+	static constexpr int cornerIndices[6] = { 0, 2, 1, 2, 0, 3 };
+	static constexpr int flippedCornerIndices[6] = { 1, 2, 0, 3, 0, 2 };
+	static constexpr float cornersU[4] = { 1, 0, 0, 1 };
+	static constexpr float cornersV[4] = { 1, 1, 0, 0 };
+
+	// Only draw the written sprites
+	MeshData::SubMesh& subMesh = *batchMesh.m_subMeshes[0];
+	subMesh.vertice_count = static_cast<uint32_t>(count * 6);
+	subMesh.index_count = batchMesh.m_hasIndices ? subMesh.vertice_count : 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		const BatchedSprite& sprite = s_batchedSprites[s_sortedBatchedSpriteIndices[firstIndex + i]];
+		const int* usedCornerIndices = sprite.isFlipped ? flippedCornerIndices : cornerIndices;
+
+#if defined(SPRITE_MANAGER_USE_VERTEX_COLOR)
+		const RGBA& rgba = sprite.color.GetRGBA();
+#if defined(__PSP__)
+		const unsigned int color = sprite.color.GetUnsignedIntABGR();
+#endif
+		Vertex* vertices = static_cast<Vertex*>(subMesh.data) + i * 6;
+#endif
+		for (size_t vertexIndex = 0; vertexIndex < 6; vertexIndex++)
+		{
+			const int corner = usedCornerIndices[vertexIndex];
+			const glm::vec3& position = sprite.corners[corner];
+			const float u = sprite.uvRect.x + cornersU[corner] * sprite.uvRect.z;
+			const float v = sprite.uvRect.y + cornersV[corner] * sprite.uvRect.w;
+#if defined(SPRITE_MANAGER_USE_VERTEX_COLOR)
+			Vertex& vertex = vertices[vertexIndex];
+			vertex.u = u;
+			vertex.v = v;
+#if defined(__PSP__)
+			vertex.color = color;
+#else
+			vertex.r = rgba.r;
+			vertex.g = rgba.g;
+			vertex.b = rgba.b;
+			vertex.a = rgba.a;
+#endif
+			vertex.x = position.x;
+			vertex.y = position.y;
+			vertex.z = position.z;
+#else
+			batchMesh.AddVertex(u, v, position.x, position.y, position.z, static_cast<unsigned int>(i * 6 + vertexIndex), 0);
+#endif
+		}
+	}
+
+	const BatchedSprite& firstSprite = s_batchedSprites[s_sortedBatchedSpriteIndices[firstIndex]];
+#if !defined(SPRITE_MANAGER_USE_VERTEX_COLOR)
+	batchMesh.unifiedColor = firstSprite.color;
+#endif
+
+#if defined(__vita__) || defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	batchMesh.SendDataToGpu();
+#elif defined(__PSP__)
+	sceKernelDcacheWritebackInvalidateAll(); // Very important
+#endif
+
+	// The flipped sprites have been written in the other winding order, the faces never need to be inverted
+	RenderingSettings renderSettings = RenderingSettings();
+	renderSettings.invertFaces = false;
+	renderSettings.renderingMode = MaterialRenderingModes::Transparent;
+	renderSettings.useDepth = false;
+	renderSettings.useTexture = true;
+	renderSettings.useLighting = false;
+
+	// The corners are already in world space
+	static const glm::mat4 identityMatrix = glm::mat4(1);
+	Graphics::DrawSubMesh(subMesh, *firstSprite.material, firstSprite.texture, renderSettings, identityMatrix, false);
+
+	Performance::AddSpriteBatch(static_cast<int>(count));
+}
+
 void SpriteManager::Render2DLine(const std::shared_ptr<MeshData>& meshData)
 {
 	XASSERT(meshData != nullptr, "[SpriteManager::Render2DLine] meshData is nullptr");
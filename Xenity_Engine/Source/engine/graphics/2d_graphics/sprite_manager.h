@@ -11,13 +11,24 @@
  */
 
 #include <memory>
+#include <vector>
+#include <cstdint>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 #include <engine/api.h>
+#include <engine/graphics/color/color.h>
+
+// The PS3 and PS2 renderers do not support vertex colors, a sprite batch is split when the color changes on these platforms
+#if !defined(__PS3__) && !defined(_EE)
+#define SPRITE_MANAGER_USE_VERTEX_COLOR
+#endif
 
 class Vector3;
 class MeshData;
 class Texture;
-class Color;
 class Transform;
 class Material;
 class Quaternion;
@@ -51,6 +62,38 @@ public:
 	*/
 	static void DrawSprite(const Transform& transform, const Color& color, Material& material, Texture* texture);
 
+	/**
+	* @brief Add a sprite to the sprite batch, the sprite is drawn by the next FlushSpriteBatch call
+	* @param transform Sprite's transform
+	* @param color Sprite's color
+	* @param material Sprite's material
+	* @param texture Sprite's texture
+	* @param orderInLayer Sprites with a lower order are drawn first
+	*/
+	static void AddSpriteToBatch(const Transform& transform, const Color& color, Material& material, Texture& texture, int orderInLayer);
+
+	/**
+	* @brief Add a sprite to the sprite batch, the sprite is drawn by the next FlushSpriteBatch call
+	* @param position Sprite's position
+	* @param rotation Sprite's roation
+	* @param scale Sprite's scale
+	* @param color Sprite's color
+	* @param material Sprite's material
+	* @param texture Sprite's texture
+	* @param orderInLayer Sprites with a lower order are drawn first
+	*/
+	static void AddSpriteToBatch(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const Color& color, Material& material, Texture& texture, int orderInLayer);
+
+	/**
+	* @brief [Internal] Sort the batched sprites by layer (keeping the addition order in a layer) and draw the consecutive sprites sharing the same material and texture with one draw call
+	*/
+	static void FlushSpriteBatch();
+
+	/**
+	* @brief [Internal] Reuse the batch vertex memory of the previous frame, called once per frame before drawing
+	*/
+	static void NewFrame();
+
 	/**
 	* @brief Render a 2D line
 	* @param meshData Mesh data
@@ -63,5 +106,55 @@ public:
 	}
 
 private:
+	/**
+	* @brief Sprite waiting to be drawn, with its corners in world space
+	*/
+	struct BatchedSprite
+	{
+		glm::vec3 corners[4];
+		Color color;
+		Material* material;
+		Texture* texture; // Atlas page if the sprite texture is packed in an atlas
+		glm::vec4 uvRect; // Area of the texture in the atlas page (x, y, width, height)
+		int orderInLayer;
+		uint32_t order; // Order of addition, the sprites of the same layer are drawn in this order
+		bool isFlipped; // True if the scale flips the sprite, the triangles are written in the other winding order
+	};
+
+	/**
+	* @brief Add a sprite with its model matrix (with the size of the texture applied)
+	*/
+	static void AddSpriteToBatch(const glm::mat4& matrix, bool isFlipped, const Color& color, Material& material, Texture& texture, int orderInLayer);
+
+	/**
+	* @brief Draw sorted sprites that share the same material and texture with one draw call
+	* @param firstIndex Index of the first sprite in s_sortedBatchedSpriteIndices
+	* @param count Number of sprites (<= SPRITE_BATCH_MAX_SPRITE_COUNT)
+	*/
+	static void DrawBatch(size_t firstIndex, size_t count);
+
+	/**
+	* @brief Get the mesh where to write the vertices of a batch
+	* @param count Number of sprites of the batch
+	*/
+	static MeshData& GetBatchMesh(size_t count);
+
 	static std::shared_ptr <MeshData> s_spriteMeshData;
+	static std::vector<BatchedSprite> s_batchedSprites;
+	static std::vector<uint32_t> s_sortedBatchedSpriteIndices;
+#if defined(__vita__) || defined(_WIN32) || defined(_WIN64) || defined(__LINUX__) || defined(__PSP__)
+	// Streaming mesh shared by all the batches
+	static std::shared_ptr<MeshData> s_batchMesh;
+#if defined(__PSP__)
+	// Vertex memory of the batches drawn during the frame, the mesh points to the vertices of the drawn batch
+	static std::vector<void*> s_batchVertexBlocks;
+	static size_t s_batchVertexBlockIndex;
+	static size_t s_batchVertexBlockOffset;
+	static size_t s_batchVertexSize;
+#endif
+#else
+	// Streaming meshes, one per batch drawn during the frame, a mesh is not rewritten while the GPU can still use it
+	static std::vector<std::shared_ptr<MeshData>> s_batchMeshes;
+	static size_t s_usedBatchMeshCount;
+#endif
 };
\ No newline at end of file
@@ -35,7 +35,7 @@ void SpriteRenderer::OnReflectionUpdated()
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 SpriteRenderer::~SpriteRenderer()
@@ -62,33 +62,32 @@ void SpriteRenderer::CreateRenderCommands(RenderBatch& renderBatch)
 	command.transform = GetTransformRaw();
 	command.isEnabled = IsEnabled() && GetGameObjectRaw()->IsLocalActive();
 
-	renderBatch.spriteCommands.push_back(command);
-	renderBatch.spriteCommandIndex++;
+	renderBatch.AddCommand(command, RenderQueueType::Sprite);
 }
 
 void SpriteRenderer::SetMaterial(const std::shared_ptr<Material>& material)
 {
 	m_material = material;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 void SpriteRenderer::SetTexture(const std::shared_ptr<Texture>& texture)
 {
 	m_texture = texture;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 void SpriteRenderer::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void SpriteRenderer::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void SpriteRenderer::DrawCommand([[maybe_unused]] const RenderCommand& renderCommand)
 {
-	SpriteManager::DrawSprite(*GetTransformRaw(), m_color, *m_material, m_texture.get());
+	SpriteManager::AddSpriteToBatch(*GetTransformRaw(), m_color, *m_material, *m_texture, m_orderInLayer);
 }
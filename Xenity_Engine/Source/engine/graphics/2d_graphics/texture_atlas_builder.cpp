@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "texture_atlas_builder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <malloc.h>
+
+#include <engine/graphics/texture.h>
+#include <engine/graphics/2d_graphics/texture_atlas_packer.h>
+#include <engine/file_system/async_file_loading.h>
+#include <engine/debug/debug.h>
+#include <engine/debug/performance.h>
+#include <engine/debug/memory_tracker.h>
+#include <engine/assertions/assertions.h>
+#include <engine/debug/stack_debug_object.h>
+
+std::vector<std::shared_ptr<Texture>> TextureAtlasBuilder::PackTextures(const std::vector<std::shared_ptr<Texture>>& textures, int pageSize)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	XASSERT(pageSize > 0, "[TextureAtlasBuilder::PackTextures] Invalid page size");
+
+	struct TextureToPack
+	{
+		Texture* texture;
+		unsigned char* pixels;
+		int width;
+		int height;
+		int pageGroup;
+	};
+
+	// Read the pixels again, the loaded textures only have their GPU copy
+	std::vector<TextureToPack> texturesToPack;
+	for (const std::shared_ptr<Texture>& texture : textures)
+	{
+		// The textures of a page can't repeat, the neighbour textures would be sampled
+		if (!texture || texture->m_atlasPage || texture->GetWrapMode() != WrapMode::ClampToEdge)
+			continue;
+
+#if defined(EDITOR)
+		if (!texture->m_file)
+			continue;
+#else
+		if (texture->m_fileSize == 0)
+			continue;
+#endif
+
+		// The file can't be read while a worker thread is loading it
+		AsyncFileLoading::WaitForFile(*texture);
+
+		int width = 0;
+		int height = 0;
+		int channelCount = 0;
+		unsigned char* pixels = texture->ReadPixels(width, height, channelCount);
+		if (!pixels)
+			continue;
+
+		if (!CanBePacked(width, height, pageSize))
+		{
+			free(pixels);
+			continue;
+		}
+
+		// A page only has textures with the same filter (and the same pixel format on PSP)
+		int pageGroup = static_cast<int>(texture->GetFilter());
+#if defined(__PSP__)
+		pageGroup |= static_cast<int>(static_cast<const TextureSettingsPSP&>(*texture->m_settings[AssetPlatform::AP_PSP]).type) << 8;
+#endif
+
+		texturesToPack.push_back({ texture.get(), pixels, width, height, pageGroup });
+	}
+
+	// The tallest textures first give a flatter skyline
+	std::sort(texturesToPack.begin(), texturesToPack.end(), [](const TextureToPack& a, const TextureToPack& b)
+		{
+			return a.height > b.height;
+		});
+
+	struct AtlasPage
+	{
+		TextureAtlasPacker packer;
+		unsigned char* pixels;
+		int pageGroup;
+		Texture* firstTexture;
+		std::vector<std::pair<Texture*, Vector4>> regions;
+	};
+
+	std::vector<AtlasPage> pages;
+	for (const TextureToPack& textureToPack : texturesToPack)
+	{
+		const int packedWidth = textureToPack.width + BORDER_SIZE * 2;
+		const int packedHeight = textureToPack.height + BORDER_SIZE * 2;
+
+		AtlasPage* usedPage = nullptr;
+		int x = 0;
+		int y = 0;
+		for (AtlasPage& page : pages)
+		{
+			if (page.pageGroup == textureToPack.pageGroup && page.packer.Insert(packedWidth, packedHeight, x, y))
+			{
+				usedPage = &page;
+				break;
+			}
+		}
+
+		if (!usedPage)
+		{
+			pages.push_back({ TextureAtlasPacker(pageSize, pageSize), static_cast<unsigned char*>(calloc(static_cast<size_t>(pageSize) * pageSize * 4, 1)), textureToPack.pageGroup, textureToPack.texture, {} });
+			usedPage = &pages.back();
+			// Always fits in an empty page, the size has been checked by CanBePacked
+			usedPage->packer.Insert(packedWidth, packedHeight, x, y);
+		}
+
+		CopyPixelsToPage(usedPage->pixels, pageSize, textureToPack.pixels, textureToPack.width, textureToPack.height, x, y);
+		usedPage->regions.push_back({ textureToPack.texture, GetUvRect(pageSize, pageSize, x, y, textureToPack.width, textureToPack.height) });
+		free(textureToPack.pixels);
+	}
+
+	std::vector<std::shared_ptr<Texture>> atlasPages;
+	size_t packedTextureCount = 0;
+	for (AtlasPage& page : pages)
+	{
+		// A page with only one texture does not remove any texture change
+		if (page.regions.size() == 1)
+		{
+			free(page.pixels);
+			continue;
+		}
+
+		std::shared_ptr<Texture> atlasPage = Texture::MakeTexture();
+		atlasPage->SetSize(pageSize, pageSize);
+		atlasPage->SetChannelCount(4);
+		atlasPage->SetFilter(page.firstTexture->GetFilter());
+		atlasPage->SetWrapMode(WrapMode::ClampToEdge);
+#if defined(__PSP__)
+		static_cast<TextureSettingsPSP&>(*atlasPage->m_settings[AssetPlatform::AP_PSP]).type = static_cast<const TextureSettingsPSP&>(*page.firstTexture->m_settings[AssetPlatform::AP_PSP]).type;
+#endif
+
+		// Uploaded like a loaded texture file, the buffer is freed by the upload
+		atlasPage->m_buffer = page.pixels;
+#if defined (DEBUG)
+		Performance::s_textureMemoryTracker->Allocate(pageSize * pageSize * 4);
+#endif
+		atlasPage->OnLoadFileReferenceFinished();
+		atlasPage->SetFileStatus(FileStatus::FileStatus_Loaded);
+
+		for (const std::pair<Texture*, Vector4>& region : page.regions)
+		{
+			region.first->SetAtlasRegion(atlasPage, region.second);
+		}
+		packedTextureCount += page.regions.size();
+		atlasPages.push_back(std::move(atlasPage));
+	}
+
+	Debug::Print("[TextureAtlasBuilder::PackTextures] " + std::to_string(packedTextureCount) + " textures packed in " + std::to_string(atlasPages.size()) + " pages", true);
+
+	return atlasPages;
+}
+
+void TextureAtlasBuilder::CopyPixelsToPage(uint8_t* pagePixels, int pageWidth, const uint8_t* pixels, int width, int height, int x, int y)
+{
+	XASSERT(pagePixels != nullptr, "[TextureAtlasBuilder::CopyPixelsToPage] pagePixels is nullptr");
+	XASSERT(pixels != nullptr, "[TextureAtlasBuilder::CopyPixelsToPage] pixels is nullptr");
+
+	const int packedHeight = height + BORDER_SIZE * 2;
+	for (int row = 0; row < packedHeight; row++)
+	{
+		const int sourceRow = std::min(std::max(row - BORDER_SIZE, 0), height - 1);
+		const uint8_t* sourceLine = pixels + static_cast<size_t>(sourceRow) * width * 4;
+		uint8_t* destinationLine = pagePixels + (static_cast<size_t>(y + row) * pageWidth + x) * 4;
+
+		// Left border, line, right border
+		for (int i = 0; i < BORDER_SIZE; i++)
+		{
+			memcpy(destinationLine + i * 4, sourceLine, 4);
+			memcpy(destinationLine + (BORDER_SIZE + width + i) * 4, sourceLine + (width - 1) * 4, 4);
+		}
+		memcpy(destinationLine + BORDER_SIZE * 4, sourceLine, static_cast<size_t>(width) * 4);
+	}
+}
+
+Vector4 TextureAtlasBuilder::GetUvRect(int pageWidth, int pageHeight, int x, int y, int width, int height)
+{
+	return Vector4(
+		static_cast<float>(x + BORDER_SIZE) / pageWidth,
+		static_cast<float>(y + BORDER_SIZE) / pageHeight,
+		static_cast<float>(width) / pageWidth,
+		static_cast<float>(height) / pageHeight);
+}
+
+bool TextureAtlasBuilder::CanBePacked(int width, int height, int pageSize)
+{
+	// Bigger textures would waste most of a page
+	return width > 0 && height > 0 && width + BORDER_SIZE * 2 <= pageSize / 2 && height + BORDER_SIZE * 2 <= pageSize / 2;
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <engine/api.h>
+#include <engine/vectors/vector4.h>
+
+class Texture;
+
+/**
+* @brief Class to pack small textures in atlas pages, so the sprites using them can be drawn in the same batch
+* The cooker packs the textures with the "packInAtlas" setting, PackTextures is for the textures loaded at runtime
+*/
+class API TextureAtlasBuilder
+{
+public:
+	/**
+	* @brief Pack textures in new atlas pages, the sprites using these textures are then drawn with the pages
+	* The pages are kept until the textures are unloaded
+	* @param textures Textures to pack, the textures bigger than half of a page, already packed or not using the ClampToEdge wrap mode are ignored
+	* @param pageSize Width and height of the pages (power of two)
+	* @return The created pages
+	*/
+	static std::vector<std::shared_ptr<Texture>> PackTextures(const std::vector<std::shared_ptr<Texture>>& textures, int pageSize);
+
+	/**
+	* @brief Copy RGBA pixels in a page and repeat the border pixels around them (avoids color bleeding with the bilinear filter)
+	* @param x Left of the area with the border
+	* @param y Top of the area with the border
+	*/
+	static void CopyPixelsToPage(uint8_t* pagePixels, int pageWidth, const uint8_t* pixels, int width, int height, int x, int y);
+
+	/**
+	* @brief Get the uv area (x, y, width, height) of pixels copied in a page with CopyPixelsToPage
+	*/
+	static Vector4 GetUvRect(int pageWidth, int pageHeight, int x, int y, int width, int height);
+
+	/**
+	* @brief Get if a texture is small enough to be packed in a page
+	*/
+	static bool CanBePacked(int width, int height, int pageSize);
+
+	/**
+	* @brief Number of pixels repeated around each texture in a page
+	*/
+	static constexpr int BORDER_SIZE = 1;
+};
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "texture_atlas_packer.h"
+
+#include <limits>
+
+#include <engine/assertions/assertions.h>
+
+TextureAtlasPacker::TextureAtlasPacker(int width, int height) : m_width(width), m_height(height)
+{
+	XASSERT(width > 0 && height > 0, "[TextureAtlasPacker::TextureAtlasPacker] Invalid page size");
+
+	Clear();
+}
+
+void TextureAtlasPacker::Clear()
+{
+	m_skyline.clear();
+	m_skyline.push_back({ 0, 0, m_width });
+	m_usedArea = 0;
+}
+
+bool TextureAtlasPacker::Insert(int width, int height, int& x, int& y)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	// Keep the position with the lowest top edge, then the one that wastes the smallest segment
+	int bestBottom = std::numeric_limits<int>::max();
+	int bestWidth = std::numeric_limits<int>::max();
+	size_t bestIndex = 0;
+	bool isFound = false;
+
+	const size_t nodeCount = m_skyline.size();
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		const int nodeY = FindPositionForNode(i, width, height);
+		if (nodeY < 0)
+			continue;
+
+		const int bottom = nodeY + height;
+		if (bottom < bestBottom || (bottom == bestBottom && m_skyline[i].width < bestWidth))
+		{
+			bestBottom = bottom;
+			bestWidth = m_skyline[i].width;
+			bestIndex = i;
+			x = m_skyline[i].x;
+			y = nodeY;
+			isFound = true;
+		}
+	}
+
+	if (!isFound)
+		return false;
+
+	AddSkylineLevel(bestIndex, x, y, width, height);
+	m_usedArea += static_cast<uint64_t>(width) * height;
+	return true;
+}
+
+float TextureAtlasPacker::GetOccupancy() const
+{
+	return static_cast<float>(m_usedArea) / (static_cast<float>(m_width) * m_height);
+}
+
+int TextureAtlasPacker::FindPositionForNode(size_t nodeIndex, int width, int height) const
+{
+	if (m_skyline[nodeIndex].x + width > m_width)
+		return -1;
+
+	// The rectangle rests on the highest node under it
+	int y = m_skyline[nodeIndex].y;
+	int widthLeft = width;
+	size_t i = nodeIndex;
+	while (widthLeft > 0)
+	{
+		XASSERT(i < m_skyline.size(), "[TextureAtlasPacker::FindPositionForNode] The skyline does not cover the page");
+
+		if (m_skyline[i].y > y)
+			y = m_skyline[i].y;
+		if (y + height > m_height)
+			return -1;
+
+		widthLeft -= m_skyline[i].width;
+		i++;
+	}
+	return y;
+}
+
+void TextureAtlasPacker::AddSkylineLevel(size_t nodeIndex, int x, int y, int width, int height)
+{
+	m_skyline.insert(m_skyline.begin() + nodeIndex, { x, y + height, width });
+
+	// Shrink or remove the nodes now under the new node
+	const int newNodeRight = x + width;
+	size_t i = nodeIndex + 1;
+	while (i < m_skyline.size() && m_skyline[i].x < newNodeRight)
+	{
+		const int shrink = newNodeRight - m_skyline[i].x;
+		if (m_skyline[i].width <= shrink)
+		{
+			m_skyline.erase(m_skyline.begin() + i);
+		}
+		else
+		{
+			m_skyline[i].x += shrink;
+			m_skyline[i].width -= shrink;
+			break;
+		}
+	}
+
+	// Merge the neighbour nodes at the same height
+	i = 0;
+	while (i + 1 < m_skyline.size())
+	{
+		if (m_skyline[i].y == m_skyline[i + 1].y)
+		{
+			m_skyline[i].width += m_skyline[i + 1].width;
+			m_skyline.erase(m_skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
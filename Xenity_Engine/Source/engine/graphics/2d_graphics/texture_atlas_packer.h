@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <engine/api.h>
+
+/**
+* @brief Skyline bottom-left rectangle packer used to place textures in atlas pages
+* Does not store any pixel, only finds the free positions
+*/
+class API TextureAtlasPacker
+{
+public:
+	TextureAtlasPacker() = delete;
+	TextureAtlasPacker(int width, int height);
+
+	/**
+	* @brief Find a free position for a rectangle and reserve it
+	* @param width Rectangle width
+	* @param height Rectangle height
+	* @param x Position of the rectangle in the page (left)
+	* @param y Position of the rectangle in the page (top)
+	* @return False if the page has no space left for the rectangle
+	*/
+	bool Insert(int width, int height, int& x, int& y);
+
+	/**
+	* @brief Remove all rectangles
+	*/
+	void Clear();
+
+	/**
+	* @brief Get the used area of the page between 0 and 1
+	*/
+	float GetOccupancy() const;
+
+	inline int GetWidth() const
+	{
+		return m_width;
+	}
+
+	inline int GetHeight() const
+	{
+		return m_height;
+	}
+
+private:
+	/**
+	* @brief Segment of the top edge of the packed rectangles
+	*/
+	struct SkylineNode
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	/**
+	* @brief Get the y position of a rectangle placed at the left of a node
+	* @return -1 if the rectangle does not fit
+	*/
+	int FindPositionForNode(size_t nodeIndex, int width, int height) const;
+
+	/**
+	* @brief Raise the skyline above a new rectangle
+	*/
+	void AddSkylineLevel(size_t nodeIndex, int x, int y, int width, int height);
+
+	std::vector<SkylineNode> m_skyline;
+	int m_width = 0;
+	int m_height = 0;
+	uint64_t m_usedArea = 0;
+};
@@ -14,15 +14,22 @@
 #endif
 #include <math.h>
 #include <malloc.h>
+#include <algorithm>
+#if defined(__PSP__)
+#include <pspkernel.h>
+#endif
 
 #include <engine/graphics/graphics.h>
 #include <engine/graphics/texture.h>
+#include <engine/graphics/material.h>
 #include <engine/graphics/camera.h>
 #include <engine/graphics/3d_graphics/mesh_manager.h>
 #include <engine/graphics/3d_graphics/mesh_data.h>
 #include <engine/asset_management/asset_manager.h>
 #include <engine/game_elements/gameobject.h>
 #include <engine/game_elements/transform.h>
+#include <engine/tools/profiler_benchmark.h>
+#include <engine/debug/performance.h>
 #include "sprite_manager.h"
 
 
@@ -36,6 +43,8 @@ Tilemap::Tilemap()
 Tilemap::~Tilemap()
 {
 	AssetManager::RemoveReflection(this);
+	DeleteChunks();
+	free(tiles);
 }
 
 ReflectiveData Tilemap::GetReflectiveData()
@@ -44,6 +53,7 @@ ReflectiveData Tilemap::GetReflectiveData()
 	Reflective::AddVariable(reflectedVariables, width, "width", true);
 	Reflective::AddVariable(reflectedVariables, height, "height", true);
 	Reflective::AddVariable(reflectedVariables, color, "color", true);
+	Reflective::AddVariable(reflectedVariables, m_material, "material", true);
 	return reflectedVariables;
 }
 
@@ -87,20 +97,23 @@ void Tilemap::Setup(int _width, int _height, int _chunkSize)
 	}
 
 	// Create chunk
-	chunkCount = (int)ceil(_width / (float)_chunkSize);
-	for (int x = 0; x < chunkCount; x++)
+	DeleteChunks();
+	chunkCountX = (int)ceil(_width / (float)_chunkSize);
+	chunkCountY = (int)ceil(_height / (float)_chunkSize);
+	for (int y = 0; y < chunkCountY; y++)
 	{
-		for (int y = 0; y < chunkCount; y++)
+		for (int x = 0; x < chunkCountX; x++)
 		{
 			TilemapChunk* chunk = new TilemapChunk();
 			chunks.push_back(chunk);
 		}
 	}
+	dirtyMeshes = true;
 }
 
 Tilemap::Tile* Tilemap::GetTile(int x, int y) const
 {
-	if (tiles == nullptr || x < 0 || y < 0 || x >= height || y >= height)
+	if (tiles == nullptr || x < 0 || y < 0 || x >= width || y >= height)
 		return nullptr;
 
 	return &tiles[x * height + y];
@@ -123,47 +136,140 @@ void Tilemap::SetTile(int x, int y, int textureId)
 {
 	Tile* tile = GetTile(x, y);
 	// If the tile exists
-	if (tile)
+	if (tile && tile->textureId != textureId)
 	{
 		needUpdateVertices = true;
 		tile->textureId = textureId;
+
+		// Only the chunk of the tile is rebuilt
+		GetChunk(x / chunkSize, y / chunkSize)->isDirty = true;
 		dirtyMeshes = true;
 	}
 }
 
-void Tilemap::FillChunks()
+void Tilemap::RebuildDirtyChunks()
+{
+	SCOPED_PROFILER("Tilemap::RebuildDirtyChunks", scopeBenchmark);
+
+	for (int y = 0; y < chunkCountY; y++)
+	{
+		for (int x = 0; x < chunkCountX; x++)
+		{
+			if (GetChunk(x, y)->isDirty)
+			{
+				RebuildChunk(x, y);
+			}
+		}
+	}
+}
+
+void Tilemap::RebuildChunk(int xChunk, int yChunk)
 {
+	TilemapChunk& chunk = *GetChunk(xChunk, yChunk);
+	chunk.isDirty = false;
+
+	// Set vertices and indices per tile
+	int verticesPerTile = 4;
+	int indicesPerTile = 6;
+	if (!useIndices)
+	{
+		verticesPerTile = 6;
+		indicesPerTile = 0;
+	}
+
+	const int firstX = xChunk * chunkSize;
+	const int lastX = std::min(firstX + chunkSize, width);
+	const int firstY = yChunk * chunkSize;
+	const int lastY = std::min(firstY + chunkSize, height);
+
+	// Count the tiles of each texture (the texture 0 is the empty tile)
+	const size_t meshCount = textures.size() - 1;
+	std::vector<int> tileCounts(meshCount, 0);
+	for (int x = firstX; x < lastX; x++)
+	{
+		for (int y = firstY; y < lastY; y++)
+		{
+			const int textureId = GetTile(x, y)->textureId;
+			if (textureId != 0)
+			{
+				tileCounts[(size_t)textureId - 1]++;
+			}
+		}
+	}
+
+	// Keep the meshes (and their GPU buffers) with the same tile count, only their vertices are written again
+	for (size_t i = meshCount; i < chunk.meshes.size(); i++)
+	{
+		delete chunk.meshes[i];
+	}
+	chunk.meshes.resize(meshCount, nullptr);
+	chunk.meshTextures.resize(meshCount, nullptr);
+	std::vector<bool> isNewMesh(meshCount, false);
+	for (size_t i = 0; i < meshCount; i++)
+	{
+		MeshData*& mesh = chunk.meshes[i];
+		const int tileCount = tileCounts[i];
+		if (mesh && static_cast<int>(mesh->m_subMeshes[0]->vertice_count) != tileCount * verticesPerTile)
+		{
+			delete mesh;
+			mesh = nullptr;
+		}
+
+		if (!mesh && tileCount != 0)
+		{
+			mesh = new MeshData(verticesPerTile * tileCount, indicesPerTile * tileCount, false, false, true);
+			mesh->m_hasIndices = useIndices;
+			mesh->unifiedColor = color;
+			isNewMesh[i] = true;
+		}
+
+		if (mesh)
+		{
+			mesh->m_subMeshes[0]->index_count = 0;
+			mesh->m_subMeshes[0]->vertice_count = 0;
+
+			// The uvs are remapped to the atlas page if the texture is packed
+			chunk.meshTextures[i] = drawTextures[i + 1];
+		}
+	}
+
 	// Fill meshes
-	for (int x = 0; x < width; x++)
+	for (int x = firstX; x < lastX; x++)
 	{
-		int xChunk = (int)floor(x / (float)chunkSize);
-		for (int y = 0; y < height; y++)
+		for (int y = firstY; y < lastY; y++)
 		{
 			Tile* tile = GetTile(x, y);
 			if (tile->textureId != 0)
 			{
-				int yChunk = (int)floor(y / (float)chunkSize);
-				MeshData* mesh = chunks[(size_t)xChunk + (size_t)yChunk * chunkCount]->meshes[(size_t)tile->textureId - 1];
+				MeshData* mesh = chunk.meshes[(size_t)tile->textureId - 1];
 				std::unique_ptr<MeshData::SubMesh>& subMesh = mesh->m_subMeshes[0];
 
 				int indiceOff = subMesh->index_count;
 				int verticeOff = subMesh->vertice_count;
 
-				float unitCoef = 100.0f / textures[tile->textureId]->GetPixelPerUnit();
-				float w = textures[tile->textureId]->GetWidth() * unitCoef;
-				float h = textures[tile->textureId]->GetHeight() * unitCoef;
+				const Texture* texture = textures[tile->textureId];
+				float unitCoef = 100.0f / texture->GetPixelPerUnit();
+				float w = texture->GetWidth() * unitCoef;
+				float h = texture->GetHeight() * unitCoef;
 				Vector2 spriteSize = Vector2(0.5f * w / 100.0f, 0.5f * h / 100.0f);
 
+				// Uvs of the texture area in its atlas page if the texture is packed
+				const Vector4 uvRect = chunk.meshTextures[(size_t)tile->textureId - 1] != texture ? texture->GetAtlasUvRect() : Vector4(0, 0, 1, 1);
+				const float u0 = uvRect.x;
+				const float u1 = uvRect.x + uvRect.z;
+				const float v0 = uvRect.y;
+				const float v1 = uvRect.y + uvRect.w;
+
 				if (!useIndices)
 				{
 					// Create tile with vertices only
-					mesh->AddVertex(1.0f, 1.0f, -spriteSize.x - x, -spriteSize.y + y, 0.0f, 0 + verticeOff, 0);
-					mesh->AddVertex(0.0f, 0.0f, spriteSize.x - x, spriteSize.y + y, 0.0f, 1 + verticeOff, 0);
-					mesh->AddVertex(0.0f, 1.0f, spriteSize.x - x, -spriteSize.y + y, 0.0f, 2 + verticeOff, 0);
+					mesh->AddVertex(u1, v1, -spriteSize.x - x, -spriteSize.y + y, 0.0f, 0 + verticeOff, 0);
+					mesh->AddVertex(u0, v0, spriteSize.x - x, spriteSize.y + y, 0.0f, 1 + verticeOff, 0);
+					mesh->AddVertex(u0, v1, spriteSize.x - x, -spriteSize.y + y, 0.0f, 2 + verticeOff, 0);
 
-					mesh->AddVertex(0.0f, 0.0f, spriteSize.x - x, spriteSize.y + y, 0.0f, 3 + verticeOff, 0);
-					mesh->AddVertex(1.0f, 1.0f, -spriteSize.x - x, -spriteSize.y + y, 0.0f, 4 + verticeOff, 0);
-					mesh->AddVertex(1.0f, 0.0f, -spriteSize.x - x, spriteSize.y + y, 0.0f, 5 + verticeOff, 0);
+					mesh->AddVertex(u0, v0, spriteSize.x - x, spriteSize.y + y, 0.0f, 3 + verticeOff, 0);
+					mesh->AddVertex(u1, v1, -spriteSize.x - x, -spriteSize.y + y, 0.0f, 4 + verticeOff, 0);
+					mesh->AddVertex(u1, v0, -spriteSize.x - x, spriteSize.y + y, 0.0f, 5 + verticeOff, 0);
 
 					subMesh->vertice_count += 6;
 				}
@@ -171,129 +277,171 @@ void Tilemap::FillChunks()
 				{
 					// Create tile with vertices and indices
 
-					mesh->AddVertex(1.0f, 1.0f, -spriteSize.x - x, -spriteSize.y + y, 0.0f, 0 + verticeOff, 0);
-					mesh->AddVertex(0.0f, 1.0f, spriteSize.x - x, -spriteSize.y + y, 0.0f, 1 + verticeOff, 0);
-					mesh->AddVertex(0.0f, 0.0f, spriteSize.x - x, spriteSize.y + y, 0.0f, 2 + verticeOff, 0);
-					mesh->AddVertex(1.0f, 0.0f, -spriteSize.x - x, spriteSize.y + y, 0.0f, 3 + verticeOff, 0);
-
-					subMesh->indices[0 + indiceOff] = 0 + verticeOff;
-					subMesh->indices[1 + indiceOff] = 2 + verticeOff;
-					subMesh->indices[2 + indiceOff] = 1 + verticeOff;
-					subMesh->indices[3 + indiceOff] = 2 + verticeOff;
-					subMesh->indices[4 + indiceOff] = 0 + verticeOff;
-					subMesh->indices[5 + indiceOff] = 3 + verticeOff;
+					mesh->AddVertex(u1, v1, -spriteSize.x - x, -spriteSize.y + y, 0.0f, 0 + verticeOff, 0);
+					mesh->AddVertex(u0, v1, spriteSize.x - x, -spriteSize.y + y, 0.0f, 1 + verticeOff, 0);
+					mesh->AddVertex(u0, v0, spriteSize.x - x, spriteSize.y + y, 0.0f, 2 + verticeOff, 0);
+					mesh->AddVertex(u1, v0, -spriteSize.x - x, spriteSize.y + y, 0.0f, 3 + verticeOff, 0);
+
+					static constexpr unsigned int tileIndices[6] = { 0, 2, 1, 2, 0, 3 };
+					for (int i = 0; i < 6; i++)
+					{
+						if (subMesh->isShortIndices)
+							static_cast<unsigned short*>(subMesh->indices)[i + indiceOff] = static_cast<unsigned short>(tileIndices[i] + verticeOff);
+						else
+							static_cast<unsigned int*>(subMesh->indices)[i + indiceOff] = tileIndices[i] + verticeOff;
+					}
 					subMesh->index_count += 6;
 					subMesh->vertice_count += 4;
 				}
 			}
 		}
 	}
+
+	// Upload the new vertices
+	bool isMeshReused = false;
+	for (size_t i = 0; i < meshCount; i++)
+	{
+		MeshData* mesh = chunk.meshes[i];
+		if (!mesh)
+			continue;
+
+		if (isNewMesh[i])
+		{
+			mesh->OnLoadFileReferenceFinished();
+		}
+		else
+		{
+#if defined(__vita__) || defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+			mesh->SendDataToGpu();
+#endif
+			isMeshReused = true;
+		}
+	}
+
+#if defined(__PSP__)
+	if (isMeshReused)
+	{
+		sceKernelDcacheWritebackInvalidateAll(); // Very important
+	}
+#else
+	(void)isMeshReused;
+#endif
 }
 
-void Tilemap::SetOrderInLayer(int orderInLayer)
+void Tilemap::SetAllChunksDirty()
 {
-	this->m_orderInLayer = orderInLayer;
-	Graphics::SetDrawOrderListAsDirty();
+	for (TilemapChunk* chunk : chunks)
+	{
+		chunk->isDirty = true;
+	}
+	dirtyMeshes = true;
 }
 
-void Tilemap::SetColor(const Color& color)
+void Tilemap::CheckAtlasPages()
 {
-	this->color = color;
-	for (int x = 0; x < chunkCount; x++)
+	// With the async loading, a page can be loaded after the chunks were built with the texture
+	const size_t textureCount = textures.size();
+	drawTextures.resize(textureCount, nullptr);
+	bool hasChanged = false;
+	for (size_t i = 1; i < textureCount; i++)
 	{
-		for (int y = 0; y < chunkCount; y++)
+		Texture* atlasPage = textures[i]->GetAtlasPage();
+		Texture* drawTexture = atlasPage ? atlasPage : textures[i];
+		if (drawTextures[i] != drawTexture)
 		{
-			TilemapChunk* chunk = chunks[(size_t)x + (size_t)y * chunkCount];
-
-			// Delete chunk meshes
-			int meshSize = (int)chunk->meshes.size();
-			for (int i = 0; i < meshSize; i++)
-			{
-				chunk->meshes[i]->unifiedColor = this->color;
-			}
+			drawTextures[i] = drawTexture;
+			hasChanged = true;
 		}
 	}
-}
 
-void Tilemap::CreateChunksMeshes()
-{
-	// Set vertices and indices per tile
-	int verticesPerTile = 4;
-	int indicesPerTile = 6;
-	if (!useIndices)
+	if (hasChanged)
 	{
-		verticesPerTile = 6;
-		indicesPerTile = 0;
+		SetAllChunksDirty();
 	}
+}
 
-	for (int x = 0; x < chunkCount; x++)
+void Tilemap::DeleteChunks()
+{
+	for (TilemapChunk* chunk : chunks)
 	{
-		for (int y = 0; y < chunkCount; y++)
+		for (MeshData* mesh : chunk->meshes)
 		{
-			TilemapChunk* chunk = chunks[(size_t)x + (size_t)y * chunkCount];
+			delete mesh;
+		}
+		delete chunk;
+	}
+	chunks.clear();
+	chunkCountX = 0;
+	chunkCountY = 0;
+}
 
-			// Delete chunk meshes
-			int meshSize = (int)chunk->meshes.size();
-			for (int i = 0; i < meshSize; i++)
-			{
-				delete chunk->meshes[i];
-			}
-			chunk->meshes.clear();
+void Tilemap::SetOrderInLayer(int orderInLayer)
+{
+	this->m_orderInLayer = orderInLayer;
+	Graphics::SetDrawOrderListAsDirty();
+}
 
-			// Create new meshes
-			for (int i = 0; i < textureSize; i++)
+void Tilemap::SetColor(const Color& color)
+{
+	this->color = color;
+	for (TilemapChunk* chunk : chunks)
+	{
+		for (MeshData* mesh : chunk->meshes)
+		{
+			if (mesh)
 			{
-				MeshData* mesh = new MeshData(verticesPerTile * chunkSize * chunkSize, indicesPerTile * chunkSize * chunkSize, false, false, true);
-				mesh->m_subMeshes[0]->index_count = 0;
-				mesh->m_subMeshes[0]->vertice_count = 0;
-				mesh->m_hasIndices = useIndices;
-				mesh->unifiedColor = color;
-				chunk->meshes.push_back(mesh);
+				mesh->unifiedColor = this->color;
 			}
 		}
 	}
 }
 
+void Tilemap::SetMaterial(const std::shared_ptr<Material>& material)
+{
+	m_material = material;
+	Graphics::SetDrawableAsDirty(this);
+}
+
 void Tilemap::CreateRenderCommands(RenderBatch& renderBatch)
 {
-	/*if (!material || !texture)
+	if (!m_material)
 		return;
 
 	RenderCommand command = RenderCommand();
-	command.material = material;
+	command.material = m_material.get();
 	command.drawable = this;
-	command.subMesh = nullptr;
-	command.transform = GetTransform();
-	command.isEnabled = IsEnabled() && GetGameObject()->IsLocalActive();
+	command.transform = GetTransformRaw();
+	command.isEnabled = IsEnabled() && GetGameObjectRaw()->IsLocalActive();
 
-	renderBatch.spriteCommands.push_back(command);
-	renderBatch.spriteCommandIndex++;*/
+	renderBatch.AddCommand(command, RenderQueueType::Sprite);
 }
 
 void Tilemap::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void Tilemap::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void Tilemap::DrawCommand(const RenderCommand& renderCommand)
 {
+	CheckAtlasPages();
 	if (dirtyMeshes)
 	{
 		dirtyMeshes = false;
-
-		CreateChunksMeshes();
-		FillChunks();
+		RebuildDirtyChunks();
 	}
 
-	DrawChunks();
+	// The chunks are not in the sprite batch, the sprites added before the tilemap are drawn first
+	SpriteManager::FlushSpriteBatch();
+
+	DrawChunks(*renderCommand.material);
 }
 
-void Tilemap::DrawChunks()
+void Tilemap::DrawChunks(Material& material)
 {
 	if (Graphics::usedCamera)
 	{
@@ -305,24 +453,42 @@ void Tilemap::DrawChunks()
 		float xChunkPosition;
 		float yChunkPosition;
 
-		auto transform = GetTransform();
+		const Transform& transform = *GetTransformRaw();
+		const Vector3& position = transform.GetPosition();
+		const Vector3& scale = transform.GetScale();
 
-		// For each chunk, check if the camera can see it
-		for (int x = 0; x < chunkCount; x++)
+		RenderingSettings renderSettings = RenderingSettings();
+		renderSettings.invertFaces = scale.x * scale.y < 0;
+		renderSettings.renderingMode = MaterialRenderingModes::Transparent;
+		renderSettings.useDepth = false;
+		renderSettings.useTexture = true;
+		renderSettings.useLighting = false;
+
+		const glm::mat4& matrix = transform.GetTransformationMatrix();
+		const float halfChunkSize = chunkSize * 0.5f;
+
+		// For each chunk, check if the camera can see it (the tiles are placed towards -x in the meshes)
+		for (int x = 0; x < chunkCountX; x++)
 		{
-			xChunkPosition = x * (float)chunkSize;
+			xChunkPosition = position.x - (x * (float)chunkSize + halfChunkSize);
 			if (xChunkPosition <= cameraPos.x + xArea && xChunkPosition >= cameraPos.x - xArea)
 			{
-				for (int y = 0; y < chunkCount; y++)
+				for (int y = 0; y < chunkCountY; y++)
 				{
-					yChunkPosition = y * (float)chunkSize;
+					yChunkPosition = position.y + y * (float)chunkSize + halfChunkSize;
 					if (yChunkPosition <= cameraPos.y + yArea && yChunkPosition >= cameraPos.y - yArea)
 					{
-						TilemapChunk* chunk = chunks[(size_t)x + (size_t)y * chunkCount];
+						const TilemapChunk* chunk = GetChunk(x, y);
 						// Draw each texture
-						for (int textureI = 0; textureI < textureSize; textureI++)
+						const size_t meshCount = chunk->meshes.size();
+						for (size_t textureI = 0; textureI < meshCount; textureI++)
 						{
-							//MeshManager::DrawMesh(transform->GetPosition(), transform->GetEulerAngles(), transform->GetLocalScale(), textures[(size_t)textureI + 1], chunk->meshes[textureI], false, true, false);
+							const MeshData* mesh = chunk->meshes[textureI];
+							// Do not draw a texture that is still loading
+							if (mesh && chunk->meshTextures[textureI]->GetFileStatus() == FileStatus::FileStatus_Loaded)
+							{
+								Graphics::DrawSubMesh(*mesh->m_subMeshes[0], material, chunk->meshTextures[textureI], renderSettings, matrix, false);
+							}
 						}
 					}
 				}
@@ -362,6 +528,9 @@ void Tilemap::RemoveTexture(Texture* texture)
 	{
 		textures.erase(textures.begin() + index);
 		textureSize = (int)textures.size() - 1;
+
+		// The meshes of the next textures have moved
+		SetAllChunksDirty();
 	}
 }
 
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <vector>
+#include <memory>
 
 #include <engine/api.h>
 #include <engine/graphics/iDrawable.h>
@@ -17,6 +18,7 @@
 
 class Texture;
 class MeshData;
+class Material;
 
 class API Tilemap : public IDrawable
 {
@@ -117,6 +119,16 @@ public:
 	*/
 	void SetColor(const Color& color);
 
+	/**
+	* @brief Set the material used to draw the tiles
+	*/
+	void SetMaterial(const std::shared_ptr<Material>& material);
+
+	inline const std::shared_ptr<Material>& GetMaterial() const
+	{
+		return m_material;
+	}
+
 protected:
 	ReflectiveData GetReflectiveData() override;
 	void OnDisabled() override;
@@ -126,31 +138,55 @@ protected:
 	class TilemapChunk
 	{
 	public:
-		std::vector<MeshData*> meshes;
+		std::vector<MeshData*> meshes; // One mesh per texture, nullptr if the chunk has no tile with this texture
+		std::vector<Texture*> meshTextures; // Texture used to draw each mesh (the atlas page if the texture is packed)
+		bool isDirty = true; // True if a tile of the chunk has changed since the last mesh rebuild
 	};
 	int chunkSize = 0;
-	bool dirtyMeshes = false;
+	bool dirtyMeshes = false; // True if at least one chunk is dirty
 
 	int m_orderInLayer = 0;
 	void DrawCommand(const RenderCommand& renderCommand) override;
 
 	/**
-	* @brief Fill all chunks meshes
-	*
+	* @brief Rebuild the meshes of the chunks with a changed tile
 	*/
-	void FillChunks();
+	void RebuildDirtyChunks();
 
 	/**
-	* @brief Delete and create new meshes for each chunk
+	* @brief Fill the meshes of a chunk, the meshes are reused when their tile count has not changed
 	*
+	* @param xChunk Chunk X position
+	* @param yChunk Chunk Y position
+	*/
+	void RebuildChunk(int xChunk, int yChunk);
+
+	/**
+	* @brief Mark all chunks to be rebuilt (when the texture list changes)
 	*/
-	void CreateChunksMeshes();
+	void SetAllChunksDirty();
+
+	/**
+	* @brief Mark all chunks to be rebuilt if an atlas page has been loaded or unloaded since the last rebuild
+	*/
+	void CheckAtlasPages();
+
+	/**
+	* @brief Delete the chunks and their meshes
+	*/
+	void DeleteChunks();
 
 	/**
 	* @brief Draw visible chunks
 	*
+	* @param material Material to use
 	*/
-	void DrawChunks();
+	void DrawChunks(Material& material);
+
+	inline TilemapChunk* GetChunk(int xChunk, int yChunk) const
+	{
+		return chunks[static_cast<size_t>(xChunk) + static_cast<size_t>(yChunk) * chunkCountX];
+	}
 
 	/**
 	* @brief Get texture index
@@ -160,7 +196,9 @@ protected:
 	*/
 	int GetTextureIndex(Texture* texture) const;
 
+	std::shared_ptr<Material> m_material = nullptr;
 	std::vector<Texture*> textures;
+	std::vector<Texture*> drawTextures; // Texture used to draw each texture of the list when the chunks were built (the atlas page if the texture is packed)
 	std::vector<TilemapChunk*> chunks;
 	int width = 0;
 	int height = 0;
@@ -170,7 +208,8 @@ protected:
 	bool useIndices = false;
 
 	int textureSize;
-	int chunkCount;
+	int chunkCountX = 0;
+	int chunkCountY = 0;
 };
 
 #endif // ENABLE_EXPERIMENTAL_FEATURES
\ No newline at end of file
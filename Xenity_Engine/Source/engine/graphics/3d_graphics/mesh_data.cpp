@@ -366,12 +366,9 @@ void MeshData::LoadFileReference()
 	{
 		m_fileStatus = FileStatus::FileStatus_Loading;
 		m_isValid = false;
-		bool result;
 #if defined(EDITOR)
-		result = WavefrontLoader::LoadFromRawData(*this);
-#else
-		result = BinaryMeshLoader::LoadMesh(*this);
-#endif
+		// Loaded on the main thread, the editor reads the sub meshes right after the loading
+		const bool result = WavefrontLoader::LoadFromRawData(*this);
 		if (result)
 		{
 			m_fileStatus = FileStatus::FileStatus_Loaded;
@@ -381,15 +378,22 @@ void MeshData::LoadFileReference()
 			m_fileStatus = FileStatus::FileStatus_Failed;
 		}
 		OnLoadFileReferenceFinished();
-		//#if defined(EDITOR)
-		//		isLoading = true;
-		//
-		//		AsyncFileLoading::AddFile(shared_from_this());
-		//
-		//		std::thread threadLoading = std::thread(WavefrontLoader::LoadFromRawData, std::dynamic_pointer_cast<MeshData>(shared_from_this()));
-		//		threadLoading.detach();
-		//#else
-		//#endif
+#else
+		// The file is kept alive by the job
+		const std::shared_ptr<FileReference> thisShared = shared_from_this();
+		AsyncFileLoading::LoadFile(thisShared, [this, thisShared]()
+			{
+				const bool result = BinaryMeshLoader::LoadMesh(*this);
+				if (result)
+				{
+					m_fileStatus = FileStatus::FileStatus_Loaded;
+				}
+				else
+				{
+					m_fileStatus = FileStatus::FileStatus_Failed;
+				}
+			});
+#endif
 	}
 }
 
@@ -419,12 +423,16 @@ void MeshData::OnLoadFileReferenceFinished()
 	ComputeBoundingBox();
 	ComputeBoundingSphere();
 	m_isValid = true;
+	m_onLoadingFinished.Trigger();
 }
 
 void MeshData::UnloadFileReference()
 {
 	if (Engine::IsRunning(true))
 	{
+		// The GPU upload of a loading mesh has to be done before unloading it
+		AsyncFileLoading::WaitForFile(*this);
+
 		if (m_fileStatus == FileStatus::FileStatus_Loaded)
 		{
 			m_fileStatus = FileStatus::FileStatus_Not_Loaded;
@@ -628,10 +636,40 @@ void MeshData::AllocSubMesh(unsigned int vcount, unsigned int index_count)
 	m_subMeshCount++;
 }
 
+void MeshData::AddExternalSubMesh(unsigned int vcount, unsigned int index_count, const void* vertexData, uint32_t vertexMemSize, const void* indexData, uint32_t indexMemSize)
+{
+	XASSERT(vertexData != nullptr, "[MeshData::AddExternalSubMesh] vertexData is nullptr");
+
+	std::unique_ptr<MeshData::SubMesh> newSubMesh = std::make_unique<MeshData::SubMesh>();
+	newSubMesh->meshData = this;
+	newSubMesh->isExternalData = true;
+	// The renderers and the loaders only read the data of loaded meshes
+	newSubMesh->data = const_cast<void*>(vertexData);
+	newSubMesh->vertexMemSize = vertexMemSize;
+	if (index_count != 0 && m_hasIndices)
+	{
+		newSubMesh->indices = const_cast<void*>(indexData);
+		newSubMesh->indexMemSize = indexMemSize;
+		newSubMesh->isShortIndices = indexMemSize / index_count == sizeof(unsigned short);
+	}
+	newSubMesh->index_count = index_count;
+	newSubMesh->vertice_count = vcount;
+
+	m_subMeshes.push_back(std::move(newSubMesh));
+	m_subMeshCount++;
+}
+
 void MeshData::SubMesh::FreeData()
 {
 	//Debug::Print("[MeshData::SubMesh::FreeData] Freeing data");
 
+	// Not owned, only forget the pointers
+	if (isExternalData)
+	{
+		data = nullptr;
+		indices = nullptr;
+	}
+
 #if !defined(_EE)
 	if (data)
 	{
@@ -21,6 +21,7 @@
 #include <engine/file_system/file_reference.h>
 #include <engine/graphics/3d_graphics/sphere.h>
 #include <engine/graphics/texture.h>
+#include <engine/event_system/event_system.h>
 
 enum class VertexElements : uint32_t
 {
@@ -113,6 +114,7 @@ public:
 		bool isOnVram = true;
 #endif
 		bool isShortIndices = true;
+		bool isExternalData = false; // If true, data and indices point to a memory not owned by the submesh (memory mapped file, sprite batch vertices)
 	};
 
 	MeshData();
@@ -216,6 +218,14 @@ public:
 		return m_vertexDescriptor;
 	}
 
+	/**
+	* Get the event called on the main thread when the mesh data is loaded and ready to be drawn
+	*/
+	inline Event<>& GetOnLoadingFinished()
+	{
+		return m_onLoadingFinished;
+	}
+
 protected:
 	friend class RendererOpengl;
 	friend class RendererRSX;
@@ -264,6 +274,12 @@ protected:
 	 */
 	void AllocSubMesh(unsigned int vcount, unsigned int index_count);
 
+	/**
+	 * @brief Add a new submesh using read-only vertices and indices owned by someone else (no allocation, no copy)
+	 * The memory has to stay valid while the submesh exists
+	 */
+	void AddExternalSubMesh(unsigned int vcount, unsigned int index_count, const void* vertexData, uint32_t vertexMemSize, const void* indexData, uint32_t indexMemSize);
+
 	int m_subMeshCount = 0;
 	bool m_hasUv = false;
 	bool m_hasNormal = false;
@@ -273,6 +289,7 @@ protected:
 	bool m_isValid = true;
 
 	Sphere m_boundingSphere;
+	Event<> m_onLoadingFinished;
 
 	VertexElements m_vertexDescriptor = VertexElements::NONE;
 
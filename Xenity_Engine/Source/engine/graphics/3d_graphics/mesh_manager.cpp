@@ -8,6 +8,7 @@
 
 #include <engine/graphics/graphics.h>
 #include <engine/file_system/file_system.h>
+#include <engine/file_system/async_file_loading.h>
 #include <engine/game_elements/transform.h>
 #include <engine/debug/debug.h>
 #include <engine/tools/math.h>
@@ -31,6 +32,7 @@ std::shared_ptr <MeshData> MeshManager::LoadMesh(const std::string& path)
 	mesh->m_file = FileSystem::MakeFile(path);
 	mesh->m_fileType = FileType::File_Mesh;
 	mesh->LoadFileReference();
+	AsyncFileLoading::WaitForFile(*mesh);
 	return mesh;
 }
 
@@ -50,4 +52,16 @@ void MeshManager::DrawMesh(const Transform& transform, const MeshData::SubMesh&
 	}
 
 	Graphics::DrawSubMesh(subMesh, material, renderSettings, transform.GetTransformationMatrix(), false);
+}
+
+void MeshManager::DrawMeshInstanced(const Transform& transform, const MeshData::SubMesh& subMesh, Material& material, RenderingSettings& renderSettings)
+{
+	const Vector3& scale = transform.GetScale();
+
+	if (scale.x * scale.y * scale.z < 0)
+	{
+		renderSettings.invertFaces = !renderSettings.invertFaces;
+	}
+
+	Graphics::DrawSubMeshInstanced(subMesh, material, renderSettings, transform.GetTransformationMatrix());
 }
\ No newline at end of file
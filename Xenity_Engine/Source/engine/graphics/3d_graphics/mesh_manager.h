@@ -39,6 +39,15 @@ public:
 	* @param renderSettings Rendering settings
 	*/
 	static void DrawMesh(const Transform& transform, const MeshData::SubMesh& subMesh, Material& material, RenderingSettings& renderSettings);
+
+	/**
+	* @brief Draw a submesh, batched with other instances sharing the same submesh and material when possible
+	* @param transform Mesh transform
+	* @param subMesh Submesh to draw
+	* @param material Material to use
+	* @param renderSettings Rendering settings
+	*/
+	static void DrawMeshInstanced(const Transform& transform, const MeshData::SubMesh& subMesh, Material& material, RenderingSettings& renderSettings);
 	
 	/**
 	* @brief Draw a submesh
@@ -20,6 +20,7 @@
 #include <engine/graphics/camera.h>
 #include <engine/graphics/shader.h>
 #include <engine/world_partitionner/world_partitionner.h>
+#include <engine/file_system/async_file_loading.h>
 #include <engine/engine.h>
 #include <engine/debug/stack_debug_object.h>
 #include <engine/debug/debug.h>
@@ -65,9 +66,9 @@ void MeshRenderer::OnDrawGizmosSelected()
 	Gizmo::SetColor(meshLineColor);
 
 	const Vector3& tPos = GetTransformRaw()->GetPosition();
-	for (auto& chunk : m_worldChunkPositions)
+	for (const uint32_t chunkIndex : m_worldChunkIndices)
 	{
-		Gizmo::DrawLine(tPos, chunk + Vector3(WORLD_CHUNK_HALF_SIZE));
+		Gizmo::DrawLine(tPos, WorldPartitionner::GetChunkPosition(chunkIndex) + Vector3(WORLD_CHUNK_HALF_SIZE));
 	}
 
 	const Color lightLineColor = Color::CreateFromRGBAFloat(1, 0, 0, 1);
@@ -98,9 +99,13 @@ Sphere MeshRenderer::ProcessBoundingSphere() const
 
 void MeshRenderer::OnNewRender()
 {
-	if (Graphics::usedCamera && GetGameObjectRaw()->IsLocalActive() && IsEnabled())
+	// Meshes in the world partitionner are already tested by WorldPartitionner::CullMeshRenderers
+	if (m_worldChunkIndices.empty() && Graphics::usedCamera && GetGameObjectRaw()->IsLocalActive() && IsEnabled())
 	{
-		m_outOfFrustum = !IsSphereInFrustum(Graphics::usedCamera->frustum, m_boundingSphere);
+		if (IsSphereInFrustum(Graphics::usedCamera->frustum, m_boundingSphere))
+		{
+			m_frustumCullingPassId = WorldPartitionner::GetFrustumCullingPassId();
+		}
 	}
 }
 
@@ -121,13 +126,16 @@ void MeshRenderer::OnReflectionUpdated()
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	if (m_meshData)
+	ListenMeshDataLoading();
+
+	// The sub mesh count of a streamed mesh is unknown until the end of the loading
+	if (m_meshData && m_meshData->m_isValid)
 	{
 		m_materials.resize(m_meshData->m_subMeshCount);
 	}
 
 	m_matCount = m_materials.size();
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 
 	m_boundingSphere = ProcessBoundingSphere();
 	WorldPartitionner::ProcessMeshRenderer(this);
@@ -139,13 +147,18 @@ void MeshRenderer::OnReflectionUpdated()
 MeshRenderer::~MeshRenderer()
 {
 	GetTransformRaw()->GetOnTransformUpdated().Unbind(&MeshRenderer::OnTransformPositionUpdated, this);
+	if (const std::shared_ptr<MeshData> listenedMeshData = m_listenedMeshData.lock())
+	{
+		listenedMeshData->GetOnLoadingFinished().Unbind(&MeshRenderer::OnMeshDataLoaded, this);
+	}
 	AssetManager::RemoveReflection(this);
 	WorldPartitionner::RemoveMeshRenderer(this);
 }
 
 void MeshRenderer::CreateRenderCommands(RenderBatch& renderBatch)
 {
-	if (!m_meshData)
+	// The commands are created again when the mesh data is loaded
+	if (!m_meshData || !m_meshData->m_isValid)
 		return;
 
 	// Create a command for each submesh
@@ -169,19 +182,11 @@ void MeshRenderer::CreateRenderCommands(RenderBatch& renderBatch)
 		command.isEnabled = IsEnabled() && GetGameObjectRaw()->IsLocalActive();
 		if (material->GetRenderingMode() == MaterialRenderingModes::Opaque || material->GetRenderingMode() == MaterialRenderingModes::Cutout)
 		{
-#if defined(ENABLE_OVERDRAW_OPTIMIZATION)
-			renderBatch.opaqueMeshCommands.push_back(command);
-			renderBatch.opaqueMeshCommandIndex++;
-#else
-			RenderQueue& renderQueue = renderBatch.renderQueues[material->GetFileId()];
-			renderQueue.commands.push_back(command);
-			renderQueue.commandIndex++;
-#endif
+			renderBatch.AddCommand(command, RenderQueueType::Opaque);
 		}
 		else
 		{
-			renderBatch.transparentMeshCommands.push_back(command);
-			renderBatch.transparentMeshCommandIndex++;
+			renderBatch.AddCommand(command, RenderQueueType::Transparent);
 		}
 	}
 }
@@ -189,8 +194,11 @@ void MeshRenderer::CreateRenderCommands(RenderBatch& renderBatch)
 void MeshRenderer::SetMeshData(const std::shared_ptr<MeshData>& meshData)
 {
 	m_meshData = meshData;
+	ListenMeshDataLoading();
 	if (meshData)
 	{
+		// The sub mesh count is needed now
+		AsyncFileLoading::WaitForFile(*meshData);
 		m_materials.resize(meshData->m_subMeshCount);
 		m_matCount = meshData->m_subMeshCount;
 	}
@@ -198,7 +206,39 @@ void MeshRenderer::SetMeshData(const std::shared_ptr<MeshData>& meshData)
 	{
 
 	}
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
+
+	m_boundingSphere = ProcessBoundingSphere();
+	WorldPartitionner::ProcessMeshRenderer(this);
+}
+
+void MeshRenderer::ListenMeshDataLoading()
+{
+	const std::shared_ptr<MeshData> listenedMeshData = m_listenedMeshData.lock();
+	if (listenedMeshData == m_meshData)
+		return;
+
+	if (listenedMeshData)
+	{
+		listenedMeshData->GetOnLoadingFinished().Unbind(&MeshRenderer::OnMeshDataLoaded, this);
+	}
+	if (m_meshData)
+	{
+		m_meshData->GetOnLoadingFinished().Bind(&MeshRenderer::OnMeshDataLoaded, this);
+	}
+	m_listenedMeshData = m_meshData;
+}
+
+void MeshRenderer::OnMeshDataLoaded()
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	m_materials.resize(m_meshData->m_subMeshCount);
+	m_matCount = m_materials.size();
+	Graphics::SetDrawableAsDirty(this);
+
+	m_boundingSphere = ProcessBoundingSphere();
+	WorldPartitionner::ProcessMeshRenderer(this);
 }
 
 void MeshRenderer::SetMaterial(const std::shared_ptr<Material>& material, int index)
@@ -207,24 +247,24 @@ void MeshRenderer::SetMaterial(const std::shared_ptr<Material>& material, int in
 	if (index < m_materials.size())
 	{
 		m_materials[index] = material;
-		Graphics::s_isRenderingBatchDirty = true;
+		Graphics::SetDrawableAsDirty(this);
 	}
 }
 
 void MeshRenderer::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void MeshRenderer::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void MeshRenderer::DrawCommand(const RenderCommand& renderCommand)
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
-	if (m_culled || m_outOfFrustum)
+	if (m_culled || m_frustumCullingPassId != WorldPartitionner::GetFrustumCullingPassId())
 		return;
 
 	if (renderCommand.material->GetShader() == nullptr)
@@ -250,6 +290,7 @@ void MeshRenderer::DrawCommand(const RenderCommand& renderCommand)
 		{
 			if (renderCommand.material->GetShader() != AssetManager::standardShaderNoPointLight)
 			{
+				Graphics::FlushInstancedDraws();
 				renderCommand.material->SetShader(AssetManager::standardShaderNoPointLight);
 				Graphics::s_currentMaterial = nullptr;
 			}
@@ -258,6 +299,7 @@ void MeshRenderer::DrawCommand(const RenderCommand& renderCommand)
 		{
 			if (renderCommand.material->GetShader() != AssetManager::standardShader)
 			{
+				Graphics::FlushInstancedDraws();
 				renderCommand.material->SetShader(AssetManager::standardShader);
 				Graphics::s_currentMaterial = nullptr;
 			}
@@ -297,6 +339,8 @@ void MeshRenderer::DrawCommand(const RenderCommand& renderCommand)
 		// Update light buffer
 		if (needLightUpdate)
 		{
+			// Queued instances have to be drawn with the previous lights
+			Graphics::FlushInstancedDraws();
 			Graphics::s_isLightUpdateNeeded = false;
 			int pointLightCount = 0;
 			int spotLightCount = 0;
@@ -359,7 +403,15 @@ void MeshRenderer::DrawCommand(const RenderCommand& renderCommand)
 	renderSettings.useTexture = true;
 	renderSettings.useLighting = renderCommand.material->GetUseLighting();
 	renderSettings.renderingMode = renderCommand.material->GetRenderingMode();
-	MeshManager::DrawMesh(*GetTransformRaw(), *renderCommand.subMesh, *renderCommand.material, renderSettings);
+	if (renderSettings.renderingMode == MaterialRenderingModes::Transparent)
+	{
+		// Transparent meshes are sorted by distance, they can't be grouped
+		MeshManager::DrawMesh(*GetTransformRaw(), *renderCommand.subMesh, *renderCommand.material, renderSettings);
+	}
+	else
+	{
+		MeshManager::DrawMeshInstanced(*GetTransformRaw(), *renderCommand.subMesh, *renderCommand.material, renderSettings);
+	}
 }
 
 void MeshRenderer::OnTransformPositionUpdated()
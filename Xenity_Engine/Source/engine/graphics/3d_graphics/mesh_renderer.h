@@ -66,7 +66,7 @@ protected:
 
 	void OnNewRender() override;
 	void OnComponentAttached() override;
-	std::vector<Vector3> m_worldChunkPositions;
+	std::vector<uint32_t> m_worldChunkIndices; // Sorted indices of the world partitionner chunks
 	std::vector<Light*> m_affectedByLights;
 	Sphere ProcessBoundingSphere() const;
 	Sphere m_boundingSphere;
@@ -98,10 +98,21 @@ protected:
 
 	void OnTransformPositionUpdated();
 
+	/**
+	* @brief Listen the loading of the current mesh data, to update the renderer when a streamed mesh is loaded
+	*/
+	void ListenMeshDataLoading();
+
+	/**
+	* @brief Called when the mesh data is loaded
+	*/
+	void OnMeshDataLoaded();
+
 	std::shared_ptr <MeshData> m_meshData = nullptr;
+	std::weak_ptr<MeshData> m_listenedMeshData;
 	std::vector<std::shared_ptr <Material>> m_materials;
 	size_t m_matCount = 0;
 
 	bool m_culled = false;
-	bool m_outOfFrustum = false;
+	uint32_t m_frustumCullingPassId = 0; // Id of the last culling pass where the mesh was in the frustum
 };
\ No newline at end of file
@@ -43,6 +43,7 @@
 #include <engine/world_partitionner/world_partitionner.h>
 #include <engine/debug/stack_debug_object.h>
 #include <engine/time/time.h>
+#include <engine/file_system/async_file_loading.h>
 #include <engine/constants.h>
 #include "shader_opengl.h"
 
@@ -50,9 +51,11 @@ std::vector<std::weak_ptr<Camera>> Graphics::cameras;
 std::shared_ptr<Camera> Graphics::usedCamera;
 bool Graphics::needUpdateCamera = true;
 int Graphics::s_iDrawablesCount = 0;
+uint64_t Graphics::s_nextDrawOrder = 0;
 int Graphics::s_lodsCount = 0;
 
 std::vector<IDrawable*> Graphics::s_orderedIDrawable;
+std::vector<IDrawable*> Graphics::s_dirtyIDrawables;
 
 std::vector<std::weak_ptr<Lod>> Graphics::s_lods;
 
@@ -73,6 +76,11 @@ std::vector <Light*> Graphics::s_directionalLights;
 bool Graphics::s_isLightUpdateNeeded = true;
 bool Graphics::s_isGridRenderingEnabled = true;
 float  Graphics::s_gridAlphaMultiplier = 1;
+bool Graphics::s_isInstancingEnabled = true;
+
+Material* Graphics::s_instancedDrawMaterial = nullptr;
+std::vector<Graphics::InstancedDrawBatch> Graphics::s_instancedDrawBatches;
+size_t Graphics::s_usedInstancedDrawBatchCount = 0;
 
 void Graphics::SetSkybox(const std::shared_ptr<SkyBox>& skybox_)
 {
@@ -133,12 +141,16 @@ void Graphics::Stop()
 	s_lods.clear();
 	s_lodsCount = 0;
 	s_orderedIDrawable.clear();
+	s_dirtyIDrawables.clear();
 	s_isRenderingBatchDirty = true;
 	renderBatch.Reset();
 	s_settings.skybox.reset();
 	skyPlane.reset();
 	s_currentShader = nullptr;
 	s_currentMaterial = nullptr;
+	s_instancedDrawMaterial = nullptr;
+	s_instancedDrawBatches.clear();
+	s_usedInstancedDrawBatchCount = 0;
 }
 
 void Graphics::SetDefaultValues()
@@ -183,6 +195,8 @@ void Graphics::Draw()
 		}
 	}
 
+	SpriteManager::NewFrame();
+
 	for (const std::weak_ptr<Camera>& weakCam : cameras)
 	{
 		usedCamera = weakCam.lock();
@@ -192,6 +206,7 @@ void Graphics::Draw()
 			Engine::GetRenderer().NewFrame();
 
 			SortTransparentDrawables();
+			SortOpaqueDrawables();
 			CheckLods();
 
 			// Set material as dirty
@@ -232,6 +247,8 @@ void Graphics::Draw()
 
 			//Engine::GetRenderer().SetFog(s_settings.isFogEnabled);
 
+			WorldPartitionner::CullMeshRenderers(usedCamera->frustum);
+
 			{
 				SCOPED_PROFILER("Graphics::CallOnNewRender", scopeBenchmarkNewRender);
 				for (IDrawable* drawable : s_orderedIDrawable)
@@ -240,19 +257,6 @@ void Graphics::Draw()
 				}
 			}
 
-#if !defined(ENABLE_OVERDRAW_OPTIMIZATION)
-			{
-				SCOPED_PROFILER("Graphics::RenderOpaque", scopeBenchmarkRenderOpaque);
-				for (const auto& renderQueue : renderBatch.renderQueues)
-				{
-					for (const RenderCommand& com : renderQueue.second.commands)
-					{
-						if (com.isEnabled)
-							com.drawable->DrawCommand(com);
-					}
-				}
-			}
-#else
 			{
 				SCOPED_PROFILER("Graphics::RenderOpaque", scopeBenchmarkRenderOpaque);
 				for (const RenderCommand& com : renderBatch.opaqueMeshCommands)
@@ -260,8 +264,8 @@ void Graphics::Draw()
 					if (com.isEnabled)
 						com.drawable->DrawCommand(com);
 				}
+				FlushInstancedDraws();
 			}
-#endif
 
 			DrawSkybox(camPos);
 
@@ -277,11 +281,13 @@ void Graphics::Draw()
 			{
 				SCOPED_PROFILER("Graphics::Render2D", scopeBenchmarkRender2D);
 				s_currentMode = IDrawableTypes::Draw_2D;
+				// The sprites are added to the sprite batch and drawn together
 				for (const RenderCommand& com : renderBatch.spriteCommands)
 				{
 					if (com.isEnabled)
 						com.drawable->DrawCommand(com);
 				}
+				SpriteManager::FlushSpriteBatch();
 			}
 
 			if (!usedCamera->IsEditor())
@@ -367,15 +373,18 @@ void Graphics::Draw()
 				// Draw all gizmos
 				{
 					SCOPED_PROFILER("Graphics::DrawGizmo", scopeBenchmarkDrawGizmo);
-					for (const std::weak_ptr<Component>& weakComponent : GameplayManager::orderedComponents)
+					for (const std::shared_ptr<GameObject>& gameObject : GameplayManager::gameObjects)
 					{
-						if (const std::shared_ptr<Component> component = weakComponent.lock())
+						if (!gameObject->IsLocalActive())
+							continue;
+
+						for (const std::shared_ptr<Component>& component : gameObject->m_components)
 						{
-							if (component->GetGameObjectRaw()->IsLocalActive() && component->IsEnabled())
+							if (component->IsEnabled())
 							{
 								component->OnDrawGizmos();
 
-								if (component->GetGameObjectRaw()->m_isSelected)
+								if (gameObject->m_isSelected)
 									component->OnDrawGizmosSelected();
 							}
 						}
@@ -420,11 +429,6 @@ bool meshComparator2(const RenderCommand& c1, const RenderCommand& c2)
 	return Vector3::Distance(c1.transform->GetPosition(), meshComparatorCamPos) > Vector3::Distance(c2.transform->GetPosition(), meshComparatorCamPos);
 }
 
-bool meshComparator3(const RenderCommand& c1, const RenderCommand& c2)
-{
-	return Vector3::Distance(c2.transform->GetPosition(), meshComparatorCamPos) > Vector3::Distance(c1.transform->GetPosition(), meshComparatorCamPos);
-}
-
 void Graphics::SortTransparentDrawables()
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
@@ -432,9 +436,15 @@ void Graphics::SortTransparentDrawables()
 	SCOPED_PROFILER("Graphics::SortTransparentDrawables", scopeBenchmark);
 	meshComparatorCamPos = usedCamera->GetTransformRaw()->GetPosition();
 	std::sort(renderBatch.transparentMeshCommands.begin(), renderBatch.transparentMeshCommands.begin() + renderBatch.transparentMeshCommandIndex, meshComparator2);
-#if defined(ENABLE_OVERDRAW_OPTIMIZATION)
-	std::sort(renderBatch.opaqueMeshCommands.begin(), renderBatch.opaqueMeshCommands.begin() + renderBatch.opaqueMeshCommandIndex, meshComparator3);
-#endif
+	renderBatch.RefreshHandles(RenderQueueType::Transparent);
+}
+
+void Graphics::SortOpaqueDrawables()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	SCOPED_PROFILER("Graphics::SortOpaqueDrawables", scopeBenchmark);
+	renderBatch.SortOpaqueCommands(usedCamera->GetTransformRaw()->GetPosition(), usedCamera->GetFarClippingPlane());
 }
 
 void Graphics::OrderDrawables()
@@ -448,8 +458,24 @@ void Graphics::OrderDrawables()
 		renderBatch.Reset();
 		for (IDrawable* drawable : s_orderedIDrawable)
 		{
+			drawable->m_isRenderCommandsDirty = false;
 			drawable->CreateRenderCommands(renderBatch);
 		}
+		s_dirtyIDrawables.clear();
+		Performance::AddRenderBatchUpdates(static_cast<int>(s_orderedIDrawable.size()));
+	}
+	else if (!s_dirtyIDrawables.empty())
+	{
+		// Only recreate the commands of the drawables that have changed
+		SCOPED_PROFILER("Graphics::UpdateRenderBatch", scopeBenchmark);
+		for (IDrawable* drawable : s_dirtyIDrawables)
+		{
+			drawable->m_isRenderCommandsDirty = false;
+			renderBatch.RemoveCommands(*drawable);
+			drawable->CreateRenderCommands(renderBatch);
+		}
+		Performance::AddRenderBatchUpdates(static_cast<int>(s_dirtyIDrawables.size()));
+		s_dirtyIDrawables.clear();
 	}
 }
 
@@ -457,6 +483,15 @@ void Graphics::DeleteAllDrawables()
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
+	for (IDrawable* drawable : s_dirtyIDrawables)
+	{
+		drawable->m_isRenderCommandsDirty = false;
+	}
+	for (IDrawable* drawable : s_orderedIDrawable)
+	{
+		drawable->m_isInDrawableList = false;
+	}
+	s_dirtyIDrawables.clear();
 	s_orderedIDrawable.clear();
 	s_iDrawablesCount = 0;
 	s_isRenderingBatchDirty = true;
@@ -470,7 +505,9 @@ void Graphics::AddDrawable(IDrawable* drawableToAdd)
 
 	s_orderedIDrawable.push_back(drawableToAdd);
 	s_iDrawablesCount++;
-	s_isRenderingBatchDirty = true;
+	drawableToAdd->m_isInDrawableList = true;
+	drawableToAdd->m_drawOrder = s_nextDrawOrder++;
+	SetDrawableAsDirty(drawableToAdd);
 	SetDrawOrderListAsDirty();
 }
 
@@ -483,18 +520,50 @@ void Graphics::RemoveDrawable(const IDrawable* drawableToRemove)
 	if (!Engine::IsRunning(true))
 		return;
 
+	// The batch must not keep commands pointing to a removed drawable
+	IDrawable* drawable = const_cast<IDrawable*>(drawableToRemove);
+	drawable->m_isInDrawableList = false;
+	renderBatch.RemoveCommands(*drawable);
+	if (drawable->m_isRenderCommandsDirty)
+	{
+		drawable->m_isRenderCommandsDirty = false;
+		s_dirtyIDrawables.erase(std::find(s_dirtyIDrawables.begin(), s_dirtyIDrawables.end(), drawable));
+	}
+
 	for (int i = 0; i < s_iDrawablesCount; i++)
 	{
 		if (s_orderedIDrawable[i] == drawableToRemove)
 		{
 			s_orderedIDrawable.erase(s_orderedIDrawable.begin() + i);
 			s_iDrawablesCount--;
-			s_isRenderingBatchDirty = true;
 			break;
 		}
 	}
 }
 
+void Graphics::SetDrawableAsDirty(IDrawable* drawable)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+
+	XASSERT(drawable != nullptr, "[Graphics::SetDrawableAsDirty] drawable is nullptr");
+
+	// Drawables that are not in the list do not have commands
+	if (drawable->m_isInDrawableList && !drawable->m_isRenderCommandsDirty)
+	{
+		drawable->m_isRenderCommandsDirty = true;
+		s_dirtyIDrawables.push_back(drawable);
+	}
+}
+
+void Graphics::UpdateDrawableEnabledState(IDrawable* drawable)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+
+	XASSERT(drawable != nullptr, "[Graphics::UpdateDrawableEnabledState] drawable is nullptr");
+
+	renderBatch.SetCommandsEnabled(*drawable, drawable->IsEnabled() && drawable->GetGameObjectRaw()->IsLocalActive());
+}
+
 void Graphics::AddLod(const std::weak_ptr<Lod>& lodToAdd)
 {
 	STACK_DEBUG_OBJECT(STACK_LOW_PRIORITY);
@@ -556,6 +625,12 @@ void Graphics::DrawSubMesh(const MeshData::SubMesh& subMesh, Material& material,
 
 	XASSERT(usedCamera != nullptr, "[Graphics::DrawSubMesh] usedCamera is nullptr");
 
+	// Keep the draw order of the queued instances
+	if (s_usedInstancedDrawBatchCount != 0)
+	{
+		FlushInstancedDraws();
+	}
+
 	if (texture == nullptr)
 	{
 		texture = AssetManager::defaultTexture.get();
@@ -584,6 +659,132 @@ void Graphics::DrawSubMesh(const MeshData::SubMesh& subMesh, Material& material,
 	Engine::GetRenderer().DrawSubMesh(subMesh, material, *texture, renderSettings);
 }
 
+void Graphics::DrawSubMeshInstanced(const MeshData::SubMesh& subMesh, Material& material, const RenderingSettings& renderSettings, const glm::mat4& matrix)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	const std::shared_ptr<Shader>& shader = material.GetShader();
+	if (!s_isInstancingEnabled || !Engine::GetRenderer().SupportsInstancing() || !shader || !shader->SupportsInstancing())
+	{
+		RenderingSettings settings = renderSettings;
+		DrawSubMesh(subMesh, material, settings, matrix, false);
+		return;
+	}
+
+	if (s_instancedDrawMaterial != &material)
+	{
+		FlushInstancedDraws();
+		s_instancedDrawMaterial = &material;
+	}
+
+	// Find the batch of the submesh, the number of different submeshes per material is usually small
+	for (size_t i = 0; i < s_usedInstancedDrawBatchCount; i++)
+	{
+		InstancedDrawBatch& batch = s_instancedDrawBatches[i];
+		if (batch.subMesh == &subMesh && batch.renderSettings.invertFaces == renderSettings.invertFaces)
+		{
+			batch.matrices.push_back(matrix);
+			return;
+		}
+	}
+
+	if (s_usedInstancedDrawBatchCount == s_instancedDrawBatches.size())
+	{
+		s_instancedDrawBatches.emplace_back();
+	}
+
+	InstancedDrawBatch& newBatch = s_instancedDrawBatches[s_usedInstancedDrawBatchCount];
+	s_usedInstancedDrawBatchCount++;
+	newBatch.subMesh = &subMesh;
+	newBatch.renderSettings = renderSettings;
+	newBatch.matrices.push_back(matrix);
+}
+
+void Graphics::FlushInstancedDraws()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (s_usedInstancedDrawBatchCount == 0)
+		return;
+
+	XASSERT(s_instancedDrawMaterial != nullptr, "[Graphics::FlushInstancedDraws] s_instancedDrawMaterial is nullptr");
+
+	// Reset the queue first, DrawSubMesh flushes the queue too
+	Material& material = *s_instancedDrawMaterial;
+	const size_t batchCount = s_usedInstancedDrawBatchCount;
+	s_instancedDrawMaterial = nullptr;
+	s_usedInstancedDrawBatchCount = 0;
+
+	for (size_t i = 0; i < batchCount; i++)
+	{
+		InstancedDrawBatch& batch = s_instancedDrawBatches[i];
+		DrawSubMeshInstances(*batch.subMesh, material, nullptr, batch.renderSettings, batch.matrices.data(), nullptr, batch.matrices.size());
+		batch.matrices.clear();
+	}
+}
+
+void Graphics::DrawSubMeshInstances(const MeshData::SubMesh& subMesh, Material& material, Texture* texture, RenderingSettings& renderSettings, const glm::mat4* matrices, const glm::vec4* colors, size_t instanceCount)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	XASSERT(matrices != nullptr, "[Graphics::DrawSubMeshInstances] matrices is nullptr");
+
+	if (texture == nullptr)
+	{
+		texture = material.m_texture.get();
+	}
+
+	// The instance colors use the vertex color input of the shader
+	const std::shared_ptr<Shader>& shader = material.GetShader();
+	const bool canUseInstancing = s_isInstancingEnabled && Engine::GetRenderer().SupportsInstancing() && shader && shader->SupportsInstancing() && (!colors || !subMesh.meshData->m_hasColor);
+	if (instanceCount == 1 || !canUseInstancing)
+	{
+		for (size_t i = 0; i < instanceCount; i++)
+		{
+			if (colors)
+			{
+				subMesh.meshData->unifiedColor.SetFromRGBAfloat(colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+			}
+			DrawSubMesh(subMesh, material, texture, renderSettings, matrices[i], false);
+		}
+		return;
+	}
+
+	// Keep the draw order of the queued instances
+	if (s_usedInstancedDrawBatchCount != 0)
+	{
+		FlushInstancedDraws();
+	}
+
+	if (texture == nullptr)
+	{
+		texture = AssetManager::defaultTexture.get();
+	}
+
+	if (colors)
+	{
+		subMesh.meshData->unifiedColor = Color::CreateFromRGBA(255, 255, 255, 255);
+	}
+
+	material.Use();
+	if (s_currentShader && s_currentShader->GetFileStatus() == FileStatus::FileStatus_Loaded)
+	{
+		s_currentShader->SetShaderInstancing(true);
+		Engine::GetRenderer().DrawSubMeshInstanced(subMesh, material, *texture, renderSettings, matrices, colors, instanceCount);
+		s_currentShader->SetShaderInstancing(false);
+	}
+}
+
+void Graphics::SetIsInstancingEnabled(bool enabled)
+{
+	s_isInstancingEnabled = enabled;
+}
+
+bool Graphics::IsInstancingEnabled()
+{
+	return s_isInstancingEnabled;
+}
+
 void Graphics::SetDrawOrderListAsDirty()
 {
 	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
@@ -623,6 +824,8 @@ void Graphics::OnProjectLoaded()
 	skyPlane = AssetManager::LoadEngineAsset<MeshData>("public_engine_assets/models/PlaneTriangulate.obj");
 	XASSERT(skyPlane != nullptr, "[Graphics::OnProjectLoaded] skyPlane is null");
 	skyPlane->LoadFileReference();
+	// Drawn without checking the loading state
+	AsyncFileLoading::WaitForFile(*skyPlane);
 }
 
 void Graphics::DrawSkybox(const Vector3& cameraPosition)
@@ -78,6 +78,11 @@ public:
 	*/
 	static void SortTransparentDrawables();
 
+	/**
+	* @brief Sort opaque drawables to reduce render state changes and overdraw
+	*/
+	static void SortOpaqueDrawables();
+
 	/**
 	* @brief Delete all drawables
 	*/
@@ -95,6 +100,18 @@ public:
 	*/
 	static void RemoveDrawable(const IDrawable* drawableToRemove);
 
+	/**
+	* @brief Ask to recreate the render commands of a drawable before the next frame (Call this when something used by CreateRenderCommands changed)
+	* @param drawable Drawable to update
+	*/
+	static void SetDrawableAsDirty(IDrawable* drawable);
+
+	/**
+	* @brief Update the enabled state of the render commands of a drawable without recreating them
+	* @param drawable Drawable to update
+	*/
+	static void UpdateDrawableEnabledState(IDrawable* drawable);
+
 	/**
 	* @brief Add a lod
 	* @param lodToAddLlod to add
@@ -137,6 +154,32 @@ public:
 
 	static void DrawSubMesh(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const MeshData::SubMesh& subMesh, Material& material, RenderingSettings& renderSettings);
 
+	/**
+	* @brief Queue a submesh to be drawn with other instances sharing the same submesh and material (Drawn with DrawSubMesh if instancing is not available)
+	* @param subMesh The submesh to draw
+	* @param material The material to use
+	* @param renderSettings The rendering settings
+	* @param matrix The matrix to apply
+	*/
+	static void DrawSubMeshInstanced(const MeshData::SubMesh& subMesh, Material& material, const RenderingSettings& renderSettings, const glm::mat4& matrix);
+
+	/**
+	* @brief Draw several instances of a submesh now with one draw call (Drawn with DrawSubMesh per instance if instancing is not available)
+	* @param subMesh The submesh to draw
+	* @param material The material to use
+	* @param texture The texture to use (material's texture if nullptr)
+	* @param renderSettings The rendering settings
+	* @param matrices The matrix of each instance
+	* @param colors The color of each instance, replaces the unified color of the mesh (can be nullptr)
+	* @param instanceCount The number of instances
+	*/
+	static void DrawSubMeshInstances(const MeshData::SubMesh& subMesh, Material& material, Texture* texture, RenderingSettings& renderSettings, const glm::mat4* matrices, const glm::vec4* colors, size_t instanceCount);
+
+	/**
+	* @brief Draw all queued instances, needs to be called before changing the render state used by the queued instances
+	*/
+	static void FlushInstancedDraws();
+
 	/**
 	* @brief Set draw order list as dirty
 	*/
@@ -153,6 +196,7 @@ public:
 	static bool needUpdateCamera;
 
 	static std::vector <IDrawable*> s_orderedIDrawable;
+	static std::vector <IDrawable*> s_dirtyIDrawables;
 	static std::vector<std::weak_ptr<Lod>> s_lods;
 
 	
@@ -168,9 +212,30 @@ public:
 	static void SetIsGridRenderingEnabled(bool enabled);
 	static bool IsGridRenderingEnabled();
 
+	/**
+	* @brief Enable or disable the instanced draw path (Only used if the renderer supports instancing)
+	*/
+	static void SetIsInstancingEnabled(bool enabled);
+	static bool IsInstancingEnabled();
+
 private:
+	/**
+	* @brief Instances of a submesh waiting to be drawn with the current instanced material
+	*/
+	struct InstancedDrawBatch
+	{
+		const MeshData::SubMesh* subMesh = nullptr;
+		RenderingSettings renderSettings;
+		std::vector<glm::mat4> matrices;
+	};
+
 	static bool s_isGridRenderingEnabled;
 	static float s_gridAlphaMultiplier;
+	static bool s_isInstancingEnabled;
+
+	static Material* s_instancedDrawMaterial;
+	static std::vector<InstancedDrawBatch> s_instancedDrawBatches; // Batches are reused between flushes to keep the matrices allocations
+	static size_t s_usedInstancedDrawBatchCount;
 
 	static void OnProjectLoaded();
 
@@ -209,6 +274,7 @@ private:
 #endif
 
 	static int s_iDrawablesCount;
+	static uint64_t s_nextDrawOrder;
 	static int s_lodsCount;
 	static bool s_drawOrderListDirty;
 };
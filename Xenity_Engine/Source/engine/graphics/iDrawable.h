@@ -19,6 +19,7 @@ public:
 
 protected:
 	friend class Graphics;
+	friend class RenderBatch;
 
 	void RemoveReferences() override;
 
@@ -33,4 +34,12 @@ protected:
 	virtual void DrawCommand(const RenderCommand & renderCommand) = 0;
 
 	virtual void OnNewRender() {};
+
+private:
+	// Handles of the commands created by this drawable in the render batch
+	std::vector<RenderCommandHandle> m_renderCommandHandles;
+	// Increases with the position of the drawable in the drawable list, keeps the sprite and UI commands in the list order
+	uint64_t m_drawOrder = 0;
+	bool m_isRenderCommandsDirty = false;
+	bool m_isInDrawableList = false;
 };
@@ -137,7 +137,11 @@ void Material::Use()
 			m_lastUsedCamera = Graphics::usedCamera.get();
 			m_lastUpdatedType = Graphics::s_currentMode;
 
-			m_shader->Use();
+			// Only the real GPU state changes are counted, not a new camera or draw type with the same state
+			if (m_shader->Use())
+			{
+				Performance::AddStateChange();
+			}
 			Update();
 
 			const int matCount = AssetManager::GetMaterialCount();
@@ -168,6 +172,7 @@ void Material::Update()
 	//Send all uniforms
 	if (!m_updated)
 	{
+		Performance::AddStateChange();
 		m_shader->SetShaderOffsetAndTiling(t_offset, t_tiling);
 
 		//int textureIndex = 0;
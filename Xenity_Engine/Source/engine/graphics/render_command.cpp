@@ -5,3 +5,262 @@
 // This file is part of Xenity Engine
 
 #include "render_command.h"
+
+#include <algorithm>
+
+#include <engine/assertions/assertions.h>
+#include "iDrawable.h"
+#include <engine/game_elements/transform.h>
+#include <engine/file_system/file_reference.h>
+#include <engine/vectors/vector3.h>
+#include "material.h"
+#include "shader.h"
+#include "texture.h"
+
+// Sort key layout (from the most significant bit):
+// rendering mode (2 bits) | shader (16 bits) | material (16 bits) | texture (16 bits) | depth bucket (12 bits)
+// With ENABLE_OVERDRAW_OPTIMIZATION:
+// rendering mode (2 bits) | depth bucket (12 bits) | shader (16 bits) | material (16 bits) | texture (16 bits)
+static constexpr uint64_t s_depthBucketBits = 12;
+static constexpr uint64_t s_depthBucketMax = (1 << s_depthBucketBits) - 1;
+static constexpr uint64_t s_renderingModeShift = 62;
+#if defined(ENABLE_OVERDRAW_OPTIMIZATION)
+static constexpr uint64_t s_depthBucketShift = 50;
+static constexpr uint64_t s_shaderShift = 32;
+static constexpr uint64_t s_materialShift = 16;
+static constexpr uint64_t s_textureShift = 0;
+#else
+static constexpr uint64_t s_depthBucketShift = 0;
+static constexpr uint64_t s_shaderShift = 44;
+static constexpr uint64_t s_materialShift = 28;
+static constexpr uint64_t s_textureShift = 12;
+#endif
+
+
+void RenderBatch::AddCommand(const RenderCommand& command, RenderQueueType queueType)
+{
+	XASSERT(command.drawable != nullptr, "[RenderBatch::AddCommand] command.drawable is nullptr");
+
+	RenderCommandHandle handle;
+	handle.queueType = queueType;
+
+	std::vector<RenderCommand>& commands = GetCommands(queueType);
+	handle.index = commands.size();
+
+	std::vector<RenderCommandHandle>& drawableHandles = command.drawable->m_renderCommandHandles;
+	if (queueType == RenderQueueType::Sprite || queueType == RenderQueueType::UI)
+	{
+		// Those queues are not sorted, a recreated command goes back to the position of its drawable instead of the end of the queue
+		const uint64_t drawOrder = command.drawable->m_drawOrder;
+		if (!commands.empty() && commands.back().sortKey > drawOrder)
+		{
+			handle.index = std::upper_bound(commands.begin(), commands.end(), drawOrder,
+				[](uint64_t order, const RenderCommand& otherCommand) { return order < otherCommand.sortKey; }) - commands.begin();
+		}
+		RenderCommand& addedCommand = *commands.insert(commands.begin() + handle.index, command);
+		addedCommand.handleIndex = drawableHandles.size();
+		addedCommand.sortKey = drawOrder;
+
+		const size_t commandCount = commands.size();
+		for (size_t i = handle.index + 1; i < commandCount; i++)
+		{
+			const RenderCommand& movedCommand = commands[i];
+			movedCommand.drawable->m_renderCommandHandles[movedCommand.handleIndex].index = i;
+		}
+	}
+	else
+	{
+		commands.push_back(command);
+		RenderCommand& addedCommand = commands.back();
+		addedCommand.handleIndex = drawableHandles.size();
+		if (queueType == RenderQueueType::Opaque)
+		{
+			XASSERT(command.material != nullptr, "[RenderBatch::AddCommand] An opaque command needs a material");
+			// The depth bucket is set every frame when sorting
+			addedCommand.sortKey = GetStateSortKey(*command.material);
+		}
+	}
+	drawableHandles.push_back(handle);
+	GetCommandCounter(queueType)++;
+}
+
+void RenderBatch::RemoveCommands(IDrawable& drawable)
+{
+	for (const RenderCommandHandle& handle : drawable.m_renderCommandHandles)
+	{
+		std::vector<RenderCommand>& commands = GetCommands(handle.queueType);
+		XASSERT(handle.index < commands.size() && commands[handle.index].drawable == &drawable, "[RenderBatch::RemoveCommands] Invalid render command handle");
+
+		const size_t lastIndex = commands.size() - 1;
+		if (handle.queueType == RenderQueueType::Sprite || handle.queueType == RenderQueueType::UI)
+		{
+			// Those queues are drawn in insertion order, keep the order of the other commands
+			commands.erase(commands.begin() + handle.index);
+			for (size_t i = handle.index; i < lastIndex; i++)
+			{
+				const RenderCommand& movedCommand = commands[i];
+				movedCommand.drawable->m_renderCommandHandles[movedCommand.handleIndex].index = i;
+			}
+		}
+		else
+		{
+			// Other queues are sorted every frame, swap with the last command
+			if (handle.index != lastIndex)
+			{
+				commands[handle.index] = commands[lastIndex];
+				const RenderCommand& movedCommand = commands[handle.index];
+				movedCommand.drawable->m_renderCommandHandles[movedCommand.handleIndex].index = handle.index;
+			}
+			commands.pop_back();
+		}
+		GetCommandCounter(handle.queueType)--;
+	}
+	drawable.m_renderCommandHandles.clear();
+}
+
+void RenderBatch::SetCommandsEnabled(IDrawable& drawable, bool isEnabled)
+{
+	for (const RenderCommandHandle& handle : drawable.m_renderCommandHandles)
+	{
+		GetCommands(handle.queueType)[handle.index].isEnabled = isEnabled;
+	}
+}
+
+void RenderBatch::RefreshHandles(RenderQueueType queueType)
+{
+	std::vector<RenderCommand>& commands = GetCommands(queueType);
+	const size_t commandCount = commands.size();
+	for (size_t i = 0; i < commandCount; i++)
+	{
+		const RenderCommand& command = commands[i];
+		command.drawable->m_renderCommandHandles[command.handleIndex].index = i;
+	}
+}
+
+void RenderBatch::SortOpaqueCommands(const Vector3& cameraPosition, float maxDistance)
+{
+	const size_t commandCount = opaqueMeshCommands.size();
+	if (commandCount <= 1)
+		return;
+
+	// Update the depth bucket of each command
+	const float distanceToBucket = maxDistance > 0 ? s_depthBucketMax / maxDistance : 0;
+	m_sortedKeys.resize(commandCount);
+	for (size_t i = 0; i < commandCount; i++)
+	{
+		RenderCommand& command = opaqueMeshCommands[i];
+		const float distance = Vector3::Distance(command.transform->GetPosition(), cameraPosition) * distanceToBucket;
+		const uint64_t depthBucket = distance < s_depthBucketMax ? static_cast<uint64_t>(distance) : s_depthBucketMax;
+		command.sortKey = (command.sortKey & ~(s_depthBucketMax << s_depthBucketShift)) | (depthBucket << s_depthBucketShift);
+		m_sortedKeys[i] = { command.sortKey, static_cast<uint32_t>(i) };
+	}
+
+	// LSD radix sort, 8 bits per pass, passes where every key has the same byte are skipped
+	m_sortedKeysTemp.resize(commandCount);
+	for (uint64_t shift = 0; shift < 64; shift += 8)
+	{
+		size_t counts[256] = { 0 };
+		for (const std::pair<uint64_t, uint32_t>& key : m_sortedKeys)
+		{
+			counts[(key.first >> shift) & 0xFF]++;
+		}
+
+		if (counts[(m_sortedKeys[0].first >> shift) & 0xFF] == commandCount)
+			continue;
+
+		size_t offset = 0;
+		for (size_t& count : counts)
+		{
+			const size_t bucketCount = count;
+			count = offset;
+			offset += bucketCount;
+		}
+
+		for (const std::pair<uint64_t, uint32_t>& key : m_sortedKeys)
+		{
+			m_sortedKeysTemp[counts[(key.first >> shift) & 0xFF]++] = key;
+		}
+		m_sortedKeys.swap(m_sortedKeysTemp);
+	}
+
+	m_sortedCommandsTemp.resize(commandCount);
+	for (size_t i = 0; i < commandCount; i++)
+	{
+		m_sortedCommandsTemp[i] = opaqueMeshCommands[m_sortedKeys[i].second];
+	}
+	opaqueMeshCommands.swap(m_sortedCommandsTemp);
+	RefreshHandles(RenderQueueType::Opaque);
+}
+
+void RenderBatch::Reset()
+{
+	// Invalidate the handles of the drawables that still have commands in the batch
+	for (std::vector<RenderCommand>* commands : { &opaqueMeshCommands, &transparentMeshCommands, &spriteCommands, &uiCommands })
+	{
+		for (const RenderCommand& command : *commands)
+		{
+			command.drawable->m_renderCommandHandles.clear();
+		}
+		commands->clear();
+	}
+
+	opaqueMeshCommandIndex = 0;
+	transparentMeshCommandIndex = 0;
+	spriteCommandIndex = 0;
+	uiCommandIndex = 0;
+	m_sortKeyIds.clear();
+}
+
+std::vector<RenderCommand>& RenderBatch::GetCommands(RenderQueueType queueType)
+{
+	switch (queueType)
+	{
+	case RenderQueueType::Opaque:
+		return opaqueMeshCommands;
+	case RenderQueueType::Transparent:
+		return transparentMeshCommands;
+	case RenderQueueType::Sprite:
+		return spriteCommands;
+	case RenderQueueType::UI:
+	default:
+		return uiCommands;
+	}
+}
+
+size_t& RenderBatch::GetCommandCounter(RenderQueueType queueType)
+{
+	switch (queueType)
+	{
+	case RenderQueueType::Opaque:
+		return opaqueMeshCommandIndex;
+	case RenderQueueType::Transparent:
+		return transparentMeshCommandIndex;
+	case RenderQueueType::Sprite:
+		return spriteCommandIndex;
+	case RenderQueueType::UI:
+	default:
+		return uiCommandIndex;
+	}
+}
+
+uint64_t RenderBatch::GetStateSortKey(const Material& material)
+{
+	const uint64_t renderingMode = static_cast<uint64_t>(material.GetRenderingMode()) & 0x3;
+	const uint64_t shaderId = material.GetShader() ? GetSortKeyId(material.GetShader()->GetFileId()) : 0;
+	const uint64_t materialId = GetSortKeyId(material.GetFileId());
+	const uint64_t textureId = material.GetTexture() ? GetSortKeyId(material.GetTexture()->GetFileId()) : 0;
+
+	return (renderingMode << s_renderingModeShift) | (shaderId << s_shaderShift) | (materialId << s_materialShift) | (textureId << s_textureShift);
+}
+
+uint16_t RenderBatch::GetSortKeyId(uint64_t fileId)
+{
+	const auto it = m_sortKeyIds.find(fileId);
+	if (it != m_sortKeyIds.end())
+		return it->second;
+
+	// 0 is used for missing files, wrap around if there are more than 65535 files (the sort is less effective but still valid)
+	const uint16_t id = static_cast<uint16_t>(m_sortKeyIds.size() % 0xFFFF + 1);
+	m_sortKeyIds[fileId] = id;
+	return id;
+}
@@ -7,12 +7,34 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <utility>
 
 #include <engine/graphics/3d_graphics/mesh_data.h>
 #include <engine/constants.h>
 
 class Material;
 class IDrawable;
+class Vector3;
+
+enum class RenderQueueType : uint8_t
+{
+	Opaque,
+	Transparent,
+	Sprite,
+	UI,
+};
+
+/**
+* @brief Location of a render command in the render batch, owned by the drawable that created the command
+*/
+class RenderCommandHandle
+{
+public:
+	RenderQueueType queueType = RenderQueueType::Opaque;
+	size_t index = 0; // Index of the command in its queue
+};
 
 class RenderCommand
 {
@@ -21,55 +43,88 @@ public:
 	Material* material = nullptr;
 	const MeshData::SubMesh* subMesh = nullptr;
 	IDrawable* drawable = nullptr;
+	size_t handleIndex = 0; // Index of the command handle in the drawable's handle list
+	uint64_t sortKey = 0; // Opaque commands: render state and depth, see RenderBatch::SortOpaqueCommands. Sprite and UI commands: draw order of the drawable
 	bool isEnabled;
 };
 
-class RenderQueue 
-{
-public:
-	std::vector<RenderCommand> commands;
-	int commandIndex = 0;
-};
-
 class RenderBatch
 {
 public:
-	// uint64_t = material id
-	std::unordered_map<uint64_t, RenderQueue> renderQueues;
-#if defined(ENABLE_OVERDRAW_OPTIMIZATION)
 	std::vector<RenderCommand> opaqueMeshCommands;
-#endif
 	std::vector<RenderCommand> transparentMeshCommands;
 	std::vector<RenderCommand> spriteCommands;
 	std::vector<RenderCommand> uiCommands;
-#if defined(ENABLE_OVERDRAW_OPTIMIZATION)
 	size_t opaqueMeshCommandIndex = 0;
-#endif
 	size_t transparentMeshCommandIndex = 0;
 	size_t spriteCommandIndex = 0;
 	size_t uiCommandIndex = 0;
 
+	/**
+	* @brief Add a command to a queue and give a handle of the command to its drawable
+	* @brief The sprite and UI commands are inserted at the position of their drawable in the drawable list
+	* @param command The command to add (command.drawable must be set)
+	* @param queueType The queue where to add the command
+	*/
+	void AddCommand(const RenderCommand& command, RenderQueueType queueType);
+
+	/**
+	* @brief Remove all the commands of a drawable
+	* @param drawable The drawable
+	*/
+	void RemoveCommands(IDrawable& drawable);
+
+	/**
+	* @brief Set the enabled state of all the commands of a drawable
+	* @param drawable The drawable
+	* @param isEnabled The new state
+	*/
+	void SetCommandsEnabled(IDrawable& drawable, bool isEnabled);
+
+	/**
+	* @brief Update the handles of the commands of a queue after the queue has been reordered
+	* @param queueType The queue type
+	*/
+	void RefreshHandles(RenderQueueType queueType);
+
+	/**
+	* @brief Sort the opaque commands by render state (rendering mode, shader, material, texture) then front to back
+	* @brief (With ENABLE_OVERDRAW_OPTIMIZATION, the distance is sorted before the shader)
+	* @param cameraPosition The position of the camera
+	* @param maxDistance The distance of the last depth bucket (camera far plane)
+	*/
+	void SortOpaqueCommands(const Vector3& cameraPosition, float maxDistance);
+
 	/**
 	* @brief Reset the render batch
 	*/
-	void Reset()
-	{
-		for (auto& renderQueue : renderQueues)
-		{
-			renderQueue.second.commands.clear();
-			renderQueue.second.commandIndex = 0;
-		}
-#if defined(ENABLE_OVERDRAW_OPTIMIZATION)
-		opaqueMeshCommandIndex = 0;
-#endif
-		transparentMeshCommandIndex = 0;
-		spriteCommandIndex = 0;
-		uiCommandIndex = 0;
-#if defined(ENABLE_OVERDRAW_OPTIMIZATION)
-		opaqueMeshCommands.clear();
-#endif
-		transparentMeshCommands.clear();
-		spriteCommands.clear();
-		uiCommands.clear();
-	}
+	void Reset();
+
+private:
+	/**
+	* @brief Get the list of commands of a queue
+	*/
+	std::vector<RenderCommand>& GetCommands(RenderQueueType queueType);
+
+	/**
+	* @brief Get the command counter of a queue
+	*/
+	size_t& GetCommandCounter(RenderQueueType queueType);
+
+	/**
+	* @brief Get the render state part of the sort key of a material (everything except the depth bucket)
+	*/
+	uint64_t GetStateSortKey(const Material& material);
+
+	/**
+	* @brief Get a small id for a file, used to pack files ids in the sort key
+	*/
+	uint16_t GetSortKeyId(uint64_t fileId);
+
+	// File id -> small id, ids are given in order of appearance since the last reset
+	std::unordered_map<uint64_t, uint16_t> m_sortKeyIds;
+	// Sort key and command index, used for the radix sort
+	std::vector<std::pair<uint64_t, uint32_t>> m_sortedKeys;
+	std::vector<std::pair<uint64_t, uint32_t>> m_sortedKeysTemp;
+	std::vector<RenderCommand> m_sortedCommandsTemp;
 };
\ No newline at end of file
@@ -104,6 +104,10 @@ public:
 	virtual void DrawSubMesh(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings) = 0;
 	virtual void DrawLine(const Vector3& a, const Vector3& b, const Color& color, RenderingSettings& settings) = 0;
 
+	// Instancing
+	virtual bool SupportsInstancing() const { return false; }
+	virtual void DrawSubMeshInstanced([[maybe_unused]] const MeshData::SubMesh& subMesh, [[maybe_unused]] const Material& material, [[maybe_unused]] const Texture& texture, [[maybe_unused]] RenderingSettings& settings, [[maybe_unused]] const glm::mat4* modelMatrices, [[maybe_unused]] const glm::vec4* instanceColors, [[maybe_unused]] size_t instanceCount) {}
+
 	virtual void Setlights(const LightsIndices& lightsIndices) = 0;
 
 	//Shader
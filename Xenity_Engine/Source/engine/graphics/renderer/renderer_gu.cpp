@@ -348,6 +348,7 @@ void RendererGU::DrawSubMesh(const MeshData::SubMesh& subMesh, const Material& m
 	{
 		usedTexture = guTexture.data[0];
 		texture.Bind();
+		Performance::AddStateChange();
 	}
 	sceGuTexOffset(material.GetOffset().x, material.GetOffset().y);
 	sceGuTexScale(material.GetTiling().x, material.GetTiling().y);
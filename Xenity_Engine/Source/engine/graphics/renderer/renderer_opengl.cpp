@@ -73,6 +73,20 @@ int RendererOpengl::Init()
 	return result;
 }
 
+void RendererOpengl::ResetVertexColor()
+{
+	if constexpr (Graphics::s_UseOpenGLFixedFunctions)
+	{
+		// Force the next draw to set the color again
+		lastUsedColor = 0x00000000;
+		lastUsedColor2 = 0xFFFFFFFF;
+	}
+	else
+	{
+		glVertexAttrib4f(VERTEX_COLOR_ATTRIBUTE_LOCATION, 1, 1, 1, 1);
+	}
+}
+
 void RendererOpengl::Setup()
 {
 	// TODO: this part needs to be improved
@@ -100,10 +114,21 @@ void RendererOpengl::Setup()
 	lastSettings.useLighting = false;
 	lastSettings.useTexture = true;
 	lastSettings.max_depth = false;
+
+	// Used by the meshes without vertex color
+	ResetVertexColor();
 }
 
 void RendererOpengl::Stop()
 {
+#if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	if (instanceBuffer != 0)
+	{
+		DeleteBuffer(instanceBuffer);
+		instanceBuffer = 0;
+		instanceBufferSize = 0;
+	}
+#endif
 #if defined(__vita__)
 	vglEnd();
 #endif
@@ -266,7 +291,7 @@ void RendererOpengl::DrawSubMesh(const MeshData::SubMesh& subMesh, const Materia
 	DrawSubMesh(subMesh, material, *material.GetTexture(), settings);
 }
 
-void RendererOpengl::DrawSubMesh(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings)
+void RendererOpengl::ApplySubMeshState(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings)
 {
 	//float material_ambient[] = { 0.0f, 0.0f, 0.0f, 1.0f };  /* default value */
 	//float material_diffuse[] = { 1.0f, 1.0f, 1.0f, 1.0f };  /* default value */
@@ -406,6 +431,7 @@ void RendererOpengl::DrawSubMesh(const MeshData::SubMesh& subMesh, const Materia
 	{
 		usedTexture = openglTexture.GetTextureId();
 		texture.Bind();
+		Performance::AddStateChange();
 	}
 
 	if constexpr (Graphics::s_UseOpenGLFixedFunctions)
@@ -415,6 +441,11 @@ void RendererOpengl::DrawSubMesh(const MeshData::SubMesh& subMesh, const Materia
 		glTranslatef(material.GetOffset().x, material.GetOffset().y, 0);
 		glScalef(material.GetTiling().x, material.GetTiling().y, 1.0f);
 	}
+}
+
+void RendererOpengl::DrawSubMesh(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings)
+{
+	ApplySubMeshState(subMesh, material, texture, settings);
 
 	// Draw
 	if (!subMesh.meshData->m_hasIndices)
@@ -428,6 +459,12 @@ void RendererOpengl::DrawSubMesh(const MeshData::SubMesh& subMesh, const Materia
 	}
 	glBindVertexArray(0);
 
+	// The current vertex color is undefined after drawing a vertex color array, set it back to white for the other meshes
+	if ((uint32_t)subMesh.meshData->m_vertexDescriptor & (uint32_t)VertexElements::COLOR)
+	{
+		ResetVertexColor();
+	}
+
 #if defined(EDITOR)
 	if (Graphics::usedCamera->IsEditor())
 	{
@@ -439,6 +476,112 @@ void RendererOpengl::DrawSubMesh(const MeshData::SubMesh& subMesh, const Materia
 	glDepthMask(GL_TRUE);
 }
 
+bool RendererOpengl::SupportsInstancing() const
+{
+#if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void RendererOpengl::DrawSubMeshInstanced(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings, const glm::mat4* modelMatrices, const glm::vec4* instanceColors, size_t instanceCount)
+{
+#if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	XASSERT(modelMatrices != nullptr, "[RendererOpengl::DrawSubMeshInstanced] modelMatrices is nullptr");
+
+	if (instanceCount == 0)
+		return;
+
+	ApplySubMeshState(subMesh, material, texture, settings);
+
+	// Upload the model matrices, the buffer only grows to avoid reallocations every frame
+	if (instanceBuffer == 0)
+		instanceBuffer = CreateBuffer();
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	const size_t dataSize = sizeof(glm::mat4) * instanceCount;
+	if (instanceBufferSize < dataSize)
+	{
+		instanceBufferSize = dataSize;
+		glBufferData(GL_ARRAY_BUFFER, instanceBufferSize, modelMatrices, GL_STREAM_DRAW);
+	}
+	else
+	{
+		// Orphan the old storage to not wait for the previous draw call
+		glBufferData(GL_ARRAY_BUFFER, instanceBufferSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, modelMatrices);
+	}
+
+	// A mat4 attribute takes 4 vec4 locations
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		const unsigned int location = INSTANCE_MATRIX_ATTRIBUTE_LOCATION + i;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, false, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * i));
+		glVertexAttribDivisor(location, 1);
+	}
+
+	if (instanceColors)
+	{
+		XASSERT(!subMesh.meshData->m_hasColor, "[RendererOpengl::DrawSubMeshInstanced] The instance colors can't be used with a mesh with vertex colors");
+
+		if (instanceColorBuffer == 0)
+			instanceColorBuffer = CreateBuffer();
+
+		glBindBuffer(GL_ARRAY_BUFFER, instanceColorBuffer);
+		const size_t colorDataSize = sizeof(glm::vec4) * instanceCount;
+		if (instanceColorBufferSize < colorDataSize)
+		{
+			instanceColorBufferSize = colorDataSize;
+			glBufferData(GL_ARRAY_BUFFER, instanceColorBufferSize, instanceColors, GL_STREAM_DRAW);
+		}
+		else
+		{
+			glBufferData(GL_ARRAY_BUFFER, instanceColorBufferSize, nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, colorDataSize, instanceColors);
+		}
+		glEnableVertexAttribArray(VERTEX_COLOR_ATTRIBUTE_LOCATION);
+		glVertexAttribPointer(VERTEX_COLOR_ATTRIBUTE_LOCATION, 4, GL_FLOAT, false, sizeof(glm::vec4), (void*)0);
+		glVertexAttribDivisor(VERTEX_COLOR_ATTRIBUTE_LOCATION, 1);
+	}
+
+	// Draw
+	if (!subMesh.meshData->m_hasIndices)
+	{
+		glDrawArraysInstanced(GL_TRIANGLES, 0, subMesh.vertice_count, static_cast<GLsizei>(instanceCount));
+	}
+	else
+	{
+		const int indiceMode = subMesh.isShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		glDrawElementsInstanced(GL_TRIANGLES, subMesh.index_count, indiceMode, 0, static_cast<GLsizei>(instanceCount));
+	}
+
+	// The sub mesh VAO is also used by non instanced draws
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		glDisableVertexAttribArray(INSTANCE_MATRIX_ATTRIBUTE_LOCATION + i);
+	}
+	if (instanceColors)
+	{
+		// The disabled location gives the white color of ResetVertexColor again
+		glVertexAttribDivisor(VERTEX_COLOR_ATTRIBUTE_LOCATION, 0);
+		glDisableVertexAttribArray(VERTEX_COLOR_ATTRIBUTE_LOCATION);
+	}
+	glBindVertexArray(0);
+
+#if defined(EDITOR)
+	if (Graphics::usedCamera->IsEditor())
+	{
+		Performance::AddDrawTriangles((subMesh.vertice_count / 3) * static_cast<int>(instanceCount));
+		Performance::AddDrawCall();
+	}
+#endif
+
+	glDepthMask(GL_TRUE);
+#endif
+}
+
 // TODO : Improve this function, it's not optimized and using shaders
 void RendererOpengl::DrawLine(const Vector3& a, const Vector3& b, const Color& color, RenderingSettings& settings)
 {
@@ -803,15 +946,30 @@ void RendererOpengl::UploadMeshData(MeshData& meshData)
 		}
 		else
 		{
-			if ((uint32_t)meshData.m_vertexDescriptor & (uint32_t)VertexElements::UV_32_BITS)
+			if (((uint32_t)meshData.m_vertexDescriptor & (uint32_t)VertexElements::UV_32_BITS) && ((uint32_t)meshData.m_vertexDescriptor & (uint32_t)VertexElements::COLOR))
 			{
-				/*if (meshData.m_hasColor)
+				stride = sizeof(Vertex);
+				if constexpr (Graphics::s_UseOpenGLFixedFunctions)
 				{
-					stride = sizeof(Vertex);
-					glTexCoordPointer(2, GL_FLOAT, stride, (void*)offsetof(Vertex, u));
-					glColorPointer(3, GL_FLOAT, stride, (void*)offsetof(Vertex, r));
+					glEnableClientState(GL_VERTEX_ARRAY);
 					glVertexPointer(3, GL_FLOAT, stride, (void*)offsetof(Vertex, x));
-				}else*/
+					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+					glTexCoordPointer(2, GL_FLOAT, stride, (void*)offsetof(Vertex, u));
+					glEnableClientState(GL_COLOR_ARRAY);
+					glColorPointer(4, GL_FLOAT, stride, (void*)offsetof(Vertex, r));
+				}
+				else
+				{
+					glEnableVertexAttribArray(0);
+					glVertexAttribPointer(0, 3, GL_FLOAT, false, stride, (void*)offsetof(Vertex, x));
+					glEnableVertexAttribArray(1);
+					glVertexAttribPointer(1, 2, GL_FLOAT, false, stride, (void*)offsetof(Vertex, u));
+					glEnableVertexAttribArray(VERTEX_COLOR_ATTRIBUTE_LOCATION);
+					glVertexAttribPointer(VERTEX_COLOR_ATTRIBUTE_LOCATION, 4, GL_FLOAT, false, stride, (void*)offsetof(Vertex, r));
+				}
+			}
+			else if ((uint32_t)meshData.m_vertexDescriptor & (uint32_t)VertexElements::UV_32_BITS)
+			{
 				stride = sizeof(VertexNoColor);
 				if constexpr (Graphics::s_UseOpenGLFixedFunctions)
 				{
@@ -56,6 +56,8 @@ public:
 	void BindTexture(const Texture& texture) override;
 	void DrawSubMesh(const MeshData::SubMesh& subMesh, const Material& material, RenderingSettings& settings) override;
 	void DrawSubMesh(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings) override;
+	bool SupportsInstancing() const override;
+	void DrawSubMeshInstanced(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings, const glm::mat4* modelMatrices, const glm::vec4* instanceColors, size_t instanceCount) override;
 	void DrawLine(const Vector3& a, const Vector3& bn, const Color& color, RenderingSettings& settings) override;
 	unsigned int CreateNewTexture() override;
 	void DeleteTexture(Texture& texture) override;
@@ -73,6 +75,7 @@ public:
 	void Setlights(const LightsIndices& lightsIndices) override;
 
 private:
+	void ApplySubMeshState(const MeshData::SubMesh& subMesh, const Material& material, const Texture& texture, RenderingSettings& settings);
 	void ApplyTextureFilters(const Texture& texture);
 	unsigned int CreateVertexArray();
 	unsigned int CreateBuffer();
@@ -99,6 +102,21 @@ private:
 	unsigned int lastUsedColor = 0x00000000;
 	unsigned int lastUsedColor2 = 0xFFFFFFFF;
 	uint64_t lastShaderIdUsedColor = 0;
+
+	/**
+	* @brief Set the vertex color used by the meshes without vertex color (white)
+	*/
+	void ResetVertexColor();
+
+	static constexpr unsigned int VERTEX_COLOR_ATTRIBUTE_LOCATION = 3;
+
+	// First attribute location of the per instance model matrix (uses 4 locations)
+	static constexpr unsigned int INSTANCE_MATRIX_ATTRIBUTE_LOCATION = 4;
+	unsigned int instanceBuffer = 0;
+	size_t instanceBufferSize = 0;
+	// Per instance colors, given on the vertex color location (only for the meshes without vertex color)
+	unsigned int instanceColorBuffer = 0;
+	size_t instanceColorBufferSize = 0;
 	// int GetDrawModeEnum(DrawMode drawMode);
 };
 #endif
\ No newline at end of file
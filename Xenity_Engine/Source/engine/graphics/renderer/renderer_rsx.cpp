@@ -678,6 +678,7 @@ void RendererRSX::DrawSubMesh(const MeshData::SubMesh& subMesh, const Material&
 	{
 		usedTexture = ps3Texture.m_ps3buffer;
 		texture.Bind();
+		Performance::AddStateChange();
 		//m_lighintDataTexture->Bind();
 	}
 
@@ -192,6 +192,16 @@ protected:
 	*/
 	virtual void SetShaderModel(const Vector3& position, const Vector3& eulerAngle, const Vector3& scale) = 0;
 
+	/**
+	* @brief Get if the shader can read the model matrix from a per instance vertex attribute
+	*/
+	virtual bool SupportsInstancing() const { return false; }
+
+	/**
+	* @brief Use the per instance model matrix instead of the model uniform
+	*/
+	virtual void SetShaderInstancing([[maybe_unused]] bool useInstancing) {}
+
 	virtual void SetLightIndices(const LightsIndices& lightsIndices) = 0;
 
 	/**
@@ -325,6 +325,20 @@ void ShaderOpenGL::SetShaderModel(const Vector3& position, const Vector3& rotati
 	SetShaderModel(transformationMatrix);
 }
 
+bool ShaderOpenGL::SupportsInstancing() const
+{
+	return m_useInstancingLocation != INVALID_SHADER_UNIFORM;
+}
+
+void ShaderOpenGL::SetShaderInstancing(bool useInstancing)
+{
+	if (m_useInstancingLocation == INVALID_SHADER_UNIFORM || m_isInstancingUsed == useInstancing)
+		return;
+
+	m_isInstancingUsed = useInstancing;
+	SetShaderAttribut(m_useInstancingLocation, useInstancing ? 1 : 0);
+}
+
 void ShaderOpenGL::SetShaderOffsetAndTiling(const Vector2& offset, const Vector2& tiling)
 {
 	SetShaderAttribut(m_offsetLocation, offset);
@@ -453,6 +467,7 @@ void ShaderOpenGL::Link()
 	m_ambientLightLocation = GetShaderUniformLocation("ambientLight");
 	m_tilingLocation = GetShaderUniformLocation("tiling");
 	m_offsetLocation = GetShaderUniformLocation("offset");
+	m_useInstancingLocation = GetShaderUniformLocation("useInstancing");
 
 	m_usedPointLightCountLocation = GetShaderUniformLocation("usedPointLightCount");
 	m_usedSpotLightCountLocation = GetShaderUniformLocation("usedSpotLightCount");
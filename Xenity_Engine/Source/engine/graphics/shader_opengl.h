@@ -63,6 +63,16 @@ protected:
 	*/
 	void SetShaderModel(const Vector3& position, const Vector3& eulerAngle, const Vector3& scale) override;
 
+	/**
+	* @brief Get if the shader has the useInstancing uniform
+	*/
+	bool SupportsInstancing() const override;
+
+	/**
+	* @brief Use the per instance model matrix instead of the model uniform
+	*/
+	void SetShaderInstancing(bool useInstancing) override;
+
 	void SetShaderOffsetAndTiling(const Vector2& offset, const Vector2& tiling) override;
 
 	void SetLightIndices(const LightsIndices& lightsIndices) override;
@@ -188,6 +198,8 @@ protected:
 	unsigned int m_ambientLightLocation = 0;
 	unsigned int m_tilingLocation = 0;
 	unsigned int m_offsetLocation = 0;
+	unsigned int m_useInstancingLocation = INVALID_SHADER_UNIFORM;
+	bool m_isInstancingUsed = false;
 
 	unsigned int m_usedPointLightCountLocation = 0;
 	unsigned int m_usedSpotLightCountLocation = 0;
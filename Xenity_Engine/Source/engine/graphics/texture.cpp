@@ -21,7 +21,6 @@
 #include <pspkernel.h>
 #include <vram.h>
 #elif defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
-#include <thread>
 #include <glad/glad.h>
 #elif defined(_EE)
 // #include "renderer/renderer_gskit.h"
@@ -43,6 +42,7 @@
 #include <engine/debug/memory_tracker.h>
 #include <engine/asset_management/project_manager.h>
 #include <engine/debug/performance.h>
+#include <engine/assertions/assertions.h>
 #include <engine/debug/stack_debug_object.h>
 
 #include "renderer/renderer.h"
@@ -117,15 +117,30 @@ void Texture::LoadFileReference()
 	{
 		m_fileStatus = FileStatus::FileStatus_Loading;
 
-#if defined(EDITOR)
-		AsyncFileLoading::AddFile(shared_from_this());
+		// The sprites are drawn with the atlas page of the texture if the cooker has packed it
+		const TextureSettings& settings = *m_settings[Application::GetAssetPlatform()];
+		if (settings.atlasPageId != 0)
+		{
+			const std::shared_ptr<Texture> atlasPage = std::dynamic_pointer_cast<Texture>(ProjectManager::GetFileReferenceById(settings.atlasPageId));
+			if (atlasPage)
+			{
+				SetAtlasRegion(atlasPage, Vector4(settings.atlasUvX, settings.atlasUvY, settings.atlasUvWidth, settings.atlasUvHeight));
+				atlasPage->LoadFileReference();
+			}
+			else
+			{
+				Debug::PrintWarning("[Texture::LoadFileReference] Atlas page not found: " + std::to_string(settings.atlasPageId), true);
+			}
+		}
 
-		std::thread threadLoading = std::thread(&Texture::CreateTexture, this, GetFilter(), GetUseMipmap());
-		threadLoading.detach();
-#else
-		CreateTexture(GetFilter(), GetUseMipmap());
-		OnLoadFileReferenceFinished();
-#endif
+		// The file is kept alive by the job
+		const std::shared_ptr<FileReference> thisShared = shared_from_this();
+		const Filter filter = GetFilter();
+		const bool useMipmap = GetUseMipmap();
+		AsyncFileLoading::LoadFile(thisShared, [this, thisShared, filter, useMipmap]()
+			{
+				CreateTexture(filter, useMipmap);
+			});
 	}
 }
 
@@ -135,11 +150,41 @@ void Texture::UnloadFileReference()
 
 	if (Engine::IsRunning(true))
 	{
+		// The GPU upload of a loading texture has to be done before unloading it
+		AsyncFileLoading::WaitForFile(*this);
+
 		if (m_fileStatus == FileStatus::FileStatus_Loaded)
 		{
 			m_fileStatus = FileStatus::FileStatus_Not_Loaded;
 			Unload();
 		}
+
+		// Do not keep the atlas page alive, it is unloaded when no texture uses it anymore
+		m_atlasPage.reset();
+	}
+}
+
+Texture* Texture::GetAtlasPage() const
+{
+	if (m_atlasPage && m_atlasPage->m_fileStatus == FileStatus::FileStatus_Loaded && m_atlasPage->IsValid())
+	{
+		return m_atlasPage.get();
+	}
+	return nullptr;
+}
+
+void Texture::SetAtlasRegion(const std::shared_ptr<Texture>& atlasPage, const Vector4& uvRect)
+{
+	XASSERT(atlasPage.get() != this, "[Texture::SetAtlasRegion] A texture can't be its own atlas page");
+
+	m_atlasPage = atlasPage;
+	if (atlasPage)
+	{
+		m_atlasUvRect = uvRect;
+	}
+	else
+	{
+		m_atlasUvRect = Vector4(0, 0, 1, 1);
 	}
 }
 
@@ -175,39 +220,64 @@ void Texture::CreateTexture(const Filter filter, const bool useMipMap)
 void Texture::LoadTexture()
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
-	
+
+	m_buffer = ReadPixels(m_width, height, nrChannels);
+	if (!m_buffer)
+	{
+		m_fileStatus = FileStatus::FileStatus_Failed;
+		return;
+	}
+
+#if defined (DEBUG)
+	Performance::s_textureMemoryTracker->Allocate(m_width * height * 4);
+#endif
+	m_fileStatus = FileStatus::FileStatus_Loaded;
+}
+
+unsigned char* Texture::ReadPixels(int& width, int& height, int& channelCount)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
 	bool openResult = true;
 #if defined(EDITOR)
 	openResult = m_file->Open(FileMode::ReadOnly);
 #endif
-	if (openResult)
+	if (!openResult)
 	{
-		size_t fileBufferSize = m_fileSize;
-		unsigned char* fileData = nullptr;
+		Debug::PrintError("[Texture::ReadPixels] Failed to open texture file", true);
+		return nullptr;
+	}
+
+	size_t fileBufferSize = m_fileSize;
+	unsigned char* fileData = nullptr;
 #if defined(EDITOR)
-		fileData = m_file->ReadAllBinary(fileBufferSize);
-		m_file->Close();
+	fileData = m_file->ReadAllBinary(fileBufferSize);
+	m_file->Close();
 #else
-		fileData = ProjectManager::fileDataBase.GetBitFile().ReadBinary(m_filePosition, fileBufferSize);
+	fileData = ProjectManager::fileDataBase.GetBitFile().ReadBinary(m_filePosition, fileBufferSize);
 #endif
 
-		// Only for editor, live resizing
+	unsigned char* pixels = nullptr;
+
+	// Only for editor, live resizing
 #if defined(EDITOR)
-		// Load image with stb_image
-		unsigned char* data2 = stbi_load_from_memory(fileData, static_cast<int>(fileBufferSize), &m_width, &height,
-									   &nrChannels, 4);
-		free(fileData);
-		int newWidth = m_width;
+	// Load image with stb_image
+	unsigned char* data2 = stbi_load_from_memory(fileData, static_cast<int>(fileBufferSize), &width, &height,
+								   &channelCount, 4);
+	free(fileData);
+	if (data2)
+	{
+		int newWidth = width;
 		int newHeight = height;
 		const int cookResolution = static_cast<int>(GetCookResolution());
 		if((newWidth > height) && newWidth > cookResolution)
 		{
-			newHeight = static_cast<int>(height * (static_cast<float>(GetCookResolution()) / static_cast<float>(m_width)));
+			newHeight = static_cast<int>(height * (static_cast<float>(GetCookResolution()) / static_cast<float>(width)));
 			newWidth = cookResolution;
 		}
-		else if((newHeight > m_width) && newHeight > cookResolution)
+		else if((newHeight > width) && newHeight > cookResolution)
 		{
-			newWidth = static_cast<int>(m_width * (static_cast<float>(GetCookResolution()) / static_cast<float>(height)));
+			newWidth = static_cast<int>(width * (static_cast<float>(GetCookResolution()) / static_cast<float>(height)));
 			newHeight = cookResolution;
 		}
 		else if ((newWidth == newHeight) && newWidth > cookResolution)
@@ -216,37 +286,26 @@ void Texture::LoadTexture()
 			newHeight = cookResolution;
 		}
 
-		m_buffer = static_cast<unsigned char*>(malloc(newWidth * newHeight * 4));
-		stbir_resize_uint8(data2, m_width, height, 0, m_buffer, newWidth, newHeight, 0, 4);
+		pixels = static_cast<unsigned char*>(malloc(newWidth * newHeight * 4));
+		stbir_resize_uint8(data2, width, height, 0, pixels, newWidth, newHeight, 0, 4);
 		free(data2);
-		m_width = newWidth;
+		width = newWidth;
 		height = newHeight;
+	}
 #else
-		// Load image with stb_image
-		m_buffer = stbi_load_from_memory(fileData, fileBufferSize, &m_width, &height,
-			&nrChannels, 4);
+	// Load image with stb_image
+	pixels = stbi_load_from_memory(fileData, fileBufferSize, &width, &height,
+		&channelCount, 4);
 
-		free(fileData);
+	free(fileData);
 #endif
 
-		if (!m_buffer)
-		{
-			Debug::PrintError("[Texture::LoadTexture] Failed to load texture", true);
-			m_fileStatus = FileStatus::FileStatus_Failed;
-			return;
-		}
-
-#if defined (DEBUG)
-		Performance::s_textureMemoryTracker->Allocate(m_width * height * 4);
-#endif
-	}
-	else
+	if (!pixels)
 	{
-		Debug::PrintError("[Texture::LoadTexture] Failed to open texture file", true);
-		m_fileStatus = FileStatus::FileStatus_Failed;
-		return;
+		Debug::PrintError("[Texture::ReadPixels] Failed to load texture", true);
 	}
-	m_fileStatus = FileStatus::FileStatus_Loaded;
+
+	return pixels;
 }
 
 #pragma endregion
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include <engine/file_system/file_reference.h>
 #include <engine/reflection/reflection.h>
 #include <engine/graphics/2d_graphics/sprite_selection.h>
+#include <engine/vectors/vector4.h>
 #include <engine/reflection/enum_utils.h>
 #include <engine/platform.h>
 #include <engine/application.h>
@@ -36,6 +37,14 @@ public:
 	bool useMipMap = false;
 	int mipmaplevelCount = 0;
 	int pixelPerUnit = 100;
+	bool packInAtlas = false; // If true, the cooker packs the texture in an atlas page shared with other small textures (ClampToEdge wrap mode only)
+
+	// Set by the cooker in the cooked meta file when the texture is packed in an atlas page
+	uint64_t atlasPageId = 0;
+	float atlasUvX = 0;
+	float atlasUvY = 0;
+	float atlasUvWidth = 1;
+	float atlasUvHeight = 1;
 
 	ReflectiveData GetReflectiveData() override
 	{
@@ -46,8 +55,23 @@ public:
 		Reflective::AddVariable(reflectedVariables, filter, "filter", true);
 		Reflective::AddVariable(reflectedVariables, wrapMode, "wrapMode", true);
 		Reflective::AddVariable(reflectedVariables, pixelPerUnit, "pixelPerUnit", true);
+		Reflective::AddVariable(reflectedVariables, packInAtlas, "packInAtlas", true);
+		AddAtlasVariables(reflectedVariables);
 		return reflectedVariables;
 	}
+
+protected:
+	/**
+	* @brief Add the atlas variables written by the cooker, hidden in the inspector
+	*/
+	void AddAtlasVariables(ReflectiveData& reflectedVariables)
+	{
+		Reflective::AddVariable(reflectedVariables, atlasPageId, "atlasPageId", false);
+		Reflective::AddVariable(reflectedVariables, atlasUvX, "atlasUvX", false);
+		Reflective::AddVariable(reflectedVariables, atlasUvY, "atlasUvY", false);
+		Reflective::AddVariable(reflectedVariables, atlasUvWidth, "atlasUvWidth", false);
+		Reflective::AddVariable(reflectedVariables, atlasUvHeight, "atlasUvHeight", false);
+	}
 };
 
 class TextureSettingsStandalone : public TextureSettings
@@ -75,6 +99,8 @@ public:
 		Reflective::AddVariable(reflectedVariables, filter, "filter", true);
 		Reflective::AddVariable(reflectedVariables, wrapMode, "wrapMode", true);
 		Reflective::AddVariable(reflectedVariables, pixelPerUnit, "pixelPerUnit", true);
+		Reflective::AddVariable(reflectedVariables, packInAtlas, "packInAtlas", true);
+		AddAtlasVariables(reflectedVariables);
 		Reflective::AddVariable(reflectedVariables, type, "type", true);
 		Reflective::AddVariable(reflectedVariables, tryPutInVram, "tryPutInVram", true);
 		return reflectedVariables;
@@ -175,6 +201,20 @@ public:
 		return m_settings.at(Application::GetAssetPlatform())->wrapMode;
 	}
 
+	/**
+	 * @brief Get the atlas page containing this texture
+	 * @return nullptr if the texture is not packed in an atlas page or if the page is not loaded yet
+	 */
+	Texture* GetAtlasPage() const;
+
+	/**
+	 * @brief Get the area of the texture in its atlas page in uv (x, y, width, height)
+	 */
+	inline const Vector4& GetAtlasUvRect() const
+	{
+		return m_atlasUvRect;
+	}
+
 protected:
 	template <class T>
 	friend class SelectAssetMenu;
@@ -196,6 +236,7 @@ protected:
 	friend class ProjectManager;
 	friend class TextManager;
 	friend class Cooker;
+	friend class TextureAtlasBuilder;
 
 	/**
 	* @brief Get texture channel count
@@ -278,6 +319,19 @@ protected:
 	 */
 	void LoadTexture();
 
+	/**
+	 * @brief Read and decode the texture file in RGBA (resized to the cook resolution in the editor)
+	 * @return Pixels to free with free() or nullptr on error
+	 */
+	unsigned char* ReadPixels(int& width, int& height, int& channelCount);
+
+	/**
+	 * @brief Draw the sprites using this texture with an area of an atlas page
+	 * @param atlasPage Atlas page or nullptr to use the texture again
+	 * @param uvRect Area of the texture in the page (x, y, width, height)
+	 */
+	void SetAtlasRegion(const std::shared_ptr<Texture>& atlasPage, const Vector4& uvRect);
+
 	/**
 	 * @brief Unload texture data
 	 */
@@ -288,6 +342,9 @@ protected:
 	unsigned char* m_buffer = nullptr;
 	int m_width = 0, height = 0, nrChannels = 0;
 
+	std::shared_ptr<Texture> m_atlasPage;
+	Vector4 m_atlasUvRect = Vector4(0, 0, 1, 1);
+
 #if defined(EDITOR)
 	TextureResolutions previousResolution = TextureResolutions::R_2048x2048;
 #endif
@@ -37,12 +37,12 @@ void Canvas::OnReflectionUpdated()
 
 void Canvas::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void Canvas::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void Canvas::CreateRenderCommands(RenderBatch& renderBatch)
@@ -52,8 +52,7 @@ void Canvas::CreateRenderCommands(RenderBatch& renderBatch)
 	command.transform = GetTransformRaw();
 	command.isEnabled = IsEnabled() && GetGameObject()->IsLocalActive();
 
-	renderBatch.uiCommands.push_back(command);
-	renderBatch.uiCommandIndex++;
+	renderBatch.AddCommand(command, RenderQueueType::UI);
 }
 
 void Canvas::DrawCommand(const RenderCommand& renderCommand)
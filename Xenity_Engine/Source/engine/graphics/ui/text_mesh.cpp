@@ -40,7 +40,7 @@ void TextMesh::OnReflectionUpdated()
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
 	m_isTextInfoDirty = true;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 TextMesh::~TextMesh()
@@ -71,23 +71,24 @@ void TextMesh::SetFont(const std::shared_ptr<Font>& font)
 	{
 		m_font = font;
 		m_isTextInfoDirty = true;
+		Graphics::SetDrawableAsDirty(this);
 	}
 }
 
 void TextMesh::SetMaterial(std::shared_ptr<Material> _material)
 {
 	m_material = _material;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 void TextMesh::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void TextMesh::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void TextMesh::CreateRenderCommands(RenderBatch& renderBatch)
@@ -101,8 +102,7 @@ void TextMesh::CreateRenderCommands(RenderBatch& renderBatch)
 	command.transform = GetTransformRaw();
 	command.isEnabled = IsEnabled() && GetGameObject()->IsLocalActive();
 
-	renderBatch.transparentMeshCommands.push_back(command);
-	renderBatch.transparentMeshCommandIndex++;
+	renderBatch.AddCommand(command, RenderQueueType::Transparent);
 }
 
 /// <summary>
@@ -40,7 +40,7 @@ void TextRenderer::OnReflectionUpdated()
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
 	m_isTextInfoDirty = true;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 TextRenderer::~TextRenderer()
@@ -71,7 +71,7 @@ void TextRenderer::SetFont(const std::shared_ptr<Font>& font)
 	{
 		m_font = font;
 		m_isTextInfoDirty = true;
-		Graphics::s_isRenderingBatchDirty = true;
+		Graphics::SetDrawableAsDirty(this);
 	}
 }
 
@@ -83,17 +83,17 @@ std::shared_ptr<Material> TextRenderer::GetMaterial()
 void TextRenderer::SetMaterial(std::shared_ptr<Material> material)
 {
 	m_material = material;
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::SetDrawableAsDirty(this);
 }
 
 void TextRenderer::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void TextRenderer::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void TextRenderer::CreateRenderCommands(RenderBatch& renderBatch)
@@ -108,8 +108,7 @@ void TextRenderer::CreateRenderCommands(RenderBatch& renderBatch)
 	command.transform = GetTransformRaw();
 	command.isEnabled = IsEnabled() && GetGameObjectRaw()->IsLocalActive();
 
-	renderBatch.uiCommands.push_back(command);
-	renderBatch.uiCommandIndex++;
+	renderBatch.AddCommand(command, RenderQueueType::UI);
 }
 
 /// <summary>
@@ -0,0 +1,293 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "job_system.h"
+
+#include <algorithm>
+
+#include <engine/assertions/assertions.h>
+#include <engine/debug/stack_debug_object.h>
+
+std::vector<std::unique_ptr<JobSystem::WorkerQueue>> JobSystem::s_queues;
+std::atomic<size_t> JobSystem::s_nextQueueIndex = 0;
+std::vector<std::function<void()>> JobSystem::s_mainThreadContinuations;
+std::vector<std::function<void()>> JobSystem::s_executedContinuations;
+#if defined(JOB_SYSTEM_USE_THREADS)
+std::vector<std::thread> JobSystem::s_workers;
+std::mutex JobSystem::s_wakeMutex;
+std::condition_variable JobSystem::s_wakeCondition;
+size_t JobSystem::s_queuedJobCount = 0;
+bool JobSystem::s_isRunning = false;
+std::mutex JobSystem::s_continuationsMutex;
+thread_local size_t JobSystem::t_workerIndex = JobSystem::NOT_A_WORKER;
+#endif
+
+void JobSystem::Init()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+#if defined(JOB_SYSTEM_USE_THREADS)
+	XASSERT(s_workers.empty(), "[JobSystem::Init] The job system is already initialized");
+
+	// Keep a core for the main thread
+	const size_t hardwareThreadCount = std::thread::hardware_concurrency();
+	const size_t workerCount = hardwareThreadCount > 2 ? hardwareThreadCount - 1 : 1;
+
+	s_isRunning = true;
+	s_queues.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		s_queues.push_back(std::make_unique<WorkerQueue>());
+	}
+	s_workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		s_workers.emplace_back(&JobSystem::WorkerLoop, i);
+	}
+#endif
+}
+
+void JobSystem::Stop()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+#if defined(JOB_SYSTEM_USE_THREADS)
+	{
+		std::lock_guard<std::mutex> lock(s_wakeMutex);
+		s_isRunning = false;
+	}
+	s_wakeCondition.notify_all();
+
+	for (std::thread& worker : s_workers)
+	{
+		worker.join();
+	}
+	s_workers.clear();
+	s_queues.clear();
+
+	std::lock_guard<std::mutex> lock(s_continuationsMutex);
+#endif
+	s_mainThreadContinuations.clear();
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> function, JobPriority priority)
+{
+	return Schedule(std::move(function), nullptr, priority);
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> function, std::function<void()> mainThreadContinuation, JobPriority priority)
+{
+	XASSERT(function != nullptr, "[JobSystem::Schedule] function is nullptr");
+
+	JobHandle handle;
+	handle.m_remainingJobCount = std::make_shared<std::atomic<size_t>>(1);
+	handle.m_priority = priority;
+
+	Job job;
+	job.function = std::move(function);
+	job.mainThreadContinuation = std::move(mainThreadContinuation);
+	job.remainingJobCount = handle.m_remainingJobCount;
+	PushJob(std::move(job), priority);
+
+	return handle;
+}
+
+void JobSystem::Wait(const JobHandle& handle)
+{
+	while (!handle.IsDone())
+	{
+#if defined(JOB_SYSTEM_USE_THREADS)
+		// Help the workers instead of sleeping, this also avoids a deadlock when a job waits for other jobs
+		// The lower priority jobs are left to the workers, they can be much longer than the waited jobs
+		Job job;
+		if (PopJob(t_workerIndex, job, handle.m_priority))
+		{
+			ExecuteJob(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+#endif
+	}
+}
+
+void JobSystem::ParallelFor(size_t count, size_t minCountPerJob, const std::function<void(size_t begin, size_t end)>& function, JobPriority priority)
+{
+	if (count == 0)
+		return;
+
+	// The calling thread takes the first range
+	size_t jobCount = GetWorkerCount() + 1;
+	if (minCountPerJob != 0)
+		jobCount = std::min(jobCount, count / minCountPerJob);
+
+	if (jobCount <= 1)
+	{
+		function(0, count);
+		return;
+	}
+
+	const size_t countPerJob = (count + jobCount - 1) / jobCount;
+	JobHandle handle;
+	handle.m_remainingJobCount = std::make_shared<std::atomic<size_t>>(0);
+	handle.m_priority = priority;
+	for (size_t i = 1; i < jobCount; i++)
+	{
+		const size_t begin = i * countPerJob;
+		const size_t end = std::min(begin + countPerJob, count);
+		if (begin >= end)
+			break;
+
+		(*handle.m_remainingJobCount)++;
+		Job job;
+		job.function = [&function, begin, end]() { function(begin, end); };
+		job.remainingJobCount = handle.m_remainingJobCount;
+		PushJob(std::move(job), priority);
+	}
+	function(0, std::min(countPerJob, count));
+
+	Wait(handle);
+}
+
+void JobSystem::ExecuteMainThreadContinuations()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	{
+#if defined(JOB_SYSTEM_USE_THREADS)
+		std::lock_guard<std::mutex> lock(s_continuationsMutex);
+#endif
+		if (s_mainThreadContinuations.empty())
+			return;
+
+		s_executedContinuations.swap(s_mainThreadContinuations);
+	}
+
+	// A continuation can schedule other jobs
+	for (const std::function<void()>& continuation : s_executedContinuations)
+	{
+		continuation();
+	}
+	s_executedContinuations.clear();
+}
+
+size_t JobSystem::GetWorkerCount()
+{
+#if defined(JOB_SYSTEM_USE_THREADS)
+	return s_workers.size();
+#else
+	return 0;
+#endif
+}
+
+void JobSystem::PushJob(Job&& job, JobPriority priority)
+{
+#if defined(JOB_SYSTEM_USE_THREADS)
+	if (!s_queues.empty())
+	{
+		// A worker pushes in its own queue to keep the data in its cache, the other threads spread the jobs
+		const size_t queueIndex = t_workerIndex != NOT_A_WORKER ? t_workerIndex : s_nextQueueIndex++ % s_queues.size();
+		WorkerQueue& queue = *s_queues[queueIndex];
+		// Counted before being queued, a thief can not take the job before the increment
+		{
+			std::lock_guard<std::mutex> lock(s_wakeMutex);
+			s_queuedJobCount++;
+		}
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs[static_cast<size_t>(priority)].push_back(std::move(job));
+		}
+		s_wakeCondition.notify_one();
+		return;
+	}
+#endif
+
+	// No worker, execute the job now
+	ExecuteJob(job);
+}
+
+bool JobSystem::PopJob(size_t workerIndex, Job& job, JobPriority lowestPriority)
+{
+#if defined(JOB_SYSTEM_USE_THREADS)
+	const size_t queueCount = s_queues.size();
+	for (size_t priority = 0; priority <= static_cast<size_t>(lowestPriority); priority++)
+	{
+		// Own queue first (last pushed job), then steal from the others (first pushed job)
+		if (workerIndex != NOT_A_WORKER)
+		{
+			WorkerQueue& queue = *s_queues[workerIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			std::deque<Job>& jobs = queue.jobs[priority];
+			if (!jobs.empty())
+			{
+				job = std::move(jobs.back());
+				jobs.pop_back();
+				std::lock_guard<std::mutex> wakeLock(s_wakeMutex);
+				s_queuedJobCount--;
+				return true;
+			}
+		}
+
+		for (size_t i = 0; i < queueCount; i++)
+		{
+			if (i == workerIndex)
+				continue;
+
+			WorkerQueue& queue = *s_queues[i];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			std::deque<Job>& jobs = queue.jobs[priority];
+			if (!jobs.empty())
+			{
+				job = std::move(jobs.front());
+				jobs.pop_front();
+				std::lock_guard<std::mutex> wakeLock(s_wakeMutex);
+				s_queuedJobCount--;
+				return true;
+			}
+		}
+	}
+#endif
+	return false;
+}
+
+void JobSystem::ExecuteJob(Job& job)
+{
+	job.function();
+
+	if (job.mainThreadContinuation)
+	{
+#if defined(JOB_SYSTEM_USE_THREADS)
+		std::lock_guard<std::mutex> lock(s_continuationsMutex);
+#endif
+		s_mainThreadContinuations.push_back(std::move(job.mainThreadContinuation));
+	}
+
+	// Decremented last, the waiting thread can destroy the data used by the job
+	(*job.remainingJobCount)--;
+}
+
+void JobSystem::WorkerLoop(size_t workerIndex)
+{
+#if defined(JOB_SYSTEM_USE_THREADS)
+	t_workerIndex = workerIndex;
+	while (true)
+	{
+		Job job;
+		if (PopJob(workerIndex, job))
+		{
+			ExecuteJob(job);
+			continue;
+		}
+
+		// Sleep until a job is queued, the queued jobs are finished before stopping
+		std::unique_lock<std::mutex> lock(s_wakeMutex);
+		s_wakeCondition.wait(lock, []() { return s_queuedJobCount != 0 || !s_isRunning; });
+		if (!s_isRunning && s_queuedJobCount == 0)
+			break;
+	}
+#endif
+}
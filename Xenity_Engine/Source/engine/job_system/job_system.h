@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+#define JOB_SYSTEM_USE_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+#include <engine/api.h>
+
+/**
+* @brief Priority of a job, the jobs with a higher priority are executed first
+*/
+enum class JobPriority
+{
+	High, // Work waited by the main thread (batched queries...)
+	Normal,
+	Low, // Background work (asset loading...)
+	Count,
+};
+
+/**
+* @brief Handle used to wait for one or several jobs
+*/
+class API JobHandle
+{
+public:
+	/**
+	* @brief Check if all jobs of the handle are finished (always true for an empty handle)
+	*/
+	inline bool IsDone() const
+	{
+		return !m_remainingJobCount || *m_remainingJobCount == 0;
+	}
+
+private:
+	friend class JobSystem;
+
+	std::shared_ptr<std::atomic<size_t>> m_remainingJobCount;
+	JobPriority m_priority = JobPriority::Low; // Priority of the jobs of the handle
+};
+
+/**
+* @brief Engine-wide pool of worker threads
+* Each worker has its own queue and steals the jobs of the other workers when its queue is empty
+* On platforms without threads, the jobs are executed immediately by the calling thread
+*/
+class API JobSystem
+{
+public:
+	/**
+	* @brief [Internal] Create the worker threads
+	*/
+	static void Init();
+
+	/**
+	* @brief [Internal] Finish the queued jobs and stop the worker threads, the pending continuations are not called
+	*/
+	static void Stop();
+
+	/**
+	* @brief Execute a function on a worker thread
+	* @param function Function to execute, has to be thread safe
+	* @param priority Priority of the job
+	*/
+	static JobHandle Schedule(std::function<void()> function, JobPriority priority = JobPriority::Normal);
+
+	/**
+	* @brief Execute a function on a worker thread, then another function on the main thread (GPU upload...)
+	* @param function Function to execute, has to be thread safe
+	* @param mainThreadContinuation Function called by the main thread once the job is finished
+	* @param priority Priority of the job
+	*/
+	static JobHandle Schedule(std::function<void()> function, std::function<void()> mainThreadContinuation, JobPriority priority = JobPriority::Normal);
+
+	/**
+	* @brief Wait for the jobs of a handle, the calling thread executes queued jobs while waiting
+	* Only the jobs with the priority of the handle or a higher priority are executed, a long background job can't delay the wait
+	* The main thread continuations of the jobs are not called
+	*/
+	static void Wait(const JobHandle& handle);
+
+	/**
+	* @brief Call a function on ranges of [0, count[ on the worker threads and wait for the end
+	* @param count Number of elements
+	* @param minCountPerJob Minimum number of elements per job, to avoid creating jobs smaller than their cost
+	* @param function Function to call with the range [begin, end[, has to be thread safe
+	*/
+	static void ParallelFor(size_t count, size_t minCountPerJob, const std::function<void(size_t begin, size_t end)>& function, JobPriority priority = JobPriority::High);
+
+	/**
+	* @brief [Internal] Call the continuations of the finished jobs, called once per frame by the engine
+	*/
+	static void ExecuteMainThreadContinuations();
+
+	/**
+	* @brief Get the number of worker threads (0 if the platform does not use threads)
+	*/
+	static size_t GetWorkerCount();
+
+private:
+	static constexpr size_t NOT_A_WORKER = SIZE_MAX;
+
+	struct Job
+	{
+		std::function<void()> function;
+		std::function<void()> mainThreadContinuation;
+		std::shared_ptr<std::atomic<size_t>> remainingJobCount;
+	};
+
+	/**
+	* @brief Queue of a worker, the owner takes the last job and the thieves take the first one
+	*/
+	struct WorkerQueue
+	{
+#if defined(JOB_SYSTEM_USE_THREADS)
+		std::mutex mutex;
+#endif
+		std::deque<Job> jobs[static_cast<size_t>(JobPriority::Count)];
+	};
+
+	/**
+	* @brief Add a job in a queue and wake up a worker
+	*/
+	static void PushJob(Job&& job, JobPriority priority);
+
+	/**
+	* @brief Take the job with the highest priority, from the queue of the worker first
+	* @param workerIndex Index of the calling worker (NOT_A_WORKER for the other threads)
+	* @param lowestPriority Lowest priority of the job to take
+	* @return False if there is no queued job
+	*/
+	static bool PopJob(size_t workerIndex, Job& job, JobPriority lowestPriority = JobPriority::Low);
+
+	/**
+	* @brief Execute a job and queue its continuation
+	*/
+	static void ExecuteJob(Job& job);
+
+	static void WorkerLoop(size_t workerIndex);
+
+	static std::vector<std::unique_ptr<WorkerQueue>> s_queues;
+	static std::atomic<size_t> s_nextQueueIndex; // Used to spread the jobs scheduled outside of the workers
+	static std::vector<std::function<void()>> s_mainThreadContinuations;
+	static std::vector<std::function<void()>> s_executedContinuations; // Swapped with s_mainThreadContinuations to call them without the lock
+#if defined(JOB_SYSTEM_USE_THREADS)
+	static std::vector<std::thread> s_workers;
+	static std::mutex s_wakeMutex;
+	static std::condition_variable s_wakeCondition;
+	static size_t s_queuedJobCount; // Protected by s_wakeMutex
+	static bool s_isRunning; // Protected by s_wakeMutex
+	static std::mutex s_continuationsMutex;
+	static thread_local size_t t_workerIndex;
+#endif
+};
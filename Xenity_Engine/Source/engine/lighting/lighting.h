@@ -172,7 +172,7 @@ protected:
 	friend class RendererVU1;
 	friend class RendererRSX;
 
-	std::vector<Vector3> m_worldChunkPositions;
+	std::vector<uint32_t> m_worldChunkIndices; // Sorted indices of the world partitionner chunks
 	int m_indexInLightList = -1;
 	int m_indexInShaderList = -1;
 	//Spot and point light
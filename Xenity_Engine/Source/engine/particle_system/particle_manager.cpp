@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "particle_manager.h"
+
+#include <algorithm>
+
+#include <engine/particle_system/particle_system.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/job_system/job_system.h>
+#include <engine/time/time.h>
+#include <engine/assertions/assertions.h>
+#include <engine/debug/performance.h>
+#include <engine/debug/stack_debug_object.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define USE_SSE_PARTICLES
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_PARTICLES
+#include <arm_neon.h>
+#endif
+
+// Below this number of particles, the jobs cost more than the simulation
+constexpr size_t MIN_PARTICLE_COUNT_FOR_WORKER_THREADS = 4096;
+
+std::vector<ParticleSystem*> ParticleManager::s_particleSystems;
+std::vector<ParticleSystem*> ParticleManager::s_updatedParticleSystems;
+
+void ParticleManager::Update()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	SCOPED_PROFILER("ParticleManager::Update", scopeBenchmark);
+
+	s_updatedParticleSystems.clear();
+	for (ParticleSystem* particleSystem : s_particleSystems)
+	{
+		const GameObject* gameObject = particleSystem->GetGameObjectRaw();
+		if (gameObject && gameObject->IsLocalActive() && particleSystem->IsEnabled())
+		{
+			s_updatedParticleSystems.push_back(particleSystem);
+		}
+	}
+
+	UpdateParticleSystems(s_updatedParticleSystems.data(), s_updatedParticleSystems.size(), Time::GetDeltaTime(), true);
+}
+
+void ParticleManager::AddParticleSystem(ParticleSystem* particleSystem)
+{
+	XASSERT(particleSystem != nullptr, "[ParticleManager::AddParticleSystem] particleSystem is nullptr");
+
+	s_particleSystems.push_back(particleSystem);
+}
+
+void ParticleManager::RemoveParticleSystem(const ParticleSystem* particleSystem)
+{
+	XASSERT(particleSystem != nullptr, "[ParticleManager::RemoveParticleSystem] particleSystem is nullptr");
+
+	const size_t particleSystemCount = s_particleSystems.size();
+	for (size_t i = 0; i < particleSystemCount; i++)
+	{
+		if (s_particleSystems[i] == particleSystem)
+		{
+			s_particleSystems[i] = s_particleSystems.back();
+			s_particleSystems.pop_back();
+			break;
+		}
+	}
+}
+
+void ParticleManager::UpdateParticleSystems(ParticleSystem* const* particleSystems, size_t count, float deltaTime, bool useWorkerThreads)
+{
+	XASSERT(particleSystems != nullptr || count == 0, "[ParticleManager::UpdateParticleSystems] particleSystems is nullptr");
+
+	// A system only touches its own particles, the systems can be updated in parallel without lock
+	const auto function = [particleSystems, deltaTime](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				particleSystems[i]->UpdateParticles(deltaTime);
+			}
+		};
+
+	if (useWorkerThreads)
+	{
+		size_t particleCount = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			particleCount += particleSystems[i]->m_aliveParticleCount;
+		}
+
+		if (particleCount >= MIN_PARTICLE_COUNT_FOR_WORKER_THREADS)
+		{
+			JobSystem::ParallelFor(count, 1, function);
+			return;
+		}
+	}
+
+	function(0, count);
+}
+
+void ParticleManager::IntegrateParticles(float* positions, const float* velocities, size_t floatCount, float deltaTime)
+{
+	size_t i = 0;
+
+#if defined(USE_SSE_PARTICLES)
+	const __m128 deltaTimes = _mm_set1_ps(deltaTime);
+	for (; i + 4 <= floatCount; i += 4)
+	{
+		const __m128 newPositions = _mm_add_ps(_mm_loadu_ps(positions + i), _mm_mul_ps(_mm_loadu_ps(velocities + i), deltaTimes));
+		_mm_storeu_ps(positions + i, newPositions);
+	}
+#elif defined(USE_NEON_PARTICLES)
+	const float32x4_t deltaTimes = vdupq_n_f32(deltaTime);
+	for (; i + 4 <= floatCount; i += 4)
+	{
+		vst1q_f32(positions + i, vmlaq_f32(vld1q_f32(positions + i), vld1q_f32(velocities + i), deltaTimes));
+	}
+#endif
+
+	// Remaining floats (or all floats without SIMD)
+	for (; i < floatCount; i++)
+	{
+		positions[i] += velocities[i] * deltaTime;
+	}
+}
+
+void ParticleManager::AgeParticles(float* lifeTimes, size_t count, float deltaTime)
+{
+	size_t i = 0;
+
+#if defined(USE_SSE_PARTICLES)
+	const __m128 deltaTimes = _mm_set1_ps(deltaTime);
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_ps(lifeTimes + i, _mm_add_ps(_mm_loadu_ps(lifeTimes + i), deltaTimes));
+	}
+#elif defined(USE_NEON_PARTICLES)
+	const float32x4_t deltaTimes = vdupq_n_f32(deltaTime);
+	for (; i + 4 <= count; i += 4)
+	{
+		vst1q_f32(lifeTimes + i, vaddq_f32(vld1q_f32(lifeTimes + i), deltaTimes));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		lifeTimes[i] += deltaTime;
+	}
+}
+
+size_t ParticleManager::FindDeadParticle(const float* lifeTimes, const float* maxLifeTimes, size_t begin, size_t count)
+{
+	size_t i = begin;
+
+	// Skip the groups of 4 alive particles, the group with a dead particle is checked by the scalar loop
+#if defined(USE_SSE_PARTICLES)
+	for (; i + 4 <= count; i += 4)
+	{
+		if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(lifeTimes + i), _mm_loadu_ps(maxLifeTimes + i))) != 0)
+			break;
+	}
+#elif defined(USE_NEON_PARTICLES)
+	for (; i + 4 <= count; i += 4)
+	{
+		const uint32x4_t isDead = vcgeq_f32(vld1q_f32(lifeTimes + i), vld1q_f32(maxLifeTimes + i));
+		const uint32x2_t isDeadPairs = vorr_u32(vget_low_u32(isDead), vget_high_u32(isDead));
+		if ((vget_lane_u32(isDeadPairs, 0) | vget_lane_u32(isDeadPairs, 1)) != 0)
+			break;
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		if (lifeTimes[i] >= maxLifeTimes[i])
+			return i;
+	}
+	return count;
+}
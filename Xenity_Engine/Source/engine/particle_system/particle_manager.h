@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+/**
+ * [Internal]
+ */
+
+#include <vector>
+#include <cstddef>
+
+class ParticleSystem;
+
+/**
+* @brief Class to simulate the particles of all particle systems in one stage of the frame
+*/
+class ParticleManager
+{
+public:
+	/**
+	* @brief Simulate the particles of the enabled particle systems, called once per frame while the game is playing
+	*/
+	static void Update();
+
+	static void AddParticleSystem(ParticleSystem* particleSystem);
+	static void RemoveParticleSystem(const ParticleSystem* particleSystem);
+
+	/**
+	* @brief Simulate the particles of several particle systems
+	* @param particleSystems Particle systems to update, each system is updated by only one thread
+	* @param deltaTime Time to simulate
+	* @param useWorkerThreads If true, the systems are spread on the job system workers
+	*/
+	static void UpdateParticleSystems(ParticleSystem* const* particleSystems, size_t count, float deltaTime, bool useWorkerThreads);
+
+	/**
+	* @brief Move the particles: positions += velocities * deltaTime
+	* @param positions Packed xyz positions
+	* @param velocities Packed xyz velocities
+	* @param floatCount Number of floats to update (3 per particle)
+	*/
+	static void IntegrateParticles(float* positions, const float* velocities, size_t floatCount, float deltaTime);
+
+	/**
+	* @brief Add deltaTime to the life time of the particles
+	*/
+	static void AgeParticles(float* lifeTimes, size_t count, float deltaTime);
+
+	/**
+	* @brief Find the first dead particle (life time >= max life time) from an index
+	* @return The index of the particle or count if all particles are alive
+	*/
+	static size_t FindDeadParticle(const float* lifeTimes, const float* maxLifeTimes, size_t begin, size_t count);
+
+private:
+	static std::vector<ParticleSystem*> s_particleSystems;
+	static std::vector<ParticleSystem*> s_updatedParticleSystems; // Enabled systems of the frame, kept to avoid an allocation per frame
+};
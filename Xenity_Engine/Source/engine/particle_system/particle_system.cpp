@@ -5,14 +5,19 @@
 // This file is part of Xenity Engine
 
 #include "particle_system.h"
+#include "particle_manager.h"
 
-#include <random>
+#include <cstdint>
 #include <glm/ext/matrix_transform.hpp>
 
 #if defined(EDITOR)
 #include <editor/gizmo.h>
 #endif
 
+#if defined(__PSP__)
+#include <pspkernel.h>
+#endif
+
 #include <engine/asset_management/asset_manager.h>
 #include <engine/graphics/renderer/renderer.h>
 #include <engine/graphics/material.h>
@@ -22,23 +27,32 @@
 #include <engine/tools/math.h>
 #include <engine/graphics/graphics.h>
 #include <engine/graphics/camera.h>
-#include <engine/time/time.h>
 #include <engine/vectors/quaternion.h>
 #include <engine/engine.h>
 #include <engine/graphics/2d_graphics/sprite_manager.h>
 #include <engine/debug/stack_debug_object.h>
 #include <engine/debug/performance.h>
+#include <engine/assertions/assertions.h>
 
 ParticleSystem::ParticleSystem()
 {
 	AssetManager::AddReflection(this);
+	ParticleManager::AddParticleSystem(this);
+
+	// Each system has its own sequence
+	m_random.SetSeed(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this)));
 
 	AllocateParticlesMemory();
 }
 
 ParticleSystem::~ParticleSystem()
 {
+	if (const std::shared_ptr<MeshData> listenedMesh = m_listenedMesh.lock())
+	{
+		listenedMesh->GetOnLoadingFinished().Unbind(&ParticleSystem::OnMeshLoaded, this);
+	}
 	AssetManager::RemoveReflection(this);
+	ParticleManager::RemoveParticleSystem(this);
 }
 
 ReflectiveData ParticleSystem::GetReflectiveData()
@@ -75,7 +89,8 @@ void ParticleSystem::OnReflectionUpdated()
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	Graphics::s_isRenderingBatchDirty = true;
+	ListenMeshLoading();
+	Graphics::SetDrawableAsDirty(this);
 	if (m_speedMin > m_speedMax)
 		m_speedMin = m_speedMax;
 	else if (m_speedMax < m_speedMin)
@@ -86,38 +101,35 @@ void ParticleSystem::OnReflectionUpdated()
 	else if (m_lifeTimeMax < m_lifeTimeMin)
 		m_lifeTimeMax = m_lifeTimeMin;
 
-	m_speedDistribution = std::uniform_real_distribution<float>(m_speedMin, m_speedMax);
-	m_lifeTimeDistribution = std::uniform_real_distribution<float>(m_lifeTimeMin, m_lifeTimeMax);
-
 	m_boxSize.x = fabs(m_boxSize.x);
 	m_boxSize.y = fabs(m_boxSize.y);
 	m_boxSize.z = fabs(m_boxSize.z);
 
-	m_boxXDistribution = std::uniform_real_distribution<float>(-m_boxSize.x / 2.0f, m_boxSize.x / 2.0f);
-	m_boxYDistribution = std::uniform_real_distribution<float>(-m_boxSize.y / 2.0f, m_boxSize.y / 2.0f);
-	m_boxZDistribution = std::uniform_real_distribution<float>(-m_boxSize.z / 2.0f, m_boxSize.z / 2.0f);
-
 	AllocateParticlesMemory();
 }
 
 void ParticleSystem::Start()
 {
-	for (int i = 0; i < m_maxParticles; i++)
-	{
-		ResetParticle(m_particles[i], true);
-	}
+	m_aliveParticleCount = 0;
 }
 
 void ParticleSystem::Update()
 {
-
+	// The particles are simulated by the ParticleManager after the components update
+	if (m_play)
+	{
+		m_play = false;
+		Play();
+	}
 }
 
 void ParticleSystem::Play()
 {
-	for (int i = 0; i < m_maxParticles; i++)
+	m_aliveParticleCount = 0;
+	const size_t maxParticles = m_particleLifeTimes.size();
+	for (size_t i = 0; i < maxParticles; i++)
 	{
-		ResetParticle(m_particles[i], false);
+		SpawnParticle();
 	}
 }
 
@@ -166,54 +178,216 @@ void ParticleSystem::OnDrawGizmosSelected()
 #endif
 }
 
-void ParticleSystem::ResetParticle(Particle& particle, bool setIsDead)
+void ParticleSystem::UpdateParticles(float deltaTime)
 {
-	if (m_emitterShape == EmitterShape::Cone)
+	// No profiler here, this function is called by the worker threads
+
+	// Move and age all particles, the dead ones are moved too, it's cheaper than checking them first
+	ParticleManager::AgeParticles(m_particleLifeTimes.data(), m_aliveParticleCount, deltaTime);
+	ParticleManager::IntegrateParticles(m_particlePositions.data(), m_particleVelocities.data(), m_aliveParticleCount * 3, deltaTime);
+
+	// Kill the dead particles, a killed particle is replaced by the last alive one so its index is checked again
+	size_t deadIndex = ParticleManager::FindDeadParticle(m_particleLifeTimes.data(), m_particleMaxLifeTimes.data(), 0, m_aliveParticleCount);
+	while (deadIndex < m_aliveParticleCount)
 	{
-		particle.position = Vector3(0);
-		particle.direction = Vector3((rand() % 2000 - 1000) / 1000.0f * m_coneAngle / 180.0f, (rand() % 1000) / 1000.0f + (180 - m_coneAngle) / 180.0f, (rand() % 2000 - 1000) / 1000.0f * m_coneAngle / 180.0f);
+		KillParticle(deadIndex);
+		deadIndex = ParticleManager::FindDeadParticle(m_particleLifeTimes.data(), m_particleMaxLifeTimes.data(), deadIndex, m_aliveParticleCount);
 	}
-	else if (m_emitterShape == EmitterShape::Box)
+
+	// Spawn new particles
+	if (m_isEmitting && m_loop)
 	{
-		particle.position = Vector3(m_boxXDistribution(m_gen), m_boxYDistribution(m_gen), m_boxZDistribution(m_gen));
-		particle.direction = m_direction;
+		m_timer += deltaTime * m_spawnRate;
+		while (m_timer > 1)
+		{
+			m_timer -= 1;
+			if (m_aliveParticleCount == m_particleLifeTimes.size())
+			{
+				m_timer = 0;
+				break;
+			}
+			SpawnParticle();
+		}
 	}
+}
 
-	particle.direction.Normalize();
+void ParticleSystem::SpawnParticle()
+{
+	XASSERT(m_aliveParticleCount < m_particleLifeTimes.size(), "[ParticleSystem::SpawnParticle] No free particle");
 
-	particle.currentSpeed = m_speedDistribution(m_gen);
+	const size_t index = m_aliveParticleCount;
+	m_aliveParticleCount++;
+
+	float* position = &m_particlePositions[index * 3];
+	Vector3 direction;
+	if (m_emitterShape == EmitterShape::Cone)
+	{
+		position[0] = 0;
+		position[1] = 0;
+		position[2] = 0;
+		const float coneRatio = m_coneAngle / 180.0f;
+		direction = Vector3(m_random.Range(-1, 1) * coneRatio, m_random.NextFloat() + 1 - coneRatio, m_random.Range(-1, 1) * coneRatio);
+	}
+	else
+	{
+		position[0] = m_random.Range(-m_boxSize.x / 2.0f, m_boxSize.x / 2.0f);
+		position[1] = m_random.Range(-m_boxSize.y / 2.0f, m_boxSize.y / 2.0f);
+		position[2] = m_random.Range(-m_boxSize.z / 2.0f, m_boxSize.z / 2.0f);
+		direction = m_direction;
+	}
 
-	particle.currentLifeTime = 0;
+	direction.Normalize();
+	const float speed = m_random.Range(m_speedMin, m_speedMax);
+	float* velocity = &m_particleVelocities[index * 3];
+	velocity[0] = direction.x * speed;
+	velocity[1] = direction.y * speed;
+	velocity[2] = direction.z * speed;
 
-	particle.lifeTime = m_lifeTimeDistribution(m_gen);
-	particle.isDead = setIsDead;
+	m_particleLifeTimes[index] = 0;
+	m_particleMaxLifeTimes[index] = m_random.Range(m_lifeTimeMin, m_lifeTimeMax);
 }
 
-void ParticleSystem::AllocateParticlesMemory()
+void ParticleSystem::KillParticle(size_t index)
 {
-	m_particles.clear();
-	for (int i = 0; i < m_maxParticles; i++)
+	XASSERT(index < m_aliveParticleCount, "[ParticleSystem::KillParticle] Index out of bounds");
+
+	m_aliveParticleCount--;
+	const size_t lastIndex = m_aliveParticleCount;
+	if (index != lastIndex)
 	{
-		Particle newParticle = Particle();
-		ResetParticle(newParticle, true);
-		m_particles.push_back(newParticle);
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			m_particlePositions[index * 3 + axis] = m_particlePositions[lastIndex * 3 + axis];
+			m_particleVelocities[index * 3 + axis] = m_particleVelocities[lastIndex * 3 + axis];
+		}
+		m_particleLifeTimes[index] = m_particleLifeTimes[lastIndex];
+		m_particleMaxLifeTimes[index] = m_particleMaxLifeTimes[lastIndex];
 	}
 }
 
-void ParticleSystem::DrawCommand(const RenderCommand& renderCommand)
+void ParticleSystem::AllocateParticlesMemory()
 {
-	SCOPED_PROFILER("ParticleSystem::DrawCommand", scopeBenchmark);
+	const size_t maxParticles = m_maxParticles > 0 ? static_cast<size_t>(m_maxParticles) : 0;
+	m_particlePositions.resize(maxParticles * 3);
+	m_particleVelocities.resize(maxParticles * 3);
+	m_particleLifeTimes.resize(maxParticles);
+	m_particleMaxLifeTimes.resize(maxParticles);
+	m_aliveParticleCount = 0;
+
+	// The mesh is created again with the new size when needed
+	m_particlesMeshData.reset();
+}
 
-	RenderingSettings renderSettings = RenderingSettings();
-	renderSettings.invertFaces = false;
-	renderSettings.useDepth = true;
-	renderSettings.useTexture = true;
-	renderSettings.useLighting = renderCommand.material->GetUseLighting();
-	renderSettings.renderingMode = renderCommand.material->GetRenderingMode();
+void ParticleSystem::UpdateParticlesMesh()
+{
+	SCOPED_PROFILER("ParticleSystem::UpdateParticlesMesh", scopeBenchmark);
 
-	static const Quaternion rotation = Quaternion::Identity();
+	// 6 vertices per particle because the PS2 renderer does not support indices
+	if (!m_particlesMeshData)
+	{
+		const unsigned int vertexCount = static_cast<unsigned int>(m_particleLifeTimes.size() * 6);
+#if defined(PARTICLE_SYSTEM_USE_VERTEX_COLOR)
+		m_particlesMeshData = MeshData::MakeMeshData(vertexCount, vertexCount, true, false, true);
+#else
+		m_particlesMeshData = MeshData::MakeMeshData(vertexCount, vertexCount, false, false, true);
+#endif
+		m_particlesMeshData->m_hasIndices = true;
+
+		// The indices never change
+		MeshData::SubMesh& subMesh = *m_particlesMeshData->m_subMeshes[0];
+		for (unsigned int i = 0; i < vertexCount; i++)
+		{
+			if (subMesh.isShortIndices)
+				static_cast<unsigned short*>(subMesh.indices)[i] = static_cast<unsigned short>(i);
+			else
+				static_cast<unsigned int*>(subMesh.indices)[i] = i;
+		}
+		m_particlesMeshData->OnLoadFileReferenceFinished();
+	}
+
+	const glm::mat4& transMat = GetTransformRaw()->GetTransformationMatrix();
+
+	// Axes of the quads, same as the matrix used to draw the sprite mesh of a particle
+	glm::vec3 axisX;
+	glm::vec3 axisY;
+	if (m_isBillboard)
+	{
+		const Vector3& camScale = Graphics::usedCamera->GetTransformRaw()->GetScale();
+		const glm::mat4& camMat = Graphics::usedCamera->GetTransformRaw()->GetTransformationMatrix();
+		const Vector3& scale = GetTransformRaw()->GetScale();
+		// Fix scale if the camera has a scale (Y and Z are inverted for some raison)
+		axisX = glm::vec3(camMat[0]) * (scale.x / camScale.x);
+		axisY = glm::vec3(camMat[1]) * (scale.y / camScale.z);
+	}
+	else
+	{
+		axisX = glm::vec3(transMat[0]);
+		axisY = glm::vec3(transMat[1]);
+	}
+	axisX *= 0.5f;
+	axisY *= 0.5f;
 
-	const size_t camCount = Graphics::cameras.size();
+	// Positions and uvs of the sprite mesh, in the order of its two triangles
+	static constexpr float cornersX[6] = { -1, 1, 1, 1, -1, -1 };
+	static constexpr float cornersY[6] = { -1, 1, -1, 1, -1, 1 };
+	static constexpr float cornersU[6] = { 1, 0, 0, 0, 1, 1 };
+	static constexpr float cornersV[6] = { 1, 0, 1, 0, 1, 0 };
+
+	MeshData::SubMesh& subMesh = *m_particlesMeshData->m_subMeshes[0];
+	const RGBA& rgba = m_color.GetRGBA();
+#if !defined(PARTICLE_SYSTEM_USE_VERTEX_COLOR)
+	m_particlesMeshData->unifiedColor = m_color;
+#endif
+	for (size_t i = 0; i < m_aliveParticleCount; i++)
+	{
+		const float* position = &m_particlePositions[i * 3];
+		const glm::vec3 center = glm::vec3(transMat * glm::vec4(position[0], position[1], position[2], 1));
+
+#if defined(PARTICLE_SYSTEM_USE_VERTEX_COLOR)
+		const float alpha = sin((m_particleLifeTimes[i] / m_particleMaxLifeTimes[i]) * Math::PI);
+#if defined(__PSP__)
+		const unsigned int color = Color::CreateFromRGBAFloat(rgba.r, rgba.g, rgba.b, alpha).GetUnsignedIntABGR();
+#endif
+		Vertex* vertices = static_cast<Vertex*>(subMesh.data) + i * 6;
+#endif
+		for (size_t corner = 0; corner < 6; corner++)
+		{
+			const glm::vec3 vertexPosition = center + axisX * cornersX[corner] + axisY * cornersY[corner];
+#if defined(PARTICLE_SYSTEM_USE_VERTEX_COLOR)
+			Vertex& vertex = vertices[corner];
+			vertex.u = cornersU[corner];
+			vertex.v = cornersV[corner];
+#if defined(__PSP__)
+			vertex.color = color;
+#else
+			vertex.r = rgba.r;
+			vertex.g = rgba.g;
+			vertex.b = rgba.b;
+			vertex.a = alpha;
+#endif
+			vertex.x = vertexPosition.x;
+			vertex.y = vertexPosition.y;
+			vertex.z = vertexPosition.z;
+#else
+			m_particlesMeshData->AddVertex(cornersU[corner], cornersV[corner], vertexPosition.x, vertexPosition.y, vertexPosition.z, static_cast<unsigned int>(i * 6 + corner), 0);
+#endif
+		}
+	}
+
+	// Only draw the alive particles
+	subMesh.vertice_count = static_cast<uint32_t>(m_aliveParticleCount * 6);
+	subMesh.index_count = subMesh.vertice_count;
+
+#if defined(__vita__) || defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	m_particlesMeshData->SendDataToGpu();
+#elif defined(__PSP__)
+	sceKernelDcacheWritebackInvalidateAll(); // Very important
+#endif
+}
+
+void ParticleSystem::DrawParticlesWithMesh(const RenderCommand& renderCommand, RenderingSettings& renderSettings)
+{
+	static const Quaternion rotation = Quaternion::Identity();
 
 	const Vector3& camScale = Graphics::usedCamera->GetTransformRaw()->GetScale();
 	const glm::mat4& camMat = Graphics::usedCamera->GetTransformRaw()->GetTransformationMatrix();
@@ -223,15 +397,13 @@ void ParticleSystem::DrawCommand(const RenderCommand& renderCommand)
 	const Vector3& scale = GetTransformRaw()->GetScale();
 	const glm::vec3 fixedScale = glm::vec3(1.0f / camScale.x, 1.0f / camScale.z, 1.0f / camScale.y) * glm::vec3(scale.x, scale.y, scale.z);
 
-	for (int i = 0; i < m_maxParticles; i++)
+	// All the particles are drawn with one instanced draw call
+	m_instanceMatrices.resize(m_aliveParticleCount);
+	m_instanceColors.resize(m_aliveParticleCount);
+	for (size_t i = 0; i < m_aliveParticleCount; i++)
 	{
-		Particle& particle = m_particles[i];
-		if (particle.isDead)
-		{
-			continue;
-		}
-
-		glm::mat4 newMat = Math::MultiplyMatrices(transMat, Math::CreateModelMatrix(particle.position, rotation, Vector3(1)));
+		const Vector3 position = Vector3(m_particlePositions[i * 3], m_particlePositions[i * 3 + 1], m_particlePositions[i * 3 + 2]);
+		glm::mat4 newMat = Math::MultiplyMatrices(transMat, Math::CreateModelMatrix(position, rotation, Vector3(1)));
 		if (m_isBillboard)
 		{
 			for (int matI = 0; matI < 3; matI++)
@@ -244,69 +416,69 @@ void ParticleSystem::DrawCommand(const RenderCommand& renderCommand)
 			newMat = glm::scale(newMat, fixedScale); // Fix scale if the camera has a scale (Y and Z are inverted for some raison)
 		}
 
-		renderCommand.subMesh->meshData->unifiedColor.SetFromRGBAfloat(rgba.r, rgba.g, rgba.b, sin((particle.currentLifeTime / particle.lifeTime) * Math::PI));
-
-		Graphics::DrawSubMesh(*renderCommand.subMesh, *m_material, m_texture.get(), renderSettings, newMat, false);
-
-		particle.position += particle.direction * Time::GetDeltaTime() / static_cast<float>(camCount) * particle.currentSpeed;
-
-		particle.currentLifeTime += Time::GetDeltaTime() / camCount;
-		if (particle.currentLifeTime >= particle.lifeTime)
-		{
-			particle.isDead = true;
-		}
+		m_instanceMatrices[i] = newMat;
+		m_instanceColors[i] = glm::vec4(rgba.r, rgba.g, rgba.b, sin((m_particleLifeTimes[i] / m_particleMaxLifeTimes[i]) * Math::PI));
 	}
 
-	// Spawn new particles
-	if (m_isEmitting && m_loop)
-	{
-		m_timer += Time::GetDeltaTime() / camCount * m_spawnRate;
-		while (m_timer > 1)
-		{
-			m_timer -= 1;
-			bool found = false;
-			for (int i = 0; i < m_maxParticles; i++)
-			{
-				Particle& particle = m_particles[i];
-				if (particle.isDead)
-				{
-					ResetParticle(particle, false);
-					found = true;
-					break;
-				}
-			}
+	Graphics::DrawSubMeshInstances(*renderCommand.subMesh, *m_material, m_texture.get(), renderSettings, m_instanceMatrices.data(), m_instanceColors.data(), m_aliveParticleCount);
+}
 
-			if (!found)
-			{
-				m_timer = 0;
-			}
-		}
-	}
+void ParticleSystem::DrawCommand(const RenderCommand& renderCommand)
+{
+	SCOPED_PROFILER("ParticleSystem::DrawCommand", scopeBenchmark);
 
-	/*if (reset)
-	{
-		reset = false;
-		for (int i = 0; i < maxParticles; i++)
-		{
-			ResetParticle(particles[i], false);
-		}
-	}*/
+	if (m_aliveParticleCount == 0)
+		return;
 
-	if (m_play)
+	RenderingSettings renderSettings = RenderingSettings();
+	renderSettings.invertFaces = false;
+	renderSettings.useDepth = true;
+	renderSettings.useTexture = true;
+	renderSettings.useLighting = renderCommand.material->GetUseLighting();
+	renderSettings.renderingMode = renderCommand.material->GetRenderingMode();
+
+	if (m_mesh)
 	{
-		m_play = false;
-		Play();
+		DrawParticlesWithMesh(renderCommand, renderSettings);
+		return;
 	}
+
+	// The quads are already in world space
+	static const glm::mat4 identityMatrix = glm::mat4(1);
+	UpdateParticlesMesh();
+	Graphics::DrawSubMesh(*m_particlesMeshData->m_subMeshes[0], *m_material, m_texture.get(), renderSettings, identityMatrix, false);
 }
 
 void ParticleSystem::OnDisabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
 }
 
 void ParticleSystem::OnEnabled()
 {
-	Graphics::s_isRenderingBatchDirty = true;
+	Graphics::UpdateDrawableEnabledState(this);
+}
+
+void ParticleSystem::ListenMeshLoading()
+{
+	const std::shared_ptr<MeshData> listenedMesh = m_listenedMesh.lock();
+	if (listenedMesh == m_mesh)
+		return;
+
+	if (listenedMesh)
+	{
+		listenedMesh->GetOnLoadingFinished().Unbind(&ParticleSystem::OnMeshLoaded, this);
+	}
+	if (m_mesh)
+	{
+		m_mesh->GetOnLoadingFinished().Bind(&ParticleSystem::OnMeshLoaded, this);
+	}
+	m_listenedMesh = m_mesh;
+}
+
+void ParticleSystem::OnMeshLoaded()
+{
+	Graphics::SetDrawableAsDirty(this);
 }
 
 void ParticleSystem::CreateRenderCommands(RenderBatch& renderBatch)
@@ -317,6 +489,10 @@ void ParticleSystem::CreateRenderCommands(RenderBatch& renderBatch)
 	if (m_material == nullptr || m_texture == nullptr)
 		return;
 
+	// The commands are created again when the mesh is loaded (see OnMeshLoaded)
+	if (m_mesh && (!m_mesh->m_isValid || m_mesh->m_subMeshes.empty()))
+		return;
+
 	RenderCommand command = RenderCommand();
 	command.material = m_material.get();
 	command.drawable = this;
@@ -328,13 +504,10 @@ void ParticleSystem::CreateRenderCommands(RenderBatch& renderBatch)
 	command.isEnabled = IsEnabled() && GetGameObjectRaw()->IsLocalActive();
 	if (m_material->GetRenderingMode() == MaterialRenderingModes::Opaque || m_material->GetRenderingMode() == MaterialRenderingModes::Cutout)
 	{
-		RenderQueue& renderQueue = renderBatch.renderQueues[m_material->GetFileId()];
-		renderQueue.commands.push_back(command);
-		renderQueue.commandIndex++;
+		renderBatch.AddCommand(command, RenderQueueType::Opaque);
 	}
 	else
 	{
-		renderBatch.transparentMeshCommands.push_back(command);
-		renderBatch.transparentMeshCommandIndex++;
+		renderBatch.AddCommand(command, RenderQueueType::Transparent);
 	}
 }
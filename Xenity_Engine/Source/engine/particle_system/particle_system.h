@@ -7,14 +7,23 @@
 #pragma once
 
 #include <vector>
-#include <random>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
 
 #include <engine/api.h>
 #include <engine/graphics/iDrawable.h>
 #include <engine/vectors/vector3.h>
+#include <engine/tools/fast_random.h>
 
 class MeshData;
 class Material;
+struct RenderingSettings;
+
+// The PS3 and PS2 renderers do not support vertex colors, the particles are not faded on these platforms
+#if !defined(__PS3__) && !defined(_EE)
+#define PARTICLE_SYSTEM_USE_VERTEX_COLOR
+#endif
 
 ENUM(EmitterShape, Box, Cone);
 
@@ -43,15 +52,8 @@ public:
 	}
 
 protected:
-	struct Particle
-	{
-		Vector3 position;
-		Vector3 direction;
-		float currentSpeed = 1;
-		float currentLifeTime = 0;
-		float lifeTime = 1;
-		bool isDead = true;
-	};
+	friend class ParticleManager;
+	friend class ParticleBenchmark;
 
 	ReflectiveData GetReflectiveData() override;
 	void OnReflectionUpdated() override;
@@ -81,14 +83,60 @@ protected:
 	* @brief Called when the component is enabled
 	*/
 	void OnEnabled() override;
-	void ResetParticle(Particle& particle, bool setIsDead);
+
+	/**
+	* @brief Move the particles and spawn the new ones, called once per frame by the ParticleManager
+	* Can be called by a worker thread, only the particles of this system are modified
+	*/
+	void UpdateParticles(float deltaTime);
+
+	/**
+	* @brief Spawn a particle at the end of the alive particles
+	*/
+	void SpawnParticle();
+
+	/**
+	* @brief Kill a particle, the last alive particle takes its place
+	*/
+	void KillParticle(size_t index);
+
 	void AllocateParticlesMemory();
 
+	/**
+	* @brief Fill the quads of the alive particles facing the used camera (or oriented by the transform)
+	*/
+	void UpdateParticlesMesh();
+
+	/**
+	* @brief Draw the particles with the custom mesh (one instanced draw call when instancing is available)
+	*/
+	void DrawParticlesWithMesh(const RenderCommand& renderCommand, RenderingSettings& renderSettings);
+
+	/**
+	* @brief Listen the loading of the current mesh, to create the render commands when a streamed mesh is loaded
+	*/
+	void ListenMeshLoading();
+
+	/**
+	* @brief Called when the mesh is loaded
+	*/
+	void OnMeshLoaded();
+
 	std::shared_ptr <MeshData> m_mesh = nullptr;
+	std::weak_ptr<MeshData> m_listenedMesh;
 	std::shared_ptr <Material> m_material = nullptr;
 	std::shared_ptr<Texture> m_texture = nullptr;
 
-	std::vector<Particle> m_particles;
+	// Particles stored as arrays, the alive particles are packed at the beginning of the arrays
+	std::vector<float> m_particlePositions; // Packed xyz, 3 floats per particle
+	std::vector<float> m_particleVelocities; // Packed xyz, 3 floats per particle
+	std::vector<float> m_particleLifeTimes; // Time since the spawn
+	std::vector<float> m_particleMaxLifeTimes;
+	size_t m_aliveParticleCount = 0;
+
+	std::shared_ptr<MeshData> m_particlesMeshData = nullptr; // Quads of the alive particles, drawn with one draw call
+	std::vector<glm::mat4> m_instanceMatrices; // Matrix of each particle drawn with the custom mesh
+	std::vector<glm::vec4> m_instanceColors; // Color of each particle drawn with the custom mesh
 	EmitterShape m_emitterShape = EmitterShape::Cone;
 	float m_coneAngle = 20;
 	bool m_reset = false;
@@ -96,12 +144,7 @@ protected:
 	float m_lifeTimeMax = 10;
 	float m_speedMin = 1;
 	float m_speedMax = 2;
-	std::default_random_engine m_gen;
-	std::uniform_real_distribution<float>m_speedDistribution;
-	std::uniform_real_distribution<float>m_lifeTimeDistribution;
-	std::uniform_real_distribution<float>m_boxXDistribution;
-	std::uniform_real_distribution<float>m_boxYDistribution;
-	std::uniform_real_distribution<float>m_boxZDistribution;
+	FastRandom m_random;
 
 	bool m_isBillboard = true;
 	float m_spawnRate = 1;
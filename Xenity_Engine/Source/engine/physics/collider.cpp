@@ -10,8 +10,19 @@
 
 #include <engine/physics/rigidbody.h>
 #include <engine/game_elements/gameobject.h>
+#include <engine/assertions/assertions.h>
 #include "physics_manager.h"
 
+void Collider::SetCollisionLayer(int collisionLayer)
+{
+	XASSERT(collisionLayer >= 0 && collisionLayer < COLLISION_LAYER_COUNT, "[Collider::SetCollisionLayer] collisionLayer is out of bounds");
+
+	if (collisionLayer < 0 || collisionLayer >= COLLISION_LAYER_COUNT)
+		return;
+
+	m_collisionLayer = collisionLayer;
+}
+
 Collider::~Collider()
 {
 	if (const std::shared_ptr<RigidBody> rb = m_attachedRigidbody.lock())
@@ -41,6 +41,19 @@ public:
 		return m_generateCollisionEvents;
 	}
 
+	/**
+	* @brief Set the collision layer used to filter the scene queries
+	* @param collisionLayer Layer between 0 and COLLISION_LAYER_COUNT - 1
+	*/
+	void SetCollisionLayer(int collisionLayer);
+
+	int GetCollisionLayer() const
+	{
+		return m_collisionLayer;
+	}
+
+	static constexpr int COLLISION_LAYER_COUNT = 32;
+
 protected:
 	friend class PhysicsManager;
 	friend class RigidBody;
@@ -67,5 +80,6 @@ protected:
 	btCollisionShape* m_bulletCollisionShape = nullptr;
 	bool m_isTrigger = false;
 	bool m_generateCollisionEvents = false;
+	int m_collisionLayer = 0;
 };
 
@@ -19,11 +19,19 @@
 #include "collision_event.h"
 #include <engine/debug/stack_debug_object.h>
 #include <engine/constants.h>
+#include <engine/assertions/assertions.h>
 
 std::vector<RigidBody*> PhysicsManager::s_rigidBodies;
 std::vector<ColliderInfo> PhysicsManager::s_colliders;
+std::unordered_map<const Collider*, size_t> PhysicsManager::s_colliderIndices;
 Vector3 PhysicsManager::s_gravity = Vector3(0, DEFAULT_GRAVITY_Y, 0);
 
+bool PhysicsManager::s_useFixedTimeStep = false;
+float PhysicsManager::s_fixedTimeStep = DEFAULT_PHYSICS_FIXED_TIME_STEP;
+int PhysicsManager::s_maxSubSteps = DEFAULT_PHYSICS_MAX_SUB_STEPS;
+float PhysicsManager::s_timeAccumulator = 0;
+int PhysicsManager::s_lastSubStepCount = 0;
+
 btDynamicsWorld* PhysicsManager::s_physDynamicsWorld = nullptr;
 btBroadphaseInterface* physBroadphase = nullptr;
 btCollisionDispatcher* physDispatcher = nullptr;
@@ -70,132 +78,111 @@ void PhysicsManager::AddEvent(Collider* collider, Collider* otherCollider, bool
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	const size_t colliderCount = s_colliders.size();
-	for (size_t i = 0; i < colliderCount; i++)
+	const auto colliderIndex = s_colliderIndices.find(collider);
+	if (colliderIndex == s_colliderIndices.end())
+		return;
+
+	ColliderInfo& colliderInfo = s_colliders[colliderIndex->second];
+	/*ColliderInfo::CollisionInfo collisionInfo;
+	collisionInfo.otherCollider = otherCollider;
+	collisionInfo.state = CollisionState::FirstFrame;*/
+	if (isTrigger)
 	{
-		if (s_colliders[i].collider == collider)
+		auto tc = colliderInfo.triggersCollisions.find(otherCollider);
+		if (tc != colliderInfo.triggersCollisions.end())
 		{
-			/*ColliderInfo::CollisionInfo collisionInfo;
-			collisionInfo.otherCollider = otherCollider;
-			collisionInfo.state = CollisionState::FirstFrame;*/
-			if (isTrigger)
+			//std::cout << "Existing collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
+			if (tc->second == CollisionState::RequireUpdate)
 			{
-				auto tc = s_colliders[i].triggersCollisions.find(otherCollider);
-				if (tc != s_colliders[i].triggersCollisions.end())
-				{
-					//std::cout << "Existing collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
-					if (tc->second == CollisionState::RequireUpdate)
-					{
-						tc->second = CollisionState::Updated;
-					}
-				}
-				else
-				{
-					//std::cout << "First collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
-					s_colliders[i].triggersCollisions[otherCollider] = CollisionState::FirstFrame;
-				}
+				tc->second = CollisionState::Updated;
 			}
-			else
+		}
+		else
+		{
+			//std::cout << "First collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
+			colliderInfo.triggersCollisions[otherCollider] = CollisionState::FirstFrame;
+		}
+	}
+	else
+	{
+		auto tc = colliderInfo.collisions.find(otherCollider);
+		if (tc != colliderInfo.collisions.end())
+		{
+			//std::cout << "Existing trigger collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
+			//tc->second = CollisionState::Updated;
+			if (tc->second == CollisionState::RequireUpdate)
 			{
-				auto tc = s_colliders[i].collisions.find(otherCollider);
-				if (tc != s_colliders[i].collisions.end())
-				{
-					//std::cout << "Existing trigger collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
-					//tc->second = CollisionState::Updated;
-					if (tc->second == CollisionState::RequireUpdate)
-					{
-						tc->second = CollisionState::Updated;
-					}
-				}
-				else
-				{
-					//std::cout << "First trigger collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
-					s_colliders[i].collisions[otherCollider] = CollisionState::FirstFrame;
-				}
-				//m_colliders[i].collisions.push_back(collisionInfo);
+				tc->second = CollisionState::Updated;
 			}
-			break;
 		}
+		else
+		{
+			//std::cout << "First trigger collision: " << collider->GetGameObject()->GetName() << " ToString" << collider->ToString() << std::endl;
+			colliderInfo.collisions[otherCollider] = CollisionState::FirstFrame;
+		}
+		//m_colliders[i].collisions.push_back(collisionInfo);
 	}
-
 }
 
 
-class MyContactResultCallback : public btCollisionWorld::ContactResultCallback
+Collider* PhysicsManager::GetCollider(const btCollisionObject* collisionObject, int childIndex)
 {
-public:
-	bool onCollisionEnter(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1)
+	if (const btRigidBody* bulletRb = btRigidBody::upcast(collisionObject))
 	{
-		STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+		// The colliders of a rigidbody are the children of its compound shape
+		const RigidBody* rb = reinterpret_cast<const RigidBody*>(bulletRb->getUserPointer());
+		const btCompoundShape* compoundShape = (bulletRb->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE) ? rb->m_bulletTriggerCompoundShape : rb->m_bulletCompoundShape;
+		if (childIndex < 0 || childIndex >= compoundShape->getNumChildShapes())
+			return nullptr;
 
-		if (colObj0Wrap->getCollisionObject()->isStaticOrKinematicObject() && colObj1Wrap->getCollisionObject()->isStaticOrKinematicObject())
-		{
-			return false;
-		}
+		return reinterpret_cast<Collider*>(compoundShape->getChildShape(childIndex)->getUserPointer());
+	}
 
+	return reinterpret_cast<Collider*>(collisionObject->getUserPointer());
+}
 
-		Collider* col0 = nullptr;
-		Collider* col1 = nullptr;
+bool PhysicsManager::CanGenerateEvents(const Collider* collider)
+{
+	return collider->m_generateCollisionEvents && collider->IsEnabled() && collider->GetGameObjectRaw()->IsLocalActive();
+}
 
-		//std::cout << "------------ Collision detected between objects ------------" << std::endl;
-		//if (!colObj0Wrap->getCollisionObject()->isStaticOrKinematicObject())
-		if (auto bulletRb = dynamic_cast<const btRigidBody*>(colObj0Wrap->getCollisionObject()))
-		{
-			RigidBody* rb = reinterpret_cast<RigidBody*>(colObj0Wrap->getCollisionObject()->getUserPointer());
-			if (colObj0Wrap->getCollisionObject()->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE)
-				col0 = reinterpret_cast<Collider*>(rb->m_bulletTriggerCompoundShape->getChildShape(index0)->getUserPointer());
-			else
-				col0 = reinterpret_cast<Collider*>(rb->m_bulletCompoundShape->getChildShape(index0)->getUserPointer());
-			//std::cout << "Object0: " << rb->GetGameObject()->GetName() << " ToString" << col0->ToString() << std::endl;
-		}
-		else
-		{
-			col0 = reinterpret_cast<Collider*>(colObj0Wrap->getCollisionObject()->getUserPointer());
-			//std::cout << "Object0: " << col0->GetGameObject()->GetName() << std::endl;
-		}
-		/*if (colObj0Wrap->getCollisionObject()->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE)
-		{
-			std::cout << "Object0 is a trigger" << std::endl;
-		}*/
+void PhysicsManager::GenerateCollisionEvents()
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-		//if (!colObj1Wrap->getCollisionObject()->isStaticOrKinematicObject())
-		if(auto bulletRb = dynamic_cast<const btRigidBody*>(colObj1Wrap->getCollisionObject()))
-		{
-			RigidBody* rb = reinterpret_cast<RigidBody*>(colObj1Wrap->getCollisionObject()->getUserPointer());
-			if (colObj1Wrap->getCollisionObject()->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE)
-				col1 = reinterpret_cast<Collider*>(rb->m_bulletTriggerCompoundShape->getChildShape(index1)->getUserPointer());
-			else
-				col1 = reinterpret_cast<Collider*>(rb->m_bulletCompoundShape->getChildShape(index1)->getUserPointer());
-			//std::cout << "Object1: " << rb->GetGameObject()->GetName() << " ToString" << col1->ToString() << std::endl;
-			//std::cout << "Object1: " << rb->GetGameObject()->GetName() << std::endl;
-		}
-		else
-		{
-			col1 = reinterpret_cast<Collider*>(colObj1Wrap->getCollisionObject()->getUserPointer());
-			//std::cout << "Object1: " << col1->GetGameObject()->GetName() << std::endl;
-		}
-		/*if (colObj1Wrap->getCollisionObject()->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE)
+	// Bullet already found the contacts during the step, read them from the persistent manifolds
+	btDispatcher* dispatcher = s_physDynamicsWorld->getDispatcher();
+	const int manifoldCount = dispatcher->getNumManifolds();
+	for (int manifoldIndex = 0; manifoldIndex < manifoldCount; manifoldIndex++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(manifoldIndex);
+		const int contactCount = manifold->getNumContacts();
+		if (contactCount == 0)
+			continue;
+
+		const btCollisionObject* body0 = manifold->getBody0();
+		const btCollisionObject* body1 = manifold->getBody1();
+		if (body0->isStaticOrKinematicObject() && body1->isStaticOrKinematicObject())
+			continue;
+
+		for (int contactIndex = 0; contactIndex < contactCount; contactIndex++)
 		{
-			std::cout << "Object1 is a trigger" << std::endl;
-		}*/
+			const btManifoldPoint& point = manifold->getContactPoint(contactIndex);
 
-		//colObj0Wrap->m_collisionObject->
-	//	std::cout << "Collision detected between objects " << colObj0Wrap->getCollisionObject() << " and " << colObj1Wrap->getCollisionObject() << std::endl;
-		//std::cout << partId0 << " " << index0 << " and " << partId1 << "   " << index1 << std::endl;
-		if (col0 && col1 && col0->GetGameObjectRaw() != col1->GetGameObjectRaw())
-			PhysicsManager::AddEvent(col0, col1, col0->IsTrigger() || col1->IsTrigger());
+			Collider* col0 = GetCollider(body0, point.m_index0);
+			Collider* col1 = GetCollider(body1, point.m_index1);
+			if (!col0 || !col1 || col0->GetGameObjectRaw() == col1->GetGameObjectRaw())
+				continue;
 
-		return false;
-	}
+			const bool isTrigger = col0->IsTrigger() || col1->IsTrigger();
+			if (CanGenerateEvents(col0))
+				AddEvent(col0, col1, isTrigger);
 
-	btScalar addSingleResult(btManifoldPoint& cp,
-		const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0,
-		const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1) override
-	{
-		onCollisionEnter(cp, colObj0Wrap, partId0, index0, colObj1Wrap, partId1, index1);
-		return 0;
+			if (CanGenerateEvents(col1))
+				AddEvent(col1, col0, isTrigger);
+		}
 	}
-};
+}
 
 void PhysicsManager::CallCollisionEvent(Collider* a, Collider* b, bool isTrigger, int state)
 {
@@ -285,55 +272,20 @@ void PhysicsManager::Update()
 
 	const size_t colliderCount = s_colliders.size();
 
-	{
-		SCOPED_PROFILER("PhysicsManager::Update|StepSimulation", scopeBenchmark2);
-		//s_physDynamicsWorld->stepSimulation(Time::GetDeltaTime(), 2, Time::GetDeltaTime() / 2); // Increase physics accuracy but trigger won't work properly
-
-		// Slow down the physics simulation if the frame rate is too low
-		float timeStep = Time::GetDeltaTime();
-		if (timeStep > 0.05f)
-		{
-			timeStep = 0.05f;
-		}
-		s_physDynamicsWorld->stepSimulation(timeStep, 0);
-	}
+	const float interpolationFactor = StepSimulation();
 
 	{
 		SCOPED_PROFILER("PhysicsManager::Update|RigidBodyTick", scopeBenchmark2);
 		for (size_t i = 0; i < rigidbodyCount; i++)
 		{
 			RigidBody* rb = s_rigidBodies[i];
-			rb->Tick();
+			rb->Tick(interpolationFactor);
 		}
 	}
 
 	{
-		SCOPED_PROFILER("PhysicsManager::Update|ContactTest", scopeBenchmark2);
-		MyContactResultCallback resultCallback;
-		for (size_t i = 0; i < rigidbodyCount; i++)
-		{
-			const RigidBody* rb = s_rigidBodies[i];
-			if (rb->m_generatesEvents && rb->IsEnabled() && rb->GetGameObjectRaw()->IsLocalActive())
-			{
-				if (!rb->m_isEmpty)
-				{
-					s_physDynamicsWorld->contactTest(rb->m_bulletRigidbody, resultCallback);
-				}
-				if (rb->m_isTriggerEmpty)
-				{
-					s_physDynamicsWorld->contactTest(rb->m_bulletTriggerRigidbody, resultCallback);
-				}
-			}
-		}
-
-		for (size_t i = 0; i < colliderCount; i++)
-		{
-			const ColliderInfo& colliderInfo = s_colliders[i];
-			if (colliderInfo.collider->m_generateCollisionEvents && colliderInfo.collider->m_bulletCollisionObject && colliderInfo.collider->IsEnabled() && colliderInfo.collider->GetGameObjectRaw()->IsLocalActive())
-			{
-				s_physDynamicsWorld->contactTest(colliderInfo.collider->m_bulletCollisionObject, resultCallback);
-			}
-		}
+		SCOPED_PROFILER("PhysicsManager::Update|GenerateCollisionEvents", scopeBenchmark2);
+		GenerateCollisionEvents();
 	}
 
 	{
@@ -397,12 +349,86 @@ void PhysicsManager::Update()
 	}
 }
 
+float PhysicsManager::StepSimulation()
+{
+	SCOPED_PROFILER("PhysicsManager::Update|StepSimulation", scopeBenchmark);
+
+	if (!s_useFixedTimeStep)
+	{
+		//s_physDynamicsWorld->stepSimulation(Time::GetDeltaTime(), 2, Time::GetDeltaTime() / 2); // Increase physics accuracy but trigger won't work properly
+
+		// Slow down the physics simulation if the frame rate is too low
+		float timeStep = Time::GetDeltaTime();
+		if (timeStep > 0.05f)
+		{
+			timeStep = 0.05f;
+		}
+		s_physDynamicsWorld->stepSimulation(timeStep, 0);
+		s_lastSubStepCount = 1;
+		return 1;
+	}
+
+	s_timeAccumulator += Time::GetDeltaTime();
+
+	int subStepCount = static_cast<int>(s_timeAccumulator / s_fixedTimeStep);
+	if (subStepCount > s_maxSubSteps)
+	{
+		// Drop the time that can't be simulated to avoid a spiral of death on slow frames
+		subStepCount = s_maxSubSteps;
+		s_timeAccumulator = s_fixedTimeStep * subStepCount;
+	}
+	s_timeAccumulator -= s_fixedTimeStep * subStepCount;
+	s_lastSubStepCount = subStepCount;
+
+	const size_t rigidbodyCount = s_rigidBodies.size();
+	for (int step = 0; step < subStepCount; step++)
+	{
+		// One profiler entry per step, the profiler shows the step count and the time of each step
+		SCOPED_PROFILER("PhysicsManager::Update|SubStep", scopeBenchmarkSubStep);
+
+		for (size_t i = 0; i < rigidbodyCount; i++)
+		{
+			s_rigidBodies[i]->SavePreviousPhysicsState();
+		}
+		s_physDynamicsWorld->stepSimulation(s_fixedTimeStep, 0);
+	}
+
+	return s_timeAccumulator / s_fixedTimeStep;
+}
+
+void PhysicsManager::SetUseFixedTimeStep(bool useFixedTimeStep)
+{
+	s_useFixedTimeStep = useFixedTimeStep;
+	s_timeAccumulator = 0;
+}
+
+void PhysicsManager::SetFixedTimeStep(float fixedTimeStep)
+{
+	XASSERT(fixedTimeStep > 0, "[PhysicsManager::SetFixedTimeStep] fixedTimeStep must be greater than 0");
+
+	if (fixedTimeStep <= 0)
+		return;
+
+	s_fixedTimeStep = fixedTimeStep;
+}
+
+void PhysicsManager::SetMaxSubSteps(int maxSubSteps)
+{
+	XASSERT(maxSubSteps > 0, "[PhysicsManager::SetMaxSubSteps] maxSubSteps must be greater than 0");
+
+	if (maxSubSteps <= 0)
+		return;
+
+	s_maxSubSteps = maxSubSteps;
+}
+
 void PhysicsManager::Clear()
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
 	PhysicsManager::s_rigidBodies.clear();
 	PhysicsManager::s_colliders.clear();
+	PhysicsManager::s_colliderIndices.clear();
 }
 
 void PhysicsManager::AddRigidBody(RigidBody* rb)
@@ -433,6 +459,7 @@ void PhysicsManager::AddCollider(Collider* col)
 
 	ColliderInfo colliderInfo;
 	colliderInfo.collider = col;
+	s_colliderIndices[col] = s_colliders.size();
 	s_colliders.push_back(colliderInfo);
 }
 
@@ -440,13 +467,24 @@ void PhysicsManager::RemoveCollider(const Collider* col)
 {
 	STACK_DEBUG_OBJECT(STACK_LOW_PRIORITY);
 
-	const size_t colliderCount = s_colliders.size();
-	for (size_t i = 0; i < colliderCount; i++)
+	const auto colliderIndex = s_colliderIndices.find(col);
+	if (colliderIndex == s_colliderIndices.end())
+		return;
+
+	// Move the last collider in the removed slot to keep the indices valid
+	const size_t index = colliderIndex->second;
+	s_colliderIndices.erase(colliderIndex);
+	if (index != s_colliders.size() - 1)
 	{
-		if (s_colliders[i].collider == col)
-		{
-			s_colliders.erase(s_colliders.begin() + i);
-			break;
-		}
+		s_colliders[index] = std::move(s_colliders.back());
+		s_colliderIndices[s_colliders[index].collider] = index;
 	}
-}
\ No newline at end of file
+	s_colliders.pop_back();
+
+	// Remove the collisions with the removed collider to not call events with a deleted collider
+	for (ColliderInfo& colliderInfo : s_colliders)
+	{
+		colliderInfo.collisions.erase(const_cast<Collider*>(col));
+		colliderInfo.triggersCollisions.erase(const_cast<Collider*>(col));
+	}
+}
@@ -20,6 +20,7 @@ class btRigidBody;
 class btVector3;
 class btQuaternion;
 class btDynamicsWorld;
+class btCollisionObject;
 class Collider;
 class Vector3;
 
@@ -70,13 +71,77 @@ public:
 	static void RemoveCollider(const Collider* rb);
 	static void AddEvent(Collider* collider, Collider* otherCollider, bool isTrigger);
 
+	/**
+	* @brief Enable or disable the fixed time step mode.
+	* When enabled, the simulation is advanced by fixed steps and the rigidbodies are interpolated between the last two steps
+	*/
+	static void SetUseFixedTimeStep(bool useFixedTimeStep);
+
+	static bool IsUsingFixedTimeStep()
+	{
+		return s_useFixedTimeStep;
+	}
+
+	/**
+	* @brief Set the duration of a simulation step in fixed time step mode (in seconds)
+	*/
+	static void SetFixedTimeStep(float fixedTimeStep);
+
+	static float GetFixedTimeStep()
+	{
+		return s_fixedTimeStep;
+	}
+
+	/**
+	* @brief Set the maximum number of simulation steps per frame in fixed time step mode, the remaining time is dropped
+	*/
+	static void SetMaxSubSteps(int maxSubSteps);
+
+	static int GetMaxSubSteps()
+	{
+		return s_maxSubSteps;
+	}
+
+	/**
+	* @brief Get the number of simulation steps done during the last update
+	*/
+	static int GetLastSubStepCount()
+	{
+		return s_lastSubStepCount;
+	}
+
+	/**
+	* @brief Get the collider of a collision object
+	* @param childIndex Index of the child shape if the collision object is a rigidbody
+	*/
+	static Collider* GetCollider(const btCollisionObject* collisionObject, int childIndex);
+
 	static btDynamicsWorld* s_physDynamicsWorld;
 	static Vector3 s_gravity;
 
 private:
 	static void CallCollisionEvent(Collider* a, Collider* b, bool isTrigger, int state);
 
+	/**
+	* @brief Advance the simulation and return the interpolation factor to apply to the rigidbodies (between 0 and 1)
+	*/
+	static float StepSimulation();
+
+	static bool s_useFixedTimeStep;
+	static float s_fixedTimeStep;
+	static int s_maxSubSteps;
+	static float s_timeAccumulator;
+	static int s_lastSubStepCount;
+
+	static bool CanGenerateEvents(const Collider* collider);
+
+	/**
+	* @brief Add the collision events from the contacts found during the last simulation step
+	*/
+	static void GenerateCollisionEvents();
+
 	static std::vector<RigidBody*> s_rigidBodies;
 	static std::vector<ColliderInfo> s_colliders;
+	static std::unordered_map<const Collider*, size_t> s_colliderIndices; // Index of the collider in s_colliders
 
 };
\ No newline at end of file
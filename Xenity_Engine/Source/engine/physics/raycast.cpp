@@ -8,6 +8,10 @@
 
 #include <bullet/btBulletDynamicsCommon.h>
 #include <bullet/BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
+#include <bullet/BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <bullet/BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <bullet/BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
+#include <bullet/BulletCollision/NarrowPhaseCollision/btPointCollector.h>
 
 #include <engine/game_elements/transform.h>
 #include <engine/game_elements/gameobject.h>
@@ -15,6 +19,10 @@
 #include "box_collider.h"
 #include "rigidbody.h"
 #include "physics_manager.h"
+#include <engine/assertions/assertions.h>
+#include <engine/debug/performance.h>
+#include <engine/debug/stack_debug_object.h>
+#include <engine/job_system/job_system.h>
 
 bool Raycast::Check(const Vector3& startPosition, const Vector3& direction, const float maxDistance, RaycastHit& raycastHit)
 {
@@ -34,4 +42,384 @@ bool Raycast::Check(const Vector3& startPosition, const Vector3& direction, cons
 		return true;
 	}
 	return false;
-}
\ No newline at end of file
+}
+#pragma region Batched queries
+
+namespace
+{
+	constexpr size_t MIN_QUERIES_PER_THREAD = 64;
+
+	/**
+	* @brief Collect the collision objects of the broadphase leaves hit by a query
+	*/
+	struct CandidateCollector : public btDbvt::ICollide
+	{
+		explicit CandidateCollector(std::vector<const btCollisionObject*>& candidates) : m_candidates(candidates)
+		{
+		}
+
+		using btDbvt::ICollide::Process;
+		void Process(const btDbvtNode* leaf)
+		{
+			const btDbvtProxy* proxy = static_cast<const btDbvtProxy*>(leaf->data);
+			m_candidates.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject));
+		}
+
+		std::vector<const btCollisionObject*>& m_candidates;
+	};
+
+	/**
+	* @brief Memory reused by the queries of a thread
+	*/
+	struct QueryScratch
+	{
+		std::vector<const btCollisionObject*> candidates;
+		btAlignedObjectArray<const btDbvtNode*> stack;
+	};
+
+	const btDbvtBroadphase& GetBroadphase()
+	{
+		// The physics manager always creates a dbvt broadphase
+		return *static_cast<const btDbvtBroadphase*>(PhysicsManager::s_physDynamicsWorld->getBroadphase());
+	}
+
+	/**
+	* @brief Fill the scratch candidates with the objects whose bounding box is crossed by a ray (expanded by an aabb for the sweeps)
+	* The broadphase ray test is not used because it shares its stack between the threads
+	*/
+	void GatherRayCandidates(const btVector3& from, const btVector3& to, const btVector3& aabbMin, const btVector3& aabbMax, QueryScratch& scratch)
+	{
+		scratch.candidates.clear();
+
+		btVector3 rayDirection = to - from;
+		const btScalar rayLength = rayDirection.length();
+		if (rayLength <= 0)
+			return;
+
+		rayDirection /= rayLength;
+		btVector3 rayDirectionInverse;
+		rayDirectionInverse[0] = rayDirection[0] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayDirection[0];
+		rayDirectionInverse[1] = rayDirection[1] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayDirection[1];
+		rayDirectionInverse[2] = rayDirection[2] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayDirection[2];
+		unsigned int signs[3] = { rayDirectionInverse[0] < 0.0, rayDirectionInverse[1] < 0.0, rayDirectionInverse[2] < 0.0 };
+
+		CandidateCollector collector(scratch.candidates);
+		const btDbvtBroadphase& broadphase = GetBroadphase();
+		for (int i = 0; i < 2; i++)
+		{
+			broadphase.m_sets[i].rayTestInternal(broadphase.m_sets[i].m_root, from, to, rayDirectionInverse, signs, rayLength, aabbMin, aabbMax, scratch.stack, collector);
+		}
+	}
+
+	bool IsColliderAccepted(const Collider* collider, const RaycastQuerySettings& settings)
+	{
+		if (!collider)
+			return false;
+
+		const int layer = collider->GetCollisionLayer();
+		if (layer < 0 || layer >= Collider::COLLISION_LAYER_COUNT || (settings.layerMask & (1u << layer)) == 0)
+			return false;
+
+		return settings.hitTriggers || !collider->IsTrigger();
+	}
+
+	uint32_t GetMaxHits(const RaycastQuerySettings& settings)
+	{
+		return settings.mode == RaycastMode::Closest ? 1 : settings.maxHitsPerQuery;
+	}
+
+	/**
+	* @brief Get the number of hits between the first hits of two queries in the hit buffer
+	*/
+	size_t GetHitStride(const RaycastQuerySettings& settings)
+	{
+		XASSERT(settings.maxHitsPerQuery >= 1, "[Raycast] maxHitsPerQuery has to be at least 1");
+
+		// With 0, all the queries would write their hit at the same place
+		return settings.maxHitsPerQuery == 0 ? 1 : settings.maxHitsPerQuery;
+	}
+
+	/**
+	* @brief Insert a hit in a list sorted by distance, the farthest hit is dropped when the list is full
+	* @return True if the hit has been inserted
+	*/
+	bool InsertHit(RaycastHitData* hits, uint32_t& hitCount, uint32_t maxHits, const RaycastHitData& hit)
+	{
+		if (maxHits == 0)
+			return false;
+
+		if (hitCount == maxHits)
+		{
+			if (hit.distance >= hits[hitCount - 1].distance)
+				return false;
+			hitCount--;
+		}
+
+		uint32_t index = hitCount;
+		while (index > 0 && hits[index - 1].distance > hit.distance)
+		{
+			hits[index] = hits[index - 1];
+			index--;
+		}
+		hits[index] = hit;
+		hitCount++;
+		return true;
+	}
+
+	int GetChildIndex(const btCollisionWorld::LocalShapeInfo* localShapeInfo)
+	{
+		// For the compound shapes, Bullet gives the child index in m_triangleIndex
+		return localShapeInfo ? localShapeInfo->m_triangleIndex : -1;
+	}
+
+	struct BatchRayResultCallback : public btCollisionWorld::RayResultCallback
+	{
+		BatchRayResultCallback(const btVector3& from, const btVector3& to, float maxDistance, const RaycastQuerySettings& settings, RaycastHitData* hits)
+			: m_from(from), m_to(to), m_maxDistance(maxDistance), m_settings(settings), m_hits(hits), m_maxHits(GetMaxHits(settings))
+		{
+		}
+
+		btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+		{
+			Collider* collider = PhysicsManager::GetCollider(rayResult.m_collisionObject, GetChildIndex(rayResult.m_localShapeInfo));
+			if (!IsColliderAccepted(collider, m_settings))
+				return m_closestHitFraction;
+
+			const btVector3 normal = normalInWorldSpace ? rayResult.m_hitNormalLocal : rayResult.m_collisionObject->getWorldTransform().getBasis() * rayResult.m_hitNormalLocal;
+			const btVector3 position = m_from.lerp(m_to, rayResult.m_hitFraction);
+
+			RaycastHitData hit;
+			hit.collider = collider;
+			hit.position = Vector3(position.x(), position.y(), position.z());
+			hit.normal = Vector3(normal.x(), normal.y(), normal.z());
+			hit.distance = rayResult.m_hitFraction * m_maxDistance;
+
+			if (InsertHit(m_hits, m_hitCount, m_maxHits, hit) && m_hitCount == m_maxHits)
+			{
+				// The list is full, farther hits are not needed anymore
+				m_closestHitFraction = m_hits[m_hitCount - 1].distance / m_maxDistance;
+			}
+			return m_closestHitFraction;
+		}
+
+		btVector3 m_from;
+		btVector3 m_to;
+		float m_maxDistance;
+		const RaycastQuerySettings& m_settings;
+		RaycastHitData* m_hits;
+		uint32_t m_maxHits;
+		uint32_t m_hitCount = 0;
+	};
+
+	struct BatchConvexResultCallback : public btCollisionWorld::ConvexResultCallback
+	{
+		BatchConvexResultCallback(const btVector3& from, const btVector3& to, float maxDistance, const RaycastQuerySettings& settings, RaycastHitData* hits)
+			: m_from(from), m_to(to), m_maxDistance(maxDistance), m_settings(settings), m_hits(hits), m_maxHits(GetMaxHits(settings))
+		{
+		}
+
+		btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+		{
+			Collider* collider = PhysicsManager::GetCollider(convexResult.m_hitCollisionObject, GetChildIndex(convexResult.m_localShapeInfo));
+			if (!IsColliderAccepted(collider, m_settings))
+				return m_closestHitFraction;
+
+			const btVector3 normal = normalInWorldSpace ? convexResult.m_hitNormalLocal : convexResult.m_hitCollisionObject->getWorldTransform().getBasis() * convexResult.m_hitNormalLocal;
+
+			RaycastHitData hit;
+			hit.collider = collider;
+			hit.position = Vector3(convexResult.m_hitPointLocal.x(), convexResult.m_hitPointLocal.y(), convexResult.m_hitPointLocal.z());
+			hit.normal = Vector3(normal.x(), normal.y(), normal.z());
+			hit.distance = convexResult.m_hitFraction * m_maxDistance;
+
+			if (InsertHit(m_hits, m_hitCount, m_maxHits, hit) && m_hitCount == m_maxHits)
+			{
+				m_closestHitFraction = m_hits[m_hitCount - 1].distance / m_maxDistance;
+			}
+			return m_closestHitFraction;
+		}
+
+		btVector3 m_from;
+		btVector3 m_to;
+		float m_maxDistance;
+		const RaycastQuerySettings& m_settings;
+		RaycastHitData* m_hits;
+		uint32_t m_maxHits;
+		uint32_t m_hitCount = 0;
+	};
+
+	/**
+	* @brief Test if a sphere overlaps a convex shape and add the hit
+	*/
+	void TestSphereOverlap(const btSphereShape& sphereShape, const btTransform& sphereTransform, const btCollisionShape* shape, const btTransform& shapeTransform,
+		Collider* collider, const RaycastQuerySettings& settings, RaycastHitData* hits, uint32_t& hitCount)
+	{
+		if (!shape->isConvex() || !IsColliderAccepted(collider, settings))
+			return;
+
+		btVoronoiSimplexSolver simplexSolver;
+		btGjkEpaPenetrationDepthSolver penetrationDepthSolver;
+		btGjkPairDetector pairDetector(&sphereShape, static_cast<const btConvexShape*>(shape), &simplexSolver, &penetrationDepthSolver);
+
+		btGjkPairDetector::ClosestPointInput input;
+		input.m_transformA = sphereTransform;
+		input.m_transformB = shapeTransform;
+
+		btPointCollector output;
+		pairDetector.getClosestPoints(input, output, nullptr);
+		if (!output.m_hasResult || output.m_distance > 0)
+			return;
+
+		RaycastHitData hit;
+		hit.collider = collider;
+		hit.position = Vector3(output.m_pointInWorld.x(), output.m_pointInWorld.y(), output.m_pointInWorld.z());
+		hit.normal = Vector3(output.m_normalOnBInWorld.x(), output.m_normalOnBInWorld.y(), output.m_normalOnBInWorld.z());
+		hit.distance = output.m_distance;
+		InsertHit(hits, hitCount, GetMaxHits(settings), hit);
+	}
+}
+
+void Raycast::RunBatch(size_t queryCount, bool useWorkerThreads, const std::function<void(size_t begin, size_t end)>& function)
+{
+	if (queryCount == 0)
+		return;
+
+	if (useWorkerThreads)
+	{
+		JobSystem::ParallelFor(queryCount, MIN_QUERIES_PER_THREAD, function);
+	}
+	else
+	{
+		function(0, queryCount);
+	}
+}
+
+void Raycast::CheckBatch(const Ray* rays, size_t rayCount, const RaycastQuerySettings& settings, RaycastHitData* hits, uint32_t* hitCounts)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	SCOPED_PROFILER("Raycast::CheckBatch", scopeBenchmark);
+
+	XASSERT(rays != nullptr || rayCount == 0, "[Raycast::CheckBatch] rays is nullptr");
+	XASSERT(hits != nullptr || rayCount == 0, "[Raycast::CheckBatch] hits is nullptr");
+	XASSERT(hitCounts != nullptr || rayCount == 0, "[Raycast::CheckBatch] hitCounts is nullptr");
+
+	const size_t hitStride = GetHitStride(settings);
+	RunBatch(rayCount, settings.useWorkerThreads, [&](size_t begin, size_t end)
+		{
+			QueryScratch scratch;
+			const btVector3 noExtent = btVector3(0, 0, 0);
+			for (size_t i = begin; i < end; i++)
+			{
+				const Ray& ray = rays[i];
+				const btVector3 from = btVector3(ray.origin.x, ray.origin.y, ray.origin.z);
+				const btVector3 to = from + btVector3(ray.direction.x, ray.direction.y, ray.direction.z) * ray.maxDistance;
+				const btTransform fromTransform = btTransform(btQuaternion::getIdentity(), from);
+				const btTransform toTransform = btTransform(btQuaternion::getIdentity(), to);
+
+				GatherRayCandidates(from, to, noExtent, noExtent, scratch);
+
+				BatchRayResultCallback resultCallback(from, to, ray.maxDistance, settings, hits + i * hitStride);
+				for (const btCollisionObject* collisionObject : scratch.candidates)
+				{
+					btCollisionWorld::rayTestSingle(fromTransform, toTransform, const_cast<btCollisionObject*>(collisionObject), collisionObject->getCollisionShape(), collisionObject->getWorldTransform(), resultCallback);
+				}
+				hitCounts[i] = resultCallback.m_hitCount;
+			}
+		});
+}
+
+void Raycast::SphereCastBatch(const Ray* rays, size_t rayCount, float radius, const RaycastQuerySettings& settings, RaycastHitData* hits, uint32_t* hitCounts)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	SCOPED_PROFILER("Raycast::SphereCastBatch", scopeBenchmark);
+
+	XASSERT(rays != nullptr || rayCount == 0, "[Raycast::SphereCastBatch] rays is nullptr");
+	XASSERT(hits != nullptr || rayCount == 0, "[Raycast::SphereCastBatch] hits is nullptr");
+	XASSERT(hitCounts != nullptr || rayCount == 0, "[Raycast::SphereCastBatch] hitCounts is nullptr");
+
+	const size_t hitStride = GetHitStride(settings);
+	RunBatch(rayCount, settings.useWorkerThreads, [&](size_t begin, size_t end)
+		{
+			QueryScratch scratch;
+			const btSphereShape sphereShape = btSphereShape(radius);
+			const btVector3 aabbMin = btVector3(-radius, -radius, -radius);
+			const btVector3 aabbMax = btVector3(radius, radius, radius);
+			for (size_t i = begin; i < end; i++)
+			{
+				const Ray& ray = rays[i];
+				const btVector3 from = btVector3(ray.origin.x, ray.origin.y, ray.origin.z);
+				const btVector3 to = from + btVector3(ray.direction.x, ray.direction.y, ray.direction.z) * ray.maxDistance;
+				const btTransform fromTransform = btTransform(btQuaternion::getIdentity(), from);
+				const btTransform toTransform = btTransform(btQuaternion::getIdentity(), to);
+
+				GatherRayCandidates(from, to, aabbMin, aabbMax, scratch);
+
+				BatchConvexResultCallback resultCallback(from, to, ray.maxDistance, settings, hits + i * hitStride);
+				for (const btCollisionObject* collisionObject : scratch.candidates)
+				{
+					btCollisionWorld::objectQuerySingle(&sphereShape, fromTransform, toTransform, const_cast<btCollisionObject*>(collisionObject), collisionObject->getCollisionShape(), collisionObject->getWorldTransform(), resultCallback, 0);
+				}
+				hitCounts[i] = resultCallback.m_hitCount;
+			}
+		});
+}
+
+void Raycast::OverlapSphereBatch(const Vector3* centers, size_t sphereCount, float radius, const RaycastQuerySettings& settings, RaycastHitData* hits, uint32_t* hitCounts)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	SCOPED_PROFILER("Raycast::OverlapSphereBatch", scopeBenchmark);
+
+	XASSERT(centers != nullptr || sphereCount == 0, "[Raycast::OverlapSphereBatch] centers is nullptr");
+	XASSERT(hits != nullptr || sphereCount == 0, "[Raycast::OverlapSphereBatch] hits is nullptr");
+	XASSERT(hitCounts != nullptr || sphereCount == 0, "[Raycast::OverlapSphereBatch] hitCounts is nullptr");
+
+	const size_t hitStride = GetHitStride(settings);
+	RunBatch(sphereCount, settings.useWorkerThreads, [&](size_t begin, size_t end)
+		{
+			QueryScratch scratch;
+			const btSphereShape sphereShape = btSphereShape(radius);
+			const btDbvtBroadphase& broadphase = GetBroadphase();
+			for (size_t i = begin; i < end; i++)
+			{
+				const btVector3 center = btVector3(centers[i].x, centers[i].y, centers[i].z);
+				const btTransform sphereTransform = btTransform(btQuaternion::getIdentity(), center);
+
+				scratch.candidates.clear();
+				CandidateCollector collector(scratch.candidates);
+				const btDbvtVolume volume = btDbvtVolume::FromCR(center, radius);
+				for (int setIndex = 0; setIndex < 2; setIndex++)
+				{
+					broadphase.m_sets[setIndex].collideTV(broadphase.m_sets[setIndex].m_root, volume, collector);
+				}
+
+				RaycastHitData* queryHits = hits + i * hitStride;
+				uint32_t hitCount = 0;
+				for (const btCollisionObject* collisionObject : scratch.candidates)
+				{
+					const btCollisionShape* shape = collisionObject->getCollisionShape();
+					const btTransform& objectTransform = collisionObject->getWorldTransform();
+					if (shape->isCompound())
+					{
+						// Test each collider of the rigidbody
+						const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(shape);
+						const int childCount = compoundShape->getNumChildShapes();
+						for (int childIndex = 0; childIndex < childCount; childIndex++)
+						{
+							TestSphereOverlap(sphereShape, sphereTransform, compoundShape->getChildShape(childIndex), objectTransform * compoundShape->getChildTransform(childIndex),
+								PhysicsManager::GetCollider(collisionObject, childIndex), settings, queryHits, hitCount);
+						}
+					}
+					else
+					{
+						TestSphereOverlap(sphereShape, sphereTransform, shape, objectTransform, PhysicsManager::GetCollider(collisionObject, -1), settings, queryHits, hitCount);
+					}
+				}
+				hitCounts[i] = hitCount;
+			}
+		});
+}
+
+#pragma endregion
@@ -7,6 +7,9 @@
 #pragma once
 
 #include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
 
 #include <engine/api.h>
 #include <engine/vectors/vector3.h>
@@ -23,6 +26,45 @@ struct RaycastHit
 	float distance = 0;
 };
 
+/**
+* @brief Ray used by the batched queries
+*/
+struct Ray
+{
+	Vector3 origin = Vector3(0, 0, 0);
+	Vector3 direction = Vector3(0, 0, 1); // Normalized
+	float maxDistance = 0;
+};
+
+/**
+* @brief Plain data hit written by the batched queries
+*/
+struct RaycastHitData
+{
+	Collider* collider = nullptr; // Valid until the collider is destroyed
+	Vector3 position = Vector3(0, 0, 0);
+	Vector3 normal = Vector3(0, 0, 0);
+	float distance = 0; // Distance along the ray, negative penetration depth for the overlaps
+};
+
+enum class RaycastMode
+{
+	Closest, // Only the closest hit of each query
+	AllHits, // All hits of each query (up to maxHitsPerQuery), sorted by distance
+};
+
+/**
+* @brief Settings of a batched query
+*/
+struct RaycastQuerySettings
+{
+	RaycastMode mode = RaycastMode::Closest;
+	uint32_t layerMask = UINT32_MAX; // Bit n set to hit the colliders of the layer n
+	bool hitTriggers = true;
+	uint32_t maxHitsPerQuery = 1; // Number of hits reserved for each query in the hit buffer (at least 1, also used in Closest mode)
+	bool useWorkerThreads = true;
+};
+
 /**
 * @brief Class to check collisions with a ray
 */
@@ -37,6 +79,35 @@ public:
 	* @param raycastHit The raycastHit struct that will be filled with the hit information
 	*/
 	static bool Check(const Vector3& startPosition, const Vector3& direction, const float maxDistance, RaycastHit& raycastHit);
+
+	/**
+	* @brief Cast a list of rays, the rays are split between worker threads when available.
+	* Do not call during the physics update, the physics world is read without lock
+	* @param rays The rays to cast
+	* @param rayCount The number of rays
+	* @param settings The query settings
+	* @param hits Hit buffer of rayCount * settings.maxHitsPerQuery elements, the hits of the ray i start at i * settings.maxHitsPerQuery
+	* @param hitCounts Buffer of rayCount elements filled with the number of hits of each ray
+	*/
+	static void CheckBatch(const Ray* rays, size_t rayCount, const RaycastQuerySettings& settings, RaycastHitData* hits, uint32_t* hitCounts);
+
+	/**
+	* @brief Sweep a sphere along a list of rays, the buffers are used like in CheckBatch
+	* @param radius The radius of the sphere
+	*/
+	static void SphereCastBatch(const Ray* rays, size_t rayCount, float radius, const RaycastQuerySettings& settings, RaycastHitData* hits, uint32_t* hitCounts);
+
+	/**
+	* @brief Find the colliders overlapping a list of spheres, the buffers are used like in CheckBatch
+	* @param centers The centers of the spheres
+	* @param radius The radius of the spheres
+	*/
+	static void OverlapSphereBatch(const Vector3* centers, size_t sphereCount, float radius, const RaycastQuerySettings& settings, RaycastHitData* hits, uint32_t* hitCounts);
+
 private:
+	/**
+	* @brief Call a function on ranges of the queries, on worker threads if available
+	*/
+	static void RunBatch(size_t queryCount, bool useWorkerThreads, const std::function<void(size_t begin, size_t end)>& function);
 };
 
@@ -319,29 +319,75 @@ void RigidBody::OnTransformUpdated()
 	if (m_disableEvent)
 		return;
 
+	// The event of the pose set by Tick can be received later with the lazy transform update, it is ignored
 	const Transform& transform = *GetTransformRaw();
-	m_bulletRigidbody->setWorldTransform(btTransform(
-		btQuaternion(transform.GetRotation().x, transform.GetRotation().y, transform.GetRotation().z, transform.GetRotation().w),
-		btVector3(transform.GetPosition().x, transform.GetPosition().y, transform.GetPosition().z)));
+	const Vector3& position = transform.GetPosition();
+	const Quaternion& rotation = transform.GetRotation();
+	const bool isPositionChanged = position != m_lastTransformPosition;
+	const bool isRotationChanged = rotation != m_lastTransformRotation;
+	if (!isPositionChanged && !isRotationChanged)
+		return;
+
+	// Keep the physics state (not the interpolated one) for the value not set by the gameplay code
+	btTransform newTransform = m_bulletRigidbody->getWorldTransform();
+	if (isPositionChanged)
+	{
+		newTransform.setOrigin(btVector3(position.x, position.y, position.z));
+		m_lastTransformPosition = position;
+	}
+	if (isRotationChanged)
+	{
+		newTransform.setRotation(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w));
+		m_lastTransformRotation = rotation;
+	}
+	m_bulletRigidbody->setWorldTransform(newTransform);
 
 	m_bulletTriggerRigidbody->setWorldTransform(m_bulletRigidbody->getWorldTransform());
 
+	// Teleported, do not interpolate from the old position
+	SavePreviousPhysicsState();
+
 	m_bulletRigidbody->activate();
 }
 
-void RigidBody::Tick()
+void RigidBody::SavePreviousPhysicsState()
+{
+	if (!m_bulletRigidbody)
+		return;
+
+	// The trigger shapes have to be at the same place during the step to generate the trigger events
+	m_bulletTriggerRigidbody->setWorldTransform(m_bulletRigidbody->getWorldTransform());
+
+	const btVector3& p = m_bulletRigidbody->getCenterOfMassPosition();
+	const btQuaternion q = m_bulletRigidbody->getOrientation();
+	m_previousPosition = Vector3(p.x(), p.y(), p.z());
+	m_previousRotation = Quaternion(q.x(), q.y(), q.z(), q.w());
+}
+
+void RigidBody::Tick(float interpolationFactor)
 {
 	if (GetGameObjectRaw()->IsLocalActive() && m_bulletTriggerRigidbody)
 	{
 		m_disableEvent = true;
 		m_bulletTriggerRigidbody->setWorldTransform(m_bulletRigidbody->getWorldTransform());
 
-		const btVector3& p = m_bulletRigidbody->getCenterOfMassPosition();
-		const btQuaternion q = m_bulletRigidbody->getOrientation();
+		btVector3 p = m_bulletRigidbody->getCenterOfMassPosition();
+		btQuaternion q = m_bulletRigidbody->getOrientation();
 
+		// Smooth the movement when the simulation does not run at the frame rate
+		if (interpolationFactor < 1)
+		{
+			const btVector3 previousPosition = btVector3(m_previousPosition.x, m_previousPosition.y, m_previousPosition.z);
+			const btQuaternion previousRotation = btQuaternion(m_previousRotation.x, m_previousRotation.y, m_previousRotation.z, m_previousRotation.w);
+			p = previousPosition.lerp(p, interpolationFactor);
+			q = previousRotation.slerp(q, interpolationFactor);
+		}
+
+		m_lastTransformPosition = Vector3(p.x(), p.y(), p.z());
+		m_lastTransformRotation = Quaternion(q.x(), q.y(), q.z(), q.w());
 		Transform& transform = *GetTransformRaw();
-		transform.SetPosition(Vector3(p.x(), p.y(), p.z()));
-		transform.SetRotation(Quaternion(q.x(), q.y(), q.z(), q.w()));
+		transform.SetPosition(m_lastTransformPosition);
+		transform.SetRotation(m_lastTransformRotation);
 
 		const btVector3& vel = m_bulletRigidbody->getLinearVelocity();
 		m_velocity = Vector3(vel.x(), vel.y(), vel.z());
@@ -423,6 +469,11 @@ void RigidBody::Awake()
 	m_bulletRigidbody->activate();
 	m_bulletTriggerRigidbody->activate();
 
+	m_previousPosition = pos;
+	m_previousRotation = rot;
+	m_lastTransformPosition = pos;
+	m_lastTransformRotation = rot;
+
 	// Add an empty shape to enable gravity with an empty rigidbody
 	m_emptyShape = new btEmptyShape();
 	AddShape(m_emptyShape, Vector3(0, 0, 0));
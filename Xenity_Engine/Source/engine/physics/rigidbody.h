@@ -10,6 +10,7 @@
 #include <engine/api.h>
 #include <engine/component.h>
 #include <engine/vectors/vector3.h>
+#include <engine/vectors/quaternion.h>
 
 class BoxCollider;
 
@@ -99,7 +100,6 @@ protected:
 	friend class BoxCollider;
 	friend class SphereCollider;
 	friend class PhysicsManager;
-	friend class MyContactResultCallback;
 
 	void AddShape(btCollisionShape* shape, const Vector3& offset);
 	void AddTriggerShape(btCollisionShape* shape, const Vector3& offset);
@@ -130,8 +130,23 @@ protected:
 	bool m_isEmpty = false;
 	bool m_isTriggerEmpty = false;
 
+	// Physics state before the last simulation step, used for the interpolation
+	Vector3 m_previousPosition = Vector3(0, 0, 0);
+	Quaternion m_previousRotation = Quaternion::Identity();
+
+	// Last pose of the transform known by the rigidbody (set by Tick or by the gameplay code).
+	// The interpolated pose of Tick is only for the rendering, only the values changed since then are sent to the physics
+	Vector3 m_lastTransformPosition = Vector3(0, 0, 0);
+	Quaternion m_lastTransformRotation = Quaternion::Identity();
+
+	/**
+	 * @brief [Internal] Store the current physics state before a simulation step and move the trigger shapes to it
+	 */
+	void SavePreviousPhysicsState();
+
 	/**
-	 * @brief [Internal]
+	 * @brief [Internal] Apply the physics state to the transform
+	 * @param interpolationFactor Position between the previous and the current physics state (1 to use the current state)
 	 */
-	void Tick();
+	void Tick(float interpolationFactor);
 };
@@ -38,6 +38,7 @@ ReflectiveData SphereCollider::GetReflectiveData()
 	AddVariable(reflectedVariables, m_offset, "offset", true);
 	AddVariable(reflectedVariables, m_isTrigger, "isTrigger", true);
 	AddVariable(reflectedVariables, m_generateCollisionEvents, "generateCollisionEvents", true);
+	AddVariable(reflectedVariables, m_collisionLayer, "collisionLayer", true);
 	return reflectedVariables;
 }
 
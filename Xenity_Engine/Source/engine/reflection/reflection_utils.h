@@ -33,6 +33,14 @@ public:
 	*/
 	static void ReflectiveToReflective(Reflective& fromReflective, Reflective& toReflective);
 
+	/**
+	* @brief Fill a Reflective data list with the values of another list, without intermediate json
+	* The variables are matched by name, the lists are replaced by a copy of the other lists
+	* @param fromDataList The Reflective data list to copy
+	* @param toDataList The Reflective data list to fill
+	*/
+	static void ReflectiveDataToReflectiveData(const ReflectiveData& fromDataList, const ReflectiveData& toDataList);
+
 	/**
 	* @brief Fill Reflective object from Json data
 	* @param j Json data
@@ -275,6 +283,31 @@ public:
 	std::enable_if_t<!std::is_base_of<Reflective, T>::value && !is_shared_ptr<T>::value && !is_weak_ptr<T>::value && !is_vector<T>::value, void>
 	static JsonToVariable(const nlohmann::ordered_json& jsonValue, const std::reference_wrapper<T> valuePtr, const ReflectiveEntry& entry);
 
+	/**
+	* @brief Fill a variable with another variable of the same type (basic types, references, files and lists of them)
+	* @param fromValue Variable to copy
+	* @param toValue Variable to fill
+	* @param entry Reflective entry of the variable to fill
+	*/
+	template<typename T>
+	static void VariableToVariable(const T& fromValue, T& toValue, const ReflectiveEntry& entry);
+
+	/**
+	* @brief Fill a variable with another variable of the same type (reflective)
+	* @param fromValue Variable to copy
+	* @param toValue Variable to fill
+	* @param entry Reflective entry of the variable to fill
+	*/
+	static void VariableToVariable(Reflective& fromValue, Reflective& toValue, const ReflectiveEntry& entry);
+
+	/**
+	* @brief Fill a vector variable with another vector variable (reflective), the reflectives are duplicated
+	* @param fromValue Variable to copy
+	* @param toValue Variable to fill
+	* @param entry Reflective entry of the variable to fill
+	*/
+	static void VariableToVariable(const std::vector<Reflective*>& fromValue, std::vector<Reflective*>& toValue, const ReflectiveEntry& entry);
+
 #pragma endregion
 };
 
@@ -263,14 +263,81 @@ inline void ReflectionUtils::ReflectiveToReflective(Reflective& fromReflective,
 	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
 
 	const ReflectiveData fromReflectiveData = fromReflective.GetReflectiveData();
-	nlohmann::ordered_json jsonData;
-	jsonData["Values"] = ReflectiveDataToJson(fromReflectiveData);
-
-	ReflectiveData toReflectiveData = toReflective.GetReflectiveData();
-	JsonToReflectiveData(jsonData, toReflectiveData);
+	const ReflectiveData toReflectiveData = toReflective.GetReflectiveData();
+	ReflectiveDataToReflectiveData(fromReflectiveData, toReflectiveData);
 	toReflective.OnReflectionUpdated();
 }
 
+inline void ReflectionUtils::ReflectiveDataToReflectiveData(const ReflectiveData& fromDataList, const ReflectiveData& toDataList)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+
+	const size_t toCount = toDataList.size();
+	size_t toIndex = 0;
+	for (const ReflectiveEntry& fromEntry : fromDataList)
+	{
+		// Both lists usually come from the same class, so the variable is expected at the next index
+		const ReflectiveEntry* toEntry = nullptr;
+		for (size_t i = 0; i < toCount; i++)
+		{
+			const ReflectiveEntry& otherEntry = toDataList[(toIndex + i) % toCount];
+			if (otherEntry.variableName == fromEntry.variableName)
+			{
+				toEntry = &otherEntry;
+				toIndex = (toIndex + i + 1) % toCount;
+				break;
+			}
+		}
+
+		if (!toEntry)
+			continue;
+
+		const VariableReference& fromVariableRef = fromEntry.variable.value();
+		const VariableReference& toVariableRef = toEntry->variable.value();
+		if (fromVariableRef.index() != toVariableRef.index())
+			continue;
+
+		std::visit([&toVariableRef, toEntry](const auto& fromValue)
+			{
+				using ValueReference = std::decay_t<decltype(fromValue)>;
+				VariableToVariable(fromValue.get(), std::get<ValueReference>(toVariableRef).get(), *toEntry);
+			}, fromVariableRef);
+	}
+}
+
+template<typename T>
+inline void ReflectionUtils::VariableToVariable(const T& fromValue, T& toValue, const ReflectiveEntry& entry)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+
+	toValue = fromValue;
+}
+
+inline void ReflectionUtils::VariableToVariable(Reflective& fromValue, Reflective& toValue, const ReflectiveEntry& entry)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+
+	ReflectionUtils::ReflectiveToReflective(fromValue, toValue);
+}
+
+inline void ReflectionUtils::VariableToVariable(const std::vector<Reflective*>& fromValue, std::vector<Reflective*>& toValue, const ReflectiveEntry& entry)
+{
+	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
+
+	const size_t vectorSize = fromValue.size();
+	toValue.resize(vectorSize);
+	for (size_t i = 0; i < vectorSize; i++)
+	{
+		Reflective* newVariable = nullptr;
+		if (fromValue[i]) // If the reflective is not null
+		{
+			newVariable = (Reflective*)entry.typeSpawner->Allocate();
+			ReflectionUtils::ReflectiveToReflective(*fromValue[i], *newVariable);
+		}
+		toValue[i] = newVariable;
+	}
+}
+
 inline void ReflectionUtils::JsonToReflective(const nlohmann::ordered_json& j, Reflective& reflective)
 {
 	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
@@ -0,0 +1,1051 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "binary_scene.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <engine/class_registry/class_registry.h>
+#include <engine/reflection/reflection_utils.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/transform.h>
+#include <engine/component.h>
+#include <engine/missing_script.h>
+#include <engine/tools/endian_utils.h>
+#include <engine/tools/template_utils.h>
+#include <engine/debug/debug.h>
+#include <engine/debug/performance.h>
+#include <engine/debug/stack_debug_object.h>
+
+using ordered_json = nlohmann::ordered_json;
+
+class BinaryScene::Reader
+{
+public:
+	Reader(const unsigned char* data, size_t size) : m_data(data), m_size(size)
+	{
+	}
+
+	template<typename T>
+	T Read()
+	{
+		CheckSize(sizeof(T));
+		T value;
+		// Use memcpy to avoid alignment issues
+		memcpy(&value, m_data + m_position, sizeof(T));
+		m_position += sizeof(T);
+#if defined(__PS3__)
+		value = EndianUtils::SwapEndian(value);
+#endif
+		return value;
+	}
+
+	void ReadString(std::string& value)
+	{
+		const uint32_t length = Read<uint32_t>();
+		CheckSize(length);
+		value.assign(reinterpret_cast<const char*>(m_data + m_position), length);
+		m_position += length;
+	}
+
+	const unsigned char* ReadBytes(size_t size)
+	{
+		CheckSize(size);
+		const unsigned char* bytes = m_data + m_position;
+		m_position += size;
+		return bytes;
+	}
+
+	void Skip(size_t size)
+	{
+		CheckSize(size);
+		m_position += size;
+	}
+
+	size_t GetPosition() const
+	{
+		return m_position;
+	}
+
+private:
+	void CheckSize(size_t size) const
+	{
+		if (size > m_size - m_position)
+		{
+			throw std::runtime_error("[BinaryScene] Unexpected end of data");
+		}
+	}
+
+	const unsigned char* m_data = nullptr;
+	size_t m_size = 0;
+	size_t m_position = 0;
+};
+
+class BinaryScene::Writer
+{
+public:
+	explicit Writer(std::vector<uint8_t>& data) : m_data(data)
+	{
+	}
+
+	template<typename T>
+	void Write(T value)
+	{
+		WriteBytes(&value, sizeof(T));
+	}
+
+	template<typename T>
+	void WriteAt(size_t position, T value)
+	{
+		memcpy(m_data.data() + position, &value, sizeof(T));
+	}
+
+	void WriteString(const std::string& value)
+	{
+		Write<uint32_t>(static_cast<uint32_t>(value.size()));
+		WriteBytes(value.data(), value.size());
+	}
+
+	void WriteBytes(const void* bytes, size_t size)
+	{
+		const size_t position = m_data.size();
+		m_data.resize(position + size);
+		if (size != 0)
+		{
+			memcpy(m_data.data() + position, bytes, size);
+		}
+	}
+
+	size_t GetPosition() const
+	{
+		return m_data.size();
+	}
+
+private:
+	std::vector<uint8_t>& m_data;
+};
+
+struct BinaryScene::SchemaClass
+{
+	uint32_t nameIndex = 0;
+	std::vector<uint32_t> fieldNameIndices;
+
+	// Index of each variable in the ReflectiveData of the class, found with the first object of the class
+	std::vector<size_t> fieldEntryIndices;
+};
+
+struct BinaryScene::WriteContext
+{
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, uint32_t> stringIndices;
+	std::vector<SchemaClass> classes;
+	std::unordered_map<std::string, uint32_t> classIndices;
+};
+
+struct BinaryScene::IdIndex
+{
+	uint64_t id = 0;
+	uint32_t index = 0;
+};
+
+struct BinaryScene::LoadContext
+{
+	struct DeferredReference
+	{
+		VariableReference variable;
+		uint64_t id = 0;
+	};
+
+	struct DeferredJsonValue
+	{
+		ReflectiveEntry entry;
+		ordered_json value;
+	};
+
+	std::vector<std::string> strings;
+	std::vector<SchemaClass> classes;
+	std::vector<IdIndex> gameObjectIds;
+	std::vector<IdIndex> componentIds;
+	std::vector<std::shared_ptr<GameObject>> gameObjects;
+	std::vector<std::shared_ptr<Component>> components; // MissingScript if the class of the component does not exist
+	std::vector<DeferredReference> references;
+	std::vector<DeferredJsonValue> jsonValues;
+};
+
+bool BinaryScene::IsBinaryScene(const unsigned char* data, size_t size)
+{
+	return data && size >= sizeof(MAGIC) && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+#pragma region Write
+
+uint32_t BinaryScene::AddString(WriteContext& context, const std::string& value)
+{
+	const auto it = context.stringIndices.find(value);
+	if (it != context.stringIndices.end())
+	{
+		return it->second;
+	}
+
+	const uint32_t index = static_cast<uint32_t>(context.strings.size());
+	context.strings.push_back(value);
+	context.stringIndices[value] = index;
+	return index;
+}
+
+uint32_t BinaryScene::AddClass(WriteContext& context, const std::string& name)
+{
+	const auto it = context.classIndices.find(name);
+	if (it != context.classIndices.end())
+	{
+		return it->second;
+	}
+
+	const uint32_t index = static_cast<uint32_t>(context.classes.size());
+	SchemaClass newClass;
+	newClass.nameIndex = AddString(context, name);
+	context.classes.push_back(newClass);
+	context.classIndices[name] = index;
+	return index;
+}
+
+void BinaryScene::AddClassFields(WriteContext& context, uint32_t classIndex, const ordered_json& objectJson)
+{
+	if (!objectJson.is_object() || !objectJson.contains("Values"))
+		return;
+
+	SchemaClass& schemaClass = context.classes[classIndex];
+	for (const auto& kv : objectJson["Values"].items())
+	{
+		const uint32_t nameIndex = AddString(context, kv.key());
+		if (std::find(schemaClass.fieldNameIndices.begin(), schemaClass.fieldNameIndices.end(), nameIndex) == schemaClass.fieldNameIndices.end())
+		{
+			schemaClass.fieldNameIndices.push_back(nameIndex);
+		}
+	}
+}
+
+void BinaryScene::WriteObjectValues(Writer& writer, WriteContext& context, uint32_t classIndex, const ordered_json& objectJson)
+{
+	const ordered_json* values = nullptr;
+	if (objectJson.is_object() && objectJson.contains("Values"))
+	{
+		values = &objectJson["Values"];
+	}
+
+	for (const uint32_t nameIndex : context.classes[classIndex].fieldNameIndices)
+	{
+		const std::string& name = context.strings[nameIndex];
+		if (values && values->contains(name))
+		{
+			WriteValue(writer, context, (*values)[name]);
+		}
+		else
+		{
+			writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::Missing));
+		}
+	}
+}
+
+void BinaryScene::WriteValue(Writer& writer, WriteContext& context, const ordered_json& value)
+{
+	switch (value.type())
+	{
+	case ordered_json::value_t::null:
+		writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::Null));
+		break;
+	case ordered_json::value_t::boolean:
+		writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::Bool));
+		writer.Write<uint8_t>(value.get<bool>() ? 1 : 0);
+		break;
+	case ordered_json::value_t::number_integer:
+		writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::Int));
+		writer.Write<int64_t>(value.get<int64_t>());
+		break;
+	case ordered_json::value_t::number_unsigned:
+		writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::UInt));
+		writer.Write<uint64_t>(value.get<uint64_t>());
+		break;
+	case ordered_json::value_t::number_float:
+		writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::Float));
+		writer.Write<double>(value.get<double>());
+		break;
+	case ordered_json::value_t::string:
+		writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::String));
+		writer.WriteString(value.get_ref<const std::string&>());
+		break;
+	default:
+		// A nested reflective is saved as {"Values": {...}}
+		if (value.is_object() && value.size() == 1 && value.contains("Values") && value["Values"].is_object())
+		{
+			const ordered_json& values = value["Values"];
+			writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::Reflective));
+			writer.Write<uint32_t>(static_cast<uint32_t>(values.size()));
+			for (const auto& kv : values.items())
+			{
+				writer.Write<uint32_t>(AddString(context, kv.key()));
+				WriteValue(writer, context, kv.value());
+			}
+		}
+		else
+		{
+			const std::vector<uint8_t> messagePack = ordered_json::to_msgpack(value);
+			writer.Write<uint8_t>(static_cast<uint8_t>(ValueType::Json));
+			writer.Write<uint32_t>(static_cast<uint32_t>(messagePack.size()));
+			writer.WriteBytes(messagePack.data(), messagePack.size());
+		}
+		break;
+	}
+}
+
+bool BinaryScene::JsonToBinary(const ordered_json& sceneJson, std::vector<uint8_t>& binaryData)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	binaryData.clear();
+
+	WriteContext context;
+	AddClass(context, "GameObject");
+	AddClass(context, "Transform");
+
+	std::vector<const ordered_json*> gameObjectsJson;
+	std::vector<uint64_t> gameObjectIds;
+	std::unordered_map<uint64_t, uint32_t> gameObjectIndices;
+
+	try
+	{
+		if (sceneJson.contains("GameObjects"))
+		{
+			for (const auto& gameObjectKV : sceneJson["GameObjects"].items())
+			{
+				const uint64_t id = std::stoull(gameObjectKV.key());
+				gameObjectIndices[id] = static_cast<uint32_t>(gameObjectsJson.size());
+				gameObjectIds.push_back(id);
+				gameObjectsJson.push_back(&gameObjectKV.value());
+			}
+		}
+		const uint32_t gameObjectCount = static_cast<uint32_t>(gameObjectsJson.size());
+
+		// Find the parent of each GameObject from the children lists
+		std::vector<uint32_t> parents(gameObjectCount, NO_PARENT);
+		std::vector<std::vector<uint32_t>> children(gameObjectCount);
+		for (uint32_t i = 0; i < gameObjectCount; i++)
+		{
+			const ordered_json& gameObjectJson = *gameObjectsJson[i];
+			if (!gameObjectJson.contains("Children"))
+				continue;
+
+			for (const auto& childKV : gameObjectJson["Children"].items())
+			{
+				const auto it = gameObjectIndices.find(childKV.value().get<uint64_t>());
+				if (it != gameObjectIndices.end() && parents[it->second] == NO_PARENT && it->second != i)
+				{
+					parents[it->second] = i;
+					children[i].push_back(it->second);
+				}
+			}
+		}
+
+		// Sort the GameObjects to have the parents before their children, the order of the roots and of the children is kept
+		std::vector<uint32_t> order;
+		order.reserve(gameObjectCount);
+		std::vector<bool> isVisited(gameObjectCount, false);
+		std::vector<uint32_t> stack;
+		for (uint32_t i = 0; i < gameObjectCount; i++)
+		{
+			if (parents[i] != NO_PARENT)
+				continue;
+
+			stack.push_back(i);
+			while (!stack.empty())
+			{
+				const uint32_t index = stack.back();
+				stack.pop_back();
+				if (isVisited[index])
+					continue;
+
+				isVisited[index] = true;
+				order.push_back(index);
+				for (auto it = children[index].rbegin(); it != children[index].rend(); ++it)
+				{
+					stack.push_back(*it);
+				}
+			}
+		}
+
+		// GameObjects in a parenting loop can't be placed, they are saved without parent
+		for (uint32_t i = 0; i < gameObjectCount; i++)
+		{
+			if (!isVisited[i])
+			{
+				parents[i] = NO_PARENT;
+				isVisited[i] = true;
+				order.push_back(i);
+			}
+		}
+
+		std::vector<uint32_t> newIndices(gameObjectCount);
+		for (uint32_t i = 0; i < gameObjectCount; i++)
+		{
+			newIndices[order[i]] = i;
+		}
+
+		// Build the classes with all the saved variables of their objects
+		for (const ordered_json* gameObjectJson : gameObjectsJson)
+		{
+			AddClassFields(context, GAMEOBJECT_CLASS_INDEX, *gameObjectJson);
+			if (gameObjectJson->contains("Transform"))
+			{
+				AddClassFields(context, TRANSFORM_CLASS_INDEX, (*gameObjectJson)["Transform"]);
+			}
+			if (gameObjectJson->contains("Components"))
+			{
+				for (const auto& componentKV : (*gameObjectJson)["Components"].items())
+				{
+					if (componentKV.value().contains("Type"))
+					{
+						const uint32_t classIndex = AddClass(context, componentKV.value()["Type"].get<std::string>());
+						AddClassFields(context, classIndex, componentKV.value());
+					}
+				}
+			}
+		}
+
+		// Write the GameObjects and their components
+		std::vector<uint8_t> body;
+		Writer bodyWriter(body);
+		std::vector<IdIndex> gameObjectIdTable(gameObjectCount);
+		std::vector<IdIndex> componentIdTable;
+		const ordered_json emptyJson;
+		for (uint32_t newIndex = 0; newIndex < gameObjectCount; newIndex++)
+		{
+			const uint32_t oldIndex = order[newIndex];
+			const ordered_json& gameObjectJson = *gameObjectsJson[oldIndex];
+
+			gameObjectIdTable[newIndex] = { gameObjectIds[oldIndex], newIndex };
+
+			std::vector<std::pair<uint64_t, const ordered_json*>> componentsJson;
+			if (gameObjectJson.contains("Components"))
+			{
+				for (const auto& componentKV : gameObjectJson["Components"].items())
+				{
+					if (componentKV.value().contains("Type"))
+					{
+						componentsJson.emplace_back(std::stoull(componentKV.key()), &componentKV.value());
+					}
+					else
+					{
+						Debug::PrintError("[BinaryScene::JsonToBinary] Component without type: " + componentKV.key(), true);
+					}
+				}
+			}
+
+			bodyWriter.Write<uint64_t>(gameObjectIds[oldIndex]);
+			bodyWriter.Write<uint32_t>(parents[oldIndex] == NO_PARENT ? NO_PARENT : newIndices[parents[oldIndex]]);
+			bodyWriter.Write<uint32_t>(static_cast<uint32_t>(componentsJson.size()));
+			WriteObjectValues(bodyWriter, context, GAMEOBJECT_CLASS_INDEX, gameObjectJson);
+			WriteObjectValues(bodyWriter, context, TRANSFORM_CLASS_INDEX, gameObjectJson.contains("Transform") ? gameObjectJson["Transform"] : emptyJson);
+
+			for (const auto& componentJson : componentsJson)
+			{
+				const ordered_json& componentValue = *componentJson.second;
+				const uint32_t classIndex = context.classIndices[componentValue["Type"].get<std::string>()];
+
+				componentIdTable.push_back({ componentJson.first, static_cast<uint32_t>(componentIdTable.size()) });
+
+				bodyWriter.Write<uint64_t>(componentJson.first);
+				bodyWriter.Write<uint32_t>(classIndex);
+				bodyWriter.Write<uint8_t>(componentValue.contains("Enabled") && !componentValue["Enabled"].get<bool>() ? 0 : 1);
+
+				// The size is used to skip the component if its class does not exist
+				const size_t sizePosition = bodyWriter.GetPosition();
+				bodyWriter.Write<uint32_t>(0);
+				WriteObjectValues(bodyWriter, context, classIndex, componentValue);
+				bodyWriter.WriteAt<uint32_t>(sizePosition, static_cast<uint32_t>(bodyWriter.GetPosition() - sizePosition - sizeof(uint32_t)));
+			}
+		}
+
+		WriteValue(bodyWriter, context, sceneJson.contains("Lighting") ? sceneJson["Lighting"] : emptyJson);
+
+		const auto compareIds = [](const IdIndex& a, const IdIndex& b)
+			{
+				return a.id < b.id;
+			};
+		std::sort(gameObjectIdTable.begin(), gameObjectIdTable.end(), compareIds);
+		std::sort(componentIdTable.begin(), componentIdTable.end(), compareIds);
+
+		// Write the header and the tables, then the body
+		Writer writer(binaryData);
+		writer.WriteBytes(MAGIC, sizeof(MAGIC));
+		writer.Write<uint32_t>(VERSION);
+		writer.Write<uint32_t>(static_cast<uint32_t>(context.strings.size()));
+		writer.Write<uint32_t>(static_cast<uint32_t>(context.classes.size()));
+		writer.Write<uint32_t>(gameObjectCount);
+		writer.Write<uint32_t>(static_cast<uint32_t>(componentIdTable.size()));
+
+		for (const std::string& string : context.strings)
+		{
+			writer.WriteString(string);
+		}
+
+		for (const SchemaClass& schemaClass : context.classes)
+		{
+			writer.Write<uint32_t>(schemaClass.nameIndex);
+			writer.Write<uint32_t>(static_cast<uint32_t>(schemaClass.fieldNameIndices.size()));
+			for (const uint32_t nameIndex : schemaClass.fieldNameIndices)
+			{
+				writer.Write<uint32_t>(nameIndex);
+			}
+		}
+
+		for (const IdIndex& idIndex : gameObjectIdTable)
+		{
+			writer.Write<uint64_t>(idIndex.id);
+			writer.Write<uint32_t>(idIndex.index);
+		}
+
+		for (const IdIndex& idIndex : componentIdTable)
+		{
+			writer.Write<uint64_t>(idIndex.id);
+			writer.Write<uint32_t>(idIndex.index);
+		}
+
+		writer.WriteBytes(body.data(), body.size());
+	}
+	catch (const std::exception& e)
+	{
+		Debug::PrintError("[BinaryScene::JsonToBinary] Scene json error: " + std::string(e.what()), true);
+		binaryData.clear();
+		return false;
+	}
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma region Load
+
+template<typename T>
+T BinaryScene::ReadNumber(Reader& reader, ValueType type)
+{
+	switch (type)
+	{
+	case ValueType::Bool:
+		return static_cast<T>(reader.Read<uint8_t>() != 0);
+	case ValueType::Int:
+		return static_cast<T>(reader.Read<int64_t>());
+	case ValueType::UInt:
+		return static_cast<T>(reader.Read<uint64_t>());
+	case ValueType::Float:
+		return static_cast<T>(reader.Read<double>());
+	default:
+		throw std::runtime_error("[BinaryScene] The value is not a number");
+	}
+}
+
+bool BinaryScene::IsNumber(ValueType type)
+{
+	return type == ValueType::Bool || type == ValueType::Int || type == ValueType::UInt || type == ValueType::Float;
+}
+
+template<typename T>
+void BinaryScene::ReadVariable(Reader& reader, LoadContext& context, ValueType type, const std::reference_wrapper<T> valuePtr, const ReflectiveEntry& entry)
+{
+	const bool isNumber = IsNumber(type);
+
+	// Write the common types directly in the variable
+	if constexpr (std::is_arithmetic<T>::value)
+	{
+		if (isNumber)
+		{
+			valuePtr.get() = ReadNumber<T>(reader, type);
+			return;
+		}
+	}
+	else if constexpr (std::is_same<T, std::string>::value)
+	{
+		if (type == ValueType::String)
+		{
+			reader.ReadString(valuePtr.get());
+			return;
+		}
+	}
+	else if constexpr (std::is_same<T, Reflective>::value)
+	{
+		if (type == ValueType::Reflective)
+		{
+			ReadNestedReflective(reader, context, valuePtr.get());
+			return;
+		}
+	}
+	else if constexpr (is_shared_ptr<T>::value) // File reference
+	{
+		if (isNumber || type == ValueType::Null)
+		{
+			const uint64_t fileId = isNumber ? ReadNumber<uint64_t>(reader, type) : 0;
+			ReflectionUtils::FillFileReference<typename T::element_type>(fileId, valuePtr, entry.typeId);
+			return;
+		}
+	}
+	else if constexpr (is_weak_ptr<T>::value) // GameObject, Transform, Component, Collider
+	{
+		if (isNumber || type == ValueType::Null)
+		{
+			// The referenced object may not be created yet
+			const uint64_t id = isNumber ? ReadNumber<uint64_t>(reader, type) : 0;
+			context.references.push_back({ VariableReference(valuePtr), id });
+			return;
+		}
+	}
+
+	// Lists, json variables and unexpected types use the json path
+	ordered_json jsonValue = ReadValueAsJson(reader, context, type);
+	if constexpr (is_vector<T>::value)
+	{
+		// The lists can contain references to objects not created yet
+		context.jsonValues.push_back({ entry, std::move(jsonValue) });
+	}
+	else
+	{
+		ReflectionUtils::JsonToVariable(jsonValue, valuePtr, entry);
+	}
+}
+
+void BinaryScene::ReadValue(Reader& reader, LoadContext& context, const ReflectiveEntry& entry)
+{
+	const ValueType type = static_cast<ValueType>(reader.Read<uint8_t>());
+	if (type == ValueType::Missing)
+		return;
+
+	std::visit([&reader, &context, type, &entry](const auto& valuePtr)
+		{
+			ReadVariable(reader, context, type, valuePtr, entry);
+		}, entry.variable.value());
+}
+
+void BinaryScene::ReadObjectValues(Reader& reader, LoadContext& context, SchemaClass& schemaClass, Reflective& reflective)
+{
+	const ReflectiveData dataList = reflective.GetReflectiveData();
+	const size_t dataCount = dataList.size();
+	const size_t fieldCount = schemaClass.fieldNameIndices.size();
+	for (size_t fieldIndex = 0; fieldIndex < fieldCount; fieldIndex++)
+	{
+		const std::string& name = context.strings[schemaClass.fieldNameIndices[fieldIndex]];
+
+		// The variables are in the same order for all objects of a class, so the search is done once
+		size_t& entryIndex = schemaClass.fieldEntryIndices[fieldIndex];
+		if (entryIndex >= dataCount || dataList[entryIndex].variableName != name)
+		{
+			entryIndex = SIZE_MAX;
+			for (size_t i = 0; i < dataCount; i++)
+			{
+				if (dataList[i].variableName == name)
+				{
+					entryIndex = i;
+					break;
+				}
+			}
+		}
+
+		if (entryIndex != SIZE_MAX)
+		{
+			ReadValue(reader, context, dataList[entryIndex]);
+		}
+		else
+		{
+			SkipValue(reader, static_cast<ValueType>(reader.Read<uint8_t>()));
+		}
+	}
+}
+
+void BinaryScene::ReadNestedReflective(Reader& reader, LoadContext& context, Reflective& reflective)
+{
+	const ReflectiveData dataList = reflective.GetReflectiveData();
+	const uint32_t fieldCount = reader.Read<uint32_t>();
+	for (uint32_t fieldIndex = 0; fieldIndex < fieldCount; fieldIndex++)
+	{
+		const uint32_t nameIndex = reader.Read<uint32_t>();
+		if (nameIndex >= context.strings.size())
+		{
+			throw std::runtime_error("[BinaryScene] Bad variable name index");
+		}
+
+		const std::string& name = context.strings[nameIndex];
+		const ReflectiveEntry* foundEntry = nullptr;
+		for (const ReflectiveEntry& entry : dataList)
+		{
+			if (entry.variableName == name)
+			{
+				foundEntry = &entry;
+				break;
+			}
+		}
+
+		if (foundEntry)
+		{
+			ReadValue(reader, context, *foundEntry);
+		}
+		else
+		{
+			SkipValue(reader, static_cast<ValueType>(reader.Read<uint8_t>()));
+		}
+	}
+	reflective.OnReflectionUpdated();
+}
+
+void BinaryScene::SkipValue(Reader& reader, ValueType type)
+{
+	switch (type)
+	{
+	case ValueType::Missing:
+	case ValueType::Null:
+		break;
+	case ValueType::Bool:
+		reader.Skip(sizeof(uint8_t));
+		break;
+	case ValueType::Int:
+	case ValueType::UInt:
+	case ValueType::Float:
+		reader.Skip(sizeof(uint64_t));
+		break;
+	case ValueType::String:
+	case ValueType::Json:
+		reader.Skip(reader.Read<uint32_t>());
+		break;
+	case ValueType::Reflective:
+	{
+		const uint32_t fieldCount = reader.Read<uint32_t>();
+		for (uint32_t i = 0; i < fieldCount; i++)
+		{
+			reader.Skip(sizeof(uint32_t));
+			SkipValue(reader, static_cast<ValueType>(reader.Read<uint8_t>()));
+		}
+		break;
+	}
+	default:
+		throw std::runtime_error("[BinaryScene] Unknown value type");
+	}
+}
+
+ordered_json BinaryScene::ReadValueAsJson(Reader& reader, const LoadContext& context, ValueType type)
+{
+	ordered_json value;
+	switch (type)
+	{
+	case ValueType::Missing:
+	case ValueType::Null:
+		break;
+	case ValueType::Bool:
+		value = reader.Read<uint8_t>() != 0;
+		break;
+	case ValueType::Int:
+		value = reader.Read<int64_t>();
+		break;
+	case ValueType::UInt:
+		value = reader.Read<uint64_t>();
+		break;
+	case ValueType::Float:
+		value = reader.Read<double>();
+		break;
+	case ValueType::String:
+	{
+		std::string stringValue;
+		reader.ReadString(stringValue);
+		value = std::move(stringValue);
+		break;
+	}
+	case ValueType::Reflective:
+	{
+		// Rebuild the json as saved by the editor
+		ordered_json& values = value["Values"];
+		values = ordered_json::object();
+		const uint32_t fieldCount = reader.Read<uint32_t>();
+		for (uint32_t i = 0; i < fieldCount; i++)
+		{
+			const uint32_t nameIndex = reader.Read<uint32_t>();
+			if (nameIndex >= context.strings.size())
+			{
+				throw std::runtime_error("[BinaryScene] Bad variable name index");
+			}
+			values[context.strings[nameIndex]] = ReadValueAsJson(reader, context, static_cast<ValueType>(reader.Read<uint8_t>()));
+		}
+		break;
+	}
+	case ValueType::Json:
+	{
+		const uint32_t size = reader.Read<uint32_t>();
+		const unsigned char* bytes = reader.ReadBytes(size);
+		value = ordered_json::from_msgpack(bytes, bytes + size);
+		break;
+	}
+	default:
+		throw std::runtime_error("[BinaryScene] Unknown value type");
+	}
+	return value;
+}
+
+ordered_json BinaryScene::ReadObjectValuesAsJson(Reader& reader, const LoadContext& context, const SchemaClass& schemaClass)
+{
+	ordered_json values = ordered_json::object();
+	for (const uint32_t nameIndex : schemaClass.fieldNameIndices)
+	{
+		const ValueType type = static_cast<ValueType>(reader.Read<uint8_t>());
+		if (type != ValueType::Missing)
+		{
+			values[context.strings[nameIndex]] = ReadValueAsJson(reader, context, type);
+		}
+	}
+	return values;
+}
+
+std::shared_ptr<GameObject> BinaryScene::FindGameObject(const LoadContext& context, uint64_t id)
+{
+	const auto it = std::lower_bound(context.gameObjectIds.begin(), context.gameObjectIds.end(), id, [](const IdIndex& idIndex, uint64_t value)
+		{
+			return idIndex.id < value;
+		});
+
+	if (it != context.gameObjectIds.end() && it->id == id)
+	{
+		return context.gameObjects[it->index];
+	}
+	return nullptr;
+}
+
+std::shared_ptr<Component> BinaryScene::FindComponent(const LoadContext& context, uint64_t id)
+{
+	const auto it = std::lower_bound(context.componentIds.begin(), context.componentIds.end(), id, [](const IdIndex& idIndex, uint64_t value)
+		{
+			return idIndex.id < value;
+		});
+
+	if (it != context.componentIds.end() && it->id == id)
+	{
+		return context.components[it->index];
+	}
+	return nullptr;
+}
+
+void BinaryScene::ResolveReferences(LoadContext& context)
+{
+	for (const LoadContext::DeferredReference& reference : context.references)
+	{
+		std::visit([&context, &reference](const auto& valuePtr)
+			{
+				using T = typename std::decay_t<decltype(valuePtr)>::type;
+				if constexpr (std::is_same<T, std::weak_ptr<GameObject>>::value)
+				{
+					valuePtr.get() = FindGameObject(context, reference.id);
+				}
+				else if constexpr (std::is_same<T, std::weak_ptr<Transform>>::value)
+				{
+					const std::shared_ptr<GameObject> gameObject = FindGameObject(context, reference.id);
+					if (gameObject)
+						valuePtr.get() = gameObject->GetTransform();
+					else
+						valuePtr.get().reset();
+				}
+				else if constexpr (std::is_same<T, std::weak_ptr<Component>>::value)
+				{
+					valuePtr.get() = FindComponent(context, reference.id);
+				}
+				else if constexpr (std::is_same<T, std::weak_ptr<Collider>>::value)
+				{
+					valuePtr.get() = std::dynamic_pointer_cast<Collider>(FindComponent(context, reference.id));
+				}
+			}, reference.variable);
+	}
+
+	for (const LoadContext::DeferredJsonValue& jsonValue : context.jsonValues)
+	{
+		const ordered_json& value = jsonValue.value;
+		const ReflectiveEntry& entry = jsonValue.entry;
+		std::visit([&value, &entry](const auto& valuePtr)
+			{
+				ReflectionUtils::JsonToVariable(value, valuePtr, entry);
+			}, entry.variable.value());
+	}
+}
+
+void BinaryScene::Load(const unsigned char* data, size_t size, std::vector<std::shared_ptr<Component>>& components, ordered_json& lightingData)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+	SCOPED_PROFILER("BinaryScene::Load", scopeBenchmark);
+
+	if (!IsBinaryScene(data, size))
+	{
+		throw std::runtime_error("[BinaryScene] Bad header");
+	}
+
+	Reader reader(data, size);
+	reader.Skip(sizeof(MAGIC));
+	if (reader.Read<uint32_t>() != VERSION)
+	{
+		throw std::runtime_error("[BinaryScene] Unsupported version");
+	}
+
+	const uint32_t stringCount = reader.Read<uint32_t>();
+	const uint32_t classCount = reader.Read<uint32_t>();
+	const uint32_t gameObjectCount = reader.Read<uint32_t>();
+	const uint32_t componentCount = reader.Read<uint32_t>();
+
+	// Check the counts before allocating anything
+	if (classCount < 2 || stringCount > size || classCount > size || gameObjectCount > size || componentCount > size)
+	{
+		throw std::runtime_error("[BinaryScene] Bad header");
+	}
+
+	LoadContext context;
+
+	context.strings.resize(stringCount);
+	for (std::string& string : context.strings)
+	{
+		reader.ReadString(string);
+	}
+
+	context.classes.resize(classCount);
+	for (SchemaClass& schemaClass : context.classes)
+	{
+		schemaClass.nameIndex = reader.Read<uint32_t>();
+		const uint32_t fieldCount = reader.Read<uint32_t>();
+		if (schemaClass.nameIndex >= stringCount || fieldCount > size)
+		{
+			throw std::runtime_error("[BinaryScene] Bad class");
+		}
+
+		schemaClass.fieldNameIndices.resize(fieldCount);
+		for (uint32_t& nameIndex : schemaClass.fieldNameIndices)
+		{
+			nameIndex = reader.Read<uint32_t>();
+			if (nameIndex >= stringCount)
+			{
+				throw std::runtime_error("[BinaryScene] Bad variable name index");
+			}
+		}
+		schemaClass.fieldEntryIndices.resize(fieldCount, SIZE_MAX);
+	}
+
+	context.gameObjectIds.resize(gameObjectCount);
+	for (IdIndex& idIndex : context.gameObjectIds)
+	{
+		idIndex.id = reader.Read<uint64_t>();
+		idIndex.index = reader.Read<uint32_t>();
+		if (idIndex.index >= gameObjectCount)
+		{
+			throw std::runtime_error("[BinaryScene] Bad GameObject index");
+		}
+	}
+
+	context.componentIds.resize(componentCount);
+	for (IdIndex& idIndex : context.componentIds)
+	{
+		idIndex.id = reader.Read<uint64_t>();
+		idIndex.index = reader.Read<uint32_t>();
+		if (idIndex.index >= componentCount)
+		{
+			throw std::runtime_error("[BinaryScene] Bad Component index");
+		}
+	}
+
+	context.gameObjects.reserve(gameObjectCount);
+	context.components.reserve(componentCount);
+	components.reserve(components.size() + componentCount);
+
+	// Create the GameObjects and the Components, the parents are always before their children
+	for (uint32_t gameObjectIndex = 0; gameObjectIndex < gameObjectCount; gameObjectIndex++)
+	{
+		const uint64_t id = reader.Read<uint64_t>();
+		const uint32_t parentIndex = reader.Read<uint32_t>();
+		const uint32_t gameObjectComponentCount = reader.Read<uint32_t>();
+
+		const std::shared_ptr<GameObject> newGameObject = CreateGameObject();
+		newGameObject->SetUniqueId(id);
+		context.gameObjects.push_back(newGameObject);
+
+		ReadObjectValues(reader, context, context.classes[GAMEOBJECT_CLASS_INDEX], *newGameObject);
+		newGameObject->OnReflectionUpdated();
+
+		if (parentIndex != NO_PARENT)
+		{
+			if (parentIndex >= gameObjectIndex)
+			{
+				throw std::runtime_error("[BinaryScene] Bad parent index");
+			}
+			newGameObject->SetParent(context.gameObjects[parentIndex]);
+		}
+
+		const std::shared_ptr<Transform> transform = newGameObject->GetTransform();
+		ReadObjectValues(reader, context, context.classes[TRANSFORM_CLASS_INDEX], *transform);
+		transform->OnReflectionUpdated();
+		transform->m_isTransformationMatrixDirty = true;
+		transform->UpdateLocalRotation();
+		transform->UpdateWorldValues();
+
+		for (uint32_t i = 0; i < gameObjectComponentCount; i++)
+		{
+			const uint64_t componentId = reader.Read<uint64_t>();
+			const uint32_t classIndex = reader.Read<uint32_t>();
+			const bool isEnabled = reader.Read<uint8_t>() != 0;
+			const uint32_t payloadSize = reader.Read<uint32_t>();
+			if (classIndex >= classCount || context.components.size() >= componentCount)
+			{
+				throw std::runtime_error("[BinaryScene] Bad component");
+			}
+
+			SchemaClass& schemaClass = context.classes[classIndex];
+			const std::string& componentName = context.strings[schemaClass.nameIndex];
+			std::shared_ptr<Component> component = ClassRegistry::AddComponentFromName(componentName, *newGameObject);
+			if (component)
+			{
+				component->SetIsEnabled(isEnabled);
+				ReadObjectValues(reader, context, schemaClass, *component);
+			}
+			else
+			{
+				// Like the json loading, keep the data of the component in a missing script to avoid data loss
+				Debug::PrintError("[BinaryScene::Load] Component class not found: " + componentName, true);
+				const size_t payloadEnd = reader.GetPosition() + payloadSize;
+				const std::shared_ptr<MissingScript> missingScript = std::make_shared<MissingScript>();
+				missingScript->data["Type"] = componentName;
+				missingScript->data["Values"] = ReadObjectValuesAsJson(reader, context, schemaClass);
+				missingScript->data["Enabled"] = isEnabled;
+				if (reader.GetPosition() != payloadEnd)
+				{
+					throw std::runtime_error("[BinaryScene] Bad component size");
+				}
+				newGameObject->AddExistingComponent(missingScript);
+				component = missingScript;
+			}
+			component->SetUniqueId(componentId);
+			context.components.push_back(component);
+			components.push_back(component);
+		}
+	}
+
+	if (context.components.size() != componentCount)
+	{
+		throw std::runtime_error("[BinaryScene] Bad component count");
+	}
+
+	lightingData = ReadValueAsJson(reader, context, static_cast<ValueType>(reader.Read<uint8_t>()));
+
+	ResolveReferences(context);
+
+	// Called once all references are set, like the json loading
+	for (const std::shared_ptr<Component>& component : context.components)
+	{
+		if (component)
+		{
+			component->OnReflectionUpdated();
+		}
+	}
+}
+
+#pragma endregion
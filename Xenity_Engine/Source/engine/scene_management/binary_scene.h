@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <json.hpp>
+
+#include <engine/reflection/reflection.h>
+
+class Component;
+class GameObject;
+
+/**
+* @brief Cooked scene format, the editor keeps the json format and the cooker converts it to this format
+*
+* Layout (little endian, swapped on big endian platforms):
+* - Header: magic, version, string count, class count, GameObject count, Component count
+* - String table: class names and variable names
+* - Class table: for each class, the name and the list of saved variables (GameObject and Transform are the two first classes)
+* - Id tables: GameObject and Component ids sorted with their index, used to resolve the references
+* - GameObjects: id, parent index, component count, GameObject and Transform values, then the components (id, class, enabled state, values)
+* - Lighting settings
+*
+* The GameObjects are sorted to have the parents before their children, so the scene is loaded in a single pass
+*/
+class BinaryScene
+{
+public:
+	/**
+	* @brief Check if the data starts with the header of a binary scene
+	*/
+	static bool IsBinaryScene(const unsigned char* data, size_t size);
+
+	/**
+	* @brief Convert a json scene (as saved by the editor) to a binary scene
+	* @param sceneJson Json data of the scene
+	* @param binaryData Filled with the binary scene
+	* @return True if the scene has been converted
+	*/
+	static bool JsonToBinary(const nlohmann::ordered_json& sceneJson, std::vector<uint8_t>& binaryData);
+
+	/**
+	* @brief [Internal] Create all GameObjects and Components of a binary scene, throws an exception if the data is corrupted
+	* @param data Binary scene data
+	* @param size Size of the data
+	* @param components Filled with the created components
+	* @param lightingData Filled with the lighting settings
+	*/
+	static void Load(const unsigned char* data, size_t size, std::vector<std::shared_ptr<Component>>& components, nlohmann::ordered_json& lightingData);
+
+private:
+	static constexpr char MAGIC[4] = { 'X', 'S', 'C', 'B' };
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t NO_PARENT = UINT32_MAX;
+	static constexpr uint32_t GAMEOBJECT_CLASS_INDEX = 0;
+	static constexpr uint32_t TRANSFORM_CLASS_INDEX = 1;
+
+	/**
+	* @brief Type of a saved value, written before each value
+	*/
+	enum class ValueType : uint8_t
+	{
+		Missing, // The variable was not saved for this object
+		Null,
+		Bool,
+		Int,
+		UInt,
+		Float,
+		String,
+		Reflective, // Nested reflective (Vector3, Color...), list of name index and value
+		Json, // MessagePack data, used for the lists and the json variables
+	};
+
+	class Reader;
+	class Writer;
+	struct WriteContext;
+	struct LoadContext;
+	struct SchemaClass;
+	struct IdIndex;
+
+	static uint32_t AddString(WriteContext& context, const std::string& value);
+	static uint32_t AddClass(WriteContext& context, const std::string& name);
+
+	/**
+	* @brief Add the saved variables of an object to the variables of its class
+	*/
+	static void AddClassFields(WriteContext& context, uint32_t classIndex, const nlohmann::ordered_json& objectJson);
+
+	/**
+	* @brief Write the values of an object in the order of its class variables
+	*/
+	static void WriteObjectValues(Writer& writer, WriteContext& context, uint32_t classIndex, const nlohmann::ordered_json& objectJson);
+	static void WriteValue(Writer& writer, WriteContext& context, const nlohmann::ordered_json& value);
+
+	/**
+	* @brief Fill a reflective with the values of an object, the variables are matched only once per class
+	*/
+	static void ReadObjectValues(Reader& reader, LoadContext& context, SchemaClass& schemaClass, Reflective& reflective);
+	static void ReadNestedReflective(Reader& reader, LoadContext& context, Reflective& reflective);
+	static void ReadValue(Reader& reader, LoadContext& context, const ReflectiveEntry& entry);
+
+	template<typename T>
+	static void ReadVariable(Reader& reader, LoadContext& context, ValueType type, const std::reference_wrapper<T> valuePtr, const ReflectiveEntry& entry);
+
+	template<typename T>
+	static T ReadNumber(Reader& reader, ValueType type);
+
+	static bool IsNumber(ValueType type);
+	static void SkipValue(Reader& reader, ValueType type);
+
+	/**
+	* @brief Read a value in the json format used by the editor
+	*/
+	static nlohmann::ordered_json ReadValueAsJson(Reader& reader, const LoadContext& context, ValueType type);
+
+	/**
+	* @brief Read the values of an object in the json format used by the editor ("Values" of a component)
+	*/
+	static nlohmann::ordered_json ReadObjectValuesAsJson(Reader& reader, const LoadContext& context, const SchemaClass& schemaClass);
+
+	/**
+	* @brief Set the GameObject/Component references once all objects are created
+	*/
+	static void ResolveReferences(LoadContext& context);
+
+	static std::shared_ptr<GameObject> FindGameObject(const LoadContext& context, uint64_t id);
+	static std::shared_ptr<Component> FindComponent(const LoadContext& context, uint64_t id);
+};
@@ -6,6 +6,8 @@
 
 #include "scene_manager.h"
 
+#include <algorithm>
+
 #if defined(EDITOR)
 #include <editor/ui/editor_ui.h>
 #include <editor/file_reference_finder.h>
@@ -13,6 +15,7 @@
 
 #include <engine/file_system/file_system.h>
 #include <engine/file_system/file.h>
+#include <engine/file_system/async_file_loading.h>
 #include <engine/class_registry/class_registry.h>
 #include <engine/reflection/reflection_utils.h>
 #include <engine/asset_management/project_manager.h>
@@ -26,6 +29,7 @@
 #include <engine/debug/debug.h>
 #include <engine/missing_script.h>
 #include "scene.h"
+#include "binary_scene.h"
 #include <engine/world_partitionner/world_partitionner.h>
 #include <engine/debug/stack_debug_object.h>
 
@@ -237,17 +241,7 @@ void SceneManager::LoadScene(const ordered_json& jsonData)
 {
 	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
 
-	// Automaticaly start the game if built in engine mode
-#if !defined(EDITOR)
-	GameplayManager::SetGameState(GameState::Starting, true);
-#else
-	if (GameplayManager::GetGameState() == GameState::Playing)
-	{
-		GameplayManager::SetGameState(GameState::Starting, true);
-	}
-#endif
-
-	ClearScene();
+	StartSceneLoading();
 
 	std::vector<std::shared_ptr<Component>> allComponents;
 
@@ -346,77 +340,94 @@ void SceneManager::LoadScene(const ordered_json& jsonData)
 				// If the gameobject has components
 				if (kv.value().contains("Components"))
 				{
-					const int componentCount = go->GetComponentCount();
 					// Find the component with the Id
 					for (const auto& kv2 : kv.value()["Components"].items())
 					{
-						for (int compI = 0; compI < componentCount; compI++)
+						const std::shared_ptr<Component> component = FindComponentById(std::stoull(kv2.key()));
+						if (component && component->GetGameObjectRaw() == go.get())
 						{
-							const std::shared_ptr<Component>& component = go->m_components[compI];
-							if (component->GetUniqueId() == std::stoull(kv2.key()))
-							{
-								// Fill values
-								ReflectionUtils::JsonToReflective(kv2.value(), *component.get());
-								break;
-							}
+							// Fill values
+							ReflectionUtils::JsonToReflective(kv2.value(), *component.get());
 						}
 					}
 				}
 			}
 		}
+	}
 
-		// Call Awake on Components
-		if (GameplayManager::GetGameState() == GameState::Starting)
-		{
-			std::vector<std::shared_ptr<Component>> orderedComponentsToInit;
-			const size_t componentsCount = allComponents.size();
-			int componentsToInitCount = 0;
+	FinishSceneLoading(allComponents, jsonData.contains("Lighting") ? jsonData["Lighting"] : ordered_json());
+}
+
+void SceneManager::LoadScene(const unsigned char* data, size_t size)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	StartSceneLoading();
+
+	std::vector<std::shared_ptr<Component>> allComponents;
+	ordered_json lightingData;
+	BinaryScene::Load(data, size, allComponents, lightingData);
+
+	FinishSceneLoading(allComponents, lightingData);
+}
+
+void SceneManager::StartSceneLoading()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	// Automaticaly start the game if built in engine mode
+#if !defined(EDITOR)
+	GameplayManager::SetGameState(GameState::Starting, true);
+#else
+	if (GameplayManager::GetGameState() == GameState::Playing)
+	{
+		GameplayManager::SetGameState(GameState::Starting, true);
+	}
+#endif
 
-			// Find uninitiated components and order them
-			for (size_t i = 0; i < componentsCount; i++)
+	ClearScene();
+
+	// The progress only counts the assets loaded by the new scene (and the ones still loading)
+	AsyncFileLoading::ResetProgress();
+}
+
+void SceneManager::FinishSceneLoading(const std::vector<std::shared_ptr<Component>>& allComponents, const ordered_json& lightingData)
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	// Call Awake on Components
+	if (GameplayManager::GetGameState() == GameState::Starting)
+	{
+		// Order the uninitiated components by priority, the components with the same priority are called in the reverse order of creation
+		std::vector<std::shared_ptr<Component>> orderedComponentsToInit;
+		orderedComponentsToInit.reserve(allComponents.size());
+		for (auto it = allComponents.rbegin(); it != allComponents.rend(); ++it)
+		{
+			if (*it && !(*it)->m_initiated)
 			{
-				if (auto& componentToCheck = allComponents[i])
-				{
-					if (!componentToCheck->m_initiated)
-					{
-						bool placeFound = false;
-						for (size_t componentToInitIndex = 0; componentToInitIndex < componentsToInitCount; componentToInitIndex++)
-						{
-							// Check if the checked has a higher priority (lower value) than the component in the list
-							if (componentToCheck->m_updatePriority <= orderedComponentsToInit[componentToInitIndex]->m_updatePriority)
-							{
-								orderedComponentsToInit.insert(orderedComponentsToInit.begin() + componentToInitIndex, componentToCheck);
-								placeFound = true;
-								break;
-							}
-						}
-						// if the priority is lower than all components's priorities in the list, add it the end of the list
-						if (!placeFound)
-						{
-							orderedComponentsToInit.push_back(componentToCheck);
-						}
-						componentsToInitCount++;
-					}
-				}
+				orderedComponentsToInit.push_back(*it);
 			}
+		}
+		std::stable_sort(orderedComponentsToInit.begin(), orderedComponentsToInit.end(), [](const std::shared_ptr<Component>& a, const std::shared_ptr<Component>& b)
+			{
+				return a->m_updatePriority < b->m_updatePriority;
+			});
 
-			// Call components Awake() function
-			for (int i = 0; i < componentsToInitCount; i++)
+		// Call components Awake() function
+		for (const std::shared_ptr<Component>& componentToInit : orderedComponentsToInit)
+		{
+			if (!componentToInit->m_isAwakeCalled && componentToInit->GetGameObject()->IsLocalActive() && componentToInit->IsEnabled())
 			{
-				const std::shared_ptr<Component>& componentToInit = orderedComponentsToInit[i];
-				if (!componentToInit->m_isAwakeCalled && componentToInit->GetGameObject()->IsLocalActive() && componentToInit->IsEnabled())
-				{
-					componentToInit->Awake();
-					componentToInit->m_isAwakeCalled = true;
-				}
+				componentToInit->Awake();
+				componentToInit->m_isAwakeCalled = true;
 			}
 		}
 	}
 
 	// Load lighting values
-	if (jsonData.contains("Lighting"))
+	if (!lightingData.is_null())
 	{
-		ReflectionUtils::JsonToReflectiveData(jsonData["Lighting"], Graphics::s_settings.GetReflectiveData());
+		ReflectionUtils::JsonToReflectiveData(lightingData, Graphics::s_settings.GetReflectiveData());
 		Graphics::OnLightingSettingsReflectionUpdate();
 	}
 
@@ -448,25 +459,41 @@ void SceneManager::LoadScene(const std::shared_ptr<Scene>& scene)
 #endif
 	if (openResult)
 	{
-		std::string jsonString;
+		std::string sceneData;
+		const unsigned char* mappedData = nullptr;
 #if defined(EDITOR)
-		jsonString = scene->m_file->ReadAll();
+		sceneData = scene->m_file->ReadAll();
 		scene->m_file->Close();
 #else
-		unsigned char* binData = ProjectManager::fileDataBase.GetBitFile().ReadBinary(scene->m_filePosition, scene->m_fileSize);
-		jsonString = std::string(reinterpret_cast<const char*>(binData), scene->m_fileSize);
-		free(binData);
+		// Read the scene without copy if the binary file is memory mapped
+		mappedData = ProjectManager::fileDataBase.GetBitFile().GetReadOnlyView(scene->m_filePosition, scene->m_fileSize);
+		if (!mappedData)
+		{
+			unsigned char* binData = ProjectManager::fileDataBase.GetBitFile().ReadBinary(scene->m_filePosition, scene->m_fileSize);
+			sceneData = std::string(reinterpret_cast<const char*>(binData), scene->m_fileSize);
+			free(binData);
+		}
 #endif
-		XASSERT(!jsonString.empty(), "[SceneManager::LoadScene] jsonString is empty");
+		const unsigned char* data = mappedData ? mappedData : reinterpret_cast<const unsigned char*>(sceneData.data());
+		const size_t dataSize = mappedData ? static_cast<size_t>(scene->m_fileSize) : sceneData.size();
+		XASSERT(dataSize != 0, "[SceneManager::LoadScene] Scene data is empty");
 
 		try
 		{
-			ordered_json data;
-			if (!jsonString.empty())
+			// The cooked scenes use the binary format
+			if (BinaryScene::IsBinaryScene(data, dataSize))
+			{
+				LoadScene(data, dataSize);
+			}
+			else
 			{
-				data = ordered_json::parse(jsonString);
+				ordered_json jsonData;
+				if (dataSize != 0)
+				{
+					jsonData = ordered_json::parse(data, data + dataSize);
+				}
+				LoadScene(jsonData);
 			}
-			LoadScene(data);
 			s_openedScene = scene;
 			SetSceneModified(false);
 		}
@@ -501,18 +528,24 @@ void SceneManager::ClearScene()
 	}
 
 	PhysicsManager::Clear();
-	GameplayManager::orderedComponents.clear();
-	GameplayManager::gameObjectsToDestroy.clear();
-	GameplayManager::componentsToDestroy.clear();
-	GameplayManager::gameObjects.clear();
-	GameplayManager::componentsCount = 0;
-	GameplayManager::gameObjectCount = 0;
+	GameplayManager::ClearComponents();
+	GameplayManager::ClearGameObjects();
 #if defined(EDITOR)
 	Editor::SetSelectedGameObject(nullptr);
 #endif
 	Window::UpdateWindowTitle();
 }
 
+float SceneManager::GetLoadingProgress()
+{
+	return AsyncFileLoading::GetProgress();
+}
+
+bool SceneManager::IsLoadingAssets()
+{
+	return AsyncFileLoading::IsLoading();
+}
+
 void SceneManager::CreateEmptyScene()
 {
 	s_openedScene.reset();
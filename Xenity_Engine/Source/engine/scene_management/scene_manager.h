@@ -7,6 +7,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <json.hpp>
 
 #include <engine/api.h>
@@ -34,6 +35,17 @@ public:
 	*/
 	API static void LoadScene(const std::shared_ptr<Scene>& scene);
 
+	/**
+	* @brief Get the loading progress of the assets of the opened scene, between 0 and 1
+	* The assets are streamed after LoadScene, a loading screen can be displayed until the progress reaches 1
+	*/
+	API static float GetLoadingProgress();
+
+	/**
+	* @brief Get if the assets of the opened scene are still loading
+	*/
+	API static bool IsLoadingAssets();
+
 #if defined(EDITOR)
 	/**
 	* @brief [Internal] Save scene
@@ -101,11 +113,28 @@ public:
 
 private:
 
+	friend class SceneLoadBenchmarkTest;
+
 	/**
 	* @brief [Internal] Load scene from json data
 	*/
 	static void LoadScene(const nlohmann::ordered_json& jsonData);
 
+	/**
+	* @brief [Internal] Load scene from binary data (cooked scene), throws an exception if the data is corrupted
+	*/
+	static void LoadScene(const unsigned char* data, size_t size);
+
+	/**
+	* @brief [Internal] Set the game state and clear the current scene before loading a scene
+	*/
+	static void StartSceneLoading();
+
+	/**
+	* @brief [Internal] Call Awake on the loaded components and apply the lighting settings
+	*/
+	static void FinishSceneLoading(const std::vector<std::shared_ptr<Component>>& allComponents, const nlohmann::ordered_json& lightingData);
+
 	static std::shared_ptr<Scene> s_openedScene;
 	static bool s_sceneModified;
 	static constexpr int s_sceneVersion = 1;
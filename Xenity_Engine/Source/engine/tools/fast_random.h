@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <cstdint>
+
+/**
+* @brief Small xorshift random generator, cheaper than rand() and the std generators
+* Not suitable for security, each instance has its own state and can be used by one thread
+*/
+class FastRandom
+{
+public:
+	inline FastRandom()
+	{
+		SetSeed(0);
+	}
+
+	inline explicit FastRandom(uint32_t seed)
+	{
+		SetSeed(seed);
+	}
+
+	/**
+	* @brief Reset the state of the generator, two generators with the same seed give the same numbers
+	*/
+	inline void SetSeed(uint32_t seed)
+	{
+		// Mix the seed to get different sequences for close seeds, the state must not be 0
+		seed ^= seed >> 16;
+		seed *= 0x7feb352d;
+		seed ^= seed >> 15;
+		seed *= 0x846ca68b;
+		seed ^= seed >> 16;
+		m_state = seed != 0 ? seed : 0x9e3779b9;
+	}
+
+	/**
+	* @brief Get a random integer
+	*/
+	inline uint32_t Next()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+		return m_state;
+	}
+
+	/**
+	* @brief Get a random float in [0, 1[
+	*/
+	inline float NextFloat()
+	{
+		// 24 bits to fit in the mantissa
+		return (Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	/**
+	* @brief Get a random float in [min, max[
+	*/
+	inline float Range(float min, float max)
+	{
+		return min + (max - min) * NextFloat();
+	}
+
+private:
+	uint32_t m_state;
+};
@@ -15,7 +15,7 @@
 #include <engine/reflection/reflection_utils.h>
 #include <engine/accessors/acc_gameobject.h>
 
-using json = nlohmann::json;
+#include <unordered_map>
 
 struct ComponentAndId
 {
@@ -65,14 +65,7 @@ void DuplicateChild(const std::shared_ptr<GameObject>& parent, const std::shared
 		const std::shared_ptr<Component> componentToDuplicate = goToDuplicateComponents[i];
 		const std::shared_ptr<Component> newComponent = ClassRegistry::AddComponentFromName(componentToDuplicate->GetComponentName(), *newGameObject);
 		newComponent->SetIsEnabled(componentToDuplicate->IsEnabled());
-		const ReflectiveData newReflection = newComponent->GetReflectiveData();
-		const ReflectiveData reflectionToCopy = componentToDuplicate->GetReflectiveData();
-
-		json copiedValues;
-		copiedValues["Values"] = ReflectionUtils::ReflectiveDataToJson(reflectionToCopy);
-
-		ReflectionUtils::JsonToReflectiveData(copiedValues, newReflection);
-		newComponent->OnReflectionUpdated();
+		ReflectionUtils::ReflectiveToReflective(*componentToDuplicate, *newComponent);
 
 		ComponentAndId newComponentAndId;
 		newComponentAndId.newComponent = newComponent;
@@ -93,6 +86,36 @@ void DuplicateChild(const std::shared_ptr<GameObject>& parent, const std::shared
 	}
 }
 
+void ReplaceDuplicatedComponent(std::weak_ptr<Component>& reference, const std::unordered_map<uint64_t, std::shared_ptr<Component>>& newComponentsByOldId)
+{
+	if (const std::shared_ptr<Component> component = reference.lock())
+	{
+		const auto it = newComponentsByOldId.find(component->GetUniqueId());
+		if (it != newComponentsByOldId.end())
+			reference = it->second;
+	}
+}
+
+void ReplaceDuplicatedGameObject(std::weak_ptr<GameObject>& reference, const std::unordered_map<uint64_t, std::shared_ptr<GameObject>>& newGameObjectsByOldId)
+{
+	if (const std::shared_ptr<GameObject> gameObject = reference.lock())
+	{
+		const auto it = newGameObjectsByOldId.find(gameObject->GetUniqueId());
+		if (it != newGameObjectsByOldId.end())
+			reference = it->second;
+	}
+}
+
+void ReplaceDuplicatedTransform(std::weak_ptr<Transform>& reference, const std::unordered_map<uint64_t, std::shared_ptr<GameObject>>& newGameObjectsByOldId)
+{
+	if (const std::shared_ptr<Transform> transform = reference.lock())
+	{
+		const auto it = newGameObjectsByOldId.find(transform->GetGameObject()->GetUniqueId());
+		if (it != newGameObjectsByOldId.end())
+			reference = it->second->GetTransform();
+	}
+}
+
 std::shared_ptr<GameObject> Instantiate(const std::shared_ptr<GameObject>& goToDuplicate)
 {
 	XASSERT(goToDuplicate != nullptr, "[GamePlayUtility::Instantiate] goToDuplicate is nullptr");
@@ -104,94 +127,58 @@ std::shared_ptr<GameObject> Instantiate(const std::shared_ptr<GameObject>& goToD
 	std::vector<GameObjectAndId> GameObjectsAndIds;
 	DuplicateChild(nullptr, goToDuplicate, ComponentsAndIds, GameObjectsAndIds);
 
+	// Old id -> new object, to replace the references in O(1)
+	std::unordered_map<uint64_t, std::shared_ptr<Component>> newComponentsByOldId;
+	std::unordered_map<uint64_t, std::shared_ptr<GameObject>> newGameObjectsByOldId;
+	newComponentsByOldId.reserve(ComponentsAndIds.size());
+	newGameObjectsByOldId.reserve(GameObjectsAndIds.size());
+	for (const ComponentAndId& componentAndId : ComponentsAndIds)
+	{
+		newComponentsByOldId[componentAndId.oldId] = componentAndId.newComponent;
+	}
+	for (const GameObjectAndId& gameObjectAndId : GameObjectsAndIds)
+	{
+		newGameObjectsByOldId[gameObjectAndId.oldId] = gameObjectAndId.newGameObject;
+	}
+
 	// If a component store in a variable a component/gameobject/transform from the duplicated gameobject, replace the reference by the component/gameobject/transform of the new gameobject
-	const size_t componentCount = ComponentsAndIds.size();
-	const size_t gameObjectCount = GameObjectsAndIds.size();
-	for (size_t componentIndex = 0; componentIndex < componentCount; componentIndex++)
+	for (const ComponentAndId& componentAndId : ComponentsAndIds)
 	{
-		const ReflectiveData newReflection = ComponentsAndIds[componentIndex].newComponent->GetReflectiveData();
+		const ReflectiveData newReflection = componentAndId.newComponent->GetReflectiveData();
 		for (const ReflectiveEntry& reflectiveEntry : newReflection)
 		{
 			const VariableReference& variableRef = reflectiveEntry.variable.value();
 			if (auto valuePtr = std::get_if<std::reference_wrapper<std::weak_ptr<Component>>>(&variableRef))
 			{
-				if (valuePtr->get().lock())
-				{
-					for (size_t j = 0; j < componentCount; j++)
-					{
-						if (valuePtr->get().lock()->GetUniqueId() == ComponentsAndIds[j].oldId)
-						{
-							valuePtr->get() = ComponentsAndIds[j].newComponent;
-						}
-					}
-				}
+				ReplaceDuplicatedComponent(valuePtr->get(), newComponentsByOldId);
 			}
 			else if (auto valuePtr = std::get_if<std::reference_wrapper<std::weak_ptr<GameObject>>>(&variableRef))
 			{
-				if (valuePtr->get().lock())
-				{
-					for (size_t j = 0; j < gameObjectCount; j++)
-					{
-						if (valuePtr->get().lock()->GetUniqueId() == GameObjectsAndIds[j].oldId)
-						{
-							valuePtr->get() = GameObjectsAndIds[j].newGameObject;
-						}
-					}
-				}
+				ReplaceDuplicatedGameObject(valuePtr->get(), newGameObjectsByOldId);
 			}
 			else if (auto valuePtr = std::get_if<std::reference_wrapper<std::weak_ptr<Transform>>>(&variableRef))
 			{
-				if (valuePtr->get().lock())
-				{
-					for (size_t j = 0; j < gameObjectCount; j++)
-					{
-						if (valuePtr->get().lock()->GetGameObject()->GetUniqueId() == GameObjectsAndIds[j].oldId)
-						{
-							valuePtr->get() = GameObjectsAndIds[j].newGameObject->GetTransform();
-						}
-					}
-				}
+				ReplaceDuplicatedTransform(valuePtr->get(), newGameObjectsByOldId);
 			}
 			else if (auto valuePtr = std::get_if<std::reference_wrapper<std::vector<std::weak_ptr<Component>>>>(&variableRef))
 			{
-				const size_t vectorSize = valuePtr->get().size();
-				for (size_t vectorIndex = 0; vectorIndex < vectorSize; vectorIndex++)
+				for (std::weak_ptr<Component>& component : valuePtr->get())
 				{
-					for (size_t j = 0; j < componentCount; j++)
-					{
-						if (valuePtr->get()[vectorIndex].lock()->GetUniqueId() == ComponentsAndIds[j].oldId)
-						{
-							valuePtr->get()[vectorIndex] = ComponentsAndIds[j].newComponent;
-						}
-					}
+					ReplaceDuplicatedComponent(component, newComponentsByOldId);
 				}
 			}
 			else if (auto valuePtr = std::get_if<std::reference_wrapper<std::vector<std::weak_ptr<GameObject>>>>(&variableRef))
 			{
-				const size_t vectorSize = valuePtr->get().size();
-				for (size_t vectorIndex = 0; vectorIndex < vectorSize; vectorIndex++)
+				for (std::weak_ptr<GameObject>& gameObject : valuePtr->get())
 				{
-					for (size_t j = 0; j < gameObjectCount; j++)
-					{
-						if (valuePtr->get()[vectorIndex].lock()->GetUniqueId() == GameObjectsAndIds[j].oldId)
-						{
-							valuePtr->get()[vectorIndex] = GameObjectsAndIds[j].newGameObject;
-						}
-					}
+					ReplaceDuplicatedGameObject(gameObject, newGameObjectsByOldId);
 				}
 			}
 			else if (auto valuePtr = std::get_if<std::reference_wrapper<std::vector<std::weak_ptr<Transform>>>>(&variableRef))
 			{
-				const size_t vectorSize = valuePtr->get().size();
-				for (size_t vectorIndex = 0; vectorIndex < vectorSize; vectorIndex++)
+				for (std::weak_ptr<Transform>& transform : valuePtr->get())
 				{
-					for (size_t j = 0; j < gameObjectCount; j++)
-					{
-						if (valuePtr->get()[vectorIndex].lock()->GetGameObject()->GetUniqueId() == GameObjectsAndIds[j].oldId)
-						{
-							valuePtr->get()[vectorIndex] = GameObjectsAndIds[j].newGameObject->GetTransform();
-						}
-					}
+					ReplaceDuplicatedTransform(transform, newGameObjectsByOldId);
 				}
 			}
 		}
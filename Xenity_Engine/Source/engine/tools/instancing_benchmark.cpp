@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "instancing_benchmark.h"
+
+#include <engine/tools/shape_spawner.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/transform.h>
+#include <engine/graphics/graphics.h>
+#include <engine/time/time.h>
+#include <engine/debug/debug.h>
+#include <engine/debug/performance.h>
+#include <engine/debug/stack_debug_object.h>
+
+InstancingBenchmark::InstancingBenchmark()
+{
+}
+
+ReflectiveData InstancingBenchmark::GetReflectiveData()
+{
+	ReflectiveData reflectedVariables;
+	Reflective::AddVariable(reflectedVariables, gridSize, "gridSize", true);
+	Reflective::AddVariable(reflectedVariables, spacing, "spacing", true);
+	Reflective::AddVariable(reflectedVariables, framesPerMode, "framesPerMode", true);
+	return reflectedVariables;
+}
+
+void InstancingBenchmark::Start()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	const std::shared_ptr<GameObject> gameObject = GetGameObject();
+	const Vector3 center = GetTransformRaw()->GetPosition();
+	const float halfSize = (gridSize - 1) * spacing / 2.0f;
+	for (int x = 0; x < gridSize; x++)
+	{
+		for (int z = 0; z < gridSize; z++)
+		{
+			const std::shared_ptr<GameObject> cube = ShapeSpawner::SpawnCube();
+			cube->GetTransform()->SetPosition(center + Vector3(x * spacing - halfSize, 0, z * spacing - halfSize));
+			cube->SetParent(gameObject);
+		}
+	}
+
+	// Start without instancing to get the reference values
+	m_wasInstancingEnabled = Graphics::IsInstancingEnabled();
+	Graphics::SetIsInstancingEnabled(false);
+	m_isInstancingPass = false;
+	m_isFinished = false;
+	m_frameCount = 0;
+	m_totalFrameTime = 0;
+	m_totalDrawCallCount = 0;
+
+	Debug::Print("[InstancingBenchmark] Rendering " + std::to_string(gridSize * gridSize) + " cubes for " + std::to_string(framesPerMode) + " frames per mode");
+}
+
+void InstancingBenchmark::Update()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (m_isFinished)
+		return;
+
+	// Skip the first frame of a mode, it still uses the previous mode
+	m_frameCount++;
+	if (m_frameCount == 1)
+		return;
+
+	m_totalFrameTime += Time::GetUnscaledDeltaTime();
+	m_totalDrawCallCount += Performance::GetDrawCallCount();
+
+	if (m_frameCount > framesPerMode)
+	{
+		PrintResults();
+		if (!m_isInstancingPass)
+		{
+			m_isInstancingPass = true;
+			m_frameCount = 0;
+			m_totalFrameTime = 0;
+			m_totalDrawCallCount = 0;
+			Graphics::SetIsInstancingEnabled(true);
+		}
+		else
+		{
+			m_isFinished = true;
+			Graphics::SetIsInstancingEnabled(m_wasInstancingEnabled);
+		}
+	}
+}
+
+void InstancingBenchmark::PrintResults() const
+{
+	const int measuredFrameCount = m_frameCount - 1;
+	const float averageFrameTime = m_totalFrameTime / measuredFrameCount * 1000.0f;
+	const int averageDrawCallCount = m_totalDrawCallCount / measuredFrameCount;
+
+	Debug::Print(std::string("[InstancingBenchmark] Instancing ") + (m_isInstancingPass ? "on" : "off") +
+		": " + std::to_string(averageFrameTime) + " ms per frame, " + std::to_string(averageDrawCallCount) + " draw calls per frame");
+}
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <engine/api.h>
+#include <engine/component.h>
+
+/**
+* @brief Component that spawns a grid of cubes sharing the same mesh and material and compares the rendering with and without instancing
+* The draw call count is only available in the editor (counted for the scene view)
+*/
+class API InstancingBenchmark : public Component
+{
+public:
+	InstancingBenchmark();
+
+	ReflectiveData GetReflectiveData() override;
+	void Start() override;
+	void Update() override;
+
+	int gridSize = 32;
+	float spacing = 2;
+	int framesPerMode = 300;
+
+private:
+	/**
+	* @brief Print the results of the current mode
+	*/
+	void PrintResults() const;
+
+	int m_frameCount = 0;
+	float m_totalFrameTime = 0;
+	int m_totalDrawCallCount = 0;
+	bool m_isInstancingPass = false;
+	bool m_isFinished = false;
+	bool m_wasInstancingEnabled = true;
+};
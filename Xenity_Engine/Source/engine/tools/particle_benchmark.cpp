@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "particle_benchmark.h"
+
+#include <algorithm>
+
+#include <engine/particle_system/particle_system.h>
+#include <engine/particle_system/particle_manager.h>
+#include <engine/job_system/job_system.h>
+#include <engine/tools/benchmark.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/debug/debug.h>
+#include <engine/debug/stack_debug_object.h>
+
+ParticleBenchmark::ParticleBenchmark()
+{
+}
+
+ReflectiveData ParticleBenchmark::GetReflectiveData()
+{
+	ReflectiveData reflectedVariables;
+	Reflective::AddVariable(reflectedVariables, particleSystemCount, "particleSystemCount", true);
+	Reflective::AddVariable(reflectedVariables, particlesPerSystem, "particlesPerSystem", true);
+	Reflective::AddVariable(reflectedVariables, framesToMeasure, "framesToMeasure", true);
+	return reflectedVariables;
+}
+
+void ParticleBenchmark::Start()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	const std::shared_ptr<GameObject> gameObject = GetGameObject();
+	m_particleSystems.clear();
+	m_updatedParticleSystems.clear();
+	for (int i = 0; i < particleSystemCount; i++)
+	{
+		const std::shared_ptr<GameObject> particleGameObject = CreateGameObject("Particles " + std::to_string(i));
+		particleGameObject->SetParent(gameObject);
+		const std::shared_ptr<ParticleSystem> particleSystem = particleGameObject->AddComponent<ParticleSystem>();
+
+		// Keep the systems full: the spawn rate replaces the dead particles
+		particleSystem->m_maxParticles = static_cast<float>(particlesPerSystem);
+		particleSystem->m_spawnRate = static_cast<float>(particlesPerSystem);
+		particleSystem->m_lifeTimeMin = 1;
+		particleSystem->m_lifeTimeMax = 3;
+		particleSystem->OnReflectionUpdated();
+		particleSystem->Play();
+
+		// Disabled to be only updated by the benchmark
+		particleSystem->SetIsEnabled(false);
+
+		m_updatedParticleSystems.push_back(particleSystem.get());
+		m_particleSystems.push_back(particleSystem);
+	}
+
+	m_frameCount = 0;
+	m_totalSingleMicroSeconds = 0;
+	m_totalParallelMicroSeconds = 0;
+	m_totalSingleParticleCount = 0;
+	m_totalParallelParticleCount = 0;
+
+	Debug::Print("[ParticleBenchmark] Updating " + std::to_string(particleSystemCount) + " particle systems of " + std::to_string(particlesPerSystem) + " particles for " + std::to_string(framesToMeasure) + " frames");
+}
+
+void ParticleBenchmark::Update()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (m_frameCount >= framesToMeasure)
+		return;
+
+	m_frameCount++;
+
+	// Same delta time for each update to compare the same amount of work
+	constexpr float deltaTime = 1 / 60.0f;
+
+	const auto countParticles = [this]()
+		{
+			uint64_t particleCount = 0;
+			for (const ParticleSystem* particleSystem : m_updatedParticleSystems)
+			{
+				particleCount += particleSystem->m_aliveParticleCount;
+			}
+			return particleCount;
+		};
+
+	Benchmark benchmark;
+
+	// Main thread only
+	m_totalSingleParticleCount += countParticles();
+	benchmark.Start();
+	ParticleManager::UpdateParticleSystems(m_updatedParticleSystems.data(), m_updatedParticleSystems.size(), deltaTime, false);
+	benchmark.Stop();
+	m_totalSingleMicroSeconds += benchmark.GetMicroSeconds();
+
+	// Worker threads
+	m_totalParallelParticleCount += countParticles();
+	benchmark.Reset();
+	benchmark.Start();
+	ParticleManager::UpdateParticleSystems(m_updatedParticleSystems.data(), m_updatedParticleSystems.size(), deltaTime, true);
+	benchmark.Stop();
+	m_totalParallelMicroSeconds += benchmark.GetMicroSeconds();
+
+	if (m_frameCount == framesToMeasure)
+	{
+		// Particles per millisecond, the time is in microseconds
+		const uint64_t singleParticlesPerMs = m_totalSingleParticleCount * 1000 / std::max<uint64_t>(m_totalSingleMicroSeconds, 1);
+		const uint64_t parallelParticlesPerMs = m_totalParallelParticleCount * 1000 / std::max<uint64_t>(m_totalParallelMicroSeconds, 1);
+		Debug::Print("[ParticleBenchmark] Main thread: " + std::to_string(m_totalSingleMicroSeconds / framesToMeasure) + " us per frame, " + std::to_string(singleParticlesPerMs) + " particles/ms");
+		Debug::Print("[ParticleBenchmark] Worker threads (" + std::to_string(JobSystem::GetWorkerCount()) + " workers): " + std::to_string(m_totalParallelMicroSeconds / framesToMeasure) + " us per frame, " + std::to_string(parallelParticlesPerMs) + " particles/ms");
+	}
+}
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <engine/api.h>
+#include <engine/component.h>
+
+class ParticleSystem;
+
+/**
+* @brief Component that simulates a lot of particle systems to compare the single threaded update with the worker threads update
+*/
+class API ParticleBenchmark : public Component
+{
+public:
+	ParticleBenchmark();
+
+	ReflectiveData GetReflectiveData() override;
+	void Start() override;
+	void Update() override;
+
+	int particleSystemCount = 100;
+	int particlesPerSystem = 5000;
+	int framesToMeasure = 100;
+
+private:
+	std::vector<std::shared_ptr<ParticleSystem>> m_particleSystems;
+	std::vector<ParticleSystem*> m_updatedParticleSystems;
+
+	int m_frameCount = 0;
+	uint64_t m_totalSingleMicroSeconds = 0;
+	uint64_t m_totalParallelMicroSeconds = 0;
+	uint64_t m_totalSingleParticleCount = 0;
+	uint64_t m_totalParallelParticleCount = 0;
+};
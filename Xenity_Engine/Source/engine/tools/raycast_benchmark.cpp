@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "raycast_benchmark.h"
+
+#include <random>
+
+#include <engine/tools/shape_spawner.h>
+#include <engine/tools/benchmark.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/transform.h>
+#include <engine/physics/box_collider.h>
+#include <engine/debug/debug.h>
+#include <engine/debug/stack_debug_object.h>
+
+RaycastBenchmark::RaycastBenchmark()
+{
+}
+
+ReflectiveData RaycastBenchmark::GetReflectiveData()
+{
+	ReflectiveData reflectedVariables;
+	Reflective::AddVariable(reflectedVariables, rayCount, "rayCount", true);
+	Reflective::AddVariable(reflectedVariables, levelSize, "levelSize", true);
+	Reflective::AddVariable(reflectedVariables, spacing, "spacing", true);
+	Reflective::AddVariable(reflectedVariables, rayLength, "rayLength", true);
+	Reflective::AddVariable(reflectedVariables, framesToMeasure, "framesToMeasure", true);
+	return reflectedVariables;
+}
+
+void RaycastBenchmark::Start()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	// Fixed seed to compare the results between runs
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<float> heightDistribution(1, 6);
+
+	// Static level: a grid of boxes with random heights
+	const std::shared_ptr<GameObject> gameObject = GetGameObject();
+	const Vector3 center = GetTransformRaw()->GetPosition();
+	const float halfSize = (levelSize - 1) * spacing / 2.0f;
+	for (int x = 0; x < levelSize; x++)
+	{
+		for (int z = 0; z < levelSize; z++)
+		{
+			const std::shared_ptr<GameObject> cube = ShapeSpawner::SpawnCube();
+			const float height = heightDistribution(generator);
+			cube->GetTransform()->SetPosition(center + Vector3(x * spacing - halfSize, height / 2.0f, z * spacing - halfSize));
+			cube->GetTransform()->SetLocalScale(Vector3(1, height, 1));
+			cube->AddComponent<BoxCollider>();
+			cube->SetParent(gameObject);
+		}
+	}
+
+	// Rays from above the level going down in random directions
+	std::uniform_real_distribution<float> positionDistribution(-halfSize, halfSize);
+	std::uniform_real_distribution<float> directionDistribution(-0.5f, 0.5f);
+	m_rays.resize(rayCount);
+	for (Ray& ray : m_rays)
+	{
+		ray.origin = center + Vector3(positionDistribution(generator), 10, positionDistribution(generator));
+		ray.direction = Vector3(directionDistribution(generator), -1, directionDistribution(generator)).Normalized();
+		ray.maxDistance = rayLength;
+	}
+	m_hits.resize(rayCount);
+	m_hitCounts.resize(rayCount);
+
+	m_frameCount = 0;
+	m_totalSingleMicroSeconds = 0;
+	m_totalBatchMicroSeconds = 0;
+	m_totalParallelBatchMicroSeconds = 0;
+
+	Debug::Print("[RaycastBenchmark] Casting " + std::to_string(rayCount) + " rays against " + std::to_string(levelSize * levelSize) + " boxes for " + std::to_string(framesToMeasure) + " frames");
+}
+
+void RaycastBenchmark::Update()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (m_frameCount >= framesToMeasure)
+		return;
+
+	// Skip the first frame, the colliders are created during it
+	m_frameCount++;
+	if (m_frameCount == 1)
+		return;
+
+	Benchmark benchmark;
+
+	// One Raycast::Check per ray
+	m_singleHitCount = 0;
+	benchmark.Start();
+	RaycastHit raycastHit;
+	for (const Ray& ray : m_rays)
+	{
+		if (Raycast::Check(ray.origin, ray.direction, ray.maxDistance, raycastHit))
+			m_singleHitCount++;
+	}
+	benchmark.Stop();
+	m_totalSingleMicroSeconds += benchmark.GetMicroSeconds();
+
+	// Batch on the main thread
+	RaycastQuerySettings settings;
+	settings.useWorkerThreads = false;
+	benchmark.Reset();
+	benchmark.Start();
+	Raycast::CheckBatch(m_rays.data(), m_rays.size(), settings, m_hits.data(), m_hitCounts.data());
+	benchmark.Stop();
+	m_totalBatchMicroSeconds += benchmark.GetMicroSeconds();
+
+	// Batch on the worker threads
+	settings.useWorkerThreads = true;
+	benchmark.Reset();
+	benchmark.Start();
+	Raycast::CheckBatch(m_rays.data(), m_rays.size(), settings, m_hits.data(), m_hitCounts.data());
+	benchmark.Stop();
+	m_totalParallelBatchMicroSeconds += benchmark.GetMicroSeconds();
+
+	m_batchHitCount = 0;
+	for (const uint32_t hitCount : m_hitCounts)
+	{
+		m_batchHitCount += hitCount;
+	}
+
+	if (m_frameCount == framesToMeasure)
+	{
+		const int measuredFrameCount = m_frameCount - 1;
+		Debug::Print("[RaycastBenchmark] Raycast::Check: " + std::to_string(m_totalSingleMicroSeconds / measuredFrameCount) + " us per frame, " + std::to_string(m_singleHitCount) + " hits");
+		Debug::Print("[RaycastBenchmark] CheckBatch: " + std::to_string(m_totalBatchMicroSeconds / measuredFrameCount) + " us per frame, " + std::to_string(m_batchHitCount) + " hits");
+		Debug::Print("[RaycastBenchmark] CheckBatch (worker threads): " + std::to_string(m_totalParallelBatchMicroSeconds / measuredFrameCount) + " us per frame");
+	}
+}
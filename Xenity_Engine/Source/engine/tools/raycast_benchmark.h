@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <vector>
+
+#include <engine/api.h>
+#include <engine/component.h>
+#include <engine/physics/raycast.h>
+
+/**
+* @brief Component that casts a lot of rays against a static level to compare Raycast::Check with the batched raycasts
+*/
+class API RaycastBenchmark : public Component
+{
+public:
+	RaycastBenchmark();
+
+	ReflectiveData GetReflectiveData() override;
+	void Start() override;
+	void Update() override;
+
+	int rayCount = 10000;
+	int levelSize = 40;
+	float spacing = 3;
+	float rayLength = 100;
+	int framesToMeasure = 100;
+
+private:
+	std::vector<Ray> m_rays;
+	std::vector<RaycastHitData> m_hits;
+	std::vector<uint32_t> m_hitCounts;
+
+	int m_frameCount = 0;
+	uint64_t m_totalSingleMicroSeconds = 0;
+	uint64_t m_totalBatchMicroSeconds = 0;
+	uint64_t m_totalParallelBatchMicroSeconds = 0;
+	size_t m_singleHitCount = 0;
+	size_t m_batchHitCount = 0;
+};
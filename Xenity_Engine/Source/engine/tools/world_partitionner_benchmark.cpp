@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "world_partitionner_benchmark.h"
+
+#include <random>
+#include <cmath>
+
+#include <engine/tools/shape_spawner.h>
+#include <engine/tools/benchmark.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/transform.h>
+#include <engine/lighting/lighting.h>
+#include <engine/graphics/color/color.h>
+#include <engine/time/time.h>
+#include <engine/debug/debug.h>
+#include <engine/debug/stack_debug_object.h>
+
+WorldPartitionnerBenchmark::WorldPartitionnerBenchmark()
+{
+}
+
+ReflectiveData WorldPartitionnerBenchmark::GetReflectiveData()
+{
+	ReflectiveData reflectedVariables;
+	Reflective::AddVariable(reflectedVariables, meshCount, "meshCount", true);
+	Reflective::AddVariable(reflectedVariables, lightCount, "lightCount", true);
+	Reflective::AddVariable(reflectedVariables, areaSize, "areaSize", true);
+	Reflective::AddVariable(reflectedVariables, moveRadius, "moveRadius", true);
+	Reflective::AddVariable(reflectedVariables, framesToMeasure, "framesToMeasure", true);
+	return reflectedVariables;
+}
+
+void WorldPartitionnerBenchmark::Start()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	// Fixed seed to compare the results between runs
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<float> distribution(-areaSize / 2.0f, areaSize / 2.0f);
+
+	const std::shared_ptr<GameObject> gameObject = GetGameObject();
+	const Vector3 center = GetTransformRaw()->GetPosition();
+
+	m_meshTransforms.reserve(meshCount);
+	m_meshStartPositions.reserve(meshCount);
+	for (int i = 0; i < meshCount; i++)
+	{
+		const std::shared_ptr<GameObject> cube = ShapeSpawner::SpawnCube();
+		const Vector3 position = center + Vector3(distribution(generator), distribution(generator) / 10.0f, distribution(generator));
+		cube->GetTransform()->SetPosition(position);
+		cube->SetParent(gameObject);
+		m_meshTransforms.push_back(cube->GetTransform());
+		m_meshStartPositions.push_back(position);
+	}
+
+	m_lightTransforms.reserve(lightCount);
+	m_lightStartPositions.reserve(lightCount);
+	for (int i = 0; i < lightCount; i++)
+	{
+		const std::shared_ptr<GameObject> lightGameObject = CreateGameObject("Benchmark Light");
+		const Vector3 position = center + Vector3(distribution(generator), 2, distribution(generator));
+		lightGameObject->GetTransform()->SetPosition(position);
+		lightGameObject->SetParent(gameObject);
+		lightGameObject->AddComponent<Light>()->SetupPointLight(Color::CreateFromRGBAFloat(1, 1, 1, 1), 1, 10);
+		m_lightTransforms.push_back(lightGameObject->GetTransform());
+		m_lightStartPositions.push_back(position);
+	}
+
+	m_frameCount = 0;
+	m_totalMeshMicroSeconds = 0;
+	m_totalLightMicroSeconds = 0;
+
+	Debug::Print("[WorldPartitionnerBenchmark] Moving " + std::to_string(meshCount) + " meshes and " + std::to_string(lightCount) + " point lights for " + std::to_string(framesToMeasure) + " frames");
+}
+
+void WorldPartitionnerBenchmark::Update()
+{
+	STACK_DEBUG_OBJECT(STACK_HIGH_PRIORITY);
+
+	if (m_frameCount >= framesToMeasure)
+		return;
+
+	const float time = Time::GetTime();
+	Benchmark benchmark;
+
+	// Each position change updates the world partitionner
+	benchmark.Start();
+	MoveObjects(m_meshTransforms, m_meshStartPositions, time);
+	benchmark.Stop();
+	m_totalMeshMicroSeconds += benchmark.GetMicroSeconds();
+
+	benchmark.Start();
+	MoveObjects(m_lightTransforms, m_lightStartPositions, time);
+	benchmark.Stop();
+	m_totalLightMicroSeconds += benchmark.GetMicroSeconds();
+
+	m_frameCount++;
+	if (m_frameCount == framesToMeasure)
+	{
+		const float averageMeshTime = m_totalMeshMicroSeconds / static_cast<float>(m_frameCount) / 1000.0f;
+		const float averageLightTime = m_totalLightMicroSeconds / static_cast<float>(m_frameCount) / 1000.0f;
+		Debug::Print("[WorldPartitionnerBenchmark] Meshes: " + std::to_string(averageMeshTime) + " ms per frame, lights: " + std::to_string(averageLightTime) + " ms per frame");
+	}
+}
+
+void WorldPartitionnerBenchmark::MoveObjects(std::vector<std::weak_ptr<Transform>>& transforms, const std::vector<Vector3>& startPositions, float time)
+{
+	const size_t count = transforms.size();
+	for (size_t i = 0; i < count; i++)
+	{
+		const std::shared_ptr<Transform> transform = transforms[i].lock();
+		if (!transform)
+			continue;
+
+		const float angle = time + i;
+		transform->SetPosition(startPositions[i] + Vector3(std::cos(angle) * moveRadius, 0, std::sin(angle) * moveRadius));
+	}
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <engine/api.h>
+#include <engine/component.h>
+#include <engine/vectors/vector3.h>
+
+class Transform;
+
+/**
+* @brief Component that moves a lot of meshes and point lights every frame to measure the cost of the world partitionner updates
+*/
+class API WorldPartitionnerBenchmark : public Component
+{
+public:
+	WorldPartitionnerBenchmark();
+
+	ReflectiveData GetReflectiveData() override;
+	void Start() override;
+	void Update() override;
+
+	int meshCount = 10000;
+	int lightCount = 200;
+	float areaSize = 300;
+	float moveRadius = 8;
+	int framesToMeasure = 300;
+
+private:
+	/**
+	* @brief Move the objects on a circle around their start position
+	*/
+	void MoveObjects(std::vector<std::weak_ptr<Transform>>& transforms, const std::vector<Vector3>& startPositions, float time);
+
+	std::vector<std::weak_ptr<Transform>> m_meshTransforms;
+	std::vector<Vector3> m_meshStartPositions;
+	std::vector<std::weak_ptr<Transform>> m_lightTransforms;
+	std::vector<Vector3> m_lightStartPositions;
+
+	int m_frameCount = 0;
+	uint64_t m_totalMeshMicroSeconds = 0;
+	uint64_t m_totalLightMicroSeconds = 0;
+};
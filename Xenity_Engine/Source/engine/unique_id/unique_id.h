@@ -30,6 +30,8 @@ public:
 	UniqueId(const UniqueId& other) = delete;
 	UniqueId& operator=(const UniqueId&) = delete;
 
+	virtual ~UniqueId() = default;
+
 	/**
 	* @brief Get unique Id
 	*/
@@ -38,9 +40,19 @@ public:
 		return m_uniqueId;
 	}
 
+protected:
+	/**
+	* @brief [Internal] Called when the id is changed with SetUniqueId (used to update the id indices)
+	* @param oldId Previous id
+	*/
+	virtual void OnUniqueIdChanged([[maybe_unused]] uint64_t oldId)
+	{
+	}
+
 private:
 	friend class ProjectManager;
 	friend class SceneManager;
+	friend class BinaryScene;
 	friend class Compiler;
 	friend class InspectorCreateGameObjectCommand;
 	friend class InspectorDeleteGameObjectCommand;
@@ -49,6 +61,7 @@ private:
 	template<typename T>
 	friend class InspectorDeleteComponentCommand;
 	friend class UniqueIdTest;
+	friend class GameplayManagerIdIndexTest;
 	template <class T>
 	friend class SelectAssetMenu;
 
@@ -71,7 +84,10 @@ private:
 	*/
 	inline void SetUniqueId(uint64_t id)
 	{
+		const uint64_t oldId = m_uniqueId;
 		m_uniqueId = id;
+		if (oldId != id)
+			OnUniqueIdChanged(oldId);
 	}
 
 	uint64_t m_uniqueId;
@@ -4,6 +4,8 @@
 #include <editor/gizmo.h>
 #endif
 
+#include <algorithm>
+
 #include <engine/asset_management/asset_manager.h>
 #include <engine/vectors/vector3.h>
 #include <engine/lighting/lighting.h>
@@ -19,114 +21,259 @@
 #include <engine/debug/performance.h>
 #include <engine/debug/stack_debug_object.h>
 #include <engine/constants.h>
+#include <engine/graphics/camera.h>
+#include <engine/tools/scope_benchmark.h>
 
-std::map<int, WorldPartitionner::XNode> WorldPartitionner::Tree::children;
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define USE_SSE_FRUSTUM_CULLING
+#include <xmmintrin.h>
+#endif
 
-struct Vector3Fast
+std::vector<WorldPartitionner::ChunkSlot> WorldPartitionner::s_chunkSlots;
+uint32_t WorldPartitionner::s_chunkSlotShift = 64;
+std::vector<WorldPartitionner::Chunk> WorldPartitionner::s_chunks;
+std::vector<uint32_t> WorldPartitionner::s_freeChunkIndices;
+std::vector<uint32_t> WorldPartitionner::s_meshChunkIndices;
+std::vector<uint32_t> WorldPartitionner::s_newChunkIndices;
+std::vector<uint32_t> WorldPartitionner::s_leftChunkIndices;
+uint32_t WorldPartitionner::s_frustumCullingPassId = 0;
+std::vector<uint8_t> WorldPartitionner::s_sphereVisibilities;
+
+// Check if a chunk intersects a sphere
+static bool ChunkIntersectsSphere(int chunkX, int chunkY, int chunkZ, const Vector3& sphereCenter, float sphereRadius)
 {
-	Vector3Fast(float x, float y, float z) 
+	const float chunkMin[3] = { static_cast<float>(chunkX * WORLD_CHUNK_SIZE), static_cast<float>(chunkY * WORLD_CHUNK_SIZE), static_cast<float>(chunkZ * WORLD_CHUNK_SIZE) };
+	const float sphereCoords[3] = { sphereCenter.x, sphereCenter.y, sphereCenter.z };
+
+	// Squared distance between the sphere center and the chunk
+	float dmin = 0.0f;
+	for (int i = 0; i < 3; ++i)
 	{
-		this->x = x;
-		this->y = y;
-		this->z = z;
+		const float chunkMax = chunkMin[i] + WORLD_CHUNK_SIZE;
+		if (sphereCoords[i] < chunkMin[i])
+		{
+			const float delta = sphereCoords[i] - chunkMin[i];
+			dmin += delta * delta;
+		}
+		else if (sphereCoords[i] > chunkMax)
+		{
+			const float delta = sphereCoords[i] - chunkMax;
+			dmin += delta * delta;
+		}
 	}
-	float x, y, z;
-};
 
-// Fonction pour v�rifier si un cube intersecte une sph�re
-bool cubeIntersectsSphere(const Vector3Fast& cubeMin, int cubeSize, const Vector3Fast& sphereCenter, float sphereRadius)
+	return dmin <= sphereRadius * sphereRadius;
+}
+
+// Remove an element from an unordered list
+template<typename T>
+static bool RemoveUnordered(std::vector<T>& list, const T& value)
 {
-	// STACK_DEBUG_OBJECT(STACK_LOW_PRIORITY);
+	auto it = std::find(list.begin(), list.end(), value);
+	if (it == list.end())
+		return false;
 
-	float dmin = 0.0f;
+	*it = list.back();
+	list.pop_back();
+	return true;
+}
 
-	// Calcul de la distance minimale au cube
-	for (int i = 0; i < 3; ++i)
+void WorldPartitionner::ClearWorld()
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	// Mesh renderers and lights can be destroyed after the world is cleared, forget their chunks now
+	for (Chunk& chunk : s_chunks)
 	{
-		float cubeMaxCoord = (&cubeMin.x)[i] + cubeSize;
-		float sphereCoord = (&sphereCenter.x)[i];
-		if (sphereCoord < (&cubeMin.x)[i])
+		for (MeshRenderer* meshRenderer : chunk.meshes)
 		{
-			dmin += static_cast<float>(std::pow(sphereCoord - (&cubeMin.x)[i], 2));
+			meshRenderer->m_worldChunkIndices.clear();
+			meshRenderer->m_affectedByLights.clear();
 		}
-		else if (sphereCoord > cubeMaxCoord)
+		for (Light* light : chunk.lights)
 		{
-			dmin += static_cast<float>(std::pow(sphereCoord - cubeMaxCoord, 2));
+			light->m_worldChunkIndices.clear();
 		}
 	}
 
-	// Si la distance est inf�rieure au rayon de la sph�re, il y a intersection
-	return dmin <= sphereRadius * sphereRadius;
+	s_chunks.clear();
+	s_freeChunkIndices.clear();
+	s_meshChunkIndices.clear();
+	s_chunkSlots.clear();
+	s_chunkSlotShift = 64;
 }
 
-// Fonction pour obtenir la liste des cubes travers�s par la sph�re
-void getCubesIntersectedBySphere(std::vector<Vector3Fast>& intersectedCubes, const Vector3Fast& pos, float r, int cubeSize) 
+uint64_t WorldPartitionner::MakeChunkKey(int x, int y, int z)
 {
-	STACK_DEBUG_OBJECT(STACK_LOW_PRIORITY);
+	constexpr uint64_t mask = (1 << 21) - 1;
+	constexpr int offset = 1 << 20;
+	return ((static_cast<uint64_t>(x + offset) & mask) << 42) | ((static_cast<uint64_t>(y + offset) & mask) << 21) | (static_cast<uint64_t>(z + offset) & mask);
+}
+
+size_t WorldPartitionner::GetFirstChunkSlotIndex(uint64_t key)
+{
+	return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> s_chunkSlotShift);
+}
 
-	// D�termination des limites de la grille � v�rifier
-	const Vector3Fast minCube = Vector3Fast(
-		std::floor((pos.x - r) / cubeSize) * cubeSize,
-		std::floor((pos.y - r) / cubeSize) * cubeSize,
-		std::floor((pos.z - r) / cubeSize) * cubeSize
-	);
-
-	const Vector3Fast maxCube = Vector3Fast(
-		std::floor((pos.x + r) / cubeSize) * cubeSize,
-		std::floor((pos.y + r) / cubeSize) * cubeSize,
-		std::floor((pos.z + r) / cubeSize) * cubeSize
-	);
-
-	// Parcours de tous les cubes potentiellement concern�s
-	for (float x = minCube.x; x <= maxCube.x; x += cubeSize)
+uint32_t WorldPartitionner::FindOrCreateChunk(int x, int y, int z)
+{
+	// Keep the load factor under 0.5 to have short probe sequences
+	const size_t usedChunkCount = s_chunks.size() - s_freeChunkIndices.size();
+	if ((usedChunkCount + 1) * 2 > s_chunkSlots.size())
+	{
+		GrowChunkSlots();
+	}
+
+	const uint64_t key = MakeChunkKey(x, y, z);
+	const size_t slotMask = s_chunkSlots.size() - 1;
+	size_t slotIndex = GetFirstChunkSlotIndex(key);
+	while (true)
 	{
-		for (float y = minCube.y; y <= maxCube.y; y += cubeSize)
+		ChunkSlot& slot = s_chunkSlots[slotIndex];
+		if (slot.key == key)
+		{
+			return slot.chunkIndex;
+		}
+
+		if (slot.key == EMPTY_CHUNK_KEY)
 		{
-			for (float z = minCube.z; z <= maxCube.z; z += cubeSize)
+			slot.key = key;
+
+			// Reuse an empty chunk, its lists keep their capacity
+			if (!s_freeChunkIndices.empty())
 			{
-				const Vector3Fast cubeMin = Vector3Fast(x, y, z);
-				if (cubeIntersectsSphere(cubeMin, cubeSize, pos, r))
-				{
-					intersectedCubes.push_back(cubeMin);
-				}
+				slot.chunkIndex = s_freeChunkIndices.back();
+				s_freeChunkIndices.pop_back();
 			}
+			else
+			{
+				slot.chunkIndex = static_cast<uint32_t>(s_chunks.size());
+				s_chunks.emplace_back();
+			}
+
+			Chunk& newChunk = s_chunks[slot.chunkIndex];
+			newChunk.x = x;
+			newChunk.y = y;
+			newChunk.z = z;
+			newChunk.isFree = false;
+			return slot.chunkIndex;
 		}
+
+		slotIndex = (slotIndex + 1) & slotMask;
 	}
 }
 
-void WorldPartitionner::ClearWorld()
+void WorldPartitionner::GrowChunkSlots()
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	Tree::children.clear();
+	const size_t newSlotCount = s_chunkSlots.empty() ? 256 : s_chunkSlots.size() * 2;
+	s_chunkSlotShift = 64;
+	for (size_t size = newSlotCount; size > 1; size >>= 1)
+	{
+		s_chunkSlotShift--;
+	}
+
+	s_chunkSlots.assign(newSlotCount, ChunkSlot());
+	const size_t slotMask = newSlotCount - 1;
+	const size_t chunkCount = s_chunks.size();
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		const Chunk& chunk = s_chunks[i];
+		if (chunk.isFree)
+			continue;
+
+		const uint64_t key = MakeChunkKey(chunk.x, chunk.y, chunk.z);
+		size_t slotIndex = GetFirstChunkSlotIndex(key);
+		while (s_chunkSlots[slotIndex].key != EMPTY_CHUNK_KEY)
+		{
+			slotIndex = (slotIndex + 1) & slotMask;
+		}
+		s_chunkSlots[slotIndex].key = key;
+		s_chunkSlots[slotIndex].chunkIndex = static_cast<uint32_t>(i);
+	}
 }
 
-void WorldPartitionner::RemoveMeshRenderer(MeshRenderer* meshRenderer)
+void WorldPartitionner::ReleaseChunkIfEmpty(uint32_t chunkIndex)
 {
-	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+	Chunk& chunk = s_chunks[chunkIndex];
+	if (!chunk.meshes.empty() || !chunk.lights.empty())
+		return;
 
-	XASSERT(meshRenderer, "The meshRenderer is null");
+	const uint64_t key = MakeChunkKey(chunk.x, chunk.y, chunk.z);
+	const size_t slotMask = s_chunkSlots.size() - 1;
+	size_t emptySlotIndex = GetFirstChunkSlotIndex(key);
+	while (s_chunkSlots[emptySlotIndex].key != key)
+	{
+		emptySlotIndex = (emptySlotIndex + 1) & slotMask;
+	}
 
-	for (auto& position : meshRenderer->m_worldChunkPositions)
+	// Move back the next slots of the probe sequence instead of using tombstones
+	size_t slotIndex = (emptySlotIndex + 1) & slotMask;
+	while (s_chunkSlots[slotIndex].key != EMPTY_CHUNK_KEY)
 	{
-		const int x = static_cast<int>(position.x / WORLD_CHUNK_SIZE);
-		const int y = static_cast<int>(position.y / WORLD_CHUNK_SIZE);
-		const int z = static_cast<int>(position.z / WORLD_CHUNK_SIZE);
+		// A slot can be moved if the empty slot is between its first slot and itself
+		const size_t firstSlotIndex = GetFirstChunkSlotIndex(s_chunkSlots[slotIndex].key);
+		if (((slotIndex - firstSlotIndex) & slotMask) >= ((slotIndex - emptySlotIndex) & slotMask))
+		{
+			s_chunkSlots[emptySlotIndex] = s_chunkSlots[slotIndex];
+			emptySlotIndex = slotIndex;
+		}
+		slotIndex = (slotIndex + 1) & slotMask;
+	}
+	s_chunkSlots[emptySlotIndex] = ChunkSlot();
+
+	chunk.isFree = true;
+	s_freeChunkIndices.push_back(chunkIndex);
+}
+
+Vector3 WorldPartitionner::GetChunkPosition(uint32_t chunkIndex)
+{
+	XASSERT(chunkIndex < s_chunks.size(), "[WorldPartitionner::GetChunkPosition] chunkIndex is out of bounds");
 
-		XNode& xNode = Tree::children[x];
-		YNode& yNode = xNode.children[y];
-		ZNode& zNode = yNode.children[z];
-		Chunk& chunk = zNode.chunk;
+	const Chunk& chunk = s_chunks[chunkIndex];
+	return Vector3(static_cast<float>(chunk.x * WORLD_CHUNK_SIZE), static_cast<float>(chunk.y * WORLD_CHUNK_SIZE), static_cast<float>(chunk.z * WORLD_CHUNK_SIZE));
+}
+
+void WorldPartitionner::GetChunksIntersectedBySphere(const Vector3& position, float radius, std::vector<uint32_t>& chunkIndices)
+{
+	STACK_DEBUG_OBJECT(STACK_LOW_PRIORITY);
 
-		auto it = std::find(chunk.meshes.begin(), chunk.meshes.end(), meshRenderer);
-		if (it != chunk.meshes.end())
+	chunkIndices.clear();
+
+	const int minX = static_cast<int>(std::floor((position.x - radius) / WORLD_CHUNK_SIZE));
+	const int minY = static_cast<int>(std::floor((position.y - radius) / WORLD_CHUNK_SIZE));
+	const int minZ = static_cast<int>(std::floor((position.z - radius) / WORLD_CHUNK_SIZE));
+	const int maxX = static_cast<int>(std::floor((position.x + radius) / WORLD_CHUNK_SIZE));
+	const int maxY = static_cast<int>(std::floor((position.y + radius) / WORLD_CHUNK_SIZE));
+	const int maxZ = static_cast<int>(std::floor((position.z + radius) / WORLD_CHUNK_SIZE));
+
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int y = minY; y <= maxY; y++)
 		{
-			chunk.meshes.erase(it);
+			for (int z = minZ; z <= maxZ; z++)
+			{
+				if (ChunkIntersectsSphere(x, y, z, position, radius))
+				{
+					chunkIndices.push_back(FindOrCreateChunk(x, y, z));
+				}
+			}
 		}
 	}
 
-	meshRenderer->m_worldChunkPositions.clear();
-	meshRenderer->m_affectedByLights.clear();
+	// The lists are compared with a merge, they have to be sorted
+	std::sort(chunkIndices.begin(), chunkIndices.end());
+}
+
+void WorldPartitionner::RemoveMeshRenderer(MeshRenderer* meshRenderer)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	XASSERT(meshRenderer, "The meshRenderer is null");
+
+	s_newChunkIndices.clear();
+	UpdateMeshRendererChunks(meshRenderer, s_newChunkIndices);
 }
 
 void WorldPartitionner::RemoveLight(Light* light)
@@ -135,72 +282,200 @@ void WorldPartitionner::RemoveLight(Light* light)
 
 	XASSERT(light, "The light is null");
 
-	for (auto& position : light->m_worldChunkPositions)
+	s_newChunkIndices.clear();
+	UpdateLightChunks(light, s_newChunkIndices);
+}
+
+void WorldPartitionner::ProcessMeshRenderer(MeshRenderer* meshRenderer)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	XASSERT(meshRenderer, "The meshRenderer is null");
+
+	const Sphere& sphere = meshRenderer->GetBoundingSphere();
+	if (sphere.radius == 0)
 	{
-		const int x = static_cast<int>(position.x / WORLD_CHUNK_SIZE);
-		const int y = static_cast<int>(position.y / WORLD_CHUNK_SIZE);
-		const int z = static_cast<int>(position.z / WORLD_CHUNK_SIZE);
+		s_newChunkIndices.clear();
+	}
+	else
+	{
+		GetChunksIntersectedBySphere(sphere.position, sphere.radius, s_newChunkIndices);
+	}
 
-		XNode& xNode = Tree::children[x];
-		YNode& yNode = xNode.children[y];
-		ZNode& zNode = yNode.children[z];
-		Chunk& chunk = zNode.chunk;
+	UpdateMeshRendererChunks(meshRenderer, s_newChunkIndices);
+}
 
-		auto it = std::find(chunk.lights.begin(), chunk.lights.end(), light);
-		if (it != chunk.lights.end())
+void WorldPartitionner::ProcessLight(Light* light)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	XASSERT(light, "The light is null");
+
+	s_newChunkIndices.clear();
+	if (light->GetType() == LightType::Point || light->GetType() == LightType::Spot)
+	{
+		if (light->IsEnabled() && light->GetGameObject()->IsLocalActive())
 		{
-			chunk.lights.erase(it);
+			GetChunksIntersectedBySphere(light->GetTransform()->GetPosition(), light->GetMaxLightDistance(), s_newChunkIndices);
 		}
+	}
 
-		for (MeshRenderer* meshRenderer : chunk.meshes)
+	UpdateLightChunks(light, s_newChunkIndices);
+}
+
+void WorldPartitionner::UpdateMeshRendererChunks(MeshRenderer* meshRenderer, const std::vector<uint32_t>& newChunkIndices)
+{
+	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
+
+	const Sphere& sphere = meshRenderer->GetBoundingSphere();
+	const CullingSphere cullingSphere = { sphere.position.x, sphere.position.y, sphere.position.z, sphere.radius };
+
+	// Walk the old and the new sorted lists at the same time to find the entered and left chunks
+	const std::vector<uint32_t>& oldChunkIndices = meshRenderer->m_worldChunkIndices;
+	const size_t oldCount = oldChunkIndices.size();
+	const size_t newCount = newChunkIndices.size();
+	size_t oldIndex = 0;
+	size_t newIndex = 0;
+	bool chunksChanged = false;
+	while (oldIndex < oldCount || newIndex < newCount)
+	{
+		if (newIndex == newCount || (oldIndex < oldCount && oldChunkIndices[oldIndex] < newChunkIndices[newIndex]))
 		{
-			// Add the light if it's not already in the list
-			auto it = std::find(meshRenderer->m_affectedByLights.begin(), meshRenderer->m_affectedByLights.end(), light);
-			if (it != meshRenderer->m_affectedByLights.end())
+			// Left chunk
+			const uint32_t chunkIndex = oldChunkIndices[oldIndex];
+			Chunk& chunk = s_chunks[chunkIndex];
+			auto it = std::find(chunk.meshes.begin(), chunk.meshes.end(), meshRenderer);
+			if (it != chunk.meshes.end())
+			{
+				const size_t meshIndex = it - chunk.meshes.begin();
+				chunk.meshes[meshIndex] = chunk.meshes.back();
+				chunk.meshes.pop_back();
+				chunk.meshBoundingSpheres[meshIndex] = chunk.meshBoundingSpheres.back();
+				chunk.meshBoundingSpheres.pop_back();
+			}
+
+			if (chunk.meshes.empty() && chunk.meshChunkListIndex != UINT32_MAX)
 			{
-				meshRenderer->m_affectedByLights.erase(it);
+				// Remove the chunk from the culled chunks
+				const uint32_t movedChunkIndex = s_meshChunkIndices.back();
+				s_meshChunkIndices[chunk.meshChunkListIndex] = movedChunkIndex;
+				s_chunks[movedChunkIndex].meshChunkListIndex = chunk.meshChunkListIndex;
+				s_meshChunkIndices.pop_back();
+				chunk.meshChunkListIndex = UINT32_MAX;
+				ReleaseChunkIfEmpty(chunkIndex);
 			}
+			chunksChanged = true;
+			oldIndex++;
+		}
+		else if (oldIndex == oldCount || newChunkIndices[newIndex] < oldChunkIndices[oldIndex])
+		{
+			// Entered chunk
+			const uint32_t chunkIndex = newChunkIndices[newIndex];
+			Chunk& chunk = s_chunks[chunkIndex];
+			if (chunk.meshChunkListIndex == UINT32_MAX)
+			{
+				chunk.meshChunkListIndex = static_cast<uint32_t>(s_meshChunkIndices.size());
+				s_meshChunkIndices.push_back(chunkIndex);
+			}
+			chunk.meshes.push_back(meshRenderer);
+			chunk.meshBoundingSpheres.push_back(cullingSphere);
+			chunksChanged = true;
+			newIndex++;
+		}
+		else
+		{
+			// Same chunk, only the bounding sphere has moved
+			Chunk& chunk = s_chunks[newChunkIndices[newIndex]];
+			auto it = std::find(chunk.meshes.begin(), chunk.meshes.end(), meshRenderer);
+			if (it != chunk.meshes.end())
+			{
+				chunk.meshBoundingSpheres[it - chunk.meshes.begin()] = cullingSphere;
+			}
+			oldIndex++;
+			newIndex++;
 		}
 	}
 
-	light->m_worldChunkPositions.clear();
+	if (chunksChanged)
+	{
+		meshRenderer->m_worldChunkIndices = newChunkIndices;
+		UpdateMeshRendererLights(meshRenderer);
+	}
 }
 
-void WorldPartitionner::ProcessMeshRenderer(MeshRenderer* meshRenderer)
+void WorldPartitionner::UpdateLightChunks(Light* light, const std::vector<uint32_t>& newChunkIndices)
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	XASSERT(meshRenderer, "The meshRenderer is null");
-
-	RemoveMeshRenderer(meshRenderer);
+	// Walk the old and the new sorted lists at the same time to find the entered and left chunks
+	s_leftChunkIndices.clear();
+	const std::vector<uint32_t>& oldChunkIndices = light->m_worldChunkIndices;
+	const size_t oldCount = oldChunkIndices.size();
+	const size_t newCount = newChunkIndices.size();
+	size_t oldIndex = 0;
+	size_t newIndex = 0;
+	bool chunksChanged = false;
+	while (oldIndex < oldCount || newIndex < newCount)
+	{
+		if (newIndex == newCount || (oldIndex < oldCount && oldChunkIndices[oldIndex] < newChunkIndices[newIndex]))
+		{
+			// Left chunk, released once the lights of its mesh renderers are updated
+			RemoveUnordered(s_chunks[oldChunkIndices[oldIndex]].lights, light);
+			s_leftChunkIndices.push_back(oldChunkIndices[oldIndex]);
+			chunksChanged = true;
+			oldIndex++;
+		}
+		else if (oldIndex == oldCount || newChunkIndices[newIndex] < oldChunkIndices[oldIndex])
+		{
+			// Entered chunk
+			Chunk& chunk = s_chunks[newChunkIndices[newIndex]];
+			chunk.lights.push_back(light);
+			for (MeshRenderer* meshRenderer : chunk.meshes)
+			{
+				auto it = std::find(meshRenderer->m_affectedByLights.begin(), meshRenderer->m_affectedByLights.end(), light);
+				if (it == meshRenderer->m_affectedByLights.end())
+				{
+					meshRenderer->m_affectedByLights.push_back(light);
+				}
+			}
+			chunksChanged = true;
+			newIndex++;
+		}
+		else
+		{
+			oldIndex++;
+			newIndex++;
+		}
+	}
 
-	const Sphere& sphere = meshRenderer->GetBoundingSphere();
-	if (sphere.radius == 0)
+	if (!chunksChanged)
 		return;
 
-	std::vector<Vector3Fast> intersectedCubes;
-	getCubesIntersectedBySphere(intersectedCubes, Vector3Fast(sphere.position.x, sphere.position.y, sphere.position.z), sphere.radius, WORLD_CHUNK_SIZE);
+	light->m_worldChunkIndices = newChunkIndices;
 
-	for (const Vector3Fast& cube : intersectedCubes)
+	// A mesh renderer of a left chunk can still be lit through another of its chunks
+	for (const uint32_t chunkIndex : s_leftChunkIndices)
 	{
-		const int x = static_cast<int>(cube.x / WORLD_CHUNK_SIZE);
-		const int y = static_cast<int>(cube.y / WORLD_CHUNK_SIZE);
-		const int z = static_cast<int>(cube.z / WORLD_CHUNK_SIZE);
-
-		XNode& xNode = Tree::children[x];
-		YNode& yNode = xNode.children[y];
-		ZNode& zNode = yNode.children[z];
-		Chunk& chunk = zNode.chunk;
-		chunk.meshes.push_back(meshRenderer);
-
-		meshRenderer->m_worldChunkPositions.push_back(Vector3(cube.x, cube.y, cube.z));
+		for (MeshRenderer* meshRenderer : s_chunks[chunkIndex].meshes)
+		{
+			if (!IsLightInMeshRendererChunks(meshRenderer, light))
+			{
+				RemoveUnordered(meshRenderer->m_affectedByLights, light);
+			}
+		}
+		ReleaseChunkIfEmpty(chunkIndex);
+	}
+}
 
-		// Add light to mesh
-		for (Light* light : chunk.lights)
+void WorldPartitionner::UpdateMeshRendererLights(MeshRenderer* meshRenderer)
+{
+	meshRenderer->m_affectedByLights.clear();
+	for (const uint32_t chunkIndex : meshRenderer->m_worldChunkIndices)
+	{
+		for (Light* light : s_chunks[chunkIndex].lights)
 		{
 			// Add the light if it's not already in the list
 			auto it = std::find(meshRenderer->m_affectedByLights.begin(), meshRenderer->m_affectedByLights.end(), light);
-
 			if (it == meshRenderer->m_affectedByLights.end())
 			{
 				meshRenderer->m_affectedByLights.push_back(light);
@@ -209,50 +484,146 @@ void WorldPartitionner::ProcessMeshRenderer(MeshRenderer* meshRenderer)
 	}
 }
 
-void WorldPartitionner::ProcessLight(Light* light)
+bool WorldPartitionner::IsLightInMeshRendererChunks(const MeshRenderer* meshRenderer, const Light* light)
+{
+	for (const uint32_t chunkIndex : meshRenderer->m_worldChunkIndices)
+	{
+		const std::vector<Light*>& lights = s_chunks[chunkIndex].lights;
+		if (std::find(lights.begin(), lights.end(), light) != lights.end())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorldPartitionner::CullMeshRenderers(const Frustum& frustum)
 {
 	STACK_DEBUG_OBJECT(STACK_MEDIUM_PRIORITY);
 
-	XASSERT(light, "The light is null");
+	SCOPED_PROFILER("WorldPartitionner::CullMeshRenderers", scopeBenchmark);
 
-	RemoveLight(light);
-	if (light->GetType() == LightType::Point || light->GetType() == LightType::Spot)
+	// Mesh renderers marked with an older id are out of the frustum
+	s_frustumCullingPassId++;
+
+	// Only the chunks with mesh renderers are tested, the empty chunks of the lights are skipped
+	int culledChunkCount = 0;
+	int visitedMeshCount = 0;
+	int culledMeshCount = 0;
+	for (const uint32_t chunkIndex : s_meshChunkIndices)
 	{
-		if (light->IsEnabled() && light->GetGameObject()->IsLocalActive())
+		Chunk& chunk = s_chunks[chunkIndex];
+		const size_t meshCount = chunk.meshes.size();
+
+		if (!IsChunkInFrustum(frustum, chunk.x, chunk.y, chunk.z))
 		{
-			std::vector<Vector3Fast> intersectedCubes;
-			Sphere sphere;
-			sphere.position = light->GetTransform()->GetPosition();
-			sphere.radius = light->GetMaxLightDistance();
-			getCubesIntersectedBySphere(intersectedCubes, Vector3Fast(sphere.position.x, sphere.position.y, sphere.position.z), sphere.radius, WORLD_CHUNK_SIZE);
-			for (const Vector3Fast& cube : intersectedCubes)
+			culledChunkCount++;
+			continue;
+		}
+
+		if (s_sphereVisibilities.size() < meshCount)
+		{
+			s_sphereVisibilities.resize(meshCount);
+		}
+
+		TestSpheresInFrustum(frustum, chunk.meshBoundingSpheres.data(), meshCount, s_sphereVisibilities.data());
+
+		visitedMeshCount += static_cast<int>(meshCount);
+		for (size_t i = 0; i < meshCount; i++)
+		{
+			if (s_sphereVisibilities[i])
 			{
-				const int x = static_cast<int>(cube.x / WORLD_CHUNK_SIZE);
-				const int y = static_cast<int>(cube.y / WORLD_CHUNK_SIZE);
-				const int z = static_cast<int>(cube.z / WORLD_CHUNK_SIZE);
+				chunk.meshes[i]->m_frustumCullingPassId = s_frustumCullingPassId;
+			}
+			else
+			{
+				culledMeshCount++;
+			}
+		}
+	}
 
-				XNode& xNode = Tree::children[x];
-				YNode& yNode = xNode.children[y];
-				ZNode& zNode = yNode.children[z];
-				Chunk& chunk = zNode.chunk;
-				chunk.lights.push_back(light);
+	Performance::AddFrustumCullingResults(culledChunkCount, visitedMeshCount, culledMeshCount);
+}
 
-				light->m_worldChunkPositions.push_back(Vector3(cube.x, cube.y, cube.z));
+bool WorldPartitionner::IsChunkInFrustum(const Frustum& frustum, int x, int y, int z)
+{
+	const float minX = static_cast<float>(x * WORLD_CHUNK_SIZE);
+	const float minY = static_cast<float>(y * WORLD_CHUNK_SIZE);
+	const float minZ = static_cast<float>(z * WORLD_CHUNK_SIZE);
+	const float maxX = minX + WORLD_CHUNK_SIZE;
+	const float maxY = minY + WORLD_CHUNK_SIZE;
+	const float maxZ = minZ + WORLD_CHUNK_SIZE;
+
+	for (const Plane& plane : frustum.planes)
+	{
+		// Test the corner of the box that is the most in the direction of the plane normal
+		const float distance = plane.A * (plane.A >= 0 ? maxX : minX) +
+			plane.B * (plane.B >= 0 ? maxY : minY) +
+			plane.C * (plane.C >= 0 ? maxZ : minZ) +
+			plane.D;
 
-				for (MeshRenderer* meshRenderer : chunk.meshes)
-				{
-					auto it = std::find(meshRenderer->m_affectedByLights.begin(), meshRenderer->m_affectedByLights.end(), light);
-					if (it == meshRenderer->m_affectedByLights.end())
-					{
-						meshRenderer->m_affectedByLights.push_back(light);
-					}
-				}
+		if (distance < 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void WorldPartitionner::TestSpheresInFrustum(const Frustum& frustum, const CullingSphere* spheres, size_t count, uint8_t* visibilities)
+{
+	size_t i = 0;
+
+#if defined(USE_SSE_FRUSTUM_CULLING)
+	static_assert(sizeof(CullingSphere) == sizeof(float) * 4, "CullingSphere has to be 4 floats to be loaded in one SSE register");
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Load 4 spheres and transpose them to get the x, y, z and radius of each sphere in a register
+		__m128 xs = _mm_loadu_ps(&spheres[i].x);
+		__m128 ys = _mm_loadu_ps(&spheres[i + 1].x);
+		__m128 zs = _mm_loadu_ps(&spheres[i + 2].x);
+		__m128 radiuses = _mm_loadu_ps(&spheres[i + 3].x);
+		_MM_TRANSPOSE4_PS(xs, ys, zs, radiuses);
+		const __m128 negativeRadiuses = _mm_sub_ps(_mm_setzero_ps(), radiuses);
+
+		__m128 isOutside = _mm_setzero_ps();
+		for (const Plane& plane : frustum.planes)
+		{
+			__m128 distances = _mm_mul_ps(xs, _mm_set1_ps(plane.A));
+			distances = _mm_add_ps(distances, _mm_mul_ps(ys, _mm_set1_ps(plane.B)));
+			distances = _mm_add_ps(distances, _mm_mul_ps(zs, _mm_set1_ps(plane.C)));
+			distances = _mm_add_ps(distances, _mm_set1_ps(plane.D));
+			isOutside = _mm_or_ps(isOutside, _mm_cmplt_ps(distances, negativeRadiuses));
+		}
+
+		const int outsideMask = _mm_movemask_ps(isOutside);
+		visibilities[i] = (outsideMask & 1) == 0;
+		visibilities[i + 1] = (outsideMask & 2) == 0;
+		visibilities[i + 2] = (outsideMask & 4) == 0;
+		visibilities[i + 3] = (outsideMask & 8) == 0;
+	}
+#endif
+
+	// Remaining spheres (or all spheres without SSE)
+	for (; i < count; i++)
+	{
+		const CullingSphere& sphere = spheres[i];
+		uint8_t isVisible = 1;
+		for (const Plane& plane : frustum.planes)
+		{
+			const float distance = plane.A * sphere.x + plane.B * sphere.y + plane.C * sphere.z + plane.D;
+			if (distance < -sphere.radius)
+			{
+				isVisible = 0;
+				break;
 			}
 		}
+		visibilities[i] = isVisible;
 	}
 }
 
-void WorldPartitionner::DrawChunk(const Chunk& chunk, int x, int y, int z)
+void WorldPartitionner::DrawChunk(const Chunk& chunk)
 {
 	STACK_DEBUG_OBJECT(STACK_VERY_LOW_PRIORITY);
 
@@ -260,7 +631,7 @@ void WorldPartitionner::DrawChunk(const Chunk& chunk, int x, int y, int z)
 		return;
 
 #if defined(EDITOR)
-	const Vector3 pos = Vector3(static_cast<float>(x * WORLD_CHUNK_SIZE), static_cast<float>(y * WORLD_CHUNK_SIZE), static_cast<float>(z * WORLD_CHUNK_SIZE));
+	const Vector3 pos = Vector3(static_cast<float>(chunk.x * WORLD_CHUNK_SIZE), static_cast<float>(chunk.y * WORLD_CHUNK_SIZE), static_cast<float>(chunk.z * WORLD_CHUNK_SIZE));
 
 	// Bottom vertex
 	const Vector3 v1 = pos + Vector3(-WORLD_CHUNK_HALF_SIZE, -WORLD_CHUNK_HALF_SIZE, -WORLD_CHUNK_HALF_SIZE) + Vector3(WORLD_CHUNK_HALF_SIZE);
@@ -306,15 +677,9 @@ void WorldPartitionner::OnDrawGizmos()
 
 	Gizmo::SetColor(lineColor);
 
-	for (const auto& xNode : Tree::children)
+	for (const Chunk& chunk : s_chunks)
 	{
-		for (const auto& yNode : xNode.second.children)
-		{
-			for (const auto& zNode : yNode.second.children)
-			{
-				DrawChunk(zNode.second.chunk, xNode.first, yNode.first, zNode.first);
-			}
-		}
+		DrawChunk(chunk);
 	}
 
 #endif
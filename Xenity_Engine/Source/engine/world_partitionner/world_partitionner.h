@@ -2,10 +2,14 @@
 
 #include <vector>
 #include <memory>
-#include <map>
+#include <cstdint>
+
+#include <engine/vectors/vector3.h>
 
 class Light;
 class MeshRenderer;
+struct Frustum;
+struct Sphere;
 
 class WorldPartitionner
 {
@@ -15,41 +19,136 @@ public:
 	static void RemoveLight(Light* light);
 	static void OnDrawGizmos();
 
+	/**
+	* @brief Bounding sphere stored contiguously in the chunks for the frustum culling
+	*/
+	struct CullingSphere
+	{
+		float x, y, z, radius;
+	};
+
 	class Chunk
 	{
 	public:
 		std::vector<Light*> lights;
 		std::vector<MeshRenderer*> meshes;
-	};
+		std::vector<CullingSphere> meshBoundingSpheres; // Same order as meshes
 
-	class ZNode
-	{
-	public:
-		Chunk chunk;
-	};
+		// Position of the chunk in chunk units
+		int x = 0;
+		int y = 0;
+		int z = 0;
 
-	class YNode
-	{
-	public:
-		std::map<int, ZNode> children;
+		uint32_t meshChunkListIndex = UINT32_MAX; // Index in s_meshChunkIndices, UINT32_MAX if the chunk has no mesh
+		bool isFree = false; // True if the chunk is in the free list and can be reused for another position
 	};
 
-	class XNode
+	/**
+	* @brief Update the chunks of a mesh renderer, only the chunks entered or left by the bounding sphere are modified
+	*/
+	static void ProcessMeshRenderer(MeshRenderer* meshRenderer);
+
+	/**
+	* @brief Update the chunks of a light, only the chunks entered or left by the light range are modified
+	*/
+	static void ProcessLight(Light* light);
+
+	/**
+	* @brief Test the chunks against the frustum and then the meshes of the visible chunks
+	* @param frustum Frustum of the camera
+	*/
+	static void CullMeshRenderers(const Frustum& frustum);
+
+	/**
+	* @brief Get the id of the last culling pass, a mesh renderer is visible if it has been marked with this id
+	*/
+	static uint32_t GetFrustumCullingPassId()
 	{
-	public:
-		std::map<int, YNode> children;
-	};
+		return s_frustumCullingPassId;
+	}
 
-	class Tree
+	/**
+	* @brief Get the world position of the minimum corner of a chunk
+	* @param chunkIndex Index of the chunk (from m_worldChunkIndices)
+	*/
+	static Vector3 GetChunkPosition(uint32_t chunkIndex);
+
+private:
+	static constexpr uint64_t EMPTY_CHUNK_KEY = UINT64_MAX;
+
+	/**
+	* @brief Slot of the chunk hash table
+	*/
+	struct ChunkSlot
 	{
-	public:
-		static std::map<int, XNode> children;
+		uint64_t key = EMPTY_CHUNK_KEY;
+		uint32_t chunkIndex = 0;
 	};
 
-	static void ProcessMeshRenderer(MeshRenderer* meshRenderer);
-	static void ProcessLight(Light* light);
+	static void DrawChunk(const Chunk& chunk);
 
-private:
-	static void DrawChunk(const Chunk& chunk, int x, int y, int z);
-};
+	/**
+	* @brief Pack the chunk position in a single key (21 bits per axis)
+	*/
+	static uint64_t MakeChunkKey(int x, int y, int z);
+
+	/**
+	* @brief Get the index of a chunk in the pool, create the chunk if it does not exist
+	*/
+	static uint32_t FindOrCreateChunk(int x, int y, int z);
+
+	/**
+	* @brief Double the size of the hash table and reinsert all chunks
+	*/
+	static void GrowChunkSlots();
+
+	/**
+	* @brief Get the first slot of the probe sequence of a key
+	*/
+	static size_t GetFirstChunkSlotIndex(uint64_t key);
 
+	/**
+	* @brief Remove a chunk from the hash table and put it in the free list if it has no mesh and no light
+	*/
+	static void ReleaseChunkIfEmpty(uint32_t chunkIndex);
+
+	/**
+	* @brief Fill a sorted list with the indices of the chunks intersected by a sphere
+	*/
+	static void GetChunksIntersectedBySphere(const Vector3& position, float radius, std::vector<uint32_t>& chunkIndices);
+
+	static void UpdateMeshRendererChunks(MeshRenderer* meshRenderer, const std::vector<uint32_t>& newChunkIndices);
+	static void UpdateLightChunks(Light* light, const std::vector<uint32_t>& newChunkIndices);
+
+	/**
+	* @brief Rebuild the list of lights affecting a mesh renderer from its chunks
+	*/
+	static void UpdateMeshRendererLights(MeshRenderer* meshRenderer);
+
+	/**
+	* @brief Check if a light is in one of the chunks of a mesh renderer
+	*/
+	static bool IsLightInMeshRendererChunks(const MeshRenderer* meshRenderer, const Light* light);
+
+	/**
+	* @brief Check if a chunk is at least partially in the frustum
+	*/
+	static bool IsChunkInFrustum(const Frustum& frustum, int x, int y, int z);
+
+	/**
+	* @brief Test a list of spheres against the frustum (4 spheres at a time when SSE is available)
+	* @param visibilities Filled with 1 if the sphere is in the frustum, 0 otherwise
+	*/
+	static void TestSpheresInFrustum(const Frustum& frustum, const CullingSphere* spheres, size_t count, uint8_t* visibilities);
+
+	static std::vector<ChunkSlot> s_chunkSlots; // Open addressing with linear probing, the size is a power of two
+	static uint32_t s_chunkSlotShift; // 64 - log2(slot count), used by the hash function
+	static std::vector<Chunk> s_chunks; // Chunk pool, the index of a chunk is stable while a mesh renderer or a light is in it
+	static std::vector<uint32_t> s_freeChunkIndices; // Empty chunks of the pool, reused before growing the pool
+	static std::vector<uint32_t> s_meshChunkIndices; // Chunks with at least one mesh renderer, only these chunks are culled
+	static std::vector<uint32_t> s_newChunkIndices;
+	static std::vector<uint32_t> s_leftChunkIndices;
+
+	static uint32_t s_frustumCullingPassId;
+	static std::vector<uint8_t> s_sphereVisibilities;
+};
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "../unit_test_manager.h"
+
+#include <engine/component.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/gameplay_manager.h>
+#include <engine/game_elements/gameobject_pool.h>
+#include <engine/tools/gameplay_utility.h>
+
+class UpdatedTestComponent : public Component
+{
+public:
+	void Update() override {}
+
+	ReflectiveData GetReflectiveData() override
+	{
+		return ReflectiveData();
+	}
+};
+
+class NotUpdatedTestComponent : public Component
+{
+public:
+	ReflectiveData GetReflectiveData() override
+	{
+		return ReflectiveData();
+	}
+};
+
+class PooledTestComponent : public Component
+{
+public:
+	void Update() override {}
+
+	void OnAcquire() override
+	{
+		acquireCount++;
+	}
+
+	void OnRelease() override
+	{
+		releaseCount++;
+	}
+
+	ReflectiveData GetReflectiveData() override
+	{
+		return ReflectiveData();
+	}
+
+	int acquireCount = 0;
+	int releaseCount = 0;
+};
+
+TestResult GameplayManagerUpdateListTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+	const size_t initialCount = GameplayManager::GetUpdatedComponentCount();
+
+	std::shared_ptr<GameObject> gameObject = CreateGameObject();
+	std::shared_ptr<UpdatedTestComponent> firstComponent = gameObject->AddComponent<UpdatedTestComponent>();
+	gameObject->AddComponent<UpdatedTestComponent>();
+	gameObject->AddComponent<NotUpdatedTestComponent>();
+
+	// Components without Update() are not in the list
+	EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), initialCount + 2, "Bad update list count after AddComponent");
+
+	firstComponent->SetUpdatePriority(-10);
+	EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), initialCount + 2, "Bad update list count after SetUpdatePriority");
+
+	Destroy(firstComponent);
+	GameplayManager::RemoveDestroyedComponents();
+	EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), initialCount + 1, "Bad update list count after component Destroy");
+
+	Destroy(gameObject);
+	GameplayManager::RemoveDestroyedGameObjects();
+	EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), initialCount, "Bad update list count after GameObject Destroy");
+
+	END_TEST();
+}
+
+TestResult GameplayManagerIdIndexTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+	std::shared_ptr<GameObject> gameObject = CreateGameObject();
+	std::shared_ptr<NotUpdatedTestComponent> component = gameObject->AddComponent<NotUpdatedTestComponent>();
+	EXPECT_EQUALS(FindGameObjectById(gameObject->GetUniqueId()), gameObject, "GameObject not found after creation");
+	EXPECT_EQUALS(FindComponentById(component->GetUniqueId()), std::static_pointer_cast<Component>(component), "Component not found after creation");
+
+	// The indices follow the id changes
+	const uint64_t oldGameObjectId = gameObject->GetUniqueId();
+	const uint64_t oldComponentId = component->GetUniqueId();
+	gameObject->SetUniqueId(oldGameObjectId + 1);
+	component->SetUniqueId(oldComponentId + 1);
+	EXPECT_EQUALS(FindGameObjectById(oldGameObjectId + 1), gameObject, "GameObject not found after SetUniqueId");
+	EXPECT_EQUALS(FindComponentById(oldComponentId + 1), std::static_pointer_cast<Component>(component), "Component not found after SetUniqueId");
+	EXPECT_NULL(FindGameObjectById(oldGameObjectId), "GameObject found with its old id");
+	EXPECT_NULL(FindComponentById(oldComponentId), "Component found with its old id");
+
+	const uint64_t componentId = component->GetUniqueId();
+	Destroy(component);
+	EXPECT_NULL(FindComponentById(componentId), "Component found after Destroy");
+	GameplayManager::RemoveDestroyedComponents();
+
+	const uint64_t gameObjectId = gameObject->GetUniqueId();
+	Destroy(gameObject);
+	GameplayManager::RemoveDestroyedGameObjects();
+	EXPECT_NULL(FindGameObjectById(gameObjectId), "GameObject found after Destroy");
+
+	END_TEST();
+}
+
+TestResult GameObjectPoolTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+	const size_t initialCount = GameplayManager::GetUpdatedComponentCount();
+
+	std::shared_ptr<GameObject> prefab = CreateGameObject();
+	prefab->AddComponent<UpdatedTestComponent>();
+	const size_t prefabCount = GameplayManager::GetUpdatedComponentCount();
+
+	{
+		GameObjectPool pool = GameObjectPool(prefab, 3);
+		EXPECT_EQUALS(pool.GetAvailableCount(), static_cast<size_t>(3), "Bad available count after prewarm");
+		EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), prefabCount, "Released instances are in the update list");
+
+		std::shared_ptr<GameObject> instance = pool.Acquire();
+		EXPECT_NOT_NULL(instance, "Acquire failed");
+		EXPECT_TRUE(instance->IsActive(), "Acquired instance not active");
+		EXPECT_EQUALS(pool.GetAvailableCount(), static_cast<size_t>(2), "Bad available count after Acquire");
+		EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), prefabCount + 1, "Acquired instance not in the update list");
+
+		std::shared_ptr<PooledTestComponent> pooledComponent = instance->AddComponent<PooledTestComponent>();
+		pool.Release(instance);
+		EXPECT_FALSE(instance->IsActive(), "Released instance still active");
+		EXPECT_EQUALS(pooledComponent->releaseCount, 1, "OnRelease not called");
+		EXPECT_EQUALS(pool.GetAvailableCount(), static_cast<size_t>(3), "Bad available count after Release");
+		EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), prefabCount, "Released instance still in the update list");
+
+		// The last released instance is reused
+		EXPECT_EQUALS(pool.Acquire(), instance, "Released instance not reused");
+		EXPECT_EQUALS(pooledComponent->acquireCount, 1, "OnAcquire not called");
+		pool.Release(instance);
+	}
+
+	// The released instances are destroyed with the pool
+	GameplayManager::RemoveDestroyedGameObjects();
+	Destroy(prefab);
+	GameplayManager::RemoveDestroyedGameObjects();
+	EXPECT_EQUALS(GameplayManager::GetUpdatedComponentCount(), initialCount, "Bad update list count after the pool destruction");
+
+	END_TEST();
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "../unit_test_manager.h"
+
+#include <engine/debug/debug.h>
+#include <engine/tools/benchmark.h>
+#include <engine/tools/gameplay_utility.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/transform.h>
+#include <engine/scene_management/scene_manager.h>
+#include <engine/test_component.h>
+
+TestResult InstantiateBenchmarkTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	constexpr size_t instanceCount = 10000;
+#else
+	constexpr size_t instanceCount = 200; // Keep the test usable on consoles
+#endif
+
+	SceneManager::ClearScene();
+
+	// Prefab with a child and a component referencing the child
+	const std::shared_ptr<GameObject> prefab = CreateGameObject("Prefab");
+	const std::shared_ptr<GameObject> prefabChild = CreateGameObject("Child");
+	prefabChild->SetParent(prefab);
+	const std::shared_ptr<TestComponent> prefabComponent = prefab->AddComponent<TestComponent>();
+	prefabComponent->myInt = 42;
+	prefabComponent->myString = "Bullet";
+	prefabComponent->vec3 = Vector3(4, 5, 6);
+	prefabComponent->myCustomClass.myCustomFloat = 2.5f;
+	prefabComponent->myFloats = { 1, 2, 3 };
+	prefabComponent->myGameObject = prefabChild;
+	prefabComponent->myTransform = prefabChild->GetTransform();
+
+	Benchmark benchmark;
+	benchmark.Start();
+	std::shared_ptr<GameObject> lastInstance;
+	for (size_t i = 0; i < instanceCount; i++)
+	{
+		lastInstance = Instantiate(prefab);
+	}
+	benchmark.Stop();
+
+	EXPECT_EQUALS(lastInstance->GetChildrenCount(), 1, "Bad child count");
+	const std::shared_ptr<GameObject> instanceChild = lastInstance->GetChild(0).lock();
+	const std::shared_ptr<TestComponent> instanceComponent = lastInstance->GetComponent<TestComponent>();
+	EXPECT_NOT_NULL(instanceComponent, "Component not duplicated");
+	if (instanceComponent)
+	{
+		EXPECT_NOT_EQUALS(instanceComponent, prefabComponent, "Component not duplicated");
+		EXPECT_EQUALS(instanceComponent->myInt, 42, "Bad int value");
+		EXPECT_EQUALS(instanceComponent->myString, "Bullet", "Bad string value");
+		EXPECT_EQUALS(instanceComponent->vec3, Vector3(4, 5, 6), "Bad reflective value");
+		EXPECT_EQUALS(instanceComponent->myCustomClass.myCustomFloat, 2.5f, "Bad nested reflective value");
+		EXPECT_EQUALS(instanceComponent->myFloats, prefabComponent->myFloats, "Bad list value");
+		// The references to the prefab's children are replaced by the new children
+		EXPECT_EQUALS(instanceComponent->myGameObject.lock(), instanceChild, "Bad GameObject reference");
+		EXPECT_EQUALS(instanceComponent->myTransform.lock(), instanceChild->GetTransform(), "Bad Transform reference");
+	}
+
+	const uint64_t microSeconds = benchmark.GetMicroSeconds();
+	const double prefabsPerSecond = microSeconds == 0 ? 0 : instanceCount * 1000000.0 / microSeconds;
+	Debug::Print("[InstantiateBenchmark] " + std::to_string(instanceCount) + " prefabs in " + std::to_string(microSeconds) + "us (" + std::to_string(static_cast<uint64_t>(prefabsPerSecond)) + " prefabs/second)");
+
+	SceneManager::ClearScene();
+
+	END_TEST();
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "../unit_test_manager.h"
+
+#include <atomic>
+#include <vector>
+
+#include <engine/debug/debug.h>
+#include <engine/job_system/job_system.h>
+
+TestResult JobSystemTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+	// Schedule and wait
+	std::atomic<size_t> executedJobCount = 0;
+	std::vector<JobHandle> handles;
+	for (size_t i = 0; i < 100; i++)
+	{
+		handles.push_back(JobSystem::Schedule([&executedJobCount]() { executedJobCount++; }));
+	}
+	for (const JobHandle& handle : handles)
+	{
+		JobSystem::Wait(handle);
+		EXPECT_TRUE(handle.IsDone(), "Job not done after Wait");
+	}
+	EXPECT_EQUALS(executedJobCount.load(), static_cast<size_t>(100), "Bad executed job count");
+
+	// Parallel for, each element has to be processed once
+	std::vector<int> values(10000, 0);
+	JobSystem::ParallelFor(values.size(), 64, [&values](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				values[i]++;
+			}
+		});
+	size_t processedCount = 0;
+	for (const int value : values)
+	{
+		if (value == 1)
+			processedCount++;
+	}
+	EXPECT_EQUALS(processedCount, values.size(), "Bad ParallelFor processed element count");
+
+	// The continuation is only called by the main thread
+	bool isContinuationCalled = false;
+	const JobHandle continuationHandle = JobSystem::Schedule([]() {}, [&isContinuationCalled]() { isContinuationCalled = true; });
+	JobSystem::Wait(continuationHandle);
+	JobSystem::ExecuteMainThreadContinuations();
+	EXPECT_TRUE(isContinuationCalled, "Continuation not called");
+
+	END_TEST();
+}
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "../unit_test_manager.h"
+
+#include <json.hpp>
+
+#include <engine/debug/debug.h>
+#include <engine/tools/benchmark.h>
+#include <engine/reflection/reflection_utils.h>
+#include <engine/game_elements/gameobject.h>
+#include <engine/game_elements/gameplay_manager.h>
+#include <engine/game_elements/transform.h>
+#include <engine/scene_management/scene_manager.h>
+#include <engine/scene_management/binary_scene.h>
+#include <engine/test_component.h>
+
+using ordered_json = nlohmann::ordered_json;
+
+/**
+* @brief Save the current scene in the json format used by the editor
+*/
+static ordered_json SaveSceneToJson()
+{
+	ordered_json sceneJson;
+	for (const std::shared_ptr<GameObject>& gameObject : GameplayManager::GetGameObjects())
+	{
+		ordered_json& gameObjectJson = sceneJson["GameObjects"][std::to_string(gameObject->GetUniqueId())];
+		gameObjectJson["Transform"]["Values"] = ReflectionUtils::ReflectiveToJson(*gameObject->GetTransform());
+		gameObjectJson["Values"] = ReflectionUtils::ReflectiveToJson(*gameObject);
+
+		std::vector<uint64_t> childrenIds;
+		const int childCount = gameObject->GetChildrenCount();
+		for (int childIndex = 0; childIndex < childCount; childIndex++)
+		{
+			childrenIds.push_back(gameObject->GetChild(childIndex).lock()->GetUniqueId());
+		}
+		gameObjectJson["Children"] = childrenIds;
+
+		for (const std::shared_ptr<Component>& component : gameObject->GetComponents<Component>())
+		{
+			ordered_json& componentJson = gameObjectJson["Components"][std::to_string(component->GetUniqueId())];
+			componentJson["Type"] = component->GetComponentName();
+			componentJson["Values"] = ReflectionUtils::ReflectiveDataToJson(component->GetReflectiveData());
+			componentJson["Enabled"] = component->IsEnabled();
+		}
+	}
+	return sceneJson;
+}
+
+/**
+* @brief Check the values of a loaded scene
+* @return False if a value is wrong
+*/
+static bool CheckLoadedScene(size_t gameObjectCount, uint64_t childId, uint64_t parentId)
+{
+	if (GameplayManager::GetGameObjects().size() != gameObjectCount)
+		return false;
+
+	const std::shared_ptr<GameObject> child = FindGameObjectById(childId);
+	const std::shared_ptr<GameObject> parent = FindGameObjectById(parentId);
+	if (!child || !parent || child->GetParent().lock() != parent)
+		return false;
+
+	if (child->GetTransform()->GetLocalPosition() != Vector3(1, 2, 3) || child->GetName() != "Child")
+		return false;
+
+	const std::shared_ptr<TestComponent> component = child->GetComponent<TestComponent>();
+	return component && component->myInt == 42 && component->vec3 == Vector3(4, 5, 6) && component->myGameObject.lock() == parent;
+}
+
+TestResult SceneLoadBenchmarkTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__LINUX__)
+	constexpr size_t gameObjectCount = 50000;
+#else
+	constexpr size_t gameObjectCount = 1000; // Keep the test usable on consoles
+#endif
+	constexpr size_t childrenPerParent = 9;
+
+	// Create a scene with parents, children and some components
+	SceneManager::ClearScene();
+	std::shared_ptr<GameObject> parent;
+	uint64_t childId = 0;
+	uint64_t parentId = 0;
+	for (size_t i = 0; i < gameObjectCount; i++)
+	{
+		if (i % (childrenPerParent + 1) == 0)
+		{
+			parent = CreateGameObject("Parent");
+			continue;
+		}
+
+		std::shared_ptr<GameObject> child = CreateGameObject("Child");
+		child->SetParent(parent);
+		child->GetTransform()->SetLocalPosition(Vector3(1, 2, 3));
+		std::shared_ptr<TestComponent> component = child->AddComponent<TestComponent>();
+		component->myInt = 42;
+		component->vec3 = Vector3(4, 5, 6);
+		component->myGameObject = parent;
+		childId = child->GetUniqueId();
+		parentId = parent->GetUniqueId();
+	}
+
+	const std::string jsonString = SaveSceneToJson().dump(0);
+	std::vector<uint8_t> binaryData;
+	EXPECT_EQUALS(BinaryScene::JsonToBinary(ordered_json::parse(jsonString), binaryData), true, "Failed to convert the scene to the binary format");
+	EXPECT_EQUALS(BinaryScene::IsBinaryScene(binaryData.data(), binaryData.size()), true, "Bad binary scene header");
+
+	Benchmark jsonBenchmark;
+	jsonBenchmark.Start();
+	SceneManager::LoadScene(ordered_json::parse(jsonString));
+	jsonBenchmark.Stop();
+	EXPECT_EQUALS(CheckLoadedScene(gameObjectCount, childId, parentId), true, "Bad scene loaded from json");
+
+	Benchmark binaryBenchmark;
+	binaryBenchmark.Start();
+	SceneManager::LoadScene(binaryData.data(), binaryData.size());
+	binaryBenchmark.Stop();
+	EXPECT_EQUALS(CheckLoadedScene(gameObjectCount, childId, parentId), true, "Bad scene loaded from binary");
+
+	SceneManager::ClearScene();
+
+	Debug::Print("[SceneLoadBenchmark] " + std::to_string(gameObjectCount) + " GameObjects: json " + std::to_string(jsonBenchmark.GetMicroSeconds()) + "us (" + std::to_string(jsonString.size()) + " bytes), binary " + std::to_string(binaryBenchmark.GetMicroSeconds()) + "us (" + std::to_string(binaryData.size()) + " bytes)");
+
+	END_TEST();
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MIT
+//
+// Copyright (c) 2022-2024 Gregory Machefer (Fewnity)
+//
+// This file is part of Xenity Engine
+
+#include "../unit_test_manager.h"
+
+#include <vector>
+
+#include <engine/debug/debug.h>
+#include <engine/graphics/2d_graphics/texture_atlas_packer.h>
+
+TestResult TextureAtlasPackerTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+	struct Rectangle
+	{
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	// Fill a page with rectangles of different sizes
+	TextureAtlasPacker packer = TextureAtlasPacker(256, 256);
+	std::vector<Rectangle> rectangles;
+	for (int i = 0; i < 200; i++)
+	{
+		Rectangle rectangle;
+		rectangle.width = 8 + (i * 7) % 25;
+		rectangle.height = 8 + (i * 13) % 19;
+		if (packer.Insert(rectangle.width, rectangle.height, rectangle.x, rectangle.y))
+		{
+			rectangles.push_back(rectangle);
+		}
+	}
+	const bool hasEnoughRectangles = rectangles.size() > static_cast<size_t>(50);
+	const bool hasGoodOccupancy = packer.GetOccupancy() > 0.7f;
+	EXPECT_TRUE(hasEnoughRectangles, "Too few rectangles packed");
+	EXPECT_TRUE(hasGoodOccupancy, "Bad page occupancy");
+
+	// The rectangles have to be in the page without overlapping
+	bool isInPage = true;
+	bool isOverlapping = false;
+	const size_t rectangleCount = rectangles.size();
+	for (size_t i = 0; i < rectangleCount; i++)
+	{
+		const Rectangle& a = rectangles[i];
+		if (a.x < 0 || a.y < 0 || a.x + a.width > 256 || a.y + a.height > 256)
+			isInPage = false;
+
+		for (size_t j = i + 1; j < rectangleCount; j++)
+		{
+			const Rectangle& b = rectangles[j];
+			if (a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height)
+				isOverlapping = true;
+		}
+	}
+	EXPECT_TRUE(isInPage, "Rectangle out of the page");
+	EXPECT_FALSE(isOverlapping, "Overlapping rectangles");
+
+	// Too big rectangle
+	int x = 0;
+	int y = 0;
+	const bool isTooBigRectanglePacked = packer.Insert(257, 10, x, y);
+	EXPECT_FALSE(isTooBigRectanglePacked, "Rectangle bigger than the page packed");
+
+	// The page is empty after a clear
+	packer.Clear();
+	const bool isFullPageRectanglePacked = packer.Insert(256, 256, x, y);
+	EXPECT_TRUE(isFullPageRectanglePacked, "Full page rectangle not packed after clear");
+	EXPECT_EQUALS(x, 0, "Bad x position");
+	EXPECT_EQUALS(y, 0, "Bad y position");
+
+	END_TEST();
+}
@@ -14,6 +14,7 @@
 #include <engine/game_elements/gameobject.h>
 #include <engine/game_elements/transform.h>
 #include <engine/tools/gameplay_utility.h>
+#include <engine/tools/benchmark.h>
 
 TestResult TransformSetPositionTest::Start(std::string& errorOut)
 {
@@ -107,4 +108,142 @@ TestResult TransformSetScaleTest::Start(std::string& errorOut)
 	Destroy(parent);
 
 	END_TEST();
-}
\ No newline at end of file
+}
+
+static int s_lazyChildUpdateCount = 0;
+
+static void OnLazyChildTransformUpdated()
+{
+	s_lazyChildUpdateCount++;
+}
+
+TestResult TransformLazyUpdateTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+	const bool wasLazyUpdateEnabled = Transform::IsLazyUpdateEnabled();
+	Transform::SetLazyUpdateEnabled(true);
+
+	std::shared_ptr<GameObject> parent = CreateGameObject();
+	std::shared_ptr<GameObject> gameObject = CreateGameObject();
+	std::shared_ptr<GameObject> child = CreateGameObject();
+	gameObject->SetParent(parent);
+	child->SetParent(gameObject);
+	std::shared_ptr<Transform> transform = gameObject->GetTransform();
+
+	// Values are resolved when read
+	parent->GetTransform()->SetPosition(Vector3(10, 20, 30));
+	transform->SetLocalPosition(Vector3(4, 5, 6));
+	EXPECT_EQUALS(transform->GetPosition(), Vector3(14, 25, 36), "Bad lazy Transform SetLocalPosition in a parent (GetPosition)");
+	EXPECT_EQUALS(child->GetTransform()->GetPosition(), Vector3(14, 25, 36), "Bad lazy Transform SetLocalPosition in a parent (child GetPosition)");
+
+	// SetPosition uses the dirty parent values
+	parent->GetTransform()->SetLocalScale(Vector3(2, 2, 2));
+	transform->SetPosition(Vector3(4, 5, 6));
+	EXPECT_EQUALS(transform->GetPosition(), Vector3(4, 5, 6), "Bad lazy Transform SetPosition in a parent (GetPosition)");
+	EXPECT_EQUALS(transform->GetLocalPosition(), Vector3(-3, -7.5f, -12), "Bad lazy Transform SetPosition in a parent (GetLocalPosition)");
+
+	// Values are resolved at the end of the frame
+	parent->GetTransform()->SetLocalScale(Vector3(1, 1, 1));
+	parent->GetTransform()->SetPosition(Vector3(0, 0, 0));
+	Transform::UpdateDirtyTransforms();
+	EXPECT_EQUALS(child->GetTransform()->GetPosition(), Vector3(-3, -7.5f, -12), "Bad lazy Transform UpdateDirtyTransforms (child GetPosition)");
+
+	// The children are updated at the end of the frame even if they are never read
+	s_lazyChildUpdateCount = 0;
+	child->GetTransform()->GetOnTransformUpdated().Bind(&OnLazyChildTransformUpdated);
+	parent->GetTransform()->SetPosition(Vector3(10, 0, 0));
+	EXPECT_EQUALS(s_lazyChildUpdateCount, 0, "Child updated before UpdateDirtyTransforms");
+	Transform::UpdateDirtyTransforms();
+	EXPECT_EQUALS(s_lazyChildUpdateCount, 1, "Child not updated by UpdateDirtyTransforms");
+	child->GetTransform()->GetOnTransformUpdated().Unbind(&OnLazyChildTransformUpdated);
+
+	Destroy(parent);
+
+	Transform::SetLazyUpdateEnabled(wasLazyUpdateEnabled);
+
+	END_TEST();
+}
+
+/**
+* @brief Move the root of a hierarchy several times per frame and return the time spent in microseconds
+*/
+static uint64_t MoveHierarchy(const std::shared_ptr<GameObject>& root, const std::shared_ptr<Transform>& readTransform, Vector3& lastPosition)
+{
+	constexpr int frameCount = 20;
+	constexpr int movesPerFrame = 4;
+
+	Benchmark benchmark;
+	benchmark.Start();
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		for (int move = 0; move < movesPerFrame; move++)
+		{
+			root->GetTransform()->SetPosition(Vector3(static_cast<float>(frame), static_cast<float>(move), 0));
+			root->GetTransform()->SetRotation(Vector3(0, static_cast<float>(frame * movesPerFrame + move), 0));
+		}
+		Transform::UpdateDirtyTransforms();
+		lastPosition = readTransform->GetPosition();
+	}
+	benchmark.Stop();
+
+	return benchmark.GetMicroSeconds();
+}
+
+TestResult TransformLazyUpdateBenchmarkTest::Start(std::string& errorOut)
+{
+	BEGIN_TEST();
+
+	const bool wasLazyUpdateEnabled = Transform::IsLazyUpdateEnabled();
+
+	constexpr int deepHierarchySize = 100;
+	constexpr int wideHierarchySize = 1000;
+
+	// Deep hierarchy: a chain of children
+	std::shared_ptr<GameObject> deepRoot = CreateGameObject();
+	std::shared_ptr<GameObject> deepLeaf = deepRoot;
+	for (int i = 0; i < deepHierarchySize; i++)
+	{
+		std::shared_ptr<GameObject> newGameObject = CreateGameObject();
+		newGameObject->SetParent(deepLeaf);
+		newGameObject->GetTransform()->SetLocalPosition(Vector3(1, 0, 0));
+		deepLeaf = newGameObject;
+	}
+
+	// Wide hierarchy: a lot of children on the same parent
+	std::shared_ptr<GameObject> wideRoot = CreateGameObject();
+	std::shared_ptr<GameObject> wideLeaf;
+	for (int i = 0; i < wideHierarchySize; i++)
+	{
+		wideLeaf = CreateGameObject();
+		wideLeaf->SetParent(wideRoot);
+		wideLeaf->GetTransform()->SetLocalPosition(Vector3(static_cast<float>(i), 0, 0));
+	}
+
+	Vector3 eagerDeepPosition;
+	Vector3 lazyDeepPosition;
+	Vector3 eagerWidePosition;
+	Vector3 lazyWidePosition;
+
+	Transform::SetLazyUpdateEnabled(false);
+	const uint64_t eagerDeepTime = MoveHierarchy(deepRoot, deepLeaf->GetTransform(), eagerDeepPosition);
+	const uint64_t eagerWideTime = MoveHierarchy(wideRoot, wideLeaf->GetTransform(), eagerWidePosition);
+
+	Transform::SetLazyUpdateEnabled(true);
+	const uint64_t lazyDeepTime = MoveHierarchy(deepRoot, deepLeaf->GetTransform(), lazyDeepPosition);
+	const uint64_t lazyWideTime = MoveHierarchy(wideRoot, wideLeaf->GetTransform(), lazyWidePosition);
+
+	Transform::SetLazyUpdateEnabled(wasLazyUpdateEnabled);
+
+	Debug::Print("[TransformLazyUpdateBenchmark] Deep hierarchy: eager " + std::to_string(eagerDeepTime) + "us, lazy " + std::to_string(lazyDeepTime) + "us");
+	Debug::Print("[TransformLazyUpdateBenchmark] Wide hierarchy: eager " + std::to_string(eagerWideTime) + "us, lazy " + std::to_string(lazyWideTime) + "us");
+
+	// Both modes have to give the same result
+	EXPECT_EQUALS(lazyDeepPosition, eagerDeepPosition, "Lazy and eager updates give different positions (deep hierarchy)");
+	EXPECT_EQUALS(lazyWidePosition, eagerWidePosition, "Lazy and eager updates give different positions (wide hierarchy)");
+
+	Destroy(deepRoot);
+	Destroy(wideRoot);
+
+	END_TEST();
+}
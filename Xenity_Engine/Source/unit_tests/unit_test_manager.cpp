@@ -5,6 +5,7 @@
 // This file is part of Xenity Engine
 
 #include "unit_test_manager.h"
+#include <engine/constants.h>
 #include <engine/debug/debug.h>
 #include <engine/vectors/vector2.h>
 #include <engine/vectors/vector2_int.h>
@@ -47,6 +48,52 @@ void UnitTestManager::StartAllTests()
 
 		TransformSetScaleTest transformSetScaleTest = TransformSetScaleTest("Transform Set Scale");
 		TryTest(transformSetScaleTest);
+
+		TransformLazyUpdateTest transformLazyUpdateTest = TransformLazyUpdateTest("Transform Lazy Update");
+		TryTest(transformLazyUpdateTest);
+
+#if defined(ENABLE_BENCHMARK_TESTS)
+		TransformLazyUpdateBenchmarkTest transformLazyUpdateBenchmarkTest = TransformLazyUpdateBenchmarkTest("Transform Lazy Update Benchmark");
+		TryTest(transformLazyUpdateBenchmarkTest);
+#endif
+	}
+
+	//------------------------------------------------------------------ Test gameplay manager
+	{
+		GameplayManagerUpdateListTest gameplayManagerUpdateListTest = GameplayManagerUpdateListTest("Gameplay Manager Update List");
+		TryTest(gameplayManagerUpdateListTest);
+
+		GameplayManagerIdIndexTest gameplayManagerIdIndexTest = GameplayManagerIdIndexTest("Gameplay Manager Id Index");
+		TryTest(gameplayManagerIdIndexTest);
+
+		GameObjectPoolTest gameObjectPoolTest = GameObjectPoolTest("GameObject Pool");
+		TryTest(gameObjectPoolTest);
+	}
+
+#if defined(ENABLE_BENCHMARK_TESTS)
+	//------------------------------------------------------------------ Test scene manager
+	{
+		SceneLoadBenchmarkTest sceneLoadBenchmarkTest = SceneLoadBenchmarkTest("Scene Load Benchmark");
+		TryTest(sceneLoadBenchmarkTest);
+	}
+
+	//------------------------------------------------------------------ Test gameplay utility
+	{
+		InstantiateBenchmarkTest instantiateBenchmarkTest = InstantiateBenchmarkTest("Instantiate Benchmark");
+		TryTest(instantiateBenchmarkTest);
+	}
+#endif
+
+	//------------------------------------------------------------------ Test job system
+	{
+		JobSystemTest jobSystemTest = JobSystemTest("Job System");
+		TryTest(jobSystemTest);
+	}
+
+	//------------------------------------------------------------------ Test texture atlas
+	{
+		TextureAtlasPackerTest textureAtlasPackerTest = TextureAtlasPackerTest("Texture Atlas Packer");
+		TryTest(textureAtlasPackerTest);
 	}
 
 	//------------------------------------------------------------------ Test color
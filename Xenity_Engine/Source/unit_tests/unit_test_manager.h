@@ -108,6 +108,40 @@ MAKE_TEST(VectorNormalize);
 MAKE_TEST(TransformSetPosition);
 MAKE_TEST(TransformSetRotation);
 MAKE_TEST(TransformSetScale);
+MAKE_TEST(TransformLazyUpdate);
+MAKE_TEST(TransformLazyUpdateBenchmark);
+
+#pragma endregion
+
+#pragma region Gameplay Manager
+
+MAKE_TEST(GameplayManagerUpdateList);
+MAKE_TEST(GameplayManagerIdIndex);
+MAKE_TEST(GameObjectPool);
+
+#pragma endregion
+
+#pragma region Scene Manager
+
+MAKE_TEST(SceneLoadBenchmark);
+
+#pragma endregion
+
+#pragma region Gameplay Utility
+
+MAKE_TEST(InstantiateBenchmark);
+
+#pragma endregion
+
+#pragma region Job System
+
+MAKE_TEST(JobSystem);
+
+#pragma endregion
+
+#pragma region Texture Atlas
+
+MAKE_TEST(TextureAtlasPacker);
 
 #pragma endregion
 
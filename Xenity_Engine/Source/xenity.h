@@ -12,6 +12,7 @@
 #include <engine/game_elements/gameobject.h>
 #include <engine/game_elements/transform.h>
 #include <engine/game_elements/rect_transform.h>
+#include <engine/game_elements/gameobject_pool.h>
 
 // Vectors
 #include <engine/vectors/vector2.h>
@@ -99,5 +100,8 @@
 // Event System
 #include <engine/event_system/event_system.h>
 
+// Job System
+#include <engine/job_system/job_system.h>
+
 // Particles
 #include <engine/particle_system/particle_system.h>
\ No newline at end of file
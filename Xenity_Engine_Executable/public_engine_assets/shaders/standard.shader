@@ -6,9 +6,11 @@
 layout (location = 0) in vec3 position;
 layout(location = 1) in vec2 uv;
 layout(location = 2) in vec3 normal;
-layout(location = 3) in vec3 color;
+layout(location = 3) in vec4 vertexColor; // White if the mesh has no vertex color
+layout(location = 4) in mat4 instanceModel; // Per instance model matrix, used when useInstancing is true
 
 out vec2 TexCoord;
+out vec4 VertexColor;
 out vec3 Normal;
 out vec3 FragPos;
 
@@ -16,14 +18,17 @@ uniform mat4 camera;
 uniform mat4 projection;
 
 uniform mat4 model; //Model matrice position, rotation and scale
+uniform bool useInstancing;
 
 void main()
 {
-	gl_Position = projection * camera * model * vec4(position, 1);
+	mat4 usedModel = useInstancing ? instanceModel : model;
+	gl_Position = projection * camera * usedModel * vec4(position, 1);
 	TexCoord = uv;
-	FragPos = vec3(model * vec4(position, 1));
+	VertexColor = vertexColor;
+	FragPos = vec3(usedModel * vec4(position, 1));
 
-	Normal = mat3(transpose(inverse(model))) * normal; //TODO Check an object with a bigger scale and with a 	offsetPosition, fix : add to offset * rotation this : * offsetPosition * scale
+	Normal = mat3(transpose(inverse(usedModel))) * normal; //TODO Check an object with a bigger scale and with a 	offsetPosition, fix : add to offset * rotation this : * offsetPosition * scale
 }
 
 //-------------- {fragment}
@@ -37,6 +42,7 @@ in vec3 Normal;
 in vec3 FragPos;
 
 in vec2 TexCoord;
+in vec4 VertexColor;
 uniform sampler2D ourTexture;
 uniform vec2 tiling;
 uniform vec2 offset;
@@ -191,9 +197,9 @@ void main()
 	}
 	result += vec3(texture(material.diffuse, (TexCoord * tiling) + offset)) * ambientLight;
 
-	float alpha = texture(material.diffuse, (TexCoord * tiling) + offset).a* color.w;
+	float alpha = texture(material.diffuse, (TexCoord * tiling) + offset).a* color.w * VertexColor.w;
 
-	gl_FragColor = vec4(result * color.xyz, alpha); //Add texture color
+	gl_FragColor = vec4(result * color.xyz * VertexColor.xyz, alpha); //Add texture color
 }
 
 //-------------- {psvita}
@@ -6,8 +6,11 @@
 layout (location = 0) in vec3 position;
 layout(location = 1) in vec2 uv;
 layout(location = 2) in vec3 normal;
+layout(location = 3) in vec4 vertexColor; // White if the mesh has no vertex color
+layout(location = 4) in mat4 instanceModel; // Per instance model matrix, used when useInstancing is true
 
 out vec2 TexCoord;
+out vec4 VertexColor;
 out vec3 Normal;
 out vec3 FragPos;
 
@@ -15,11 +18,14 @@ uniform mat4 camera;
 uniform mat4 projection;
 
 uniform mat4 model; //Model matrice position, rotation and scale
+uniform bool useInstancing;
 
 void main()
 {
-	gl_Position = projection * camera * model * vec4(position, 1);
+	mat4 usedModel = useInstancing ? instanceModel : model;
+	gl_Position = projection * camera * usedModel * vec4(position, 1);
 	TexCoord = uv;
+	VertexColor = vertexColor;
 }
 
 //-------------- {fragment}
@@ -31,6 +37,7 @@ uniform vec4 color;
 uniform vec3 cameraPos;
 
 in vec2 TexCoord;
+in vec4 VertexColor;
 
 uniform vec2 tiling;
 uniform vec2 offset;
@@ -46,12 +53,12 @@ void main()
 {
 	// Ambient
 
-	vec3 ambient = color.xyz * vec3(texture(material.diffuse, (TexCoord * tiling) + offset)); //Get ambient intensity and color
+	vec3 ambient = color.xyz * VertexColor.xyz * vec3(texture(material.diffuse, (TexCoord * tiling) + offset)); //Get ambient intensity and color
 
 	//Result
 	vec3 result = ambient; //Set face result
 
-	float alpha = texture(material.diffuse, (TexCoord * tiling) + offset).a * color.w;
+	float alpha = texture(material.diffuse, (TexCoord * tiling) + offset).a * color.w * VertexColor.w;
 	FragColor = vec4(result, alpha); //Add texture color
 }
 